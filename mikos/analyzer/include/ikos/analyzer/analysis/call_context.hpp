@@ -43,10 +43,14 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <mutex>
 
 #include <llvm/ADT/DenseMap.h>
 
+#include <ikos/core/adt/patricia_tree/set.hpp>
+
 #include <ikos/ar/semantic/statement.hpp>
 
 #include <ikos/analyzer/support/assert.hpp>
@@ -55,7 +59,13 @@ namespace ikos {
 namespace analyzer {
 
 /// \brief Represents a calling context
+///
+/// Calling contexts are unique, see CallContextFactory.
 class CallContext {
+private:
+  /// \brief Persistent set of functions, using their addresses as indexes
+  using FunctionSet = core::PatriciaTreeSet< core::Index >;
+
 private:
   /// \brief Parent call context
   CallContext* _parent = nullptr;
@@ -63,15 +73,42 @@ private:
   /// \brief Call statement
   ar::CallBase* _call = nullptr;
 
+  /// \brief Unique identifier, in order of creation
+  ///
+  /// The empty calling context has the identifier 0.
+  std::size_t _id = 0;
+
+  /// \brief Number of calls in the calling context
+  std::size_t _depth = 0;
+
+  /// \brief Functions within the calling context
+  ///
+  /// This shares most nodes with the set of the parent.
+  FunctionSet _functions;
+
 private:
   /// \brief Create an empty call context
   CallContext() = default;
 
   /// \brief Create a call context
-  CallContext(CallContext* parent, ar::CallBase* call)
-      : _parent(parent), _call(call) {
+  CallContext(CallContext* parent, ar::CallBase* call, std::size_t id)
+      : _parent(parent),
+        _call(call),
+        _id(id),
+        _depth(parent->_depth + 1),
+        _functions(parent->_functions) {
     ikos_assert(this->_parent != nullptr);
     ikos_assert(this->_call != nullptr);
+
+    if (ar::Function* fun = call->code()->function_or_null()) {
+      this->_functions.insert(index(fun));
+    }
+  }
+
+  /// \brief Return the index of the given function in the set
+  static core::Index index(const ar::Function* fun) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast< core::Index >(fun);
   }
 
 public:
@@ -90,6 +127,14 @@ public:
   /// \brief Destructor
   ~CallContext() = default;
 
+  /// \brief Return the unique identifier of the calling context
+  ///
+  /// Identifiers are dense, starting at 0 for the empty calling context.
+  std::size_t id() const { return this->_id; }
+
+  /// \brief Return the number of calls in the calling context
+  std::size_t depth() const { return this->_depth; }
+
   /// \brief Return true if this is an empty calling context
   bool empty() const { return this->_parent == nullptr; }
 
@@ -110,15 +155,7 @@ public:
 
   /// \brief Return true if the given function is within the call context
   bool contains(ar::Function* fun) const {
-    const CallContext* context = this;
-
-    for (; context->_parent != nullptr; context = context->_parent) {
-      if (context->_call->code()->function_or_null() == fun) {
-        return true;
-      }
-    }
-
-    return false;
+    return this->_functions.contains(index(fun));
   }
 
 private:
@@ -135,6 +172,12 @@ private:
 
   std::unique_ptr< CallContext > _empty_call_context;
 
+  /// \brief Identifier of the next calling context
+  std::size_t _next_id = 1;
+
+  /// \brief Mutex protecting the map, for concurrent analyses
+  std::mutex _mutex;
+
 public:
   /// \brief Constructor
   CallContextFactory();
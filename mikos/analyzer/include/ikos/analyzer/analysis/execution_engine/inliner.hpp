@@ -57,6 +57,7 @@
 
 #include <ikos/analyzer/analysis/execution_engine/engine.hpp>
 #include <ikos/analyzer/analysis/execution_engine/numerical.hpp>
+#include <ikos/analyzer/analysis/execution_engine/summary_cache.hpp>
 #include <ikos/analyzer/analysis/pointer/value.hpp>
 #include <ikos/analyzer/util/demangle.hpp>
 #include <ikos/analyzer/util/log.hpp>
@@ -355,7 +356,38 @@ private:
 
       std::unique_ptr< FunctionAnalyzer > callee_analyzer = nullptr;
 
-      if (this->_convergence_achieved && _ctx.opts.use_fixpoint_cache) {
+      // Function summaries are only used until the fixpoint is reached, since
+      // the checks need a fixpoint on the callee
+      FunctionSummaryCache< AbstractDomain >* summary_cache =
+          this->_caller.summary_cache();
+      bool use_summary = summary_cache != nullptr &&
+                         !this->_convergence_achieved &&
+                         summary_cache->is_cacheable(callee);
+      if (use_summary) {
+        if (auto summary = summary_cache->find(callee, engine.inv())) {
+          if (_ctx.opts.use_fixpoint_cache) {
+            // There is no fix-point to save for later
+            this->_calls_cache[call][callee].reset();
+          }
+
+          engine.set_inv(std::move(summary->first));
+
+          // Merge exceptions in caught_exceptions, in case it's an invoke
+          engine.inv().merge_propagated_in_caught_exceptions();
+
+          if (engine.inv().is_normal_flow_bottom()) {
+            post.join_with(engine.inv()); // collect the exception states
+            continue;
+          }
+
+          engine.match_up(call, summary->second);
+          post.join_with(engine.inv());
+          continue;
+        }
+      }
+
+      if (this->_convergence_achieved && _ctx.opts.use_fixpoint_cache &&
+          this->_calls_cache[call][callee] != nullptr) {
         // Use the previously computed fix-point
         callee_analyzer = std::move(this->_calls_cache[call][callee]);
 
@@ -380,7 +412,16 @@ private:
 
         // Run analysis on callee
         log::debug("Analyzing function '" + demangle(callee->name()) + "'");
-        callee_analyzer->run(engine.inv());
+        if (use_summary) {
+          AbstractDomain entry = engine.inv();
+          callee_analyzer->run(engine.inv());
+          summary_cache->insert(callee,
+                                std::move(entry),
+                                callee_analyzer->exit_invariant(),
+                                callee_analyzer->return_stmt());
+        } else {
+          callee_analyzer->run(engine.inv());
+        }
       }
 
       if (this->_check_callees) {
@@ -0,0 +1,313 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Cache of function summaries for the inliner
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <llvm/ADT/DenseMap.h>
+
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/intrinsic.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/semantic/value.hpp>
+
+#include <ikos/analyzer/support/cast.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Cache of function summaries
+///
+/// A summary maps the entry invariant of a callee to its exit invariant. If a
+/// callee is called again with an entry invariant smaller or equal to the one
+/// of a summary, the exit invariant of the summary is a sound approximation of
+/// the exit invariant of the call, and the callee does not need to be
+/// analyzed again.
+///
+/// The entry invariant is the whole invariant after the parameters are
+/// assigned, including the variables and memory of the callers, because the
+/// exit invariant of a summary replaces the invariant after the call. It is
+/// not projected onto what the callee can read, hence summaries are mostly
+/// reused within the same caller.
+///
+/// Summaries are only used for callees that cannot create dynamically
+/// allocated memory locations, directly or through their own callees. These
+/// locations depend on the call context (see DynAllocMemoryLocation), so the
+/// exit invariant of a callee that allocates memory refers to the locations of
+/// the call that computed it, and cannot be reused for another call.
+///
+/// Since the summaries also refer to the call stack of the analyzed entry
+/// point, a cache should only be used for the analysis of one entry point.
+///
+/// The cache holds at most `capacity` summaries, and evicts the least recently
+/// used ones.
+template < typename AbstractDomain >
+class FunctionSummaryCache {
+public:
+  /// \brief Summary of a function
+  struct Summary {
+    /// \brief Called function
+    ar::Function* callee;
+
+    /// \brief Invariant at the entry of the function
+    AbstractDomain entry;
+
+    /// \brief Invariant at the exit of the function
+    AbstractDomain exit;
+
+    /// \brief Return statement in the callee, or null
+    ar::ReturnValue* return_stmt;
+  };
+
+private:
+  /// \brief List of summaries, from the most to the least recently used
+  using SummaryList = std::list< Summary >;
+
+  /// \brief Map from function to summaries
+  using FunctionMap =
+      llvm::DenseMap< ar::Function*,
+                      std::vector< typename SummaryList::iterator > >;
+
+private:
+  /// \brief Maximum number of summaries
+  std::size_t _capacity;
+
+  /// \brief Summaries
+  SummaryList _summaries;
+
+  /// \brief Summaries of each function
+  FunctionMap _functions;
+
+  /// \brief Whether summaries can be used for a function
+  llvm::DenseMap< ar::Function*, bool > _cacheable;
+
+  /// \brief Number of calls that used a summary
+  std::size_t _hits = 0;
+
+  /// \brief Number of calls that did not find a summary
+  std::size_t _misses = 0;
+
+  /// \brief Mutex
+  mutable std::mutex _mutex;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param capacity Maximum number of summaries
+  explicit FunctionSummaryCache(std::size_t capacity) : _capacity(capacity) {}
+
+  /// \brief No copy constructor
+  FunctionSummaryCache(const FunctionSummaryCache&) = delete;
+
+  /// \brief No move constructor
+  FunctionSummaryCache(FunctionSummaryCache&&) = delete;
+
+  /// \brief No copy assignment operator
+  FunctionSummaryCache& operator=(const FunctionSummaryCache&) = delete;
+
+  /// \brief No move assignment operator
+  FunctionSummaryCache& operator=(FunctionSummaryCache&&) = delete;
+
+  /// \brief Destructor
+  ~FunctionSummaryCache() = default;
+
+  /// \brief Return true if summaries can be used for calls to `callee`
+  ///
+  /// This is the case if `callee` cannot create dynamically allocated memory
+  /// locations, directly or through its callees.
+  bool is_cacheable(ar::Function* callee) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    return this->is_context_insensitive(callee);
+  }
+
+  /// \brief Return the exit invariant and the return statement for a call to
+  /// `callee` with the given entry invariant, if a summary covers it
+  ///
+  /// Precondition: `is_cacheable(callee)`
+  boost::optional< std::pair< AbstractDomain, ar::ReturnValue* > > find(
+      ar::Function* callee, const AbstractDomain& entry) {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+
+    auto it = this->_functions.find(callee);
+    if (it != this->_functions.end()) {
+      for (auto summary : it->second) {
+        if (entry.leq(summary->entry)) {
+          this->_hits++;
+          this->_summaries.splice(this->_summaries.begin(),
+                                  this->_summaries,
+                                  summary);
+          return std::make_pair(summary->exit, summary->return_stmt);
+        }
+      }
+    }
+
+    this->_misses++;
+    return boost::none;
+  }
+
+  /// \brief Add a summary for `callee`
+  ///
+  /// Precondition: `is_cacheable(callee)`
+  void insert(ar::Function* callee,
+              AbstractDomain entry,
+              AbstractDomain exit,
+              ar::ReturnValue* return_stmt) {
+    if (this->_capacity == 0) {
+      return;
+    }
+
+    // Summaries are only read from now on, and copies returned by find()
+    // share their representation, so they must not be normalized lazily
+    entry.normalize();
+    exit.normalize();
+
+    std::lock_guard< std::mutex > lock(this->_mutex);
+
+    if (this->_summaries.size() >= this->_capacity) {
+      this->evict();
+    }
+
+    this->_summaries.push_front(
+        Summary{callee, std::move(entry), std::move(exit), return_stmt});
+    this->_functions[callee].push_back(this->_summaries.begin());
+  }
+
+  /// \brief Return the number of calls that used a summary
+  std::size_t hits() const {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    return this->_hits;
+  }
+
+  /// \brief Return the number of calls that did not find a summary
+  std::size_t misses() const {
+    std::lock_guard< std::mutex > lock(this->_mutex);
+    return this->_misses;
+  }
+
+private:
+  /// \brief Return true if `fun` cannot create dynamically allocated memory
+  /// locations, directly or through its callees
+  ///
+  /// Indirect calls and recursive functions are conservatively considered as
+  /// allocating memory.
+  ///
+  /// Precondition: the current thread owns the mutex
+  bool is_context_insensitive(ar::Function* fun) {
+    auto it = this->_cacheable.find(fun);
+    if (it != this->_cacheable.end()) {
+      return it->second;
+    }
+
+    if (fun->is_declaration()) {
+      bool result = !is_allocation(fun);
+      this->_cacheable[fun] = result;
+      return result;
+    }
+
+    // Functions in a cycle of the call graph are not cacheable
+    this->_cacheable[fun] = false;
+
+    for (ar::BasicBlock* bb : *fun->body()) {
+      for (ar::Statement* stmt : *bb) {
+        auto call = dyn_cast< ar::CallBase >(stmt);
+        if (call == nullptr || call->is_asm()) {
+          continue;
+        }
+        auto cst = dyn_cast< ar::FunctionPointerConstant >(call->called());
+        if (cst == nullptr ||
+            !this->is_context_insensitive(cst->function())) {
+          return false;
+        }
+      }
+    }
+
+    this->_cacheable[fun] = true;
+    return true;
+  }
+
+  /// \brief Return true if `fun` is an intrinsic that creates a dynamically
+  /// allocated memory location
+  static bool is_allocation(ar::Function* fun) {
+    switch (fun->intrinsic_id()) {
+      case ar::Intrinsic::LibcMalloc:
+      case ar::Intrinsic::LibcCalloc:
+      case ar::Intrinsic::LibcValloc:
+      case ar::Intrinsic::LibcAlignedAlloc:
+      case ar::Intrinsic::LibcRealloc:
+      case ar::Intrinsic::LibcFopen:
+      case ar::Intrinsic::LibcStrdup:
+      case ar::Intrinsic::LibcStrndup:
+      case ar::Intrinsic::LibcppNew:
+      case ar::Intrinsic::LibcppNewArray:
+      case ar::Intrinsic::LibcppAllocateException:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /// \brief Remove the least recently used summary
+  ///
+  /// Precondition: the current thread owns the mutex
+  void evict() {
+    auto last = std::prev(this->_summaries.end());
+    auto& callee_summaries = this->_functions[last->callee];
+    callee_summaries.erase(std::find(callee_summaries.begin(),
+                                     callee_summaries.end(),
+                                     last));
+    if (callee_summaries.empty()) {
+      this->_functions.erase(last->callee);
+    }
+    this->_summaries.erase(last);
+  }
+
+}; // end class FunctionSummaryCache
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -46,6 +46,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 #include <boost/optional.hpp>
 
@@ -162,6 +163,9 @@ private:
   llvm::DenseMap< ar::Function*, std::unique_ptr< CodeFixpointParameters > >
       _map;
 
+  /// \brief Mutex protecting the map, for concurrent analyses
+  std::mutex _mutex;
+
 public:
   /// \brief Constructor
   explicit FixpointParameters(const AnalysisOptions& opts);
@@ -52,6 +52,8 @@
 
 #include <llvm/ADT/DenseMap.h>
 
+#include <ikos/ar/format/namer.hpp>
+
 #include <ikos/analyzer/analysis/context.hpp>
 #include <ikos/analyzer/analysis/variable.hpp>
 
@@ -109,13 +111,17 @@ public:
   boost::optional< const VariableRefList& > dead_at_end(
       ar::BasicBlock* bb) const;
 
+  /// \brief Set the list of live variables at the entry of the given block
+  void set_live_at_entry(ar::BasicBlock* bb, VariableRefList vars);
+
+  /// \brief Set the list of dead variables at the end of the given block
+  void set_dead_at_end(ar::BasicBlock* bb, VariableRefList vars);
+
   /// \brief Run the analysis
+  ///
+  /// Functions are analyzed concurrently, using the `jobs` option.
   void run();
 
-private:
-  /// \brief Run the analysis on the given code
-  void run(ar::Code* code);
-
 public:
   /// \brief Dump the liveness analysis results, for debugging purpose
   void dump(std::ostream& o) const;
@@ -125,7 +131,12 @@ private:
   void dump(std::ostream& o, ar::Code* code) const;
 
   /// \brief Dump a VariableRefList
-  static void dump(std::ostream& o, const VariableRefList& vars);
+  ///
+  /// Variables are named as in the text format of the AR, so that the results
+  /// can be matched against the output of --display-ar.
+  static void dump(std::ostream& o,
+                   const VariableRefList& vars,
+                   const ar::Namer& namer);
 
 }; // end class LivenessAnalysis
 
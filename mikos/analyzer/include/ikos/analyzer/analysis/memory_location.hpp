@@ -46,6 +46,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <llvm/ADT/DenseMap.h>
@@ -315,6 +316,9 @@ private:
                   std::unique_ptr< DynAllocMemoryLocation > >
       _dyn_alloc_map;
 
+  /// \brief Mutex protecting the maps, for concurrent analyses
+  std::mutex _mutex;
+
 public:
   /// \brief Default constructor
   MemoryFactory();
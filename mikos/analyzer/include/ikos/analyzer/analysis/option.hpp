@@ -67,7 +67,9 @@ enum class MachineIntDomainOption {
   Congruence,
   IntervalCongruence,
   DBM,
+  SparseDBM,
   VarPackDBM,
+  VarPackSparseDBM,
   VarPackDBMCongruence,
   Gauge,
   GaugeIntervalCongruence,
@@ -97,8 +99,12 @@ inline const char* machine_int_domain_option_str(MachineIntDomainOption d) {
       return "interval-congruence";
     case MachineIntDomainOption::DBM:
       return "dbm";
+    case MachineIntDomainOption::SparseDBM:
+      return "sparse-dbm";
     case MachineIntDomainOption::VarPackDBM:
       return "var-pack-dbm";
+    case MachineIntDomainOption::VarPackSparseDBM:
+      return "var-pack-sparse-dbm";
     case MachineIntDomainOption::VarPackDBMCongruence:
       return "var-pack-dbm-congruence";
     case MachineIntDomainOption::Gauge:
@@ -293,9 +299,37 @@ public:
   /// \brief Is memory optimization (MIKOS) used
   bool use_memopt;
 
+  /// \brief Store cached pre invariants with memopt as deltas
+  ///
+  /// The pre invariant of a block with a single predecessor is recomputed
+  /// from the predecessor when running the deferred checks.
+  bool memopt_delta_invariants;
+
   /// \brief Is the analysis interprocedural or intraprocedural
   Procedural procedural;
 
+  /// \brief Number of threads for the value analysis
+  ///
+  /// Zero means one thread per hardware thread.
+  unsigned jobs;
+
+  /// \brief Memory budget of a thread of the value analysis, in MB
+  ///
+  /// Zero means no budget.
+  unsigned worker_mem;
+
+  /// \brief Memory limit of the value analysis with memopt, in MB
+  ///
+  /// When it is approached, cached callee analyzers are released and analyzed
+  /// again when running the deferred checks. Zero means no limit.
+  unsigned memory_limit;
+
+  /// \brief Number of threads for the fixpoint on a function body
+  ///
+  /// Independent top-level components of a function are analyzed
+  /// concurrently. Only used by the intraprocedural analysis without memopt.
+  unsigned fixpoint_jobs;
+
   /// \brief Strategy for the increasing iterations (before reaching a fixpoint)
   WideningStrategy widening_strategy;
 
@@ -329,9 +363,18 @@ public:
   /// \brief Wether we should save fixpoints on called functions or not
   bool use_fixpoint_cache;
 
+  /// \brief Maximum number of function summaries reused across call sites
+  ///
+  /// Zero disables function summaries.
+  unsigned summary_cache_size;
+
   /// \brief Wether we should use the partitioning abstract domain or not
   bool use_partitioning_domain;
 
+  /// \brief Wether the variable packing domains only normalize the packs
+  /// needed by queries or not
+  bool lazy_normalization;
+
   /// \brief Policy of initialization for global variables
   GlobalsInitPolicy globals_init_policy;
 
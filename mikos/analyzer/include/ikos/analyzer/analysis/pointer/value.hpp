@@ -75,6 +75,10 @@ private:
   /// \brief Map from variable to pointer value
   using PointerMap = std::unordered_map< Variable*, PointerAbsValue >;
 
+public:
+  /// \brief Iterator over the pointer information
+  using Iterator = PointerMap::const_iterator;
+
 private:
   /// \brief Map from variables to pointer abstract values
   PointerMap _map;
@@ -110,6 +114,12 @@ public:
   /// \brief Insert an information about a pointer
   void insert(Variable* v, const PointerAbsValue&);
 
+  /// \brief Begin iterator over the pointer information
+  Iterator begin() const { return this->_map.begin(); }
+
+  /// \brief End iterator over the pointer information
+  Iterator end() const { return this->_map.end(); }
+
   /// \brief Dump the pointer constraints, for debugging purpose
   void dump(std::ostream&) const;
 
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Persistent cache of the pre-analyses results
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include <llvm/ADT/StringRef.h>
+
+#include <ikos/analyzer/analysis/context.hpp>
+#include <ikos/analyzer/analysis/fixpoint_parameters.hpp>
+#include <ikos/analyzer/analysis/liveness.hpp>
+#include <ikos/analyzer/analysis/pointer/function.hpp>
+#include <ikos/analyzer/analysis/pointer/pointer.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Persistent cache of the pre-analyses results
+///
+/// Stores the results of the liveness analysis, the widening hint analysis,
+/// the function pointer analysis and the pointer analysis, so that they can be
+/// reused by a later run on the same bundle, for instance with different
+/// checkers or display options.
+///
+/// Each result is stored in its own file, named after the hash of the bundle
+/// and of the options that affect that result. Objects of the bundle (global
+/// variables, functions, variables, basic blocks and statements) are saved as
+/// indexes in the order of the bundle.
+class PreanalysisCache {
+private:
+  /// \brief Index of the objects of the bundle
+  class Index;
+
+private:
+  // Analysis context
+  Context& _ctx;
+
+  // Cache directory
+  boost::filesystem::path _directory;
+
+  // Hash of the bundle and of the given options
+  std::string _digest;
+
+  // Index of the objects of the bundle, built on demand
+  std::unique_ptr< Index > _index;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param ctx Analysis context
+  /// \param directory Cache directory
+  /// \param options Options that affect all results (e.g, analyzer version)
+  PreanalysisCache(Context& ctx,
+                   boost::filesystem::path directory,
+                   llvm::StringRef options);
+
+  /// \brief No copy constructor
+  PreanalysisCache(const PreanalysisCache&) = delete;
+
+  /// \brief No move constructor
+  PreanalysisCache(PreanalysisCache&&) = delete;
+
+  /// \brief No copy assignment operator
+  PreanalysisCache& operator=(const PreanalysisCache&) = delete;
+
+  /// \brief No move assignment operator
+  PreanalysisCache& operator=(PreanalysisCache&&) = delete;
+
+  /// \brief Destructor
+  ~PreanalysisCache();
+
+  /// \brief Load the results of the liveness analysis
+  ///
+  /// Returns false if there is no valid cache entry.
+  bool load(LivenessAnalysis& liveness);
+
+  /// \brief Save the results of the liveness analysis
+  ///
+  /// Returns false if the cache entry could not be written.
+  bool save(const LivenessAnalysis& liveness);
+
+  /// \brief Load the widening hints in the given fixpoint parameters
+  ///
+  /// Returns false if there is no valid cache entry.
+  bool load_widening_hints(FixpointParameters& parameters);
+
+  /// \brief Save the widening hints of the given fixpoint parameters
+  ///
+  /// Returns false if the cache entry could not be written.
+  bool save_widening_hints(FixpointParameters& parameters);
+
+  /// \brief Load the results of the function pointer analysis
+  ///
+  /// Returns false if there is no valid cache entry.
+  bool load(FunctionPointerAnalysis& function_pointer);
+
+  /// \brief Save the results of the function pointer analysis
+  ///
+  /// Returns false if the cache entry could not be written.
+  bool save(const FunctionPointerAnalysis& function_pointer);
+
+  /// \brief Load the results of the pointer analysis
+  ///
+  /// Returns false if there is no valid cache entry.
+  bool load(PointerAnalysis& pointer);
+
+  /// \brief Save the results of the pointer analysis
+  ///
+  /// Returns false if the cache entry could not be written.
+  bool save(const PointerAnalysis& pointer);
+
+private:
+  /// \brief Return the index of the objects of the bundle
+  Index& index();
+
+  /// \brief Return the path of the cache entry for the given result
+  ///
+  /// \param name Name of the result
+  /// \param options Options that affect the result
+  boost::filesystem::path path(llvm::StringRef name,
+                               llvm::StringRef options) const;
+
+  /// \brief Return the options that affect the pointer analysis
+  std::string pointer_options();
+
+}; // end class PreanalysisCache
+
+} // end namespace analyzer
+} // end namespace ikos
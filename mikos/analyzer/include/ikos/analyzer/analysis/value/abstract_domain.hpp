@@ -44,20 +44,71 @@
 #pragma once
 
 #include <ikos/core/domain/exception/exception.hpp>
+#ifdef IKOS_STATIC_DOMAIN
+#include <ikos/core/domain/lifetime/separate_domain.hpp>
+#include <ikos/core/domain/memory/value.hpp>
+#include <ikos/core/domain/nullity/separate_domain.hpp>
+#include <ikos/core/domain/scalar/composite.hpp>
+#include <ikos/core/domain/uninitialized/separate_domain.hpp>
+#else
 #include <ikos/core/domain/memory/polymorphic_domain.hpp>
+#endif
 
 #include <ikos/analyzer/analysis/context.hpp>
 #include <ikos/analyzer/analysis/memory_location.hpp>
 #include <ikos/analyzer/analysis/variable.hpp>
+#ifdef IKOS_STATIC_DOMAIN
+#include <ikos/analyzer/analysis/value/machine_int_domain.hpp>
+#endif
 
 namespace ikos {
 namespace analyzer {
 namespace value {
 
+#ifdef IKOS_STATIC_DOMAIN
+
+/// \brief Uninitialized abstract domain
+using UninitializedAbstractDomain =
+    core::uninitialized::SeparateDomain< Variable* >;
+
+/// \brief Nullity abstract domain
+using NullityAbstractDomain = core::nullity::SeparateDomain< Variable* >;
+
+/// \brief Scalar abstract domain
+using ScalarAbstractDomain =
+    core::scalar::CompositeDomain< Variable*,
+                                   MemoryLocation*,
+                                   UninitializedAbstractDomain,
+                                   MachineIntAbstractDomain,
+                                   NullityAbstractDomain >;
+
+/// \brief Lifetime abstract domain
+using LifetimeAbstractDomain =
+    core::lifetime::SeparateDomain< MemoryLocation* >;
+
+/// \brief Value abstract domain
+using ValueAbstractDomain = core::memory::ValueDomain< Variable*,
+                                                       MemoryLocation*,
+                                                       VariableFactory*,
+                                                       ScalarAbstractDomain,
+                                                       LifetimeAbstractDomain >;
+
+/// \brief Memory abstract domain for the value analysis
+///
+/// The analyzer was built with STATIC_DOMAIN: the execution engine, the
+/// fixpoint iterators and the checkers are instantiated on the concrete
+/// domain, without virtual calls nor heap allocations on copies. The
+/// partitioning domain is not available.
+using MemoryAbstractDomain = ValueAbstractDomain;
+
+#else
+
 /// \brief Memory abstract domain for the value analysis
 using MemoryAbstractDomain =
     core::memory::PolymorphicDomain< Variable*, MemoryLocation* >;
 
+#endif
+
 /// \brief Abstract domain for the value analysis
 using AbstractDomain = core::exception::ExceptionDomain< MemoryAbstractDomain >;
 
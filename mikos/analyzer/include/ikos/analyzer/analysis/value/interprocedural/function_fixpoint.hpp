@@ -77,6 +77,10 @@ private:
   using InlineCallExecutionEngineT =
       InlineCallExecutionEngine< FunctionFixpoint, AbstractDomain >;
 
+public:
+  /// \brief Cache of function summaries
+  using FunctionSummaryCacheT = FunctionSummaryCache< AbstractDomain >;
+
 private:
   /// \brief Analyzed function
   ar::Function* _function;
@@ -93,6 +97,9 @@ private:
   /// \brief Progress logger
   ProgressLogger& _logger;
 
+  /// \brief Cache of function summaries, or null
+  FunctionSummaryCacheT* _summary_cache;
+
   /// \brief Numerical execution engine
   NumericalExecutionEngineT _exec_engine;
 
@@ -104,11 +111,14 @@ public:
   ///
   /// \param ctx Analysis context
   /// \param checkers List of checkers to run
+  /// \param logger Progress logger
   /// \param entry_point Function to analyze
+  /// \param summary_cache Cache of function summaries, or null
   FunctionFixpoint(Context& ctx,
                    const std::vector< std::unique_ptr< Checker > >& checkers,
                    ProgressLogger& logger,
-                   ar::Function* entry_point);
+                   ar::Function* entry_point,
+                   FunctionSummaryCacheT* summary_cache);
 
   /// \brief Constructor for a callee
   ///
@@ -187,6 +197,9 @@ public:
   /// \brief Return the call context
   CallContext* call_context() const { return this->_call_context; }
 
+  /// \brief Return the cache of function summaries, or null
+  FunctionSummaryCacheT* summary_cache() const { return this->_summary_cache; }
+
   /// \brief Return the exit invariant, or bottom
   const AbstractDomain& exit_invariant() const {
     return this->_call_exec_engine.exit_invariant();
@@ -39,6 +39,8 @@
 
 #pragma once
 
+#include <unordered_set>
+
 #include <ikos/ar/semantic/code.hpp>
 #include <ikos/ar/semantic/function.hpp>
 
@@ -53,6 +55,7 @@
 #include <ikos/analyzer/analysis/value/abstract_domain.hpp>
 #include <ikos/analyzer/analysis/value/interprocedural/progress.hpp>
 #include <ikos/analyzer/checker/checker.hpp>
+#include <ikos/analyzer/util/memory.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -105,16 +108,28 @@ private:
   std::unordered_map< ar::BasicBlock*,
     std::vector< std::unique_ptr< FunctionFixpoint >>> _callee_cache;
 
+  /// \brief Memory budget, or null
+  MemoryBudget* _memory_budget;
+
+  /// \brief Basic blocks whose calls are not cached to stay within the memory
+  /// budget
+  ///
+  /// Their calls are analyzed again by run_deferred_checks(), from the cached
+  /// pre invariant.
+  std::unordered_set< ar::BasicBlock* > _uncached_calls;
+
 public:
   /// \brief Constructor for an entry point
   ///
   /// \param ctx Analysis context
   /// \param checkers List of checkers to run
   /// \param entry_point Function to analyze
+  /// \param memory_budget Memory budget, or null
   FunctionFixpoint(Context& ctx,
                    const std::vector< std::unique_ptr< Checker > >& checkers,
                    ProgressLogger& logger,
-                   ar::Function* entry_point);
+                   ar::Function* entry_point,
+                   MemoryBudget* memory_budget);
 
   /// \brief Constructor for a callee
   ///
@@ -217,6 +232,9 @@ public:
 
   /// \brief Set the call result for the given call statement in the basic block
   void set_call_cache(ar::BasicBlock* bb, ar::CallBase* call, AbstractDomain inv) {
+    if (this->_uncached_calls.count(bb) != 0) {
+      return;
+    }
     auto it = this->_call_cache[bb].find(call);
     if (it != this->_call_cache[bb].end()) {
       it->second = std::move(inv);
@@ -232,12 +250,14 @@ public:
       it->second.clear();
       this->_call_cache.erase(bb);
     }
+    this->_uncached_calls.erase(bb);
   }
 
   /// \brief Append the callee analyzer to the given basic block
-  void append_to_callee_cache(ar::BasicBlock* bb, std::unique_ptr< FunctionFixpoint >& callee) {
-    this->_callee_cache[bb].emplace_back(std::move(callee));
-  }
+  ///
+  /// If the memory budget is exceeded, the callee analyzer is released
+  /// instead, along with the other cached calls that can be analyzed again.
+  void append_to_callee_cache(ar::BasicBlock* bb, std::unique_ptr< FunctionFixpoint >& callee);
 
   /// \brief Erase the callees analyzers for the given basic block
   void erase_callee_cache(ar::BasicBlock* bb) {
@@ -43,19 +43,62 @@
 
 #pragma once
 
+#if defined(IKOS_STATIC_DOMAIN_INTERVAL)
+#include <ikos/core/domain/machine_int/interval.hpp>
+#elif defined(IKOS_STATIC_DOMAIN_VAR_PACK_DBM_CONGRUENCE)
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/numeric/var_packing_dbm_congruence.hpp>
+#else
 #include <ikos/core/domain/machine_int/polymorphic_domain.hpp>
+#endif
 
 #include <ikos/analyzer/analysis/option.hpp>
 #include <ikos/analyzer/analysis/variable.hpp>
+#include <ikos/analyzer/support/number.hpp>
 
 namespace ikos {
 namespace analyzer {
 namespace value {
 
+#if defined(IKOS_STATIC_DOMAIN_INTERVAL)
+
+/// \brief Machine integer abstract domain used for the value analysis
+///
+/// The analyzer was built with STATIC_DOMAIN=interval: the domain is fixed at
+/// compile time, and the value analysis is instantiated on it directly.
+using MachineIntAbstractDomain = core::machine_int::IntervalDomain< Variable* >;
+
+/// \brief Machine integer abstract domain the analyzer was built for
+constexpr MachineIntDomainOption StaticMachineIntDomain =
+    MachineIntDomainOption::Interval;
+
+#elif defined(IKOS_STATIC_DOMAIN_VAR_PACK_DBM_CONGRUENCE)
+
+/// \brief Machine integer abstract domain used for the value analysis
+///
+/// The analyzer was built with STATIC_DOMAIN=var-pack-dbm-congruence: the
+/// domain is fixed at compile time, and the value analysis is instantiated on
+/// it directly.
+using MachineIntNumericDomain =
+    core::numeric::VarPackingDBMCongruence< ZNumber, Variable* >;
+using MachineIntAbstractDomain =
+    core::machine_int::NumericDomainAdapter< Variable*,
+                                             MachineIntNumericDomain >;
+
+/// \brief Machine integer abstract domain the analyzer was built for
+constexpr MachineIntDomainOption StaticMachineIntDomain =
+    MachineIntDomainOption::VarPackDBMCongruence;
+
+#else
+
 /// \brief Machine integer abstract domain used for the value analysis
 using MachineIntAbstractDomain =
     core::machine_int::PolymorphicDomain< Variable* >;
 
+#endif
+
+#ifndef IKOS_STATIC_DOMAIN
+
 /// \name Constructors of machine integer abstract domains
 /// @{
 
@@ -71,9 +114,15 @@ MachineIntAbstractDomain make_bottom_machine_int_interval_congruence();
 MachineIntAbstractDomain make_top_machine_int_dbm();
 MachineIntAbstractDomain make_bottom_machine_int_dbm();
 
+MachineIntAbstractDomain make_top_machine_int_sparse_dbm();
+MachineIntAbstractDomain make_bottom_machine_int_sparse_dbm();
+
 MachineIntAbstractDomain make_top_machine_int_var_pack_dbm();
 MachineIntAbstractDomain make_bottom_machine_int_var_pack_dbm();
 
+MachineIntAbstractDomain make_top_machine_int_var_pack_sparse_dbm();
+MachineIntAbstractDomain make_bottom_machine_int_var_pack_sparse_dbm();
+
 MachineIntAbstractDomain make_top_machine_int_var_pack_dbm_congruence();
 MachineIntAbstractDomain make_bottom_machine_int_var_pack_dbm_congruence();
 
@@ -133,7 +182,12 @@ make_bottom_machine_int_var_pack_apron_pkgrid_polyhedra_lin_cong();
 
 /// @}
 
+#endif // IKOS_STATIC_DOMAIN
+
 /// \brief Create the top machine integer abstract value of the given choice
+///
+/// With a STATIC_DOMAIN build, throws a LogicError for any other domain than
+/// the one the analyzer was built for.
 MachineIntAbstractDomain make_top_machine_int_abstract_value(
     MachineIntDomainOption domain);
 
@@ -46,6 +46,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -495,6 +496,9 @@ private:
   std::vector< std::unique_ptr< UnnamedShadowVariable > >
       _unnamed_shadow_variable_vec;
 
+  /// \brief Mutex protecting the maps, for concurrent analyses
+  std::mutex _mutex;
+
 public:
   /// \brief Constructor
   explicit VariableFactory(ar::Bundle* bundle);
@@ -0,0 +1,259 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Columnar binary output for the largest result tables
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <ikos/analyzer/exception.hpp>
+#include <ikos/analyzer/support/string_ref.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace columnar {
+
+/// \brief Version of the columnar format, written in the manifest
+const int FormatVersion = 1;
+
+/// \brief Value of a NULL entry in a column
+const std::int64_t Null = INT64_MIN;
+
+/// \brief Error while writing columnar files
+class Error : public analyzer::Exception {
+private:
+  /// \brief Explanatory message
+  ///
+  /// See https://clang.llvm.org/extra/clang-tidy/checks/cert-err60-cpp.html
+  std::shared_ptr< const std::string > _msg;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param msg Explanatory message
+  explicit Error(const std::string& msg)
+      : _msg(std::make_shared< const std::string >(msg)) {}
+
+  /// \brief No default constructor
+  Error() = delete;
+
+  /// \brief Copy constructor
+  Error(const Error&) noexcept = default;
+
+  /// \brief Move constructor
+  Error(Error&&) noexcept = default;
+
+  /// \brief Copy assignment operator
+  Error& operator=(const Error&) noexcept = default;
+
+  /// \brief Move assignment operator
+  Error& operator=(Error&&) noexcept = default;
+
+  /// \brief Get the explanatory string
+  const char* what() const noexcept override;
+
+  /// \brief Destructor
+  ~Error() override;
+
+}; // end class Error
+
+class Store;
+
+/// \brief Stream-based interface for populating a columnar table
+///
+/// Each column is a file of 64-bit little-endian integers, one per row, named
+/// `<table>.<column>.i64`. Strings are stored as indexes in the string table
+/// of the store.
+class Ostream {
+private:
+  /// \brief Owning store
+  Store& _store;
+
+  /// \brief Table name
+  std::string _name;
+
+  /// \brief Column names
+  std::vector< std::string > _column_names;
+
+  /// \brief Column files
+  std::vector< std::unique_ptr< llvm::raw_fd_ostream > > _columns;
+
+  /// \brief Current column entered
+  std::size_t _current_column = 0;
+
+  /// \brief Number of rows
+  std::int64_t _num_rows = 0;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param store The owning store
+  /// \param table_name The table name
+  /// \param columns The column names
+  Ostream(Store& store,
+          StringRef table_name,
+          llvm::ArrayRef< std::string > columns);
+
+  /// \brief No copy constructor
+  Ostream(const Ostream&) = delete;
+
+  /// \brief No move constructor
+  Ostream(Ostream&&) = delete;
+
+  /// \brief No copy assignment operator
+  Ostream& operator=(const Ostream&) = delete;
+
+  /// \brief No move assignment operator
+  Ostream& operator=(Ostream&&) = delete;
+
+  /// \brief Destructor
+  ~Ostream();
+
+public:
+  /// \brief Insert a string
+  void add(StringRef s);
+
+  /// \brief Insert NULL
+  void add_null();
+
+  /// \brief Insert an integer
+  void add(std::int64_t n);
+
+  /// \brief Flush the row
+  void flush();
+
+  /// \brief Return the table name
+  const std::string& name() const { return this->_name; }
+
+  /// \brief Return the column names
+  const std::vector< std::string >& columns() const {
+    return this->_column_names;
+  }
+
+  /// \brief Return the number of rows
+  std::int64_t num_rows() const { return this->_num_rows; }
+
+  /// \brief Flush and close the column files
+  void close();
+
+}; // end class Ostream
+
+/// \brief Directory of columnar tables sharing a string table
+///
+/// The directory contains:
+///   * One file per column, see columnar::Ostream;
+///   * `strings.data`, the concatenation of all strings;
+///   * `strings.offsets.i64`, the offset of each string in `strings.data`,
+///     followed by the total size;
+///   * `manifest.json`, listing the tables and their number of rows. It is
+///     written by close(), hence its presence marks a complete directory.
+///
+/// The caller is responsible for the synchronization.
+class Store {
+private:
+  /// \brief Directory
+  boost::filesystem::path _directory;
+
+  /// \brief Tables
+  std::vector< std::unique_ptr< Ostream > > _tables;
+
+  /// \brief Map from string to index in the string table
+  llvm::StringMap< std::int64_t > _strings;
+
+  /// \brief String data file
+  std::unique_ptr< llvm::raw_fd_ostream > _string_data;
+
+  /// \brief String offsets file
+  std::unique_ptr< llvm::raw_fd_ostream > _string_offsets;
+
+  /// \brief Current size of the string data
+  std::int64_t _string_data_size = 0;
+
+  /// \brief Whether close() was called
+  bool _closed = false;
+
+public:
+  /// \brief Constructor
+  ///
+  /// Remove the directory if it exists, and create it.
+  explicit Store(boost::filesystem::path directory);
+
+  /// \brief No copy constructor
+  Store(const Store&) = delete;
+
+  /// \brief No move constructor
+  Store(Store&&) = delete;
+
+  /// \brief No copy assignment operator
+  Store& operator=(const Store&) = delete;
+
+  /// \brief No move assignment operator
+  Store& operator=(Store&&) = delete;
+
+  /// \brief Destructor
+  ~Store();
+
+  /// \brief Return the directory
+  const boost::filesystem::path& directory() const { return this->_directory; }
+
+  /// \brief Create a table with the given columns
+  Ostream& add_table(StringRef name, llvm::ArrayRef< std::string > columns);
+
+  /// \brief Insert a string in the string table and return its index
+  std::int64_t insert_string(StringRef s);
+
+  /// \brief Flush all files and write the manifest
+  void close();
+
+  /// \brief Open a file of the directory for writing
+  std::unique_ptr< llvm::raw_fd_ostream > open(StringRef filename) const;
+
+}; // end class Store
+
+} // end namespace columnar
+} // end namespace analyzer
+} // end namespace ikos
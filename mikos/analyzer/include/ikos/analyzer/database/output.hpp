@@ -43,6 +43,11 @@
 
 #pragma once
 
+#include <memory>
+
+#include <boost/filesystem.hpp>
+
+#include <ikos/analyzer/database/columnar.hpp>
 #include <ikos/analyzer/database/sqlite.hpp>
 #include <ikos/analyzer/database/table/call_contexts.hpp>
 #include <ikos/analyzer/database/table/checks.hpp>
@@ -52,17 +57,29 @@
 #include <ikos/analyzer/database/table/operands.hpp>
 #include <ikos/analyzer/database/table/settings.hpp>
 #include <ikos/analyzer/database/table/statements.hpp>
+#include <ikos/analyzer/database/table/statistics.hpp>
 #include <ikos/analyzer/database/table/times.hpp>
 
 namespace ikos {
 namespace analyzer {
 
+/// \brief Format of the largest tables of the output database
+enum class OutputFormat {
+  /// \brief All tables are in the SQLite database
+  SQLite,
+
+  /// \brief Statements, call contexts and checks are in columnar files,
+  /// see columnar::Store
+  Columnar,
+};
+
 /// \brief Output database
 class OutputDatabase {
 public:
   sqlite::DbConnection& db;
   SettingsTable settings;
   TimesTable times;
+  StatisticsTable statistics;
   FilesTable files;
   FunctionsTable functions;
   StatementsTable statements;
@@ -71,10 +88,28 @@ public:
   MemoryLocationsTable memory_locations;
   ChecksTable checks;
 
+private:
+  /// \brief Columnar store, or null
+  std::unique_ptr< columnar::Store > _columnar;
+
 public:
   /// \brief Constructor
   explicit OutputDatabase(sqlite::DbConnection& db_);
 
+  /// \brief Create the indexes of all tables, once they are filled
+  void create_indexes();
+
+  /// \brief Write the statements, call contexts and checks in columnar files
+  /// instead of the database, see columnar::Store
+  ///
+  /// This must be called before inserting rows in these tables.
+  void enable_columnar(const boost::filesystem::path& directory);
+
+  /// \brief Write the manifest of the columnar files, if enabled
+  ///
+  /// This must be called once all the checks are written.
+  void close_columnar();
+
 }; // end class OutputDatabase
 
 } // end namespace analyzer
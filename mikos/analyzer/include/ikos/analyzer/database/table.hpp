@@ -44,7 +44,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include <ikos/analyzer/database/columnar.hpp>
 #include <ikos/analyzer/database/sqlite.hpp>
 
 namespace ikos {
@@ -59,6 +61,12 @@ protected:
   /// \brief Table name
   std::string _name;
 
+  /// \brief Column names
+  std::vector< std::string > _columns;
+
+  /// \brief Indexed columns
+  std::vector< std::string > _indexes;
+
 public:
   /// \brief No default constructor
   DatabaseTable() = delete;
@@ -68,7 +76,7 @@ public:
   /// \param db The database connection
   /// \param name The table name
   /// \param cols The table columns
-  /// \param indexes The table indexes
+  /// \param indexes The table indexes, created by create_indexes()
   DatabaseTable(
       sqlite::DbConnection& db,
       std::string name,
@@ -93,7 +101,118 @@ public:
   /// \brief Name of the table
   const std::string& name() const { return this->_name; }
 
+  /// \brief Names of the columns
+  const std::vector< std::string >& columns() const { return this->_columns; }
+
+  /// \brief Create the indexes of the table
+  ///
+  /// Indexes are created once the table is filled, since maintaining them
+  /// on each insertion is slower.
+  void create_indexes();
+
 }; // end class DatabaseTable
 
+/// \brief Stream-based interface for populating a table
+///
+/// Rows are inserted in the database, or in a columnar table once
+/// set_columnar() is called, see columnar::Store.
+class TableOstream {
+private:
+  /// \brief Database output stream
+  sqlite::DbOstream _db;
+
+  /// \brief Columnar output stream, or null
+  columnar::Ostream* _columnar = nullptr;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param db The database connection
+  /// \param table_name The table name
+  /// \param columns Number of columns
+  TableOstream(sqlite::DbConnection& db, StringRef table_name, int columns)
+      : _db(db, table_name, columns) {}
+
+  /// \brief No copy constructor
+  TableOstream(const TableOstream&) = delete;
+
+  /// \brief No move constructor
+  TableOstream(TableOstream&&) = delete;
+
+  /// \brief No copy assignment operator
+  TableOstream& operator=(const TableOstream&) = delete;
+
+  /// \brief No move assignment operator
+  TableOstream& operator=(TableOstream&&) = delete;
+
+  /// \brief Destructor
+  ~TableOstream() = default;
+
+  /// \brief Insert the next rows in the given columnar table
+  void set_columnar(columnar::Ostream& o) { this->_columnar = &o; }
+
+  /// \brief Insert a string
+  void add(StringRef s) {
+    if (this->_columnar != nullptr) {
+      this->_columnar->add(s);
+    } else {
+      this->_db.add(s);
+    }
+  }
+
+  /// \brief Insert NULL
+  void add_null() {
+    if (this->_columnar != nullptr) {
+      this->_columnar->add_null();
+    } else {
+      this->_db.add_null();
+    }
+  }
+
+  /// \brief Insert an integer
+  void add(sqlite::DbInt64 n) {
+    if (this->_columnar != nullptr) {
+      this->_columnar->add(static_cast< std::int64_t >(n));
+    } else {
+      this->_db.add(n);
+    }
+  }
+
+  /// \brief Flush the row
+  void flush() {
+    if (this->_columnar != nullptr) {
+      this->_columnar->flush();
+    } else {
+      this->_db.flush();
+    }
+  }
+
+}; // end class TableOstream
+
+/// \brief Insert a string
+inline TableOstream& operator<<(TableOstream& o, StringRef s) {
+  o.add(s);
+  return o;
+}
+
+/// \brief Insert an integer
+inline TableOstream& operator<<(TableOstream& o, sqlite::DbInt64 n) {
+  o.add(n);
+  return o;
+}
+
+/// \brief Insert sqlite::end_row or sqlite::null
+inline TableOstream& operator<<(TableOstream& o,
+                                sqlite::DbOstream& (*m)(sqlite::DbOstream&)) {
+  if (m == &sqlite::end_row) {
+    o.flush();
+  } else if (m == &sqlite::null) {
+    o.add_null();
+  } else {
+    ikos_unreachable("invalid function pointer argument");
+  }
+  return o;
+}
+
 } // end namespace analyzer
 } // end namespace ikos
@@ -43,7 +43,7 @@
 
 #pragma once
 
-#include <llvm/ADT/DenseMap.h>
+#include <vector>
 
 #include <ikos/analyzer/analysis/call_context.hpp>
 #include <ikos/analyzer/database/table.hpp>
@@ -62,11 +62,11 @@ private:
   /// \brief Statements table
   StatementsTable& _statements;
 
-  /// \brief Database output stream
-  sqlite::DbOstream _row;
+  /// \brief Output stream
+  TableOstream _row;
 
-  /// \brief Map from CallContext* to id
-  llvm::DenseMap< CallContext*, sqlite::DbInt64 > _map;
+  /// \brief Map from CallContext::id() to id, or -1 if not inserted
+  std::vector< sqlite::DbInt64 > _map;
 
   /// \brief Last inserted id
   sqlite::DbInt64 _last_insert_id = 0;
@@ -77,9 +77,19 @@ public:
                              FunctionsTable& functions,
                              StatementsTable& statements);
 
+  /// \brief Insert the next rows in the given columnar store
+  void set_columnar(columnar::Store& store);
+
   /// \brief Insert the given call context in the database and return the id
+  ///
+  /// This also inserts the parent call contexts that are not in the database
+  /// yet, in a single pass.
   sqlite::DbInt64 insert(CallContext* call_context);
 
+private:
+  /// \brief Return the id of the given call context, or -1 if not inserted
+  sqlite::DbInt64 find(CallContext* call_context) const;
+
 }; // end class CallContextsTable
 
 } // end namespace analyzer
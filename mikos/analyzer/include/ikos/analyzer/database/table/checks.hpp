@@ -43,11 +43,22 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <llvm/ADT/SmallVector.h>
+
 #include <ikos/analyzer/analysis/result.hpp>
 #include <ikos/analyzer/checker/kind.hpp>
 #include <ikos/analyzer/checker/name.hpp>
 #include <ikos/analyzer/database/table.hpp>
 #include <ikos/analyzer/database/table/call_contexts.hpp>
+#include <ikos/analyzer/database/table/memory_locations.hpp>
 #include <ikos/analyzer/database/table/operands.hpp>
 #include <ikos/analyzer/database/table/statements.hpp>
 #include <ikos/analyzer/json/json.hpp>
@@ -57,6 +68,136 @@ namespace analyzer {
 
 /// \brief Checks table
 class ChecksTable : public DatabaseTable {
+public:
+  /// \brief Checks recorded by a thread, waiting to be written
+  ///
+  /// This is used by concurrent analyses to write the checks of each function
+  /// in a deterministic order, see ChecksTable::ScopeBuffer.
+  class Buffer {
+  private:
+    /// \brief A recorded check
+    ///
+    /// The information is formatted in JSON when the check is written.
+    struct Row {
+      CheckKind kind;
+      CheckerName checker;
+      Result status;
+      ar::Statement* stmt;
+      CallContext* call_context;
+      llvm::SmallVector< ar::Value*, 2 > operands;
+      JsonDict info;
+    };
+
+  private:
+    /// \brief Recorded checks, in order of insertion
+    std::vector< Row > _rows;
+
+  public:
+    /// \brief Constructor
+    Buffer() = default;
+
+    /// \brief No copy constructor
+    Buffer(const Buffer&) = delete;
+
+    /// \brief Move constructor
+    Buffer(Buffer&&) = default;
+
+    /// \brief No copy assignment operator
+    Buffer& operator=(const Buffer&) = delete;
+
+    /// \brief Move assignment operator
+    Buffer& operator=(Buffer&&) = default;
+
+    /// \brief Destructor
+    ~Buffer() = default;
+
+    /// \brief Return true if the buffer is empty
+    bool empty() const { return this->_rows.empty(); }
+
+    // friends
+    friend class ChecksTable;
+
+  }; // end class Buffer
+
+  /// \brief Record the checks inserted by the current thread in a buffer,
+  /// until the end of the scope
+  class ScopeBuffer {
+  private:
+    /// \brief Previous buffer of the current thread, or null
+    Buffer* _previous;
+
+  public:
+    /// \brief Constructor
+    explicit ScopeBuffer(Buffer& buffer);
+
+    /// \brief No copy constructor
+    ScopeBuffer(const ScopeBuffer&) = delete;
+
+    /// \brief No move constructor
+    ScopeBuffer(ScopeBuffer&&) = delete;
+
+    /// \brief No copy assignment operator
+    ScopeBuffer& operator=(const ScopeBuffer&) = delete;
+
+    /// \brief No move assignment operator
+    ScopeBuffer& operator=(ScopeBuffer&&) = delete;
+
+    /// \brief Destructor
+    ~ScopeBuffer();
+
+  }; // end class ScopeBuffer
+
+  /// \brief Write the checks in a background thread, until the end of the
+  /// scope
+  ///
+  /// Analysis threads only queue the checks. The background thread formats
+  /// them and inserts them in batches, taking the database lock once per
+  /// batch.
+  ///
+  /// The scope must end before the statements and call contexts of the checks
+  /// are destroyed.
+  class ScopeAsyncWriter {
+  private:
+    /// \brief Checks table
+    ChecksTable& _table;
+
+  public:
+    /// \brief Constructor
+    explicit ScopeAsyncWriter(ChecksTable& table);
+
+    /// \brief No copy constructor
+    ScopeAsyncWriter(const ScopeAsyncWriter&) = delete;
+
+    /// \brief No move constructor
+    ScopeAsyncWriter(ScopeAsyncWriter&&) = delete;
+
+    /// \brief No copy assignment operator
+    ScopeAsyncWriter& operator=(const ScopeAsyncWriter&) = delete;
+
+    /// \brief No move assignment operator
+    ScopeAsyncWriter& operator=(ScopeAsyncWriter&&) = delete;
+
+    /// \brief Write the queued checks and stop the background thread
+    ///
+    /// Rethrows the first error of the background thread, if any.
+    void finish();
+
+    /// \brief Destructor
+    ///
+    /// Calls finish() if it was not called, ignoring errors.
+    ~ScopeAsyncWriter();
+
+  }; // end class ScopeAsyncWriter
+
+private:
+  /// \brief Number of checks in a batch of the background thread
+  static const std::size_t BatchSize = 1024;
+
+  /// \brief Maximum number of batches waiting for the background thread
+  ///
+  /// Analysis threads wait when the queue is full, to bound the memory usage.
+  static const std::size_t MaxQueuedBatches = 64;
+
 private:
   /// \brief Statements table
   StatementsTable& _statements;
@@ -67,20 +208,60 @@ private:
   /// \brief Call contexts table
   CallContextsTable& _call_contexts;
 
-  /// \brief Database output stream
-  sqlite::DbOstream _row;
+  /// \brief Memory locations table
+  MemoryLocationsTable& _memory_locations;
+
+  /// \brief Output stream
+  TableOstream _row;
 
   /// \brief Last inserted id
   sqlite::DbInt64 _last_insert_id = 0;
 
+  /// \brief Background thread writing the checks, if any
+  std::thread _writer;
+
+  /// \brief Whether checks are queued for the background thread
+  bool _async = false;
+
+  /// \brief Mutex protecting the queue
+  std::mutex _queue_mutex;
+
+  /// \brief Signaled when a batch is queued or when the writer should stop
+  std::condition_variable _batch_queued;
+
+  /// \brief Signaled when a batch is taken by the background thread
+  std::condition_variable _batch_taken;
+
+  /// \brief Batch being filled
+  std::vector< Buffer::Row > _current_batch;
+
+  /// \brief Batches waiting for the background thread
+  std::deque< std::vector< Buffer::Row > > _batches;
+
+  /// \brief Whether the background thread should stop once the queue is empty
+  bool _stopping = false;
+
+  /// \brief First error of the background thread
+  std::exception_ptr _error;
+
 public:
   /// \brief Constructor
   explicit ChecksTable(sqlite::DbConnection& db,
                        StatementsTable& statements,
                        OperandsTable& operands,
-                       CallContextsTable& call_contexts);
+                       CallContextsTable& call_contexts,
+                       MemoryLocationsTable& memory_locations);
+
+  /// \brief Insert the next rows in the given columnar store
+  void set_columnar(columnar::Store& store);
 
   /// \brief Insert a check in the database
+  ///
+  /// If the current thread is within a ChecksTable::ScopeBuffer, the check is
+  /// recorded in the buffer instead.
+  ///
+  /// Memory locations referenced in `info` (see MemoryLocationsTable::ref())
+  /// are inserted when the check is written.
   void insert(CheckKind kind,
               CheckerName checker,
               Result status,
@@ -89,6 +270,31 @@ public:
               llvm::ArrayRef< ar::Value* > operands = {},
               const JsonDict& info = {});
 
+  /// \brief Write the checks recorded in the given buffer, and clear it
+  void flush(Buffer& buffer);
+
+private:
+  /// \brief Queue a check for the background thread
+  void enqueue(Buffer::Row row);
+
+  /// \brief Queue a list of checks for the background thread
+  void enqueue(std::vector< Buffer::Row > rows);
+
+  /// \brief Main loop of the background thread
+  void run_writer();
+
+  /// \brief Write a check in the database
+  void write(const Buffer::Row& row);
+
+  /// \brief Write a check in the database
+  void write(CheckKind kind,
+             CheckerName checker,
+             Result status,
+             ar::Statement* stmt,
+             CallContext* call_context,
+             llvm::ArrayRef< ar::Value* > operands,
+             StringRef info);
+
 }; // end class ChecksTable
 
 } // end namespace analyzer
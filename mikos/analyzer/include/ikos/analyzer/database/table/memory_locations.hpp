@@ -43,6 +43,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <llvm/ADT/DenseMap.h>
 
 #include <ikos/analyzer/analysis/memory_location.hpp>
@@ -51,12 +53,34 @@
 #include <ikos/analyzer/database/table/functions.hpp>
 #include <ikos/analyzer/database/table/statements.hpp>
 #include <ikos/analyzer/json/json.hpp>
+#include <ikos/analyzer/support/string_ref.hpp>
 
 namespace ikos {
 namespace analyzer {
 
 /// \brief Memory locations table
 class MemoryLocationsTable : public DatabaseTable {
+public:
+  /// \brief Reference to a memory location in a JSON value
+  ///
+  /// The string representation is a placeholder, replaced by the id of the
+  /// memory location in MemoryLocationsTable::resolve(). This allows checkers
+  /// running concurrently to refer to memory locations without inserting
+  /// them, so that ids follow the order in which checks are written rather
+  /// than the order in which threads run.
+  class JsonRef final : public JsonNode {
+  private:
+    MemoryLocation* _mem_loc;
+
+  public:
+    /// \brief Constructor
+    explicit JsonRef(MemoryLocation* mem_loc) : _mem_loc(mem_loc) {}
+
+    /// \brief Return the string representation
+    std::string str() const override;
+
+  }; // end class JsonRef
+
 private:
   /// \brief Functions table
   FunctionsTable& _functions;
@@ -86,6 +110,15 @@ public:
   /// \brief Insert the given memory location in the database and return the id
   sqlite::DbInt64 insert(MemoryLocation* mem_loc);
 
+  /// \brief Return a reference to the given memory location, for a JSON value
+  ///
+  /// The memory location is inserted when the JSON value is resolved.
+  JsonRef ref(MemoryLocation* mem_loc) const;
+
+  /// \brief Insert the memory locations referenced in the given JSON string,
+  /// in order of appearance, and return the string with their ids
+  std::string resolve(StringRef json);
+
   /// \brief Return the json info for the given memory location
   JsonDict info(MemoryLocation* mem_loc);
 
@@ -63,8 +63,8 @@ private:
   /// \brief Functions table
   FunctionsTable& _functions;
 
-  /// \brief Database output stream
-  sqlite::DbOstream _row;
+  /// \brief Output stream
+  TableOstream _row;
 
   /// \brief Map from ar::Statement* to id
   llvm::DenseMap< ar::Statement*, sqlite::DbInt64 > _map;
@@ -78,6 +78,9 @@ public:
                   FilesTable& files,
                   FunctionsTable& functions);
 
+  /// \brief Insert the next rows in the given columnar store
+  void set_columnar(columnar::Store& store);
+
   /// \brief Insert the given statement in the database and return the id
   sqlite::DbInt64 insert(ar::Statement* stmt);
 
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Persistent cache of the abstract representation
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Module.h>
+
+#include <ikos/ar/semantic/bundle.hpp>
+#include <ikos/ar/semantic/context.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Persistent cache of the abstract representation
+///
+/// Stores the bundle produced by the translation from LLVM to AR and the AR
+/// passes in the binary format of ar::BinaryWriter, in a file named after the
+/// hash of the bitcode and of the options of the translation and the passes.
+///
+/// Front-end pointers are saved as indexes in the LLVM module, so the module
+/// must still be parsed to load a bundle from the cache. The verifier, the
+/// translation, the type checker and the passes are skipped.
+class ArCache {
+private:
+  // Path of the cache entry
+  boost::filesystem::path _path;
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param directory Cache directory
+  /// \param bitcode Content of the bitcode file
+  /// \param options Options of the translation and the passes
+  ArCache(const boost::filesystem::path& directory,
+          llvm::StringRef bitcode,
+          llvm::StringRef options);
+
+  /// \brief Return the path of the cache entry
+  const boost::filesystem::path& path() const { return this->_path; }
+
+  /// \brief Load the bundle from the cache
+  ///
+  /// Returns null if there is no valid cache entry.
+  ar::Bundle* load(ar::Context& ctx, llvm::Module& module) const;
+
+  /// \brief Save the bundle in the cache
+  ///
+  /// Returns false if the cache entry could not be written, or if some
+  /// front-end objects of the bundle could not be restored from it.
+  bool save(ar::Bundle* bundle, llvm::Module& module) const;
+
+}; // end class ArCache
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -44,6 +44,7 @@
 #pragma once
 
 #include <iostream>
+#include <mutex>
 
 #include <ikos/core/support/compiler.hpp>
 
@@ -140,6 +141,11 @@ protected:
   /// \brief Output stream
   std::ostream& _out;
 
+  /// \brief Mutex held while a log message is alive
+  ///
+  /// This prevents messages from concurrent analyses from interleaving.
+  std::recursive_mutex _mutex;
+
 public:
   /// \brief constructor
   explicit Logger(std::ostream& out) noexcept : _out(out) {}
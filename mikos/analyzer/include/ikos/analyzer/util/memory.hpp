@@ -0,0 +1,123 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Memory usage utilities
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Return the resident set size of the current process, in bytes
+///
+/// This is close to a high-water mark: the allocator usually keeps the memory
+/// that was freed, so the resident set size barely drops after frees.
+///
+/// Return zero if it is not available on this platform.
+std::size_t resident_memory();
+
+/// \brief Return the heap memory in use by the current process, in bytes
+///
+/// Unlike resident_memory(), this drops as soon as memory is freed. It does
+/// not account for the fragmentation of the heap.
+///
+/// Fall back to resident_memory() if the allocator does not provide it.
+std::size_t allocated_memory();
+
+/// \brief Memory budget of the analysis
+///
+/// The heap memory in use, see allocated_memory(), is polled at most once
+/// every `PollPeriod` calls to exceeded(), since reading it walks the
+/// allocator arenas. This is thread-safe.
+class MemoryBudget {
+private:
+  /// \brief Number of calls to exceeded() between two polls
+  static const unsigned PollPeriod = 16;
+
+private:
+  /// \brief Limit, in bytes
+  std::size_t _limit;
+
+  /// \brief Number of calls to exceeded()
+  std::atomic< unsigned > _calls{0};
+
+  /// \brief Result of the last poll
+  std::atomic< bool > _exceeded{false};
+
+  /// \brief Number of evicted objects, see add_evictions()
+  std::atomic< std::size_t > _evictions{0};
+
+public:
+  /// \brief Constructor
+  ///
+  /// \param limit Limit, in bytes
+  explicit MemoryBudget(std::size_t limit) : _limit(limit) {}
+
+  /// \brief No copy constructor
+  MemoryBudget(const MemoryBudget&) = delete;
+
+  /// \brief No move constructor
+  MemoryBudget(MemoryBudget&&) = delete;
+
+  /// \brief No copy assignment operator
+  MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+  /// \brief No move assignment operator
+  MemoryBudget& operator=(MemoryBudget&&) = delete;
+
+  /// \brief Destructor
+  ~MemoryBudget() = default;
+
+  /// \brief Return true if the heap memory in use is close to the limit
+  ///
+  /// This returns true above 90% of the limit, leaving room for the objects
+  /// allocated until the next poll.
+  bool exceeded();
+
+  /// \brief Record that n objects were released to stay within the budget
+  void add_evictions(std::size_t n) { this->_evictions += n; }
+
+  /// \brief Return the number of objects released to stay within the budget
+  std::size_t evictions() const { return this->_evictions.load(); }
+
+}; // end class MemoryBudget
+
+} // end namespace analyzer
+} // end namespace ikos
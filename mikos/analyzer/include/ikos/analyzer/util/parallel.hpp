@@ -0,0 +1,187 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Helpers to run independent analyses concurrently
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ikos/analyzer/util/memory.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+/// \brief Return the number of threads to use for the given `jobs` option
+///
+/// Zero means one thread per hardware thread.
+inline unsigned num_threads(unsigned jobs) {
+  if (jobs == 0) {
+    return std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  return jobs;
+}
+
+/// \brief Run tasks concurrently, and commit their results in order
+///
+/// Call `analyze(i, worker)` for every task `i` in [0, num_tasks) on `jobs`
+/// threads, where `worker` is the index of the thread in [0, jobs). Then call
+/// `commit(i)` sequentially, in increasing order of `i`, as soon as the task
+/// `i` and all the tasks before it are analyzed.
+///
+/// `commit` is never called concurrently, so it can write in the output
+/// database deterministically.
+///
+/// To bound the memory usage, a task is not started while more than `window`
+/// analyzed tasks are waiting to be committed.
+///
+/// If `worker_memory` is not zero, it is the memory budget of a worker, in
+/// bytes. A task is not started while the heap memory in use by the process,
+/// see allocated_memory(), exceeds the budget of the running workers. At least
+/// one task is always running, so the analysis can progress even if a single
+/// task exceeds the budget.
+///
+/// If a task throws an exception, no new task is started, and the first
+/// exception is rethrown once all threads are done.
+template < typename AnalyzeFunction, typename CommitFunction >
+void parallel_ordered_for(std::size_t num_tasks,
+                          unsigned jobs,
+                          std::size_t window,
+                          AnalyzeFunction analyze,
+                          CommitFunction commit,
+                          std::size_t worker_memory = 0) {
+  if (jobs <= 1 || num_tasks <= 1) {
+    for (std::size_t i = 0; i < num_tasks; i++) {
+      analyze(i, 0U);
+      commit(i);
+    }
+    return;
+  }
+
+  window = std::max(window, static_cast< std::size_t >(jobs));
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::size_t next_task = 0;
+  std::size_t next_commit = 0;
+  std::size_t running = 0;
+  std::vector< bool > analyzed(num_tasks, false);
+  bool committing = false;
+  std::exception_ptr error = nullptr;
+
+  auto worker = [&](unsigned worker_id) {
+    std::unique_lock< std::mutex > lock(mutex);
+
+    while (true) {
+      cond.wait(lock, [&] {
+        return error != nullptr || next_task >= num_tasks ||
+               (next_task < next_commit + window &&
+                (worker_memory == 0 || running == 0 ||
+                 allocated_memory() <= running * worker_memory));
+      });
+
+      if (error != nullptr || next_task >= num_tasks) {
+        return;
+      }
+
+      std::size_t task = next_task++;
+      running++;
+      lock.unlock();
+      try {
+        analyze(task, worker_id);
+      } catch (...) {
+        lock.lock();
+        running--;
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        cond.notify_all();
+        return;
+      }
+      lock.lock();
+      running--;
+      analyzed[task] = true;
+
+      // Commit all the tasks that are ready, unless another thread is already
+      // doing it. In that case, it will notice this task before leaving.
+      if (!committing) {
+        committing = true;
+        while (error == nullptr && next_commit < num_tasks &&
+               analyzed[next_commit]) {
+          std::size_t ready = next_commit;
+          lock.unlock();
+          try {
+            commit(ready);
+          } catch (...) {
+            lock.lock();
+            if (error == nullptr) {
+              error = std::current_exception();
+            }
+            break;
+          }
+          lock.lock();
+          next_commit++;
+        }
+        committing = false;
+      }
+
+      cond.notify_all();
+    }
+  };
+
+  std::vector< std::thread > threads;
+  threads.reserve(jobs);
+  for (unsigned i = 0; i < jobs; i++) {
+    threads.emplace_back(worker, i);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -83,6 +83,14 @@ def parse_arguments(argv):
                         metavar='<file>',
                         help='Output database file (default: output.db)',
                         default='output.db')
+    parser.add_argument('--output-format',
+                        dest='output_format',
+                        metavar='',
+                        help=args.help('Output format:',
+                                       args.output_formats,
+                                       args.default_output_format),
+                        choices=args.choices(args.output_formats),
+                        default=args.default_output_format)
     parser.add_argument('-v',
                         dest='verbosity',
                         help='Increase verbosity',
@@ -120,6 +128,13 @@ def parse_arguments(argv):
                           help='Enable memory optimization (MIKOS)',
                           action='store_true',
                           default=False)
+    analysis.add_argument('--memopt-delta-invariants',
+                          dest='memopt_delta_invariants',
+                          help='With --memopt, recompute the cached invariants'
+                               ' of blocks with a single predecessor instead'
+                               ' of storing them',
+                          action='store_true',
+                          default=False)
     analysis.add_argument('-e', '--entry-points',
                           dest='entry_points',
                           metavar='<function>',
@@ -155,11 +170,32 @@ def parse_arguments(argv):
                           help='Disable the widening hint analysis',
                           action='store_true',
                           default=False)
+    analysis.add_argument('--reuse-preanalysis',
+                          dest='reuse_preanalysis',
+                          metavar='<directory>',
+                          help='Cache the results of the liveness, widening '
+                               'hint and pointer analyses in the given '
+                               'directory, and reuse them across runs',
+                          default=None)
     analysis.add_argument('--no-fixpoint-cache',
                           dest='no_fixpoint_cache',
                           help='Disable the cache of fixpoints',
                           action='store_true',
                           default=False)
+    analysis.add_argument('--summary-cache',
+                          dest='summary_cache',
+                          metavar='',
+                          help='Maximum number of function summaries reused'
+                               ' across call sites, without --memopt'
+                               ' (default: 0, disabled)',
+                          default=0,
+                          type=args.Integer(min=0))
+    analysis.add_argument('--lazy-normalization',
+                          dest='lazy_normalization',
+                          help='Only normalize the variable packs needed by '
+                               'queries, with the var-pack domains',
+                          action='store_true',
+                          default=False)
     analysis.add_argument('--proc',
                           dest='procedural',
                           metavar='',
@@ -168,6 +204,21 @@ def parse_arguments(argv):
                                          args.default_procedurality),
                           choices=args.choices(args.proceduralities),
                           default=args.default_procedurality)
+    analysis.add_argument('-j', '--jobs',
+                          dest='jobs',
+                          metavar='',
+                          help='Number of threads for the value analysis,'
+                               ' 0 for one per core (default: 1)',
+                          default=1,
+                          type=args.Integer(min=0))
+    analysis.add_argument('--fixpoint-jobs',
+                          dest='fixpoint_jobs',
+                          metavar='',
+                          help='Number of threads for the fixpoint on a'
+                               ' function body, with --proc=intra and without'
+                               ' --memopt (default: 1)',
+                          default=1,
+                          type=args.Integer(min=1))
     analysis.add_argument('--widening-strategy',
                           dest='widening_strategy',
                           metavar='',
@@ -306,6 +357,13 @@ def parse_arguments(argv):
                               '(__ikos_assert, etc.)',
                          action='store_true',
                          default=False)
+    imports.add_argument('--ar-cache',
+                         dest='ar_cache',
+                         metavar='<directory>',
+                         help='Cache the abstract representation in the '
+                              'given directory, and reuse it across runs on '
+                              'the same bitcode',
+                         default=None)
 
     # AR passes options
     passes = parser.add_argument_group('AR Passes Options')
@@ -486,6 +544,16 @@ def parse_arguments(argv):
                           dest='mem',
                           help='MEM limit (MB)',
                           type=args.Integer(min=1))
+    resource.add_argument('--worker-mem',
+                          dest='worker_mem',
+                          help='MEM budget of an analysis thread (MB),'
+                               ' used with --jobs',
+                          type=args.Integer(min=1))
+    resource.add_argument('--memory-limit',
+                          dest='memory_limit',
+                          help='MEM budget of the analysis with --memopt (MB),'
+                               ' analyze callees again instead of exceeding it',
+                          type=args.Integer(min=1))
 
     opt = parser.parse_args(argv)
 
@@ -758,12 +826,20 @@ def ikos_analyzer(db_path, pp_path, opt):
             '-entry-points=%s' % ','.join(opt.entry_points),
             '-globals-init=%s' % opt.globals_init,
             '-proc=%s' % opt.procedural,
+            '-j=%d' % opt.jobs,
+            '-fixpoint-jobs=%d' % opt.fixpoint_jobs,
             '-widening-strategy=%s' % opt.widening_strategy,
             '-widening-delay=%d' % opt.widening_delay,
             '-widening-period=%d' % opt.widening_period]
 
     if opt.memopt:
         cmd.append('-memopt')
+    if opt.memopt_delta_invariants:
+        cmd.append('-memopt-delta-invariants')
+    if opt.worker_mem:
+        cmd.append('-worker-mem=%d' % opt.worker_mem)
+    if opt.memory_limit:
+        cmd.append('-memory-limit=%d' % opt.memory_limit)
     if opt.narrowing_strategy == 'auto':
         if opt.domain in domains_without_narrowing:
             cmd.append('-narrowing-strategy=meet')
@@ -791,8 +867,14 @@ def ikos_analyzer(db_path, pp_path, opt):
         cmd.append('-no-pointer')
     if opt.no_widening_hints:
         cmd.append('-no-widening-hints')
+    if opt.reuse_preanalysis:
+        cmd.append('-reuse-preanalysis=%s' % opt.reuse_preanalysis)
     if opt.no_fixpoint_cache:
         cmd.append('-no-fixpoint-cache')
+    if opt.summary_cache:
+        cmd.append('-summary-cache=%d' % opt.summary_cache)
+    if opt.lazy_normalization:
+        cmd.append('-lazy-normalization')
     if opt.partitioning != 'no':
         cmd.append('-enable-partitioning-domain')
     if opt.hardware_addresses:
@@ -812,6 +894,8 @@ def ikos_analyzer(db_path, pp_path, opt):
         cmd.append('-no-libcpp')
     if opt.no_libikos:
         cmd.append('-no-libikos')
+    if opt.ar_cache:
+        cmd.append('-ar-cache=%s' % opt.ar_cache)
 
     # AR passes options
     if opt.no_type_check:
@@ -863,6 +947,8 @@ def ikos_analyzer(db_path, pp_path, opt):
 
     # input/output
     cmd += [pp_path, '-o', db_path]
+    if opt.output_format != args.default_output_format:
+        cmd.append('-output-format=%s' % opt.output_format)
 
     # set resource limit, if requested
     if opt.mem:
@@ -1096,3 +1182,5 @@ def main(argv):
 
     if opt.remove_db:
         os.remove(opt.output_db)
+        if opt.output_format == 'columnar':
+            shutil.rmtree(opt.output_db + '.columnar', ignore_errors=True)
@@ -206,8 +206,12 @@ domains = (
      'Reduced product of Interval and Congruence'),
     ('dbm',
      'Difference-Bound Matrices domain'),
+    ('sparse-dbm',
+     'Sparse Difference-Bound Matrices domain'),
     ('var-pack-dbm',
      'Difference-Bound Matrices domain with variable packing'),
+    ('var-pack-sparse-dbm',
+     'Sparse Difference-Bound Matrices domain with variable packing'),
     ('var-pack-dbm-congruence',
      'Reduced product of DBM with variable packing and Congruence'),
     ('gauge',
@@ -368,6 +372,14 @@ report_formats = (
     ('no', 'Do not generate a report'),
 )
 
+output_formats = (
+    ('sqlite', 'Write all results in the output database'),
+    ('columnar', 'Write statements, call contexts and checks in columnar '
+                 'files, in <output-db>.columnar'),
+)
+
+default_output_format = 'sqlite'
+
 status_filters = (
     ('*', 'All'),
     ('error', 'Error'),
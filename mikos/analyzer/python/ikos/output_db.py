@@ -41,7 +41,12 @@
 ###############################################################################
 import collections
 import json
+import mmap
+import os
+import os.path
 import sqlite3
+import struct
+import sys
 
 from ikos.enums import FilesTable, FunctionsTable, StatementsTable, \
     CallContextsTable, OperandsTable, MemoryLocationsTable, ChecksTable
@@ -71,7 +76,15 @@ class OutputDatabase(object):
         # This is bytes in python 2 and unicode in python 3
         self.con.text_factory = str
 
+        # Statements, call contexts and checks written in columnar files
+        # with ikos-analyzer -output-format=columnar, or None
+        self.columnar = None
+        if self.load_settings().get('output-format') == 'columnar':
+            self.columnar = ColumnarResults(path + '.columnar')
+
     def close(self):
+        if self.columnar is not None:
+            self.columnar.close()
         self.con.close()
 
     def load_settings(self):
@@ -111,6 +124,20 @@ class OutputDatabase(object):
         c.executemany('INSERT INTO times VALUES (?, ?)', rows)
         self.con.commit()
 
+    def load_statistics(self):
+        '''
+        Load the statistics of the analysis from the database,
+        as a list of tuples (name, value)
+        '''
+        c = self.con.cursor()
+        c.execute("SELECT name FROM sqlite_master "
+                  "WHERE type = 'table' AND name = 'statistics'")
+        if c.fetchone() is None:
+            # Database created by an older version
+            return []
+        c.execute('SELECT name, value FROM statistics ORDER BY name')
+        return c.fetchall()
+
     @CachedProperty
     def files(self):
         return self._fetch_table('files', File)
@@ -121,6 +148,9 @@ class OutputDatabase(object):
 
     @CachedProperty
     def statements(self):
+        if self.columnar is not None:
+            return [Statement(row, self)
+                    for row in self.columnar.rows('statements')]
         return self._fetch_table('statements', Statement)
 
     @CachedProperty
@@ -129,6 +159,9 @@ class OutputDatabase(object):
 
     @CachedProperty
     def call_contexts(self):
+        if self.columnar is not None:
+            return [CallContext(row, self)
+                    for row in self.columnar.rows('call_contexts')]
         return self._fetch_table('call_contexts', CallContext)
 
     @CachedProperty
@@ -140,6 +173,196 @@ class OutputDatabase(object):
         c.execute('SELECT * FROM %s ORDER BY id' % table)
         return [klass(row, self) for row in c]
 
+    def load_checks(self,
+                    order_by,
+                    statuses=None,
+                    checkers=None,
+                    always_checkers=()):
+        '''
+        Iterate over the rows of the checks table, sorted by the given columns
+
+        Arguments:
+            order_by(list): List of column names
+            statuses(list): Keep only these statuses, or None
+            checkers(list): Keep only these checkers, or None
+            always_checkers(list): Keep these checkers, regardless of the
+                statuses and checkers filters
+        '''
+        if self.columnar is not None:
+            return self.columnar.checks(order_by,
+                                        statuses,
+                                        checkers,
+                                        always_checkers)
+
+        where = []
+        if statuses is not None:
+            where.append(' OR '.join('(status=%d)' % status
+                                     for status in statuses) or '0=1')
+        if checkers is not None:
+            where.append(' OR '.join('(checker=%d)' % checker
+                                     for checker in checkers) or '0=1')
+        where = ' AND '.join('(%s)' % clause for clause in where)
+
+        if where and always_checkers:
+            where = '(%s) OR %s' % (where, ' OR '.join('(checker=%d)' % checker
+                                                       for checker
+                                                       in always_checkers))
+
+        if where:
+            where = 'WHERE %s' % where
+
+        c = self.con.cursor()
+        c.execute('SELECT * FROM checks %s ORDER BY %s' %
+                  (where, ', '.join(order_by)))
+        return c
+
+    def load_check_kinds(self):
+        ''' Return the sorted list of distinct check kinds '''
+        if self.columnar is not None:
+            return sorted(set(self.columnar.column('checks', 'kind')))
+
+        c = self.con.cursor()
+        c.execute('SELECT DISTINCT kind FROM checks ORDER BY kind')
+        return [row[0] for row in c]
+
+
+class ColumnarResults(object):
+    '''
+    Statements, call contexts and checks written in columnar files
+
+    Each column is a file of 64-bit little-endian integers, mapped in memory.
+    Strings are indexes in a shared string table. See columnar.hpp in the
+    analyzer for the format.
+    '''
+
+    # Columns holding an index in the string table
+    STRING_COLUMNS = {('checks', 'operands'), ('checks', 'info')}
+
+    def __init__(self, directory):
+        self.directory = directory
+
+        manifest_path = os.path.join(directory, 'manifest.json')
+        if not os.path.exists(manifest_path):
+            raise sqlite3.DatabaseError('missing or incomplete columnar '
+                                        'output: %s' % directory)
+
+        with open(manifest_path) as f:
+            manifest = json.load(f)
+
+        if manifest['version'] != 1:
+            raise sqlite3.DatabaseError('unsupported columnar output '
+                                        'version: %s' % manifest['version'])
+
+        self.null = manifest['null']
+        self.tables = manifest['tables']
+        self._files = []
+        self._views = []
+        self._columns = {}
+        self._string_offsets = self._map('strings.offsets.i64')
+        self._string_data = self._open('strings.data')
+
+    def close(self):
+        self._columns = {}
+        self._string_offsets = None
+        self._string_data = None
+        for view in self._views:
+            view.release()  # required to close the memory map
+        self._views = []
+        for f in reversed(self._files):
+            f.close()
+        self._files = []
+
+    def _open(self, filename):
+        ''' Map the given file in memory '''
+        f = open(os.path.join(self.directory, filename), 'rb')
+        self._files.append(f)
+        if os.fstat(f.fileno()).st_size == 0:
+            return b''  # mmap does not support empty files
+
+        data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        self._files.append(data)
+        return data
+
+    def _map(self, filename):
+        ''' Return the 64-bit integers of the given file '''
+        data = self._open(filename)
+        if (sys.byteorder == 'little' and hasattr(memoryview, 'cast') and
+                len(data) > 0):
+            # No copy
+            view = memoryview(data).cast('q')
+            self._views.append(view)
+            return view
+        return struct.unpack_from('<%dq' % (len(data) // 8), data)
+
+    def column(self, table, name):
+        ''' Return the raw values of the given column '''
+        key = (table, name)
+        if key not in self._columns:
+            self._columns[key] = self._map('%s.%s.i64' % key)
+        return self._columns[key]
+
+    def string(self, index):
+        ''' Return the string at the given index of the string table '''
+        begin = self._string_offsets[index]
+        end = self._string_offsets[index + 1]
+        s = self._string_data[begin:end]
+        if bytes is not str:
+            s = s.decode('utf-8')
+        return s
+
+    def rows(self, table, indexes=None):
+        '''
+        Iterate over the rows of the given table, as tuples in the same
+        layout as the database
+
+        Arguments:
+            indexes(iterable): Row numbers, or None for all rows
+        '''
+        columns = []
+        for name in self.tables[table]['columns']:
+            columns.append((self.column(table, name),
+                            (table, name) in self.STRING_COLUMNS))
+
+        if indexes is None:
+            indexes = range(self.tables[table]['rows'])
+
+        null = self.null
+        for i in indexes:
+            row = []
+            for values, is_string in columns:
+                value = values[i]
+                if value == null:
+                    row.append(None)
+                elif is_string:
+                    row.append(self.string(value))
+                else:
+                    row.append(value)
+            yield tuple(row)
+
+    def checks(self, order_by, statuses, checkers, always_checkers):
+        ''' See OutputDatabase.load_checks() '''
+        indexes = range(self.tables['checks']['rows'])
+
+        if statuses is not None or checkers is not None:
+            status_values = self.column('checks', 'status')
+            checker_values = self.column('checks', 'checker')
+            statuses = set(statuses) if statuses is not None else None
+            checkers = set(checkers) if checkers is not None else None
+            always_checkers = set(always_checkers)
+            indexes = [i for i in indexes
+                       if (statuses is None or
+                           status_values[i] in statuses) and
+                       (checkers is None or
+                        checker_values[i] in checkers) or
+                       checker_values[i] in always_checkers]
+
+        # NULL is the smallest value, as in SQLite
+        keys = [self.column('checks', name) for name in order_by]
+        indexes = sorted(indexes,
+                         key=lambda i: tuple(values[i] for values in keys))
+
+        return self.rows('checks', indexes)
+
 
 class File(object):
     ''' Represents a source file '''
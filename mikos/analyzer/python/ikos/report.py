@@ -105,6 +105,18 @@ def print_timing_results(db, full=True, sort=True):
     for name, elapsed in results:
         printf('%s: %s\n', name.ljust(name_width), format_time(elapsed))
 
+    if not full:
+        return
+
+    statistics = db.load_statistics()
+    if not statistics:
+        return
+
+    printf('\n' + bold('# Analysis stats:') + '\n')
+    name_width = max(len(name) for name, _ in statistics)
+    for name, value in statistics:
+        printf('%s: %d\n', name.ljust(name_width), value)
+
 
 ###########
 # summary #
@@ -181,9 +193,7 @@ def generate_summary(db):
     '''
     summary = Summary(ok=0, error=0, warning=0, unreachable=0)
 
-    c = db.con.cursor()
-    order_by = 'statement_id, call_context_id'
-    c.execute('SELECT * FROM checks ORDER BY %s' % order_by)
+    c = db.load_checks(order_by=('statement_id', 'call_context_id'))
 
     stmt_id_key = operator.itemgetter(ChecksTable.STATEMENT_ID)
     context_id_key = operator.itemgetter(ChecksTable.CALL_CONTEXT_ID)
@@ -332,14 +342,12 @@ def print_raw_checks(db, interprocedural):
         'operands',
         'info'
     ]
-    order_by = 'call_context_id, statement_id, kind'
+    order_by = ('call_context_id', 'statement_id', 'kind')
 
     if not interprocedural:
         header.pop(0)  # no context column if intraprocedural
 
-    c = db.con.cursor()
-    c.execute('SELECT * FROM checks ORDER BY %s' % order_by)
-    rows = c.fetchall()
+    rows = list(db.load_checks(order_by=order_by))
 
     # Format all rows
     for i, row in enumerate(rows):
@@ -384,8 +392,6 @@ def print_raw_checks(db, interprocedural):
         row[-3] = format_status(row[-3])  # add colors for result column
         printf(fmt, *row)
 
-    c.close()
-
 
 ##########
 # report #
@@ -491,41 +497,25 @@ def generate_report(db, status_filter=None, analyses_filter=None):
                             (analyses_filter is None or
                              CheckerName.DEAD_CODE in analyses_filter))
 
-    # Generate where clause
-    where = []
+    # Generate filters
+    statuses = status_filter
 
-    if status_filter is not None:
-        if not status_filter:
-            where = ['0=1']  # status_filter=[], filter everything
-        else:
-            where.append(' OR '.join('(status=%d)' % status
-                                     for status in status_filter))
-
-    if analyses_filter is not None:
-        if not analyses_filter:
-            where = ['0=1']  # analyses_filter=[], filter everything
-        elif len(analyses_filter) == len(args.analyses):
-            pass  # nothing to filter
-        else:
-            where.append(' OR '.join('(checker=%d)' % checker
-                                     for checker in analyses_filter))
-
-    where = ' AND '.join('(%s)' % clause for clause in where)
+    checkers = analyses_filter
+    if checkers and len(checkers) == len(args.analyses):
+        checkers = None  # nothing to filter
 
+    always_checkers = ()
     if display_unreachables and not display_oks:
         # Only show unreachable statements if the statement is unreachable for
         # all calling contexts. To detect this, we need to make sure to get all
         # checks from the DeadCodeChecker, especially 'ok' checks.
-        where = '(%s) OR (checker=%d)' % (where, CheckerName.DEAD_CODE)
-
-    if where:
-        where = 'WHERE %s' % where
-
-    order_by = 'ORDER BY statement_id, call_context_id'
+        always_checkers = (CheckerName.DEAD_CODE,)
 
     # Execute query
-    c = db.con.cursor()
-    c.execute('SELECT * FROM checks %s %s' % (where, order_by))
+    c = db.load_checks(order_by=('statement_id', 'call_context_id'),
+                       statuses=statuses,
+                       checkers=checkers,
+                       always_checkers=always_checkers)
 
     stmt_id_key = operator.itemgetter(ChecksTable.STATEMENT_ID)
     context_id_key = operator.itemgetter(ChecksTable.CALL_CONTEXT_ID)
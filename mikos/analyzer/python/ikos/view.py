@@ -372,9 +372,7 @@ class ViewReport:
     def pre_process(self):
         ''' Pre processing some values '''
         # List of CheckKind
-        c = self.db.con.cursor()
-        rows = c.execute("SELECT DISTINCT kind FROM checks ORDER BY kind")
-        self.kinds = [row[0] for row in rows]
+        self.kinds = self.db.load_check_kinds()
 
         # Generate report
         self._report = report.generate_report(self.db)
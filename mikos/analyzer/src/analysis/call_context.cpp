@@ -54,10 +54,13 @@ CallContextFactory::~CallContextFactory() = default;
 CallContext* CallContextFactory::get_context(CallContext* parent,
                                              ar::CallBase* call) {
   ikos_assert(parent != nullptr && call != nullptr);
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_map.find({parent, call});
   if (it == this->_map.end()) {
     auto call_context =
-        std::unique_ptr< CallContext >(new CallContext(parent, call));
+        std::unique_ptr< CallContext >(new CallContext(parent,
+                                                       call,
+                                                       this->_next_id++));
     auto res = this->_map.try_emplace({parent, call}, std::move(call_context));
     ikos_assert(res.second);
     return res.first->second.get();
@@ -105,6 +105,7 @@ FixpointParameters::~FixpointParameters() = default;
 
 CodeFixpointParameters& FixpointParameters::get(ar::Function* fun) {
   ikos_assert(fun->is_definition());
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_map.find(fun);
   if (it != this->_map.end()) {
     return *it->second;
@@ -77,6 +77,7 @@ const AggregateLit& LiteralFactory::get_aggregate(ar::Value* value) {
 }
 
 const Literal& LiteralFactory::get(ar::Value* value) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_map.find(value);
   if (it == this->_map.end()) {
     std::pair< Map::iterator, bool > res =
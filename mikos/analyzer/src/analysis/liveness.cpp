@@ -43,8 +43,10 @@
  *
  ******************************************************************************/
 
-#include <ikos/core/domain/discrete_domain.hpp>
-#include <ikos/core/fixpoint/fwd_fixpoint_iterator.hpp>
+#include <algorithm>
+#include <queue>
+
+#include <llvm/ADT/BitVector.h>
 
 #include <ikos/ar/semantic/code.hpp>
 
@@ -52,319 +54,273 @@
 #include <ikos/analyzer/analysis/variable.hpp>
 #include <ikos/analyzer/util/demangle.hpp>
 #include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/parallel.hpp>
 #include <ikos/analyzer/util/progress.hpp>
 
 namespace ikos {
 namespace analyzer {
 namespace {
 
-/// \brief Lattice of liveness
+/// \brief Liveness solver on dense bit-vectors
 ///
-/// This is a small wrapper around core::DiscreteDomain, with a few changes:
-///   * The default constructor returns bottom
-///   * Has convenient operator+ and operator-
-template < typename VariableRef >
-class LivenessDomain final
-    : public core::AbstractDomain< LivenessDomain< VariableRef > > {
-private:
-  using DiscreteDomain = core::DiscreteDomain< VariableRef >;
-
-public:
-  using Iterator = typename DiscreteDomain::Iterator;
-
-private:
-  DiscreteDomain _inv;
-
-private:
-  /// \brief Private constructor
-  explicit LivenessDomain(DiscreteDomain inv) : _inv(std::move(inv)) {}
-
-public:
-  /// \brief Create the top liveness domain
-  static LivenessDomain top() { return LivenessDomain(DiscreteDomain::top()); }
-
-  /// \brief Create the bottom liveness domain
-  static LivenessDomain bottom() {
-    return LivenessDomain(DiscreteDomain::bottom());
-  }
-
-  /// \brief Create the empty liveness domain
-  static LivenessDomain empty() {
-    return LivenessDomain(DiscreteDomain::bottom());
-  }
-
-  /// \brief Create the liveness domain with the given elements
-  LivenessDomain(std::initializer_list< VariableRef > elements)
-      : _inv(elements) {}
-
-  /// \brief Copy constructor
-  LivenessDomain(const LivenessDomain&) noexcept = default;
-
-  /// \brief Move constructor
-  LivenessDomain(LivenessDomain&&) noexcept = default;
-
-  /// \brief Copy assignment operator
-  LivenessDomain& operator=(const LivenessDomain&) noexcept = default;
-
-  /// \brief Move assignment operator
-  LivenessDomain& operator=(LivenessDomain&&) noexcept = default;
-
-  /// \brief Destructor
-  ~LivenessDomain() override = default;
-
-  /// \brief Return the number of elements in the liveness domain
-  std::size_t size() const { return this->_inv.size(); }
-
-  /// \brief Begin iterator over the elements
-  Iterator begin() const { return this->_inv.begin(); }
-
-  /// \brief End iterator over the elements
-  Iterator end() const { return this->_inv.end(); }
-
-  bool is_bottom() const override { return this->_inv.is_bottom(); }
-
-  bool is_top() const override { return this->_inv.is_top(); }
-
-  void set_to_bottom() override { this->_inv.set_to_bottom(); }
-
-  void set_to_top() override { this->_inv.set_to_top(); }
-
-  bool leq(const LivenessDomain& other) const override {
-    return this->_inv.leq(other._inv);
-  }
-
-  bool equals(const LivenessDomain& other) const override {
-    return this->_inv.equals(other._inv);
-  }
-
-  void join_with(const LivenessDomain& other) override {
-    this->_inv.join_with(other._inv);
-  }
-
-  void widen_with(const LivenessDomain& other) override {
-    this->_inv.widen_with(other._inv);
-  }
-
-  void meet_with(const LivenessDomain& other) override {
-    this->_inv.meet_with(other._inv);
-  }
-
-  void narrow_with(const LivenessDomain& other) override {
-    this->_inv.narrow_with(other._inv);
-  }
-
-  void operator-=(const LivenessDomain& other) {
-    this->_inv.difference_with(other._inv);
-  }
-
-  void operator-=(VariableRef v) { this->_inv.remove(v); }
-
-  void operator+=(const LivenessDomain& other) {
-    this->_inv.join_with(other._inv);
-  }
-
-  void operator+=(VariableRef v) { this->_inv.add(v); }
-
-  void dump(std::ostream& o) const override { this->_inv.dump(o); }
-
-  static std::string name() { return "liveness domain"; }
-
-}; // end class LivenessDomain
-
-/// \brief Inverse an ar::Code* graph
+/// Variables of the code are numbered, and sets of variables are represented
+/// by bit-vectors, so that the union and difference are word-wise operations.
 ///
-/// The entry node is the exit node, and successors and predecessors are swapped
-struct ReverseCodeGraphTrait {
-  using NodeRef = ar::BasicBlock*;
-  using SuccessorNodeIterator = ar::BasicBlock::BasicBlockIterator;
-  using PredecessorNodeIterator = ar::BasicBlock::BasicBlockIterator;
-
-  static ar::BasicBlock* entry(ar::Code* code) {
-    ikos_assert_msg(code->has_exit_block(), "code graph cannot be inversed");
-    return code->exit_block();
-  }
-
-  static SuccessorNodeIterator successor_begin(ar::BasicBlock* bb) {
-    return bb->predecessor_begin();
-  }
-
-  static SuccessorNodeIterator successor_end(ar::BasicBlock* bb) {
-    return bb->predecessor_end();
-  }
+/// The solver computes the least fixpoint of the backward equations:
+///
+/// OUT(B) = U IN(S) for all successors S of B
+/// IN(B) = (OUT(B) \ kill(B)) U gen(B)
+///
+/// with a worklist ordered by the reverse post-order of the reversed control
+/// flow graph. Only the basic blocks that can reach the exit block are
+/// analyzed.
+class LivenessSolver {
+private:
+  /// \brief A (kill, gen, all) triple
+  struct BlockInfo {
+    /// \brief Variables defined in the block
+    llvm::BitVector kill;
 
-  static PredecessorNodeIterator predecessor_begin(ar::BasicBlock* bb) {
-    return bb->successor_begin();
-  }
+    /// \brief Variables used in the block before being defined
+    llvm::BitVector gen;
 
-  static PredecessorNodeIterator predecessor_end(ar::BasicBlock* bb) {
-    return bb->successor_end();
-  }
+    /// \brief Variables defined or used in the block
+    llvm::BitVector all;
 
-}; // end struct ReverseCodeGraphTrait
+    /// \brief Live variables at the entry of the block
+    llvm::BitVector live_in;
 
-/// \brief Liveness fixpoint iterator
-class LivenessFixpointIterator final
-    : public core::InterleavedFwdFixpointIterator< ar::Code*,
-                                                   LivenessDomain< Variable* >,
-                                                   ReverseCodeGraphTrait > {
-private:
-  /// \brief Parent class
-  using FwdFixpointIterator =
-      core::InterleavedFwdFixpointIterator< ar::Code*,
-                                            LivenessDomain< Variable* >,
-                                            ReverseCodeGraphTrait >;
-
-  /// \brief Liveness abstract domain
-  using LivenessDomainT = LivenessDomain< Variable* >;
-
-  /// \brief A pair (kill, gen)
-  struct KillGen {
-    LivenessDomainT kill;
-    LivenessDomainT gen;
+    /// \brief Live variables at the end of the block
+    llvm::BitVector live_out;
   };
 
-  /// \brief Map from basic block to a (kill, gen) pair
-  using KillGenMap = llvm::DenseMap< ar::BasicBlock*, KillGen >;
-
-  /// \brief Map from basic block to liveness domain
-  using LivenessMap = llvm::DenseMap< ar::BasicBlock*, LivenessDomainT >;
-
-public:
-  /// \brief Iterator on a map from basic block to liveness domain
-  using LivenessMapIterator = LivenessMap::const_iterator;
-
 private:
+  /// \brief Analyzed code
+  ar::Code* _code;
+
   /// \brief Variable factory
   VariableFactory& _vfac;
 
-  /// \brief Store (kill, gen) sets for each basic block
-  KillGenMap _kg_map;
-
-  /// \brief Set of all variables (defined and used) for each basic blocks
-  LivenessMap _all_vars_map;
-
-  /// \brief Set of live variables at the **entry** of a basic block
-  LivenessMap _live_at_entry_map;
+  /// \brief Map from variable to its number
+  llvm::DenseMap< Variable*, unsigned > _var_index;
 
-  /// \brief Set of dead variables at the **end** of a basic block
-  LivenessMap _dead_at_end_map;
-
-public:
-  LivenessFixpointIterator(ar::Code* code, VariableFactory& vfac)
-      : FwdFixpointIterator(code, LivenessDomainT::bottom()), _vfac(vfac) {
-    this->init();
-  }
+  /// \brief List of variables, indexed by number
+  std::vector< Variable* > _vars;
 
-  LivenessMapIterator live_at_entry_begin() const {
-    return this->_live_at_entry_map.begin();
-  }
+  /// \brief Basic blocks that can reach the exit block, in reverse post-order
+  /// of the reversed control flow graph
+  std::vector< ar::BasicBlock* > _order;
 
-  LivenessMapIterator live_at_entry_end() const {
-    return this->_live_at_entry_map.end();
-  }
+  /// \brief Map from basic block to its position in `_order`
+  llvm::DenseMap< ar::BasicBlock*, unsigned > _position;
 
-  LivenessMapIterator dead_at_end_begin() const {
-    return this->_dead_at_end_map.begin();
-  }
+  /// \brief Information on each basic block, indexed by position
+  std::vector< BlockInfo > _infos;
 
-  LivenessMapIterator dead_at_end_end() const {
-    return this->_dead_at_end_map.end();
-  }
+public:
+  /// \brief Constructor
+  LivenessSolver(ar::Code* code, VariableFactory& vfac)
+      : _code(code), _vfac(vfac) {}
 
   /// \brief Compute the set of dead and live variables
-  void run() { FwdFixpointIterator::run(LivenessDomainT::bottom()); }
-
-  /// \brief Apply the kill-gen equation
-  ///
-  /// IN(B) = (OUT(B) \ kill (B)) U gen (B)
-  LivenessDomainT analyze_node(ar::BasicBlock* bb,
-                               LivenessDomainT post) override {
-    auto it = this->_kg_map.find(bb);
-    ikos_assert(it != this->_kg_map.end());
-
-    LivenessDomainT pre(post);
-    pre -= it->second.kill; // delete kill set
-    pre += it->second.gen;  // add gen set
-    return pre;
-  }
-
-  LivenessDomainT analyze_edge(ar::BasicBlock*,
-                               ar::BasicBlock*,
-                               LivenessDomainT pre) override {
-    return pre;
+  void run() {
+    this->compute_order();
+    this->number_variables();
+    this->init();
+    this->solve();
+  }
+
+  /// \brief Store the results in the given lists
+  void results(
+      std::vector< std::pair< ar::BasicBlock*,
+                              LivenessAnalysis::VariableRefList > >&
+          live_at_entry,
+      std::vector< std::pair< ar::BasicBlock*,
+                              LivenessAnalysis::VariableRefList > >&
+          dead_at_end) const {
+    live_at_entry.reserve(this->_order.size());
+    dead_at_end.reserve(this->_order.size());
+
+    for (unsigned pos = 0; pos < this->_order.size(); pos++) {
+      const BlockInfo& info = this->_infos[pos];
+      live_at_entry.emplace_back(this->_order[pos],
+                                 this->to_variable_ref_list(info.live_in));
+
+      // dead = all - live
+      llvm::BitVector dead(info.all);
+      dead.reset(info.live_out);
+      dead_at_end.emplace_back(this->_order[pos],
+                               this->to_variable_ref_list(dead));
+    }
   }
 
-  /// \brief Store the set of dead variables at the exit of `bb`
-  ///
-  /// Note: this is the post invariant, because we reversed the graph
-  void process_pre(ar::BasicBlock* bb,
-                   const LivenessDomainT& post_live) override {
-    ikos_assert(!post_live.is_top());
-
-    auto it = this->_all_vars_map.find(bb);
-    ikos_assert(it != this->_all_vars_map.end());
-    LivenessDomainT all = it->second;
-
-    // dead = all - live
-    LivenessDomainT dead(all);
-    dead -= post_live;
+private:
+  /// \brief Compute the reverse post-order of the reversed control flow graph
+  void compute_order() {
+    // Iterative depth-first search from the exit block, following the
+    // predecessors
+    using StackEntry = std::pair< ar::BasicBlock*,
+                                  ar::BasicBlock::BasicBlockIterator >;
+    llvm::DenseMap< ar::BasicBlock*, bool > visited;
+    std::vector< StackEntry > stack;
+    std::vector< ar::BasicBlock* > post_order;
+
+    ar::BasicBlock* exit = this->_code->exit_block();
+    visited[exit] = true;
+    stack.emplace_back(exit, exit->predecessor_begin());
+
+    while (!stack.empty()) {
+      ar::BasicBlock* bb = stack.back().first;
+      ar::BasicBlock::BasicBlockIterator& it = stack.back().second;
+      if (it != bb->predecessor_end()) {
+        ar::BasicBlock* pred = *it;
+        ++it;
+        if (visited.try_emplace(pred, true).second) {
+          stack.emplace_back(pred, pred->predecessor_begin());
+        }
+      } else {
+        post_order.push_back(bb);
+        stack.pop_back();
+      }
+    }
 
-    this->_dead_at_end_map.try_emplace(bb, dead);
+    this->_order.assign(post_order.rbegin(), post_order.rend());
+    for (unsigned pos = 0; pos < this->_order.size(); pos++) {
+      this->_position[this->_order[pos]] = pos;
+    }
   }
 
-  /// \brief Store the set of live variables at the entry of `bb`
-  ///
-  /// Note: this is the pre invariant, because we reversed the graph
-  void process_post(ar::BasicBlock* bb,
-                    const LivenessDomainT& pre_live) override {
-    ikos_assert(!pre_live.is_top());
+  /// \brief Number the variables defined or used in the analyzed blocks
+  void number_variables() {
+    for (ar::BasicBlock* bb : this->_order) {
+      for (ar::Statement* stmt : *bb) {
+        if (stmt->has_result()) {
+          this->number(this->variable_ref(stmt->result()));
+        }
+        for (auto op_it = stmt->op_begin(), op_et = stmt->op_end();
+             op_it != op_et;
+             ++op_it) {
+          Variable* var = this->variable_ref(*op_it);
+          if (var != nullptr) {
+            this->number(var);
+          }
+        }
+      }
+    }
+  }
 
-    this->_live_at_entry_map.try_emplace(bb, pre_live);
+  /// \brief Give a number to the given variable, if it has none
+  void number(Variable* var) {
+    ikos_assert(var != nullptr);
+    if (this->_var_index.try_emplace(var, this->_vars.size()).second) {
+      this->_vars.push_back(var);
+    }
   }
 
-private:
   /// \brief Compute kill/gen sets for each basic blocks
   void init() {
-    ar::Code* code = this->cfg();
+    auto num_vars = static_cast< unsigned >(this->_vars.size());
+    this->_infos.resize(this->_order.size());
+
+    for (unsigned pos = 0; pos < this->_order.size(); pos++) {
+      BlockInfo& info = this->_infos[pos];
+      info.kill.resize(num_vars);
+      info.gen.resize(num_vars);
+      info.all.resize(num_vars);
+      info.live_in.resize(num_vars);
+      info.live_out.resize(num_vars);
+
+      ar::BasicBlock* bb = this->_order[pos];
+      for (auto it = bb->rbegin(), et = bb->rend(); it != et; ++it) {
+        ar::Statement* stmt = *it;
+
+        // Process defs
+        if (stmt->has_result()) {
+          Variable* var = this->variable_ref(stmt->result());
+          ikos_assert_msg(var != nullptr, "result is not a variable");
+          unsigned idx = this->_var_index[var];
+
+          info.kill.set(idx);
+          info.gen.reset(idx);
+          info.all.set(idx);
+        }
 
-    for (auto it = code->begin(), et = code->end(); it != et; ++it) {
-      this->init(*it);
+        // Process uses
+        for (auto op_it = stmt->op_begin(), op_et = stmt->op_end();
+             op_it != op_et;
+             ++op_it) {
+          Variable* var = this->variable_ref(*op_it);
+          if (var != nullptr) {
+            unsigned idx = this->_var_index[var];
+            info.gen.set(idx);
+            info.all.set(idx);
+          }
+        }
+      }
     }
   }
 
-  /// \brief Compute kill/gen sets for the given basic block
-  void init(ar::BasicBlock* bb) {
-    auto kill = LivenessDomainT::empty();
-    auto gen = LivenessDomainT::empty();
-    auto all = LivenessDomainT::empty();
+  /// \brief Compute the least fixpoint
+  void solve() {
+    // Min-heap on the position, to process the blocks in order
+    std::priority_queue< unsigned,
+                         std::vector< unsigned >,
+                         std::greater< unsigned > >
+        worklist;
+    std::vector< bool > in_worklist(this->_order.size(), true);
+    for (unsigned pos = 0; pos < this->_order.size(); pos++) {
+      worklist.push(pos);
+    }
 
-    for (auto it = bb->rbegin(), et = bb->rend(); it != et; ++it) {
-      ar::Statement* stmt = *it;
+    llvm::BitVector live_in;
+    while (!worklist.empty()) {
+      unsigned pos = worklist.top();
+      worklist.pop();
+      in_worklist[pos] = false;
+
+      BlockInfo& info = this->_infos[pos];
+      ar::BasicBlock* bb = this->_order[pos];
+
+      // OUT(B) = U IN(S)
+      for (auto it = bb->successor_begin(), et = bb->successor_end(); it != et;
+           ++it) {
+        auto succ = this->_position.find(*it);
+        if (succ != this->_position.end()) {
+          info.live_out |= this->_infos[succ->second].live_in;
+        }
+      }
 
-      // Process defs
-      if (stmt->has_result()) {
-        Variable* var = this->variable_ref(stmt->result());
-        ikos_assert_msg(var != nullptr, "result is not a variable");
+      // IN(B) = (OUT(B) \ kill(B)) U gen(B)
+      live_in = info.live_out;
+      live_in.reset(info.kill);
+      live_in |= info.gen;
 
-        kill += var;
-        gen -= var;
-        all += var;
+      if (live_in == info.live_in) {
+        continue;
       }
-
-      // Process uses
-      for (auto op_it = stmt->op_begin(), op_et = stmt->op_end();
-           op_it != op_et;
-           ++op_it) {
-        Variable* var = this->variable_ref(*op_it);
-        if (var != nullptr) {
-          gen += var;
-          all += var;
+      std::swap(info.live_in, live_in);
+
+      for (auto it = bb->predecessor_begin(), et = bb->predecessor_end();
+           it != et;
+           ++it) {
+        auto pred = this->_position.find(*it);
+        if (pred != this->_position.end() && !in_worklist[pred->second]) {
+          in_worklist[pred->second] = true;
+          worklist.push(pred->second);
         }
       }
     }
+  }
 
-    this->_kg_map.try_emplace(bb, KillGen{kill, gen});
-    this->_all_vars_map.try_emplace(bb, all);
+  /// \brief Convert a bit-vector into a VariableRefList
+  LivenessAnalysis::VariableRefList to_variable_ref_list(
+      const llvm::BitVector& bits) const {
+    LivenessAnalysis::VariableRefList list;
+    list.reserve(bits.count());
+    for (unsigned idx : bits.set_bits()) {
+      list.push_back(this->_vars[idx]);
+    }
+    return list;
   }
 
   /// \brief Get the Variable* of an ar::Value
@@ -384,7 +340,18 @@ private:
     }
   }
 
-}; // end class LivenessFixpointIterator
+}; // end class LivenessSolver
+
+/// \brief Liveness results of a code
+struct CodeLiveness {
+  /// \brief List of live variables at the entry of each basic block
+  std::vector< std::pair< ar::BasicBlock*, LivenessAnalysis::VariableRefList > >
+      live_at_entry;
+
+  /// \brief List of dead variables at the end of each basic block
+  std::vector< std::pair< ar::BasicBlock*, LivenessAnalysis::VariableRefList > >
+      dead_at_end;
+};
 
 } // end anonymous namespace
 
@@ -412,34 +379,30 @@ boost::optional< const LivenessAnalysis::VariableRefList& > LivenessAnalysis::
   }
 }
 
+void LivenessAnalysis::set_live_at_entry(ar::BasicBlock* bb,
+                                         VariableRefList vars) {
+  this->_live_at_entry_map[bb] = std::move(vars);
+}
+
+void LivenessAnalysis::set_dead_at_end(ar::BasicBlock* bb,
+                                       VariableRefList vars) {
+  this->_dead_at_end_map[bb] = std::move(vars);
+}
+
 void LivenessAnalysis::run() {
   ar::Bundle* bundle = _ctx.bundle;
 
-  // Setup a progress logger
-  std::unique_ptr< ProgressLogger > progress =
-      make_progress_logger(_ctx.opts.progress,
-                           LogLevel::Info,
-                           /* num_tasks = */
-                           std::count_if(bundle->global_begin(),
-                                         bundle->global_end(),
-                                         [](ar::GlobalVariable* gv) {
-                                           return gv->is_definition();
-                                         }) +
-                               std::count_if(bundle->function_begin(),
-                                             bundle->function_end(),
-                                             [](ar::Function* fun) {
-                                               return fun->is_definition();
-                                             }));
-  ScopeLogger scope(*progress);
+  // Codes to analyze, with their progress message
+  std::vector< std::pair< ar::Code*, std::string > > codes;
 
   for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
        ++it) {
     ar::GlobalVariable* gv = *it;
     if (gv->is_definition()) {
-      progress->start_task(
-          "Running liveness analysis on initializer of global variable '" +
-          demangle(gv->name()) + "'");
-      this->run(gv->initializer());
+      codes.emplace_back(gv->initializer(),
+                         "Running liveness analysis on initializer of global "
+                         "variable '" +
+                             demangle(gv->name()) + "'");
     }
   }
 
@@ -448,50 +411,54 @@ void LivenessAnalysis::run() {
        ++it) {
     ar::Function* fun = *it;
     if (fun->is_definition()) {
-      progress->start_task("Running liveness analysis on function '" +
-                           demangle(fun->name()) + "'");
-      this->run(fun->body());
+      codes.emplace_back(fun->body(),
+                         "Running liveness analysis on function '" +
+                             demangle(fun->name()) + "'");
     }
   }
-}
 
-/// \brief Convert a LivenessDomain into a VariableRefList
-static LivenessAnalysis::VariableRefList to_variable_ref_list(
-    const LivenessDomain< Variable* >& value) {
-  LivenessAnalysis::VariableRefList list;
+  // Setup a progress logger
+  std::unique_ptr< ProgressLogger > progress =
+      make_progress_logger(_ctx.opts.progress,
+                           LogLevel::Info,
+                           /* num_tasks = */ codes.size());
+  ScopeLogger scope(*progress);
 
-  if (!value.is_bottom()) {
-    list.reserve(value.size());
-    std::copy(value.begin(), value.end(), std::back_inserter(list));
-  }
+  // Codes are analyzed concurrently, results are stored in order
+  unsigned jobs = num_threads(_ctx.opts.jobs);
+  std::vector< CodeLiveness > pending(codes.size());
 
-  return list;
-}
+  auto analyze = [&](std::size_t i, unsigned /*thread*/) {
+    ar::Code* code = codes[i].first;
+    progress->start_task(codes[i].second);
 
-void LivenessAnalysis::run(ar::Code* code) {
-  // If the code has no exit block, do nothing
-  if (!code->has_exit_block()) {
-    return;
-  }
+    // If the code has no exit block, do nothing
+    if (!code->has_exit_block()) {
+      return;
+    }
 
-  // Run the liveness fixpoint iterator
-  LivenessFixpointIterator fixpoint(code, *_ctx.var_factory);
-  fixpoint.run();
+    LivenessSolver solver(code, *_ctx.var_factory);
+    solver.run();
+    solver.results(pending[i].live_at_entry, pending[i].dead_at_end);
+  };
 
-  // Store the results
-  for (auto it = fixpoint.live_at_entry_begin(),
-            et = fixpoint.live_at_entry_end();
-       it != et;
-       ++it) {
-    this->_live_at_entry_map.try_emplace(it->first,
-                                         to_variable_ref_list(it->second));
-  }
-  for (auto it = fixpoint.dead_at_end_begin(), et = fixpoint.dead_at_end_end();
-       it != et;
-       ++it) {
-    this->_dead_at_end_map.try_emplace(it->first,
-                                       to_variable_ref_list(it->second));
-  }
+  auto commit = [&](std::size_t i) {
+    CodeLiveness& result = pending[i];
+    for (auto& entry : result.live_at_entry) {
+      this->_live_at_entry_map.try_emplace(entry.first,
+                                           std::move(entry.second));
+    }
+    for (auto& entry : result.dead_at_end) {
+      this->_dead_at_end_map.try_emplace(entry.first, std::move(entry.second));
+    }
+    result = CodeLiveness{};
+  };
+
+  parallel_ordered_for(codes.size(),
+                       jobs,
+                       /* window = */ 4 * jobs,
+                       analyze,
+                       commit);
 }
 
 void LivenessAnalysis::dump(std::ostream& o) const {
@@ -519,26 +486,24 @@ void LivenessAnalysis::dump(std::ostream& o) const {
 }
 
 void LivenessAnalysis::dump(std::ostream& o, ar::Code* code) const {
+  ar::Namer namer(code);
+
   for (ar::BasicBlock* bb : *code) {
     // Live at entry
-    o << "live_at_entry(";
-    bb->dump(o);
-    o << ") = ";
+    o << "live_at_entry(#" << namer.name(bb) << ") = ";
     auto it = this->_live_at_entry_map.find(bb);
     if (it != this->_live_at_entry_map.end()) {
-      dump(o, it->second);
+      dump(o, it->second, namer);
     } else {
       o << "none";
     }
     o << "\n";
 
     // Dead at end
-    o << "dead_at_end(";
-    bb->dump(o);
-    o << ") = ";
+    o << "dead_at_end(#" << namer.name(bb) << ") = ";
     it = this->_dead_at_end_map.find(bb);
     if (it != this->_dead_at_end_map.end()) {
-      dump(o, it->second);
+      dump(o, it->second, namer);
     } else {
       o << "none";
     }
@@ -547,10 +512,17 @@ void LivenessAnalysis::dump(std::ostream& o, ar::Code* code) const {
 }
 
 void LivenessAnalysis::dump(std::ostream& o,
-                            const LivenessAnalysis::VariableRefList& vars) {
+                            const LivenessAnalysis::VariableRefList& vars,
+                            const ar::Namer& namer) {
   o << "{";
   for (auto it = vars.begin(), et = vars.end(); it != et;) {
-    (*it)->dump(o);
+    if (auto lv = dyn_cast< LocalVariable >(*it)) {
+      o << "$" << namer.name(lv->local_var());
+    } else if (auto iv = dyn_cast< InternalVariable >(*it)) {
+      o << "%" << namer.name(iv->internal_var());
+    } else {
+      (*it)->dump(o);
+    }
     if (++it != et) {
       o << ", ";
     }
@@ -161,6 +161,7 @@ MemoryFactory::MemoryFactory()
 MemoryFactory::~MemoryFactory() = default;
 
 LocalMemoryLocation* MemoryFactory::get_local(ar::LocalVariable* var) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_local_memory_map.find(var);
   if (it == this->_local_memory_map.end()) {
     auto ml = std::make_unique< LocalMemoryLocation >(var);
@@ -173,6 +174,7 @@ LocalMemoryLocation* MemoryFactory::get_local(ar::LocalVariable* var) {
 }
 
 GlobalMemoryLocation* MemoryFactory::get_global(ar::GlobalVariable* var) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_global_memory_map.find(var);
   if (it == this->_global_memory_map.end()) {
     auto ml = std::make_unique< GlobalMemoryLocation >(var);
@@ -185,6 +187,7 @@ GlobalMemoryLocation* MemoryFactory::get_global(ar::GlobalVariable* var) {
 }
 
 FunctionMemoryLocation* MemoryFactory::get_function(ar::Function* fun) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_function_memory_map.find(fun);
   if (it == this->_function_memory_map.end()) {
     auto ml = std::make_unique< FunctionMemoryLocation >(fun);
@@ -203,6 +206,7 @@ FunctionMemoryLocation* MemoryFactory::get_function(
 
 AggregateMemoryLocation* MemoryFactory::get_aggregate(
     ar::InternalVariable* var) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_aggregate_memory_map.find(var);
   if (it == this->_aggregate_memory_map.end()) {
     auto ml = std::make_unique< AggregateMemoryLocation >(var);
@@ -228,6 +232,7 @@ LibcErrnoMemoryLocation* MemoryFactory::get_libc_errno() {
 
 DynAllocMemoryLocation* MemoryFactory::get_dyn_alloc(ar::CallBase* call,
                                                      CallContext* context) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_dyn_alloc_map.find({call, context});
   if (it == this->_dyn_alloc_map.end()) {
     auto ml = std::make_unique< DynAllocMemoryLocation >(call, context);
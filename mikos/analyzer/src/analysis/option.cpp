@@ -77,9 +77,15 @@ void AnalysisOptions::save(SettingsTable& table) {
                machine_int_domain_option_str(this->machine_int_domain));
 
   table.insert("use-memory-optimization", this->use_memopt);
+  table.insert("memopt-delta-invariants", this->memopt_delta_invariants);
 
   table.insert("procedural", procedural_str(this->procedural));
 
+  table.insert("jobs", std::to_string(this->jobs));
+  table.insert("worker-mem", std::to_string(this->worker_mem));
+  table.insert("memory-limit", std::to_string(this->memory_limit));
+  table.insert("fixpoint-jobs", std::to_string(this->fixpoint_jobs));
+
   table.insert("widening-strategy",
                widening_strategy_str(this->widening_strategy));
 
@@ -109,8 +115,12 @@ void AnalysisOptions::save(SettingsTable& table) {
 
   table.insert("use-fixpoint-cache", this->use_fixpoint_cache);
 
+  table.insert("summary-cache-size", std::to_string(this->summary_cache_size));
+
   table.insert("use-partitioning-domain", this->use_partitioning_domain);
 
+  table.insert("lazy-normalization", this->lazy_normalization);
+
   table.insert("globals-init-policy",
                globals_init_policy_str(this->globals_init_policy));
 
@@ -0,0 +1,910 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Implementation of the persistent cache of the pre-analyses results
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <ikos/ar/format/binary.hpp>
+#include <ikos/ar/semantic/bundle.hpp>
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/semantic/value.hpp>
+
+#include <ikos/analyzer/analysis/call_context.hpp>
+#include <ikos/analyzer/analysis/memory_location.hpp>
+#include <ikos/analyzer/analysis/pointer/value.hpp>
+#include <ikos/analyzer/analysis/preanalysis_cache.hpp>
+#include <ikos/analyzer/analysis/variable.hpp>
+#include <ikos/analyzer/support/assert.hpp>
+#include <ikos/analyzer/support/cast.hpp>
+#include <ikos/analyzer/support/number.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief Magic number at the beginning of a cache entry
+const char Magic[8] = {'I', 'K', 'O', 'S', '-', 'P', 'R', 'E'};
+
+/// \brief Version of the cache entries
+///
+/// This must be incremented whenever the format, the variable kinds or the
+/// memory location kinds change.
+const uint64_t Version = 1;
+
+/// \brief Size of the header: magic, version, payload size and checksum
+const std::size_t HeaderSize = 32;
+
+/// \brief Return the FNV-1a hash of the given buffer
+uint64_t checksum(const char* data, std::size_t size) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (std::size_t i = 0; i < size; i++) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    h ^= static_cast< unsigned char >(data[i]);
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+/// \brief Write a 64-bit little-endian integer at the given position
+void write_u64(char* p, uint64_t n) {
+  for (std::size_t i = 0; i < 8; i++) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    p[i] = static_cast< char >((n >> (8 * i)) & 0xff);
+  }
+}
+
+/// \brief Read a 64-bit little-endian integer at the given position
+uint64_t read_u64(const char* p) {
+  uint64_t n = 0;
+  for (std::size_t i = 0; i < 8; i++) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    n |= uint64_t(static_cast< unsigned char >(p[i])) << (8 * i);
+  }
+  return n;
+}
+
+/// \brief Output buffer
+///
+/// Integers are encoded in LEB128, so that small integers take one byte.
+class Output {
+private:
+  std::string _buf;
+
+public:
+  /// \brief Write an unsigned integer
+  void uint(uint64_t n) {
+    while (n >= 0x80) {
+      this->_buf.push_back(static_cast< char >((n & 0x7f) | 0x80));
+      n >>= 7;
+    }
+    this->_buf.push_back(static_cast< char >(n));
+  }
+
+  /// \brief Write a boolean
+  void boolean(bool b) { this->_buf.push_back(b ? 1 : 0); }
+
+  /// \brief Write an unlimited precision integer
+  void znumber(const ZNumber& n) {
+    std::string s = n.str(16);
+    this->uint(s.size());
+    this->_buf.append(s);
+  }
+
+  /// \brief Write a machine integer
+  void machine_int(const MachineInt& n) {
+    this->znumber(n.to_z_number());
+    this->uint(n.bit_width());
+    this->boolean(n.sign() == Signed);
+  }
+
+  /// \brief Return the content of the buffer
+  const std::string& str() const { return this->_buf; }
+
+}; // end class Output
+
+/// \brief Input buffer
+///
+/// The buffer was validated by its checksum, hence reads are only checked by
+/// assertions.
+class Input {
+private:
+  const char* _cur;
+  const char* _end;
+
+public:
+  /// \brief Constructor
+  Input(const char* begin, const char* end) : _cur(begin), _end(end) {}
+
+  /// \brief Read an unsigned integer
+  uint64_t uint() {
+    uint64_t n = 0;
+    unsigned shift = 0;
+    while (true) {
+      ikos_assert_msg(this->_cur != this->_end, "unexpected end of buffer");
+      auto byte = static_cast< unsigned char >(*this->_cur++);
+      n |= uint64_t(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return n;
+      }
+      shift += 7;
+    }
+  }
+
+  /// \brief Read a boolean
+  bool boolean() {
+    ikos_assert_msg(this->_cur != this->_end, "unexpected end of buffer");
+    return *this->_cur++ != 0;
+  }
+
+  /// \brief Read an unlimited precision integer
+  ZNumber znumber() {
+    auto size = static_cast< std::size_t >(this->uint());
+    ikos_assert_msg(size <= static_cast< std::size_t >(this->_end - this->_cur),
+                    "unexpected end of buffer");
+    std::string s(this->_cur, size);
+    this->_cur += size;
+    return ZNumber::from_string(s, 16);
+  }
+
+  /// \brief Read a machine integer
+  MachineInt machine_int() {
+    ZNumber n = this->znumber();
+    auto bit_width = static_cast< unsigned >(this->uint());
+    Signedness sign = this->boolean() ? Signed : Unsigned;
+    return MachineInt(n, bit_width, sign);
+  }
+
+  /// \brief Return true if the whole buffer was read
+  bool at_end() const { return this->_cur == this->_end; }
+
+}; // end class Input
+
+/// \brief Write a cache entry
+///
+/// The entry is written in a temporary file first, so that concurrent runs
+/// never read a partial cache entry.
+bool write_entry(const boost::filesystem::path& path, const Output& payload) {
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(path.parent_path(), ec);
+  if (ec) {
+    return false;
+  }
+
+  const std::string& data = payload.str();
+  std::array< char, HeaderSize > header{};
+  std::copy(std::begin(Magic), std::end(Magic), header.begin());
+  write_u64(&header[8], Version);
+  write_u64(&header[16], data.size());
+  write_u64(&header[24], checksum(data.data(), data.size()));
+
+  boost::filesystem::path tmp = path;
+  tmp += boost::filesystem::unique_path(".%%%%-%%%%.tmp");
+  {
+    std::ofstream out(tmp.string(), std::ios::out | std::ios::binary);
+    out.write(header.data(), header.size());
+    out.write(data.data(), static_cast< std::streamsize >(data.size()));
+    if (!out) {
+      out.close();
+      boost::filesystem::remove(tmp, ec);
+      return false;
+    }
+  }
+
+  boost::filesystem::rename(tmp, path, ec);
+  if (ec) {
+    boost::filesystem::remove(tmp, ec);
+    return false;
+  }
+  return true;
+}
+
+/// \brief Read a cache entry
+///
+/// Returns null if there is no valid cache entry.
+std::unique_ptr< llvm::MemoryBuffer > read_entry(
+    const boost::filesystem::path& path) {
+  llvm::ErrorOr< std::unique_ptr< llvm::MemoryBuffer > > buffer =
+      llvm::MemoryBuffer::getFile(path.string(),
+                                  /*FileSize = */ -1,
+                                  /*RequiresNullTerminator = */ false);
+  if (!buffer) {
+    return nullptr;
+  }
+
+  const char* data = (*buffer)->getBufferStart();
+  std::size_t size = (*buffer)->getBufferSize();
+  if (size < HeaderSize ||
+      !std::equal(std::begin(Magic), std::end(Magic), data)) {
+    return nullptr;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  const char* payload = data + HeaderSize;
+  if (read_u64(&data[8]) != Version ||
+      read_u64(&data[16]) != size - HeaderSize ||
+      read_u64(&data[24]) != checksum(payload, size - HeaderSize)) {
+    return nullptr;
+  }
+  return std::move(*buffer);
+}
+
+/// \brief Return the input buffer over the payload of a cache entry
+Input payload(const llvm::MemoryBuffer& buffer) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return Input(buffer.getBufferStart() + HeaderSize, buffer.getBufferEnd());
+}
+
+/// \brief Return the hexadecimal MD5 digest of the given strings
+std::string md5(llvm::ArrayRef< llvm::StringRef > strings) {
+  llvm::MD5 hash;
+  for (llvm::StringRef s : strings) {
+    hash.update(s);
+    hash.update(llvm::ArrayRef< uint8_t >{0});
+  }
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  llvm::SmallString< 32 > digest;
+  llvm::MD5::stringifyResult(result, digest);
+  return digest.str().str();
+}
+
+} // end anonymous namespace
+
+/// \brief Index of the objects of the bundle
+///
+/// Objects are numbered in the order of the bundle, which is stable for a
+/// given bundle hash.
+class PreanalysisCache::Index {
+private:
+  std::vector< ar::GlobalVariable* > _globals;
+  std::vector< ar::Function* > _functions;
+  std::vector< ar::LocalVariable* > _locals;
+  std::vector< ar::InternalVariable* > _internals;
+  std::vector< ar::BasicBlock* > _blocks;
+  std::vector< ar::Statement* > _statements;
+  std::vector< ar::InlineAssemblyConstant* > _inline_asms;
+
+  // Map from objects to their index
+  llvm::DenseMap< const void*, uint64_t > _ids;
+
+public:
+  /// \brief Constructor
+  explicit Index(ar::Bundle* bundle) {
+    for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
+         ++it) {
+      this->add(this->_globals, *it);
+    }
+    for (auto it = bundle->function_begin(), et = bundle->function_end();
+         it != et;
+         ++it) {
+      this->add(this->_functions, *it);
+    }
+    for (ar::GlobalVariable* gv : this->_globals) {
+      if (gv->is_definition()) {
+        this->add(gv->initializer());
+      }
+    }
+    for (ar::Function* fun : this->_functions) {
+      for (auto it = fun->local_variable_begin(),
+                et = fun->local_variable_end();
+           it != et;
+           ++it) {
+        this->add(this->_locals, *it);
+      }
+      if (fun->is_definition()) {
+        this->add(fun->body());
+      }
+    }
+  }
+
+  /// \brief Return the function with the given index
+  ar::Function* function(uint64_t id) const { return this->_functions.at(id); }
+
+  /// \brief Return the basic block with the given index
+  ar::BasicBlock* block(uint64_t id) const { return this->_blocks.at(id); }
+
+  /// \brief Return the index of the given object
+  uint64_t id(const void* object) const {
+    auto it = this->_ids.find(object);
+    ikos_assert_msg(it != this->_ids.end(), "object not in the bundle");
+    return it->second;
+  }
+
+  /// \brief Begin iterator over the basic blocks
+  auto block_begin() const { return this->_blocks.begin(); }
+
+  /// \brief End iterator over the basic blocks
+  auto block_end() const { return this->_blocks.end(); }
+
+  /// \brief Return true if the given variable can be saved
+  bool is_saved(Variable* v) const {
+    switch (v->kind()) {
+      case Variable::LocalVariableKind:
+      case Variable::GlobalVariableKind:
+      case Variable::InternalVariableKind:
+      case Variable::FunctionPointerVariableKind:
+      case Variable::ReturnVariableKind:
+        return true;
+      case Variable::InlineAssemblyPointerVariableKind:
+        return this->_ids.count(
+                   cast< InlineAssemblyPointerVariable >(v)->inline_asm()) !=
+               0;
+      default:
+        return false;
+    }
+  }
+
+  /// \brief Write a variable
+  ///
+  /// Precondition: is_saved(v)
+  void write(Output& o, Variable* v) const {
+    o.uint(v->kind());
+    switch (v->kind()) {
+      case Variable::LocalVariableKind: {
+        o.uint(this->id(cast< LocalVariable >(v)->local_var()));
+      } break;
+      case Variable::GlobalVariableKind: {
+        o.uint(this->id(cast< GlobalVariable >(v)->global_var()));
+      } break;
+      case Variable::InternalVariableKind: {
+        o.uint(this->id(cast< InternalVariable >(v)->internal_var()));
+      } break;
+      case Variable::InlineAssemblyPointerVariableKind: {
+        auto asm_ptr = cast< InlineAssemblyPointerVariable >(v);
+        o.uint(this->id(asm_ptr->inline_asm()));
+      } break;
+      case Variable::FunctionPointerVariableKind: {
+        o.uint(this->id(cast< FunctionPointerVariable >(v)->function()));
+      } break;
+      case Variable::ReturnVariableKind: {
+        o.uint(this->id(cast< ReturnVariable >(v)->function()));
+      } break;
+      default: {
+        ikos_unreachable("unexpected variable");
+      }
+    }
+  }
+
+  /// \brief Read a variable
+  Variable* read_variable(Input& in, VariableFactory& vfac) const {
+    auto kind = static_cast< Variable::VariableKind >(in.uint());
+    uint64_t id = in.uint();
+    switch (kind) {
+      case Variable::LocalVariableKind:
+        return vfac.get_local(this->_locals.at(id));
+      case Variable::GlobalVariableKind:
+        return vfac.get_global(this->_globals.at(id));
+      case Variable::InternalVariableKind:
+        return vfac.get_internal(this->_internals.at(id));
+      case Variable::InlineAssemblyPointerVariableKind:
+        return vfac.get_asm_ptr(this->_inline_asms.at(id));
+      case Variable::FunctionPointerVariableKind:
+        return vfac.get_function_ptr(this->_functions.at(id));
+      case Variable::ReturnVariableKind:
+        return vfac.get_return(this->_functions.at(id));
+      default:
+        ikos_unreachable("unexpected variable kind");
+    }
+  }
+
+  /// \brief Write a memory location
+  void write(Output& o, MemoryLocation* ml) const {
+    o.uint(ml->kind());
+    switch (ml->kind()) {
+      case MemoryLocation::LocalMemoryKind: {
+        o.uint(this->id(cast< LocalMemoryLocation >(ml)->local_var()));
+      } break;
+      case MemoryLocation::GlobalMemoryKind: {
+        o.uint(this->id(cast< GlobalMemoryLocation >(ml)->global_var()));
+      } break;
+      case MemoryLocation::FunctionMemoryKind: {
+        o.uint(this->id(cast< FunctionMemoryLocation >(ml)->function()));
+      } break;
+      case MemoryLocation::AggregateMemoryKind: {
+        o.uint(this->id(cast< AggregateMemoryLocation >(ml)->internal_var()));
+      } break;
+      case MemoryLocation::AbsoluteZeroMemoryKind:
+      case MemoryLocation::ArgvMemoryKind:
+      case MemoryLocation::LibcErrnoMemoryKind:
+        break;
+      case MemoryLocation::DynAllocMemoryKind: {
+        auto dyn_alloc = cast< DynAllocMemoryLocation >(ml);
+        o.uint(this->id(dyn_alloc->call()));
+
+        // Calls of the context, starting from the outermost
+        std::vector< ar::CallBase* > calls;
+        for (CallContext* c = dyn_alloc->context(); !c->empty();
+             c = c->parent()) {
+          calls.push_back(c->call());
+        }
+        o.uint(calls.size());
+        for (auto it = calls.rbegin(), et = calls.rend(); it != et; ++it) {
+          o.uint(this->id(*it));
+        }
+      } break;
+      default: {
+        ikos_unreachable("unexpected memory location");
+      }
+    }
+  }
+
+  /// \brief Read a memory location
+  MemoryLocation* read_memory_location(Input& in,
+                                       MemoryFactory& mfac,
+                                       CallContextFactory& cfac) const {
+    auto kind = static_cast< MemoryLocation::MemoryLocationKind >(in.uint());
+    switch (kind) {
+      case MemoryLocation::LocalMemoryKind:
+        return mfac.get_local(this->_locals.at(in.uint()));
+      case MemoryLocation::GlobalMemoryKind:
+        return mfac.get_global(this->_globals.at(in.uint()));
+      case MemoryLocation::FunctionMemoryKind:
+        return mfac.get_function(this->_functions.at(in.uint()));
+      case MemoryLocation::AggregateMemoryKind:
+        return mfac.get_aggregate(this->_internals.at(in.uint()));
+      case MemoryLocation::AbsoluteZeroMemoryKind:
+        return mfac.get_absolute_zero();
+      case MemoryLocation::ArgvMemoryKind:
+        return mfac.get_argv();
+      case MemoryLocation::LibcErrnoMemoryKind:
+        return mfac.get_libc_errno();
+      case MemoryLocation::DynAllocMemoryKind: {
+        auto call = cast< ar::CallBase >(this->_statements.at(in.uint()));
+        CallContext* context = cfac.get_empty();
+        for (uint64_t n = in.uint(); n > 0; n--) {
+          context = cfac.get_context(context,
+                                     cast< ar::CallBase >(
+                                         this->_statements.at(in.uint())));
+        }
+        return mfac.get_dyn_alloc(call, context);
+      }
+      default:
+        ikos_unreachable("unexpected memory location kind");
+    }
+  }
+
+  /// \brief Return true if the given variables can be saved
+  bool is_saved(const LivenessAnalysis::VariableRefList& vars) const {
+    return std::all_of(vars.begin(), vars.end(), [this](Variable* v) {
+      return this->is_saved(v);
+    });
+  }
+
+  /// \brief Write a list of variables
+  ///
+  /// Precondition: is_saved(vars)
+  void write(Output& o, const LivenessAnalysis::VariableRefList& vars) const {
+    o.uint(vars.size());
+    for (Variable* v : vars) {
+      this->write(o, v);
+    }
+  }
+
+  /// \brief Read a list of variables
+  LivenessAnalysis::VariableRefList read_variables(
+      Input& in, VariableFactory& vfac) const {
+    LivenessAnalysis::VariableRefList vars(in.uint());
+    for (Variable*& v : vars) {
+      v = this->read_variable(in, vfac);
+    }
+    return vars;
+  }
+
+  /// \brief Write a pointer abstract value
+  void write(Output& o, const PointerAbsValue& value) const {
+    const MachineIntInterval& offset = value.offset();
+    o.uint(offset.bit_width());
+    o.boolean(offset.sign() == Signed);
+    o.boolean(value.is_bottom());
+    if (value.is_bottom()) {
+      return;
+    }
+
+    const core::Uninitialized& uninitialized = value.uninitialized();
+    if (uninitialized.is_top()) {
+      o.uint(0);
+    } else if (uninitialized.is_initialized()) {
+      o.uint(1);
+    } else {
+      ikos_assert(uninitialized.is_uninitialized());
+      o.uint(2);
+    }
+
+    const core::Nullity& nullity = value.nullity();
+    if (nullity.is_bottom()) {
+      o.uint(0);
+    } else if (nullity.is_top()) {
+      o.uint(1);
+    } else if (nullity.is_null()) {
+      o.uint(2);
+    } else {
+      ikos_assert(nullity.is_non_null());
+      o.uint(3);
+    }
+
+    const PointsToSet& points_to = value.points_to();
+    if (points_to.is_bottom()) {
+      o.uint(0);
+    } else if (points_to.is_top()) {
+      o.uint(1);
+    } else {
+      o.uint(2);
+      o.uint(points_to.size());
+      for (MemoryLocation* ml : points_to) {
+        this->write(o, ml);
+      }
+    }
+
+    o.boolean(offset.is_bottom());
+    if (!offset.is_bottom()) {
+      o.znumber(offset.lb().to_z_number());
+      o.znumber(offset.ub().to_z_number());
+    }
+  }
+
+  /// \brief Read a pointer abstract value
+  PointerAbsValue read_pointer(Input& in,
+                               MemoryFactory& mfac,
+                               CallContextFactory& cfac) const {
+    auto bit_width = static_cast< unsigned >(in.uint());
+    Signedness sign = in.boolean() ? Signed : Unsigned;
+    if (in.boolean()) {
+      return PointerAbsValue::bottom(bit_width, sign);
+    }
+
+    core::Uninitialized uninitialized = core::Uninitialized::top();
+    switch (in.uint()) {
+      case 0:
+        break;
+      case 1: {
+        uninitialized = core::Uninitialized::initialized();
+      } break;
+      case 2: {
+        uninitialized = core::Uninitialized::uninitialized();
+      } break;
+      default: {
+        ikos_unreachable("unexpected uninitialized value");
+      }
+    }
+
+    core::Nullity nullity = core::Nullity::top();
+    switch (in.uint()) {
+      case 0: {
+        nullity = core::Nullity::bottom();
+      } break;
+      case 1:
+        break;
+      case 2: {
+        nullity = core::Nullity::null();
+      } break;
+      case 3: {
+        nullity = core::Nullity::non_null();
+      } break;
+      default: {
+        ikos_unreachable("unexpected nullity value");
+      }
+    }
+
+    PointsToSet points_to = PointsToSet::top();
+    switch (in.uint()) {
+      case 0: {
+        points_to = PointsToSet::bottom();
+      } break;
+      case 1:
+        break;
+      case 2: {
+        points_to = PointsToSet::empty();
+        for (uint64_t n = in.uint(); n > 0; n--) {
+          points_to.add(this->read_memory_location(in, mfac, cfac));
+        }
+      } break;
+      default: {
+        ikos_unreachable("unexpected points-to set");
+      }
+    }
+
+    MachineIntInterval offset = MachineIntInterval::bottom(bit_width, sign);
+    if (!in.boolean()) {
+      ZNumber lb = in.znumber();
+      ZNumber ub = in.znumber();
+      offset = MachineIntInterval(MachineInt(lb, bit_width, sign),
+                                  MachineInt(ub, bit_width, sign));
+    }
+
+    return PointerAbsValue(std::move(uninitialized),
+                           std::move(nullity),
+                           std::move(points_to),
+                           std::move(offset));
+  }
+
+  /// \brief Write the given pointer information
+  ///
+  /// Temporary shadow variables are not saved, since they are only used
+  /// during the analysis that created them.
+  void write(Output& o, const PointerInfo& info) const {
+    o.uint(std::count_if(info.begin(),
+                         info.end(),
+                         [this](const auto& entry) {
+                           return this->is_saved(entry.first);
+                         }));
+    for (const auto& entry : info) {
+      if (this->is_saved(entry.first)) {
+        this->write(o, entry.first);
+        this->write(o, entry.second);
+      }
+    }
+  }
+
+  /// \brief Read pointer information
+  void read(Input& in, PointerInfo& info, Context& ctx) const {
+    info.clear();
+    for (uint64_t n = in.uint(); n > 0; n--) {
+      Variable* v = this->read_variable(in, *ctx.var_factory);
+      info.insert(v,
+                  this->read_pointer(in,
+                                     *ctx.mem_factory,
+                                     *ctx.call_context_factory));
+    }
+  }
+
+private:
+  /// \brief Number the given object
+  template < typename T >
+  void add(std::vector< T* >& objects, T* object) {
+    if (this->_ids.try_emplace(object, objects.size()).second) {
+      objects.push_back(object);
+    }
+  }
+
+  /// \brief Number the objects of the given code
+  void add(ar::Code* code) {
+    for (auto it = code->internal_variable_begin(),
+              et = code->internal_variable_end();
+         it != et;
+         ++it) {
+      this->add(this->_internals, *it);
+    }
+    for (ar::BasicBlock* bb : *code) {
+      this->add(this->_blocks, bb);
+      for (ar::Statement* stmt : *bb) {
+        this->add(this->_statements, stmt);
+        for (auto op = stmt->op_begin(), et = stmt->op_end(); op != et; ++op) {
+          if (auto cst = dyn_cast< ar::InlineAssemblyConstant >(*op)) {
+            this->add(this->_inline_asms, cst);
+          }
+        }
+      }
+    }
+  }
+
+}; // end class PreanalysisCache::Index
+
+// PreanalysisCache
+
+PreanalysisCache::PreanalysisCache(Context& ctx,
+                                   boost::filesystem::path directory,
+                                   llvm::StringRef options)
+    : _ctx(ctx), _directory(std::move(directory)) {
+  std::ostringstream bundle;
+  ar::BinaryWriter().write(bundle, ctx.bundle);
+  this->_digest = md5({bundle.str(), options});
+}
+
+PreanalysisCache::~PreanalysisCache() = default;
+
+PreanalysisCache::Index& PreanalysisCache::index() {
+  if (!this->_index) {
+    this->_index = std::make_unique< Index >(this->_ctx.bundle);
+  }
+  return *this->_index;
+}
+
+boost::filesystem::path PreanalysisCache::path(llvm::StringRef name,
+                                               llvm::StringRef options) const {
+  return this->_directory / (md5({this->_digest, name, options}) + "." +
+                             name.str());
+}
+
+std::string PreanalysisCache::pointer_options() {
+  const AnalysisOptions& opts = this->_ctx.opts;
+  const Index& index = this->index();
+  std::ostringstream o;
+  o << static_cast< int >(opts.widening_strategy) << ":"
+    << static_cast< int >(opts.narrowing_strategy) << ":"
+    << opts.widening_delay << ":" << opts.widening_period << ":";
+  if (opts.narrowing_iterations) {
+    o << *opts.narrowing_iterations;
+  }
+  o << ":";
+  for (const auto& p : opts.widening_delay_functions) {
+    o << index.id(p.first) << "=" << p.second << ",";
+  }
+  o << ":" << opts.use_liveness << ":" << opts.use_widening_hints;
+  return o.str();
+}
+
+bool PreanalysisCache::load(LivenessAnalysis& liveness) {
+  std::unique_ptr< llvm::MemoryBuffer > buffer =
+      read_entry(this->path("liveness", ""));
+  if (!buffer) {
+    return false;
+  }
+
+  const Index& index = this->index();
+  Input in = payload(*buffer);
+  for (uint64_t n = in.uint(); n > 0; n--) {
+    ar::BasicBlock* bb = index.block(in.uint());
+    if (in.boolean()) {
+      liveness.set_live_at_entry(bb,
+                                 index.read_variables(in,
+                                                      *this->_ctx.var_factory));
+    }
+    if (in.boolean()) {
+      liveness.set_dead_at_end(bb,
+                               index.read_variables(in,
+                                                    *this->_ctx.var_factory));
+    }
+  }
+  ikos_assert(in.at_end());
+  return true;
+}
+
+bool PreanalysisCache::save(const LivenessAnalysis& liveness) {
+  const Index& index = this->index();
+  Output o;
+  o.uint(std::distance(index.block_begin(), index.block_end()));
+  for (auto it = index.block_begin(), et = index.block_end(); it != et; ++it) {
+    ar::BasicBlock* bb = *it;
+    o.uint(index.id(bb));
+
+    auto live = liveness.live_at_entry(bb);
+    if (live && !index.is_saved(*live)) {
+      return false;
+    }
+    o.boolean(static_cast< bool >(live));
+    if (live) {
+      index.write(o, *live);
+    }
+
+    auto dead = liveness.dead_at_end(bb);
+    if (dead && !index.is_saved(*dead)) {
+      return false;
+    }
+    o.boolean(static_cast< bool >(dead));
+    if (dead) {
+      index.write(o, *dead);
+    }
+  }
+  return write_entry(this->path("liveness", ""), o);
+}
+
+bool PreanalysisCache::load_widening_hints(FixpointParameters& parameters) {
+  std::unique_ptr< llvm::MemoryBuffer > buffer =
+      read_entry(this->path("widening-hints", ""));
+  if (!buffer) {
+    return false;
+  }
+
+  const Index& index = this->index();
+  Input in = payload(*buffer);
+  for (uint64_t n = in.uint(); n > 0; n--) {
+    ar::BasicBlock* head = index.block(in.uint());
+    MachineInt hint = in.machine_int();
+    parameters.get(head->code()->function())
+        .widening_hints.add(head, std::move(hint));
+  }
+  ikos_assert(in.at_end());
+  return true;
+}
+
+bool PreanalysisCache::save_widening_hints(FixpointParameters& parameters) {
+  ar::Bundle* bundle = this->_ctx.bundle;
+  const Index& index = this->index();
+
+  // Collect the hints first, to write their number
+  std::vector< std::pair< ar::BasicBlock*, const MachineInt* > > hints;
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    ar::Function* fun = *it;
+    if (fun->is_definition()) {
+      for (const auto& hint : parameters.get(fun).widening_hints) {
+        hints.emplace_back(hint.first, &hint.second);
+      }
+    }
+  }
+
+  Output o;
+  o.uint(hints.size());
+  for (const auto& hint : hints) {
+    o.uint(index.id(hint.first));
+    o.machine_int(*hint.second);
+  }
+  return write_entry(this->path("widening-hints", ""), o);
+}
+
+bool PreanalysisCache::load(FunctionPointerAnalysis& function_pointer) {
+  std::unique_ptr< llvm::MemoryBuffer > buffer =
+      read_entry(this->path("function-pointer", ""));
+  if (!buffer) {
+    return false;
+  }
+
+  Input in = payload(*buffer);
+  this->index().read(in, function_pointer.results(), this->_ctx);
+  ikos_assert(in.at_end());
+  return true;
+}
+
+bool PreanalysisCache::save(const FunctionPointerAnalysis& function_pointer) {
+  Output o;
+  this->index().write(o, function_pointer.results());
+  return write_entry(this->path("function-pointer", ""), o);
+}
+
+bool PreanalysisCache::load(PointerAnalysis& pointer) {
+  std::unique_ptr< llvm::MemoryBuffer > buffer =
+      read_entry(this->path("pointer", this->pointer_options()));
+  if (!buffer) {
+    return false;
+  }
+
+  Input in = payload(*buffer);
+  this->index().read(in, pointer.results(), this->_ctx);
+  ikos_assert(in.at_end());
+  return true;
+}
+
+bool PreanalysisCache::save(const PointerAnalysis& pointer) {
+  Output o;
+  this->index().write(o, pointer.results());
+  return write_entry(this->path("pointer", this->pointer_options()), o);
+}
+
+} // end namespace analyzer
+} // end namespace ikos
@@ -50,6 +50,7 @@
 
 #include <ikos/analyzer/analysis/value/abstract_domain.hpp>
 #include <ikos/analyzer/analysis/value/machine_int_domain.hpp>
+#include <ikos/analyzer/exception.hpp>
 
 namespace ikos {
 namespace analyzer {
@@ -57,6 +58,8 @@ namespace value {
 
 namespace {
 
+#ifndef IKOS_STATIC_DOMAIN
+
 /// \brief Uninitialized abstract domain
 using UninitializedAbstractDomain =
     core::uninitialized::SeparateDomain< Variable* >;
@@ -87,6 +90,8 @@ using ValueAbstractDomain = core::memory::ValueDomain< Variable*,
 using PartitioningAbstractDomain = core::memory::
     PartitioningDomain< Variable*, MemoryLocation*, ValueAbstractDomain >;
 
+#endif // IKOS_STATIC_DOMAIN
+
 /// \brief Create the bottom memory abstract value
 MemoryAbstractDomain make_bottom_memory_abstract_value(Context& ctx) {
   auto inv = ValueAbstractDomain(
@@ -97,11 +102,18 @@ MemoryAbstractDomain make_bottom_memory_abstract_value(Context& ctx) {
                            NullityAbstractDomain::bottom()),
       LifetimeAbstractDomain::bottom());
 
+#ifdef IKOS_STATIC_DOMAIN
+  if (ctx.opts.use_partitioning_domain) {
+    throw LogicError("ikos was compiled without the partitioning domain");
+  }
+  return inv;
+#else
   if (ctx.opts.use_partitioning_domain) {
     return MemoryAbstractDomain(PartitioningAbstractDomain(inv));
   } else {
     return MemoryAbstractDomain(inv);
   }
+#endif
 }
 
 /// \brief Create the top memory abstract value
@@ -114,11 +126,18 @@ MemoryAbstractDomain make_top_memory_abstract_value(Context& ctx) {
                            NullityAbstractDomain::top()),
       LifetimeAbstractDomain::top());
 
+#ifdef IKOS_STATIC_DOMAIN
+  if (ctx.opts.use_partitioning_domain) {
+    throw LogicError("ikos was compiled without the partitioning domain");
+  }
+  return inv;
+#else
   if (ctx.opts.use_partitioning_domain) {
     return MemoryAbstractDomain(PartitioningAbstractDomain(inv));
   } else {
     return MemoryAbstractDomain(inv);
   }
+#endif
 }
 
 } // end anonymous namespace
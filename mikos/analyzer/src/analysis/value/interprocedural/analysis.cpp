@@ -44,6 +44,9 @@
 #include <memory>
 #include <vector>
 
+#include <ikos/core/domain/copy_on_write.hpp>
+#include <ikos/core/domain/normalization.hpp>
+
 #include <ikos/analyzer/analysis/value/abstract_domain.hpp>
 #include <ikos/analyzer/analysis/value/global_variable.hpp>
 #include <ikos/analyzer/analysis/value/interprocedural/function_fixpoint.hpp>
@@ -53,8 +56,11 @@
 #include <ikos/analyzer/analysis/value/interprocedural/analysis.hpp>
 #include <ikos/analyzer/analysis/value/interprocedural/progress.hpp>
 #include <ikos/analyzer/checker/checker.hpp>
+#include <ikos/analyzer/database/output.hpp>
 #include <ikos/analyzer/util/demangle.hpp>
 #include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/memory.hpp>
+#include <ikos/analyzer/util/parallel.hpp>
 #include <ikos/analyzer/util/progress.hpp>
 #include <ikos/analyzer/util/timer.hpp>
 
@@ -63,6 +69,28 @@ namespace analyzer {
 namespace value {
 namespace interprocedural {
 
+namespace {
+
+/// \brief Analysis of an entry point, waiting to be committed in the database
+struct PendingEntryPoint {
+  /// \brief Checks recorded during the analysis
+  ChecksTable::Buffer checks;
+
+  /// \brief Time spent in the fixpoint
+  Timer::Duration value_time;
+
+  /// \brief Time spent in the checks (without memopt)
+  Timer::Duration check_time;
+
+  /// \brief Number of calls that used a function summary
+  std::size_t summary_hits = 0;
+
+  /// \brief Number of calls that did not find a function summary
+  std::size_t summary_misses = 0;
+};
+
+} // end anonymous namespace
+
 Analysis::Analysis(Context& ctx)
     : _ctx(ctx) {}
 
@@ -72,12 +100,55 @@ void Analysis::run() {
   // Bundle
   ar::Bundle* bundle = _ctx.bundle;
 
+  // Normalization policy of the variable packing domains
+  core::LazyNormalization::enable(_ctx.opts.lazy_normalization);
+
   // Create checkers
   std::vector< std::unique_ptr< Checker > > checkers;
   for (CheckerName name : _ctx.opts.analyses) {
     checkers.emplace_back(make_checker(_ctx, name));
   }
 
+  // Caches of function summaries
+  //
+  // Summaries refer to the call stack of the analyzed entry point, hence each
+  // entry point (or global constructor and destructor) uses its own cache.
+  //
+  // With memopt, checks are run during the analysis of the callees, hence
+  // callees cannot be skipped.
+  bool use_summary_cache =
+      _ctx.opts.summary_cache_size > 0 && !_ctx.opts.use_memopt;
+  std::size_t summary_hits = 0;
+  std::size_t summary_misses = 0;
+
+  auto make_summary_cache = [&] {
+    std::unique_ptr< FunctionFixpoint::FunctionSummaryCacheT > summary_cache;
+    if (use_summary_cache) {
+      summary_cache =
+          std::make_unique< FunctionFixpoint::FunctionSummaryCacheT >(
+              _ctx.opts.summary_cache_size);
+    }
+    return summary_cache;
+  };
+
+  auto record_summary_cache =
+      [&](const std::unique_ptr< FunctionFixpoint::FunctionSummaryCacheT >&
+              summary_cache) {
+        if (summary_cache) {
+          summary_hits += summary_cache->hits();
+          summary_misses += summary_cache->misses();
+        }
+      };
+
+  // Memory budget
+  //
+  // With memopt, cached callee analyzers are released when it is exceeded.
+  std::unique_ptr< MemoryBudget > memory_budget;
+  if (_ctx.opts.memory_limit > 0 && _ctx.opts.use_memopt) {
+    memory_budget = std::make_unique< MemoryBudget >(
+        static_cast< std::size_t >(_ctx.opts.memory_limit) * 1024UL * 1024UL);
+  }
+
   // Initial invariant
   AbstractDomain init_inv = make_initial_abstract_value(_ctx);
 
@@ -142,7 +213,13 @@ void Analysis::run() {
       ScopeLogger scope(*logger);
 
       // Create a function fixpoint
-      FunctionFixpoint fixpoint(_ctx, checkers, *logger, ctor);
+      std::unique_ptr< FunctionFixpoint::FunctionSummaryCacheT >
+          summary_cache = make_summary_cache();
+      FunctionFixpoint fixpoint(_ctx,
+                                checkers,
+                                *logger,
+                                ctor,
+                                summary_cache.get());
 
       {
         log::info("Analyzing global constructor '" + demangle(ctor->name()) +
@@ -161,6 +238,7 @@ void Analysis::run() {
       }
 
       init_inv = fixpoint.exit_invariant();
+      record_summary_cache(summary_cache);
     }
 
     if (_ctx.opts.display_invariants == DisplayOption::All) {
@@ -171,15 +249,19 @@ void Analysis::run() {
     }
   }
 
-  // Analyze each entry point
+  // Entry points with an implementation
+  std::vector< ar::Function* > entry_points;
   for (ar::Function* entry_point : _ctx.opts.entry_points) {
     if (!entry_point->is_definition()) {
       log::error("missing implementation of function '" + entry_point->name() +
                  "'");
       continue;
     }
+    entry_points.push_back(entry_point);
+  }
 
-    // Entry point initial invariant
+  // Return the initial invariant of an entry point
+  auto entry_invariant = [&](ar::Function* entry_point) {
     AbstractDomain entry_inv = make_bottom_abstract_value(_ctx);
 
     if (std::find(_ctx.opts.no_init_globals.begin(),
@@ -196,40 +278,176 @@ void Analysis::run() {
       entry_inv = init_main_invariant(_ctx, entry_point, entry_inv);
     }
 
-    // Setup a progress logger
-    std::unique_ptr< interprocedural::ProgressLogger > logger =
-        make_progress_logger(_ctx, _ctx.opts.progress, LogLevel::Info);
-    ScopeLogger scope(*logger);
+    return entry_inv;
+  };
+
+  // Number of threads
+  unsigned jobs = num_threads(_ctx.opts.jobs);
+
+  if (jobs > 1 && entry_points.size() > 1) {
+    // Copies of the initial invariant share its representation across
+    // threads, so it is normalized beforehand, and then only read.
+    init_inv.normalize();
+
+    // Analyze entry points concurrently
+    //
+    // Entry points are independent: they all start from the invariant after
+    // the global initialization, and they only share read-only results (AR,
+    // pointer analysis, liveness). Checks are written in the database in the
+    // order of the entry points, so that the output database does not depend
+    // on the number of threads.
+
+    // Checkers might hold a state, so each thread has its own set of checkers
+    std::vector< std::vector< std::unique_ptr< Checker > > > thread_checkers(
+        jobs);
+    for (auto& worker_checkers : thread_checkers) {
+      for (CheckerName name : _ctx.opts.analyses) {
+        worker_checkers.emplace_back(make_checker(_ctx, name));
+      }
+    }
 
-    if (_ctx.opts.use_memopt) {
-      // Create a function fixpoint
-      memory::FunctionFixpoint fixpoint(_ctx, checkers, *logger, entry_point);
+    // The interactive progress logger shows a single call stack, so threads
+    // only report the entry points they start
+    std::vector< std::unique_ptr< interprocedural::ProgressLogger > >
+        thread_loggers(jobs);
+    for (auto& logger : thread_loggers) {
+      logger = make_progress_logger(_ctx, ProgressOption::None, LogLevel::Info);
+    }
 
-      {
-        log::info("[MIKOS] Analyzing entry point '" + demangle(entry_point->name()) +
-                  "'");
-        ScopeTimerDatabase t(_ctx.output_db->times,
-                             "ikos-analyzer.value." + entry_point->name());
-        fixpoint.run(entry_inv);
-      }
-    } else {
-      // Create a function fixpoint
-      FunctionFixpoint fixpoint(_ctx, checkers, *logger, entry_point);
+    std::unique_ptr< analyzer::ProgressLogger > progress =
+        make_progress_logger(_ctx.opts.progress,
+                             LogLevel::Info,
+                             /* num_tasks = */ entry_points.size());
+    ScopeLogger scope(*progress);
+
+    std::vector< PendingEntryPoint > pending(entry_points.size());
+
+    auto analyze = [&](std::size_t i, unsigned thread) {
+      ar::Function* entry_point = entry_points[i];
+      PendingEntryPoint& result = pending[i];
+      ChecksTable::ScopeBuffer buffer(result.checks);
+      Timer timer;
+
+      if (_ctx.opts.use_memopt) {
+        memory::FunctionFixpoint fixpoint(_ctx,
+                                          thread_checkers[thread],
+                                          *thread_loggers[thread],
+                                          entry_point,
+                                          memory_budget.get());
+
+        progress->start_task("[MIKOS] Analyzing entry point '" +
+                             demangle(entry_point->name()) + "'");
+        timer.start();
+        fixpoint.run(entry_invariant(entry_point));
+        timer.stop();
+        result.value_time = timer.elapsed();
+      } else {
+        // Checks are run by the thread, so that the invariants are released
+        // before the next entry point
+        std::unique_ptr< FunctionFixpoint::FunctionSummaryCacheT >
+            summary_cache = make_summary_cache();
+        FunctionFixpoint fixpoint(_ctx,
+                                  thread_checkers[thread],
+                                  *thread_loggers[thread],
+                                  entry_point,
+                                  summary_cache.get());
+
+        progress->start_task("Analyzing entry point '" +
+                             demangle(entry_point->name()) + "'");
+        timer.start();
+        fixpoint.run(entry_invariant(entry_point));
+        timer.stop();
+        result.value_time = timer.elapsed();
+
+        timer.start();
+        fixpoint.run_checks();
+        timer.stop();
+        result.check_time = timer.elapsed();
 
-      {
-        log::info("Analyzing entry point '" + demangle(entry_point->name()) +
-                  "'");
-        ScopeTimerDatabase t(_ctx.output_db->times,
-                             "ikos-analyzer.value." + entry_point->name());
-        fixpoint.run(entry_inv);
+        if (summary_cache) {
+          result.summary_hits = summary_cache->hits();
+          result.summary_misses = summary_cache->misses();
+        }
+      }
+    };
+
+    auto commit = [&](std::size_t i) {
+      ar::Function* entry_point = entry_points[i];
+      PendingEntryPoint& result = pending[i];
+
+      _ctx.output_db->checks.flush(result.checks);
+      _ctx.output_db->times.insert("ikos-analyzer.value." +
+                                       entry_point->name(),
+                                   result.value_time.count());
+      if (!_ctx.opts.use_memopt) {
+        _ctx.output_db->times.insert("ikos-analyzer.check." +
+                                         entry_point->name(),
+                                     result.check_time.count());
       }
+      summary_hits += result.summary_hits;
+      summary_misses += result.summary_misses;
+    };
+
+    parallel_ordered_for(entry_points.size(),
+                         jobs,
+                         /* window = */ 2 * jobs,
+                         analyze,
+                         commit,
+                         /* worker_memory = */ _ctx.opts.worker_mem * 1024UL *
+                             1024UL);
+  } else {
+    // Analyze each entry point
+    for (ar::Function* entry_point : entry_points) {
+      // Entry point initial invariant
+      AbstractDomain entry_inv = entry_invariant(entry_point);
 
-      {
-        log::info("Checking properties for entry point '" +
-                  demangle(entry_point->name()) + "'");
-        ScopeTimerDatabase t(_ctx.output_db->times,
-                             "ikos-analyzer.check." + entry_point->name());
-        fixpoint.run_checks();
+      // Setup a progress logger
+      std::unique_ptr< interprocedural::ProgressLogger > logger =
+          make_progress_logger(_ctx, _ctx.opts.progress, LogLevel::Info);
+      ScopeLogger scope(*logger);
+
+      if (_ctx.opts.use_memopt) {
+        // Create a function fixpoint
+        memory::FunctionFixpoint fixpoint(_ctx,
+                                          checkers,
+                                          *logger,
+                                          entry_point,
+                                          memory_budget.get());
+
+        {
+          log::info("[MIKOS] Analyzing entry point '" +
+                    demangle(entry_point->name()) + "'");
+          ScopeTimerDatabase t(_ctx.output_db->times,
+                               "ikos-analyzer.value." + entry_point->name());
+          fixpoint.run(entry_inv);
+        }
+      } else {
+        // Create a function fixpoint
+        std::unique_ptr< FunctionFixpoint::FunctionSummaryCacheT >
+            summary_cache = make_summary_cache();
+        FunctionFixpoint fixpoint(_ctx,
+                                  checkers,
+                                  *logger,
+                                  entry_point,
+                                  summary_cache.get());
+
+        {
+          log::info("Analyzing entry point '" + demangle(entry_point->name()) +
+                    "'");
+          ScopeTimerDatabase t(_ctx.output_db->times,
+                               "ikos-analyzer.value." + entry_point->name());
+          fixpoint.run(entry_inv);
+        }
+
+        {
+          log::info("Checking properties for entry point '" +
+                    demangle(entry_point->name()) + "'");
+          ScopeTimerDatabase t(_ctx.output_db->times,
+                               "ikos-analyzer.check." + entry_point->name());
+          fixpoint.run_checks();
+        }
+
+        record_summary_cache(summary_cache);
       }
     }
   }
@@ -256,7 +474,13 @@ void Analysis::run() {
       ScopeLogger scope(*logger);
 
       // Create a function fixpoint
-      FunctionFixpoint fixpoint(_ctx, checkers, *logger, dtor);
+      std::unique_ptr< FunctionFixpoint::FunctionSummaryCacheT >
+          summary_cache = make_summary_cache();
+      FunctionFixpoint fixpoint(_ctx,
+                                checkers,
+                                *logger,
+                                dtor,
+                                summary_cache.get());
 
       {
         log::info("Analyzing global destructor '" + demangle(dtor->name()) +
@@ -276,6 +500,7 @@ void Analysis::run() {
       }
 
       init_inv = fixpoint.exit_invariant();
+      record_summary_cache(summary_cache);
     }
   }
 
@@ -285,6 +510,24 @@ void Analysis::run() {
        ++it) {
     _ctx.output_db->functions.insert(*it);
   }
+
+  if (use_summary_cache) {
+    _ctx.output_db->statistics.insert("summary-cache.hits", summary_hits);
+    _ctx.output_db->statistics.insert("summary-cache.misses", summary_misses);
+  }
+
+  if (memory_budget) {
+    _ctx.output_db->statistics.insert("memory-limit.evictions",
+                                      memory_budget->evictions());
+  }
+
+  _ctx.output_db->statistics.insert("copy-on-write.avoided-copies",
+                                    core::CopyOnWriteStats::avoided_copies());
+  _ctx.output_db->statistics.insert("normalization.closures",
+                                    core::LazyNormalization::closures());
+  _ctx.output_db->statistics.insert(
+      "normalization.avoided-closures",
+      core::LazyNormalization::avoided_closures());
 }
 
 } // end namespace interprocedural
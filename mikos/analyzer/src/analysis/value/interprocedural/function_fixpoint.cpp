@@ -53,13 +53,15 @@ FunctionFixpoint::FunctionFixpoint(
     Context& ctx,
     const std::vector< std::unique_ptr< Checker > >& checkers,
     ProgressLogger& logger,
-    ar::Function* entry_point)
+    ar::Function* entry_point,
+    FunctionSummaryCacheT* summary_cache)
     : FwdFixpointIterator(entry_point->body(), make_bottom_abstract_value(ctx)),
       _function(entry_point),
       _call_context(ctx.call_context_factory->get_empty()),
       _fixpoint_parameters(ctx.fixpoint_parameters->get(entry_point)),
       _checkers(checkers),
       _logger(logger),
+      _summary_cache(summary_cache),
       _exec_engine(make_bottom_abstract_value(ctx),
                    ctx,
                    this->_call_context,
@@ -87,6 +89,7 @@ FunctionFixpoint::FunctionFixpoint(Context& ctx,
       _fixpoint_parameters(ctx.fixpoint_parameters->get(callee)),
       _checkers(caller._checkers),
       _logger(caller._logger),
+      _summary_cache(caller._summary_cache),
       _exec_engine(make_bottom_abstract_value(ctx),
                    ctx,
                    this->_call_context,
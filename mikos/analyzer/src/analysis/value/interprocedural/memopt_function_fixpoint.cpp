@@ -50,7 +50,8 @@ FunctionFixpoint::FunctionFixpoint(
     Context& ctx,
     const std::vector< std::unique_ptr< Checker > >& checkers,
     ProgressLogger& logger,
-    ar::Function* entry_point)
+    ar::Function* entry_point,
+    MemoryBudget* memory_budget)
     : FwdFixpointIterator(entry_point->body(), make_bottom_abstract_value(ctx), checkers, /*defer_checks=*/false),
       _function(entry_point),
       _call_context(ctx.call_context_factory->get_empty()),
@@ -68,7 +69,10 @@ FunctionFixpoint::FunctionFixpoint(
       _call_exec_engine(ctx,
                         _exec_engine,
                         *this,
-                        make_bottom_abstract_value(ctx)) {}
+                        make_bottom_abstract_value(ctx)),
+      _memory_budget(memory_budget) {
+  this->set_delta_pre(ctx.opts.memopt_delta_invariants);
+}
 
 FunctionFixpoint::FunctionFixpoint(Context& ctx,
                                    const FunctionFixpoint& caller,
@@ -93,7 +97,10 @@ FunctionFixpoint::FunctionFixpoint(Context& ctx,
       _call_exec_engine(ctx,
                         _exec_engine,
                         *this,
-                        make_bottom_abstract_value(ctx)) {}
+                        make_bottom_abstract_value(ctx)),
+      _memory_budget(caller._memory_budget) {
+  this->set_delta_pre(ctx.opts.memopt_delta_invariants);
+}
 
 void FunctionFixpoint::run(AbstractDomain inv) {
   if (!this->_call_context->empty()) {
@@ -281,6 +288,22 @@ void FunctionFixpoint::process_post(ar::BasicBlock* bb,
 }
 
 void FunctionFixpoint::run_deferred_checks(ar::BasicBlock* bb) {
+  if (this->use_delta_pre()) {
+    if (!this->has_pre(bb)) {
+      // Already checked, as the predecessor of a derived pre invariant
+      return;
+    }
+    // Replaying the chain of predecessors materializes the pre invariant
+    std::vector< ar::BasicBlock* > bases;
+    for (ar::BasicBlock* base = this->delta_pre_base_of(bb); base != nullptr;
+         base = this->delta_pre_base_of(base)) {
+      bases.push_back(base);
+    }
+    for (auto it = bases.rbegin(), et = bases.rend(); it != et; ++it) {
+      this->run_deferred_checks(*it);
+    }
+  }
+
   this->_exec_engine.set_inv(std::move(this->pre(bb)));
   this->erase_pre(bb);
   this->_call_exec_engine.set_defer_checks(false);
@@ -309,8 +332,59 @@ void FunctionFixpoint::run_deferred_checks(ar::BasicBlock* bb) {
   }
 
   this->_call_cache.erase(bb);
+  this->_uncached_calls.erase(bb);
 
   this->_exec_engine.exec_leave(bb);
+
+  if (this->use_delta_pre()) {
+    // analyze_edge() overwrites the invariant of the execution engine
+    AbstractDomain post = std::move(this->_exec_engine.inv());
+    this->materialize_delta_pre(bb, post);
+  }
+}
+
+void FunctionFixpoint::append_to_callee_cache(
+    ar::BasicBlock* bb, std::unique_ptr< FunctionFixpoint >& callee) {
+  if (this->_uncached_calls.count(bb) != 0) {
+    callee.reset();
+    return;
+  }
+
+  if (this->_memory_budget == nullptr || !this->wto().has_check(bb) ||
+      !this->_memory_budget->exceeded()) {
+    this->_callee_cache[bb].emplace_back(std::move(callee));
+    return;
+  }
+
+  // The memory budget is exceeded: release the cached calls of the blocks
+  // with a cached pre invariant. run_deferred_checks() analyzes them again.
+  //
+  // Calls of a block are either all cached or all analyzed again, otherwise
+  // the checks of a callee would be run twice.
+  std::size_t evictions = 1;
+  callee.reset();
+  this->_uncached_calls.insert(bb);
+
+  for (auto it = this->_callee_cache.begin(); it != this->_callee_cache.end();) {
+    if (this->wto().has_check(it->first)) {
+      evictions += it->second.size();
+      this->_uncached_calls.insert(it->first);
+      it = this->_callee_cache.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = this->_call_cache.begin(); it != this->_call_cache.end();) {
+    if (this->wto().has_check(it->first)) {
+      evictions += it->second.size();
+      this->_uncached_calls.insert(it->first);
+      it = this->_call_cache.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  this->_memory_budget->add_evictions(evictions);
 }
 
 void FunctionFixpoint::run_deferred_checks_in_callees(ar::BasicBlock* bb) {
@@ -331,8 +405,13 @@ void FunctionFixpoint::run_all_deferred_checks() {
   for (auto& p : this->pre()) {
     pre.push_back(p.first);
   }
+  for (auto& p : this->delta_pre()) {
+    pre.push_back(p.first);
+  }
   for (auto node : pre) {
-    run_deferred_checks(node);
+    if (this->has_pre(node)) {
+      run_deferred_checks(node);
+    }
   }
   this->clear_pre();
 
@@ -44,13 +44,18 @@
 #include <memory>
 #include <vector>
 
+#include <ikos/core/domain/copy_on_write.hpp>
+#include <ikos/core/domain/normalization.hpp>
+
 #include <ikos/analyzer/analysis/value/abstract_domain.hpp>
 #include <ikos/analyzer/analysis/value/intraprocedural/function_fixpoint.hpp>
 #include <ikos/analyzer/analysis/value/intraprocedural/memopt_function_fixpoint.hpp>
 #include <ikos/analyzer/analysis/value/intraprocedural/analysis.hpp>
 #include <ikos/analyzer/checker/checker.hpp>
+#include <ikos/analyzer/database/output.hpp>
 #include <ikos/analyzer/util/demangle.hpp>
 #include <ikos/analyzer/util/log.hpp>
+#include <ikos/analyzer/util/parallel.hpp>
 #include <ikos/analyzer/util/progress.hpp>
 #include <ikos/analyzer/util/timer.hpp>
 
@@ -59,6 +64,22 @@ namespace analyzer {
 namespace value {
 namespace intraprocedural {
 
+namespace {
+
+/// \brief Analysis of a function, waiting to be committed in the database
+struct PendingFunction {
+  /// \brief Fixpoint, waiting for the checks (without memopt)
+  std::unique_ptr< FunctionFixpoint > fixpoint;
+
+  /// \brief Checks recorded during the analysis (memopt with several jobs)
+  ChecksTable::Buffer checks;
+
+  /// \brief Time spent in the fixpoint
+  Timer::Duration time;
+};
+
+} // end anonymous namespace
+
 Analysis::Analysis(Context& ctx)
     : _ctx(ctx) {}
 
@@ -68,70 +89,123 @@ void Analysis::run() {
   // Bundle
   ar::Bundle* bundle = _ctx.bundle;
 
+  // Normalization policy of the variable packing domains
+  core::LazyNormalization::enable(_ctx.opts.lazy_normalization);
+
+  // Number of threads
+  unsigned jobs = num_threads(_ctx.opts.jobs);
+
   // Create checkers
-  std::vector< std::unique_ptr< Checker > > checkers;
-  for (CheckerName name : _ctx.opts.analyses) {
-    checkers.emplace_back(make_checker(_ctx, name));
+  //
+  // Checkers might hold a state, so each thread has its own set of checkers.
+  std::vector< std::vector< std::unique_ptr< Checker > > > checkers(jobs);
+  for (auto& thread_checkers : checkers) {
+    for (CheckerName name : _ctx.opts.analyses) {
+      thread_checkers.emplace_back(make_checker(_ctx, name));
+    }
   }
 
   // Initial invariant
+  //
+  // Copies share its representation across threads, so it is normalized
+  // beforehand, and then only read.
   AbstractDomain init_inv = make_initial_abstract_value(_ctx);
+  init_inv.normalize();
 
-  // Setup a progress logger
-  std::unique_ptr< ProgressLogger > progress =
-      make_progress_logger(_ctx.opts.progress,
-                           LogLevel::Info,
-                           /* num_tasks = */
-                           2 * std::count_if(bundle->function_begin(),
-                                             bundle->function_end(),
-                                             [](ar::Function* fun) {
-                                               return fun->is_definition();
-                                             }));
-  ScopeLogger scope(*progress);
-
-  // Analyze every function in the bundle
+  // Insert every function in the database, so that function ids do not depend
+  // on the order in which functions are analyzed
+  std::vector< ar::Function* > functions;
   for (auto it = bundle->function_begin(), et = bundle->function_end();
        it != et;
        ++it) {
     ar::Function* function = *it;
-
-    // Insert the function in the database
     _ctx.output_db->functions.insert(function);
 
-    if (!function->is_definition()) {
-      continue;
+    if (function->is_definition()) {
+      functions.push_back(function);
     }
+  }
+
+  // Setup a progress logger
+  std::unique_ptr< ProgressLogger > progress =
+      make_progress_logger(_ctx.opts.progress,
+                           LogLevel::Info,
+                           /* num_tasks = */ 2 * functions.size());
+  ScopeLogger scope(*progress);
+
+  // Analyze every function in the bundle
+  //
+  // Functions are analyzed concurrently, starting from the same initial
+  // invariant. Results are written in the database in the order of the
+  // bundle, so that the output database does not depend on the number of
+  // threads.
+  std::vector< PendingFunction > pending(functions.size());
+
+  auto analyze = [&](std::size_t i, unsigned thread) {
+    ar::Function* function = functions[i];
+    PendingFunction& result = pending[i];
+    Timer timer;
 
     if (_ctx.opts.use_memopt) {
-      memory::FunctionFixpoint fixpoint(_ctx, checkers, function);
+      memory::FunctionFixpoint fixpoint(_ctx, checkers[thread], function);
 
-      {
-        progress->start_task("[MIKOS] Analyzing function '" + demangle(function->name()) +
-                             "'");
-        ScopeTimerDatabase t(_ctx.output_db->times,
-                             "ikos-analyzer.value." + function->name());
+      progress->start_task("[MIKOS] Analyzing function '" +
+                           demangle(function->name()) + "'");
+      timer.start();
+      if (jobs > 1) {
+        ChecksTable::ScopeBuffer buffer(result.checks);
+        fixpoint.run(init_inv);
+      } else {
         fixpoint.run(init_inv);
       }
+      timer.stop();
     } else {
-      FunctionFixpoint fixpoint(_ctx, function);
+      result.fixpoint = std::make_unique< FunctionFixpoint >(_ctx, function);
+      result.fixpoint->set_jobs(_ctx.opts.fixpoint_jobs);
+
+      progress->start_task("Analyzing function '" +
+                           demangle(function->name()) + "'");
+      timer.start();
+      result.fixpoint->run(init_inv);
+      timer.stop();
+    }
 
-      {
-        progress->start_task("Analyzing function '" + demangle(function->name()) +
-                             "'");
-        ScopeTimerDatabase t(_ctx.output_db->times,
-                             "ikos-analyzer.value." + function->name());
-        fixpoint.run(init_inv);
-      }
+    result.time = timer.elapsed();
+  };
 
-      {
-        progress->start_task("Checking properties for function '" +
-                             demangle(function->name()) + "'");
-        ScopeTimerDatabase t(_ctx.output_db->times,
-                             "ikos-analyzer.check." + function->name());
-        fixpoint.run_checks(checkers);
-      }
+  auto commit = [&](std::size_t i) {
+    ar::Function* function = functions[i];
+    PendingFunction& result = pending[i];
+
+    _ctx.output_db->checks.flush(result.checks);
+    _ctx.output_db->times.insert("ikos-analyzer.value." + function->name(),
+                                 result.time.count());
+
+    if (!_ctx.opts.use_memopt) {
+      progress->start_task("Checking properties for function '" +
+                           demangle(function->name()) + "'");
+      ScopeTimerDatabase t(_ctx.output_db->times,
+                           "ikos-analyzer.check." + function->name());
+      result.fixpoint->run_checks(checkers[0]);
+      result.fixpoint.reset();
     }
-  }
+  };
+
+  parallel_ordered_for(functions.size(),
+                       jobs,
+                       /* window = */ 4 * jobs,
+                       analyze,
+                       commit,
+                       /* worker_memory = */ _ctx.opts.worker_mem * 1024UL *
+                           1024UL);
+
+  _ctx.output_db->statistics.insert("copy-on-write.avoided-copies",
+                                    core::CopyOnWriteStats::avoided_copies());
+  _ctx.output_db->statistics.insert("normalization.closures",
+                                    core::LazyNormalization::closures());
+  _ctx.output_db->statistics.insert(
+      "normalization.avoided-closures",
+      core::LazyNormalization::avoided_closures());
 }
 
 } // end namespace intraprocedural
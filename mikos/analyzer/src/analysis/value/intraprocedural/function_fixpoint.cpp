@@ -158,7 +158,15 @@ AbstractDomain FunctionFixpoint::analyze_node(ar::BasicBlock* bb,
     transfer_function(exec_engine, call_exec_engine, stmt);
   }
   exec_engine.exec_leave(bb);
-  return std::move(exec_engine.inv());
+
+  AbstractDomain post = std::move(exec_engine.inv());
+  if (this->jobs() > 1) {
+    // Successor components copy the post invariant, possibly in other
+    // threads, and copies share their representation. Normalize it now
+    // instead of lazily, in concurrent const methods.
+    post.normalize();
+  }
+  return post;
 }
 
 AbstractDomain FunctionFixpoint::analyze_edge(ar::BasicBlock* src,
@@ -57,7 +57,9 @@ FunctionFixpoint::FunctionFixpoint(
       _ctx(ctx),
       _empty_call_context(ctx.call_context_factory->get_empty()),
       _checkers(checkers),
-      _fixpoint_parameters(ctx.fixpoint_parameters->get(function)) {}
+      _fixpoint_parameters(ctx.fixpoint_parameters->get(function)) {
+  this->set_delta_pre(ctx.opts.memopt_delta_invariants);
+}
 
 void FunctionFixpoint::run(AbstractDomain inv) {
   FwdFixpointIterator::run(std::move(inv));
@@ -210,6 +212,22 @@ void FunctionFixpoint::process_post(ar::BasicBlock* /*bb*/,
                                     const AbstractDomain& /*post*/) {}
 
 void FunctionFixpoint::run_deferred_checks(ar::BasicBlock* bb) {
+  if (this->use_delta_pre()) {
+    if (!this->has_pre(bb)) {
+      // Already checked, as the predecessor of a derived pre invariant
+      return;
+    }
+    // Replaying the chain of predecessors materializes the pre invariant
+    std::vector< ar::BasicBlock* > bases;
+    for (ar::BasicBlock* base = this->delta_pre_base_of(bb); base != nullptr;
+         base = this->delta_pre_base_of(base)) {
+      bases.push_back(base);
+    }
+    for (auto it = bases.rbegin(), et = bases.rend(); it != et; ++it) {
+      this->run_deferred_checks(*it);
+    }
+  }
+
   NumericalExecutionEngine< AbstractDomain >
       exec_engine(std::move(this->pre(bb)),
                   _ctx,
@@ -238,6 +256,7 @@ void FunctionFixpoint::run_deferred_checks(ar::BasicBlock* bb) {
   }
 
   exec_engine.exec_leave(bb);
+  this->materialize_delta_pre(bb, exec_engine.inv());
 }
 
 } // end namespace memory
@@ -41,12 +41,17 @@
  *
  ******************************************************************************/
 
+#include <string>
+
 #include <ikos/analyzer/analysis/value/machine_int_domain.hpp>
+#include <ikos/analyzer/exception.hpp>
 
 namespace ikos {
 namespace analyzer {
 namespace value {
 
+#ifndef IKOS_STATIC_DOMAIN
+
 MachineIntAbstractDomain make_top_machine_int_abstract_value(
     MachineIntDomainOption domain) {
   switch (domain) {
@@ -58,8 +63,12 @@ MachineIntAbstractDomain make_top_machine_int_abstract_value(
       return make_top_machine_int_interval_congruence();
     case MachineIntDomainOption::DBM:
       return make_top_machine_int_dbm();
+    case MachineIntDomainOption::SparseDBM:
+      return make_top_machine_int_sparse_dbm();
     case MachineIntDomainOption::VarPackDBM:
       return make_top_machine_int_var_pack_dbm();
+    case MachineIntDomainOption::VarPackSparseDBM:
+      return make_top_machine_int_var_pack_sparse_dbm();
     case MachineIntDomainOption::VarPackDBMCongruence:
       return make_top_machine_int_var_pack_dbm_congruence();
     case MachineIntDomainOption::Gauge:
@@ -109,8 +118,12 @@ MachineIntAbstractDomain make_bottom_machine_int_abstract_value(
       return make_bottom_machine_int_interval_congruence();
     case MachineIntDomainOption::DBM:
       return make_bottom_machine_int_dbm();
+    case MachineIntDomainOption::SparseDBM:
+      return make_bottom_machine_int_sparse_dbm();
     case MachineIntDomainOption::VarPackDBM:
       return make_bottom_machine_int_var_pack_dbm();
+    case MachineIntDomainOption::VarPackSparseDBM:
+      return make_bottom_machine_int_var_pack_sparse_dbm();
     case MachineIntDomainOption::VarPackDBMCongruence:
       return make_bottom_machine_int_var_pack_dbm_congruence();
     case MachineIntDomainOption::Gauge:
@@ -149,6 +162,43 @@ MachineIntAbstractDomain make_bottom_machine_int_abstract_value(
   }
 }
 
+#else // IKOS_STATIC_DOMAIN
+
+namespace {
+
+/// \brief Throw a LogicError if the analyzer was not built for the domain
+void check_static_machine_int_domain(MachineIntDomainOption domain) {
+  if (domain != StaticMachineIntDomain) {
+    throw LogicError(
+        std::string("ikos was compiled for the machine integer domain ") +
+        machine_int_domain_option_str(StaticMachineIntDomain) + " only");
+  }
+}
+
+} // end anonymous namespace
+
+MachineIntAbstractDomain make_top_machine_int_abstract_value(
+    MachineIntDomainOption domain) {
+  check_static_machine_int_domain(domain);
+#if defined(IKOS_STATIC_DOMAIN_INTERVAL)
+  return MachineIntAbstractDomain::top();
+#else
+  return MachineIntAbstractDomain(MachineIntNumericDomain::top());
+#endif
+}
+
+MachineIntAbstractDomain make_bottom_machine_int_abstract_value(
+    MachineIntDomainOption domain) {
+  check_static_machine_int_domain(domain);
+#if defined(IKOS_STATIC_DOMAIN_INTERVAL)
+  return MachineIntAbstractDomain::bottom();
+#else
+  return MachineIntAbstractDomain(MachineIntNumericDomain::bottom());
+#endif
+}
+
+#endif // IKOS_STATIC_DOMAIN
+
 } // end namespace value
 } // end namespace analyzer
 } // end namespace ikos
@@ -200,6 +200,7 @@ VariableFactory::VariableFactory(ar::Bundle* bundle)
 VariableFactory::~VariableFactory() = default;
 
 LocalVariable* VariableFactory::get_local(ar::LocalVariable* var) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_local_variable_map.find(var);
   if (it == this->_local_variable_map.end()) {
     auto vn = std::make_unique< LocalVariable >(var);
@@ -214,6 +215,7 @@ LocalVariable* VariableFactory::get_local(ar::LocalVariable* var) {
 }
 
 GlobalVariable* VariableFactory::get_global(ar::GlobalVariable* var) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_global_variable_map.find(var);
   if (it == this->_global_variable_map.end()) {
     auto vn = std::make_unique< GlobalVariable >(var);
@@ -228,6 +230,7 @@ GlobalVariable* VariableFactory::get_global(ar::GlobalVariable* var) {
 }
 
 InternalVariable* VariableFactory::get_internal(ar::InternalVariable* var) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_internal_variable_map.find(var);
   if (it == this->_internal_variable_map.end()) {
     auto vn = std::make_unique< InternalVariable >(var);
@@ -245,6 +248,7 @@ InternalVariable* VariableFactory::get_internal(ar::InternalVariable* var) {
 
 InlineAssemblyPointerVariable* VariableFactory::get_asm_ptr(
     ar::InlineAssemblyConstant* cst) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_inline_asm_pointer_map.find(cst);
   if (it == this->_inline_asm_pointer_map.end()) {
     auto vn = std::make_unique< InlineAssemblyPointerVariable >(cst);
@@ -259,6 +263,7 @@ InlineAssemblyPointerVariable* VariableFactory::get_asm_ptr(
 }
 
 FunctionPointerVariable* VariableFactory::get_function_ptr(ar::Function* fun) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_function_pointer_map.find(fun);
   if (it == this->_function_pointer_map.end()) {
     auto vn = std::make_unique< FunctionPointerVariable >(fun);
@@ -281,6 +286,7 @@ CellVariable* VariableFactory::get_cell(MemoryLocation* address,
                                         const MachineInt& offset,
                                         const MachineInt& size,
                                         Signedness sign) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto key = std::make_tuple(address, offset, size);
   auto it = this->_cell_map.find(key);
   if (it == this->_cell_map.end()) {
@@ -309,6 +315,7 @@ CellVariable* VariableFactory::get_cell(MemoryLocation* address,
 }
 
 AllocSizeVariable* VariableFactory::get_alloc_size(MemoryLocation* address) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_alloc_size_map.find(address);
   if (it == this->_alloc_size_map.end()) {
     auto vn = std::make_unique< AllocSizeVariable >(this->_size_type, address);
@@ -321,6 +328,7 @@ AllocSizeVariable* VariableFactory::get_alloc_size(MemoryLocation* address) {
 }
 
 ReturnVariable* VariableFactory::get_return(ar::Function* fun) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_return_variable_map.find(fun);
   if (it == this->_return_variable_map.end()) {
     auto vn = std::make_unique< ReturnVariable >(fun);
@@ -338,6 +346,7 @@ ReturnVariable* VariableFactory::get_return(ar::Function* fun) {
 
 NamedShadowVariable* VariableFactory::get_named_shadow(ar::Type* type,
                                                        llvm::StringRef name) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   auto it = this->_named_shadow_variable_map.find(name);
   if (it == this->_named_shadow_variable_map.end()) {
     auto vn = std::make_unique< NamedShadowVariable >(type, name);
@@ -355,6 +364,7 @@ NamedShadowVariable* VariableFactory::get_named_shadow(ar::Type* type,
 }
 
 UnnamedShadowVariable* VariableFactory::create_unnamed_shadow(ar::Type* type) {
+  std::lock_guard< std::mutex > lock(this->_mutex);
   std::size_t id = this->_unnamed_shadow_variable_vec.size();
   auto vn = std::make_unique< UnnamedShadowVariable >(type, id);
   if (vn->type()->is_pointer() || vn->type()->is_aggregate()) {
@@ -931,7 +931,7 @@ BufferOverflowChecker::CheckResult BufferOverflowChecker::check_mem_access(
 
     // Add block info
     JsonDict block_info = {
-        {"id", _ctx.output_db->memory_locations.insert(addr)}};
+        {"id", _ctx.output_db->memory_locations.ref(addr)}};
 
     // Perform analysis
     auto check = this->check_memory_location_access(stmt,
@@ -268,7 +268,7 @@ DoubleFreeChecker::CheckResult DoubleFreeChecker::check_double_free(
 
   for (const auto& addr : addrs) {
     JsonDict block_info = {
-        {"id", _ctx.output_db->memory_locations.insert(addr)}};
+        {"id", _ctx.output_db->memory_locations.ref(addr)}};
     Result result = this->check_memory_location_free(call, inv, addr);
     block_info.put("status", static_cast< int >(result));
 
@@ -177,7 +177,7 @@ FunctionCallChecker::CheckResult FunctionCallChecker::check_call(
 
   for (MemoryLocation* addr : callees) {
     JsonDict block_info = {
-        {"id", _ctx.output_db->memory_locations.insert(addr)}};
+        {"id", _ctx.output_db->memory_locations.ref(addr)}};
 
     if (!isa< FunctionMemoryLocation >(addr)) {
       // Not a call to a function memory location, emit a warning
@@ -250,7 +250,7 @@ PointerAlignmentChecker::CheckResult PointerAlignmentChecker::check_alignment(
   for (MemoryLocation* addr : addrs) {
     // Add info to json
     JsonDict block_info = {
-        {"id", _ctx.output_db->memory_locations.insert(addr)}};
+        {"id", _ctx.output_db->memory_locations.ref(addr)}};
 
     // Is the points_to correctly aligned?
     Result is_correctly_aligned =
@@ -217,7 +217,7 @@ PointerCompareChecker::CheckResult PointerCompareChecker::check_pointer_compare(
     if (left_addrs.is_set()) {
       JsonList left_points_to;
       for (MemoryLocation* mem_loc : left_addrs) {
-        left_points_to.add(_ctx.output_db->memory_locations.insert(mem_loc));
+        left_points_to.add(_ctx.output_db->memory_locations.ref(mem_loc));
       }
       info.put("left_points_to", left_points_to);
     } else {
@@ -227,7 +227,7 @@ PointerCompareChecker::CheckResult PointerCompareChecker::check_pointer_compare(
     if (right_addrs.is_set()) {
       JsonList right_points_to;
       for (MemoryLocation* mem_loc : right_addrs) {
-        right_points_to.add(_ctx.output_db->memory_locations.insert(mem_loc));
+        right_points_to.add(_ctx.output_db->memory_locations.ref(mem_loc));
       }
       info.put("right_points_to", right_points_to);
     } else {
@@ -0,0 +1,205 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Columnar binary output for the largest result tables
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <llvm/Support/EndianStream.h>
+#include <llvm/Support/FileSystem.h>
+
+#include <ikos/analyzer/database/columnar.hpp>
+#include <ikos/analyzer/json/json.hpp>
+#include <ikos/analyzer/support/assert.hpp>
+
+namespace ikos {
+namespace analyzer {
+namespace columnar {
+
+namespace {
+
+/// \brief Write a 64-bit little-endian integer
+void write_int64(llvm::raw_ostream& o, std::int64_t n) {
+  llvm::support::endian::write< std::int64_t >(o, n, llvm::support::little);
+}
+
+} // end anonymous namespace
+
+// Error
+
+const char* Error::what() const noexcept {
+  return this->_msg->c_str();
+}
+
+Error::~Error() = default;
+
+// Ostream
+
+Ostream::Ostream(Store& store,
+                 StringRef table_name,
+                 llvm::ArrayRef< std::string > columns)
+    : _store(store), _name(table_name) {
+  ikos_assert(!columns.empty());
+
+  for (const std::string& column : columns) {
+    this->_column_names.push_back(column);
+    this->_columns.push_back(store.open(this->_name + "." + column + ".i64"));
+  }
+}
+
+Ostream::~Ostream() = default;
+
+void Ostream::add(StringRef s) {
+  this->add(this->_store.insert_string(s));
+}
+
+void Ostream::add_null() {
+  this->add(Null);
+}
+
+void Ostream::add(std::int64_t n) {
+  ikos_assert_msg(this->_current_column < this->_columns.size(),
+                  "too many columns");
+  write_int64(*this->_columns[this->_current_column++], n);
+}
+
+void Ostream::flush() {
+  ikos_assert_msg(this->_current_column == this->_columns.size(),
+                  "missing columns");
+  this->_current_column = 0;
+  this->_num_rows++;
+}
+
+void Ostream::close() {
+  for (const auto& column : this->_columns) {
+    column->close();
+    if (column->has_error()) {
+      column->clear_error();
+      throw Error("unable to write columnar table '" + this->_name + "'");
+    }
+  }
+}
+
+// Store
+
+Store::Store(boost::filesystem::path directory)
+    : _directory(std::move(directory)) {
+  boost::system::error_code err;
+  boost::filesystem::remove_all(this->_directory, err);
+  if (!boost::filesystem::create_directories(this->_directory, err)) {
+    throw Error("unable to create directory '" + this->_directory.string() +
+                "'");
+  }
+
+  this->_string_data = this->open("strings.data");
+  this->_string_offsets = this->open("strings.offsets.i64");
+  write_int64(*this->_string_offsets, 0);
+}
+
+Store::~Store() = default;
+
+Ostream& Store::add_table(StringRef name,
+                          llvm::ArrayRef< std::string > columns) {
+  this->_tables.push_back(std::make_unique< Ostream >(*this, name, columns));
+  return *this->_tables.back();
+}
+
+std::int64_t Store::insert_string(StringRef s) {
+  auto res = this->_strings.try_emplace(llvm::StringRef(s.data(), s.size()),
+                                        this->_strings.size());
+  if (res.second) {
+    this->_string_data->write(s.data(), s.size());
+    this->_string_data_size += static_cast< std::int64_t >(s.size());
+    write_int64(*this->_string_offsets, this->_string_data_size);
+  }
+  return res.first->second;
+}
+
+void Store::close() {
+  if (this->_closed) {
+    return;
+  }
+  this->_closed = true;
+
+  JsonDict tables;
+  for (const auto& table : this->_tables) {
+    table->close();
+
+    JsonList columns;
+    for (const auto& column : table->columns()) {
+      columns.add(column);
+    }
+    tables.put(table->name(),
+               JsonDict{{"columns", columns}, {"rows", table->num_rows()}});
+  }
+
+  for (auto* file : {this->_string_data.get(), this->_string_offsets.get()}) {
+    file->close();
+    if (file->has_error()) {
+      file->clear_error();
+      throw Error("unable to write columnar string table");
+    }
+  }
+
+  // Written last: readers ignore a directory without a manifest
+  auto manifest = this->open("manifest.json");
+  *manifest << JsonDict{{"version", FormatVersion},
+                        {"null", Null},
+                        {"strings",
+                         static_cast< std::int64_t >(this->_strings.size())},
+                        {"tables", tables}}
+                   .str();
+  manifest->close();
+  if (manifest->has_error()) {
+    manifest->clear_error();
+    throw Error("unable to write columnar manifest");
+  }
+}
+
+std::unique_ptr< llvm::raw_fd_ostream > Store::open(StringRef filename) const {
+  boost::filesystem::path path = this->_directory / filename.to_string();
+  std::error_code err;
+  auto file = std::make_unique< llvm::raw_fd_ostream >(path.string(),
+                                                       err,
+                                                       llvm::sys::fs::OF_None);
+  if (err) {
+    throw Error("unable to open '" + path.string() + "': " + err.message());
+  }
+  return file;
+}
+
+} // end namespace columnar
+} // end namespace analyzer
+} // end namespace ikos
@@ -50,15 +50,46 @@ OutputDatabase::OutputDatabase(sqlite::DbConnection& db_)
     : db(db_),
       settings(db_),
       times(db_),
+      statistics(db_),
       files(db_),
       functions(db_, files),
       statements(db_, files, functions),
       operands(db_),
       call_contexts(db_, functions, statements),
       memory_locations(db_, functions, statements, call_contexts),
-      checks(db_, statements, operands, call_contexts) {
+      checks(db_, statements, operands, call_contexts, memory_locations) {
   this->db.set_commit_policy(sqlite::CommitPolicy::Auto);
 }
 
+void OutputDatabase::create_indexes() {
+  this->settings.create_indexes();
+  this->times.create_indexes();
+  this->statistics.create_indexes();
+  this->files.create_indexes();
+  this->functions.create_indexes();
+  this->statements.create_indexes();
+  this->operands.create_indexes();
+  this->call_contexts.create_indexes();
+  this->memory_locations.create_indexes();
+  this->checks.create_indexes();
+}
+
+void OutputDatabase::enable_columnar(
+    const boost::filesystem::path& directory) {
+  ikos_assert(!this->_columnar);
+  this->_columnar = std::make_unique< columnar::Store >(directory);
+  this->statements.set_columnar(*this->_columnar);
+  this->call_contexts.set_columnar(*this->_columnar);
+  this->checks.set_columnar(*this->_columnar);
+  this->settings.insert("output-format", "columnar");
+}
+
+void OutputDatabase::close_columnar() {
+  if (this->_columnar) {
+    std::lock_guard< std::recursive_mutex > lock(this->db.mutex());
+    this->_columnar->close();
+  }
+}
+
 } // end namespace analyzer
 } // end namespace ikos
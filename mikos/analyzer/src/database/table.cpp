@@ -54,7 +54,17 @@ DatabaseTable::DatabaseTable(
     : _db(db), _name(std::move(name)) {
   this->_db.drop_table(this->_name);
   this->_db.create_table(this->_name, cols);
+  for (const auto& col : cols) {
+    this->_columns.push_back(col.first.to_string());
+  }
   for (const auto& col : indexes) {
+    this->_indexes.push_back(col.to_string());
+  }
+}
+
+void DatabaseTable::create_indexes() {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  for (const auto& col : this->_indexes) {
     std::string index_name("index_");
     index_name += this->_name;
     index_name += '_';
@@ -41,6 +41,8 @@
  *
  ******************************************************************************/
 
+#include <llvm/ADT/SmallVector.h>
+
 #include <ikos/analyzer/database/table/call_contexts.hpp>
 
 namespace ikos {
@@ -60,46 +62,75 @@ CallContextsTable::CallContextsTable(sqlite::DbConnection& db,
       _statements(statements),
       _row(db, "call_contexts", 4) {}
 
+void CallContextsTable::set_columnar(columnar::Store& store) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  this->_row.set_columnar(store.add_table(this->_name, this->_columns));
+}
+
 sqlite::DbInt64 CallContextsTable::insert(CallContext* call_context) {
   ikos_assert(call_context != nullptr);
 
-  auto it = this->_map.find(call_context);
-  if (it != this->_map.end()) {
-    return it->second;
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+
+  sqlite::DbInt64 id = this->find(call_context);
+  if (id >= 0) {
+    return id;
   }
 
-  // Insert the parent first
-  sqlite::DbInt64 parent_id = 0;
-  if (call_context->has_parent()) {
-    parent_id = this->insert(call_context->parent());
+  // Collect the call contexts to insert, up to the first inserted parent
+  llvm::SmallVector< CallContext*, 16 > chain;
+  sqlite::DbInt64 parent_id = -1;
+  chain.push_back(call_context);
+  while (chain.back()->has_parent()) {
+    parent_id = this->find(chain.back()->parent());
+    if (parent_id >= 0) {
+      break;
+    }
+    chain.push_back(chain.back()->parent());
   }
 
-  // Insert row
-  sqlite::DbInt64 id = this->_last_insert_id++;
-
-  this->_row << id;
-  if (call_context->empty()) {
-    this->_row << sqlite::null;
-    this->_row << sqlite::null;
-    this->_row << sqlite::null;
-  } else {
-    // call_id
-    ar::CallBase* call = call_context->call();
-    this->_row << this->_statements.insert(call);
-
-    // function_id
-    ar::Code* code = call->code();
-    ikos_assert(code->is_function_body());
-    this->_row << this->_functions.insert(code->function());
-
-    // parent_id
-    this->_row << parent_id;
+  // Insert rows, parents first
+  for (auto it = chain.rbegin(), et = chain.rend(); it != et; ++it) {
+    CallContext* context = *it;
+    id = this->_last_insert_id++;
+
+    this->_row << id;
+    if (context->empty()) {
+      this->_row << sqlite::null;
+      this->_row << sqlite::null;
+      this->_row << sqlite::null;
+    } else {
+      // call_id
+      ar::CallBase* call = context->call();
+      this->_row << this->_statements.insert(call);
+
+      // function_id
+      ar::Code* code = call->code();
+      ikos_assert(code->is_function_body());
+      this->_row << this->_functions.insert(code->function());
+
+      // parent_id
+      ikos_assert(parent_id >= 0);
+      this->_row << parent_id;
+    }
+    this->_row << sqlite::end_row;
+
+    if (context->id() >= this->_map.size()) {
+      this->_map.resize(context->id() + 1, -1);
+    }
+    this->_map[context->id()] = id;
+    parent_id = id;
   }
-  this->_row << sqlite::end_row;
 
-  this->_map.try_emplace(call_context, id);
   return id;
 }
 
+sqlite::DbInt64 CallContextsTable::find(CallContext* call_context) const {
+  if (call_context->id() < this->_map.size()) {
+    return this->_map[call_context->id()];
+  }
+  return -1;
+}
+
 } // end namespace analyzer
 } // end namespace ikos
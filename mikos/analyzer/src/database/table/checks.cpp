@@ -49,7 +49,8 @@ namespace analyzer {
 ChecksTable::ChecksTable(sqlite::DbConnection& db,
                          StatementsTable& statements,
                          OperandsTable& operands,
-                         CallContextsTable& call_contexts)
+                         CallContextsTable& call_contexts,
+                         MemoryLocationsTable& memory_locations)
     : DatabaseTable(db,
                     "checks",
                     {{"id", sqlite::DbColumnType::Integer},
@@ -64,8 +65,67 @@ ChecksTable::ChecksTable(sqlite::DbConnection& db,
       _statements(statements),
       _operands(operands),
       _call_contexts(call_contexts),
+      _memory_locations(memory_locations),
       _row(db, "checks", 8) {}
 
+namespace {
+
+/// \brief Buffer of the current thread, or null
+thread_local ChecksTable::Buffer* ThreadBuffer = nullptr;
+
+} // end anonymous namespace
+
+ChecksTable::ScopeBuffer::ScopeBuffer(Buffer& buffer)
+    : _previous(ThreadBuffer) {
+  ThreadBuffer = &buffer;
+}
+
+ChecksTable::ScopeBuffer::~ScopeBuffer() {
+  ThreadBuffer = this->_previous;
+}
+
+ChecksTable::ScopeAsyncWriter::ScopeAsyncWriter(ChecksTable& table)
+    : _table(table) {
+  ikos_assert_msg(!table._async, "checks are already written asynchronously");
+  table._async = true;
+  table._writer = std::thread(&ChecksTable::run_writer, &table);
+}
+
+void ChecksTable::ScopeAsyncWriter::finish() {
+  ChecksTable& table = this->_table;
+  if (!table._writer.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard< std::mutex > lock(table._queue_mutex);
+    table._stopping = true;
+  }
+  table._batch_queued.notify_one();
+  table._writer.join();
+  table._async = false;
+  table._stopping = false;
+
+  if (table._error != nullptr) {
+    std::exception_ptr error = table._error;
+    table._error = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+ChecksTable::ScopeAsyncWriter::~ScopeAsyncWriter() {
+  try {
+    this->finish();
+  } catch (...) {
+    // The error is lost, finish() should be called explicitly to report it
+  }
+}
+
+void ChecksTable::set_columnar(columnar::Store& store) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  this->_row.set_columnar(store.add_table(this->_name, this->_columns));
+}
+
 void ChecksTable::insert(CheckKind kind,
                          CheckerName checker,
                          Result status,
@@ -73,6 +133,134 @@ void ChecksTable::insert(CheckKind kind,
                          CallContext* call_context,
                          llvm::ArrayRef< ar::Value* > operands,
                          const JsonDict& info) {
+  if (ThreadBuffer != nullptr || this->_async) {
+    Buffer::Row row{kind,
+                    checker,
+                    status,
+                    stmt,
+                    call_context,
+                    llvm::SmallVector< ar::Value*, 2 >(operands.begin(),
+                                                       operands.end()),
+                    info};
+    if (ThreadBuffer != nullptr) {
+      ThreadBuffer->_rows.push_back(std::move(row));
+    } else {
+      this->enqueue(std::move(row));
+    }
+    return;
+  }
+
+  std::string info_str = info.empty() ? std::string() : info.str();
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  this->write(kind, checker, status, stmt, call_context, operands, info_str);
+}
+
+void ChecksTable::flush(Buffer& buffer) {
+  if (this->_async) {
+    this->enqueue(std::move(buffer._rows));
+    buffer._rows.clear();
+    return;
+  }
+
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  for (const Buffer::Row& row : buffer._rows) {
+    this->write(row);
+  }
+  buffer._rows.clear();
+}
+
+void ChecksTable::enqueue(Buffer::Row row) {
+  std::unique_lock< std::mutex > lock(this->_queue_mutex);
+  this->_current_batch.push_back(std::move(row));
+  if (this->_current_batch.size() < BatchSize) {
+    return;
+  }
+
+  this->_batch_taken.wait(lock, [this] {
+    return this->_batches.size() < MaxQueuedBatches;
+  });
+  this->_batches.push_back(std::move(this->_current_batch));
+  this->_current_batch.clear();
+  this->_current_batch.reserve(BatchSize);
+  lock.unlock();
+  this->_batch_queued.notify_one();
+}
+
+void ChecksTable::enqueue(std::vector< Buffer::Row > rows) {
+  if (rows.empty()) {
+    return;
+  }
+
+  std::unique_lock< std::mutex > lock(this->_queue_mutex);
+  this->_batch_taken.wait(lock, [this] {
+    return this->_batches.size() < MaxQueuedBatches;
+  });
+
+  // Keep the order of insertion
+  if (!this->_current_batch.empty()) {
+    this->_batches.push_back(std::move(this->_current_batch));
+    this->_current_batch.clear();
+  }
+  this->_batches.push_back(std::move(rows));
+  lock.unlock();
+  this->_batch_queued.notify_one();
+}
+
+void ChecksTable::run_writer() {
+  while (true) {
+    std::vector< Buffer::Row > batch;
+    {
+      std::unique_lock< std::mutex > lock(this->_queue_mutex);
+      this->_batch_queued.wait(lock, [this] {
+        return !this->_batches.empty() || this->_stopping;
+      });
+      if (!this->_batches.empty()) {
+        batch = std::move(this->_batches.front());
+        this->_batches.pop_front();
+      } else if (!this->_current_batch.empty()) {
+        batch.swap(this->_current_batch);
+      } else {
+        return;
+      }
+    }
+    this->_batch_taken.notify_all();
+
+    // After an error, the remaining checks are dropped
+    if (this->_error != nullptr) {
+      continue;
+    }
+    try {
+      std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+      for (const Buffer::Row& row : batch) {
+        this->write(row);
+      }
+    } catch (...) {
+      this->_error = std::current_exception();
+    }
+  }
+}
+
+void ChecksTable::write(const Buffer::Row& row) {
+  this->write(row.kind,
+              row.checker,
+              row.status,
+              row.stmt,
+              row.call_context,
+              row.operands,
+              row.info.empty() ? std::string() : row.info.str());
+}
+
+void ChecksTable::write(CheckKind kind,
+                        CheckerName checker,
+                        Result status,
+                        ar::Statement* stmt,
+                        CallContext* call_context,
+                        llvm::ArrayRef< ar::Value* > operands,
+                        StringRef info) {
+  // Insert the referenced memory locations first, so that their ids only
+  // depend on the order in which checks are written
+  std::string info_str = this->_memory_locations.resolve(info);
+
   sqlite::DbInt64 id = this->_last_insert_id++;
 
   this->_row << id;
@@ -97,8 +285,8 @@ void ChecksTable::insert(CheckKind kind,
     this->_row << sqlite::null;
   }
   this->_row << this->_call_contexts.insert(call_context);
-  if (!info.empty()) {
-    this->_row << info.str();
+  if (!info_str.empty()) {
+    this->_row << info_str;
   } else {
     this->_row << sqlite::null;
   }
@@ -41,6 +41,9 @@
  *
  ******************************************************************************/
 
+#include <cstdint>
+#include <string>
+
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/IntrinsicInst.h>
@@ -54,6 +57,25 @@
 namespace ikos {
 namespace analyzer {
 
+namespace {
+
+/// \brief Delimiter of memory location references in JSON strings
+///
+/// Control characters are always escaped in JSON strings, see JsonString, so
+/// this cannot appear in a JSON value otherwise.
+const char RefDelimiter = '\x01';
+
+} // end anonymous namespace
+
+std::string MemoryLocationsTable::JsonRef::str() const {
+  std::string r;
+  r.push_back(RefDelimiter);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  r.append(std::to_string(reinterpret_cast< std::uintptr_t >(this->_mem_loc)));
+  r.push_back(RefDelimiter);
+  return r;
+}
+
 MemoryLocationsTable::MemoryLocationsTable(sqlite::DbConnection& db,
                                            FunctionsTable& functions,
                                            StatementsTable& statements,
@@ -72,6 +94,8 @@ MemoryLocationsTable::MemoryLocationsTable(sqlite::DbConnection& db,
 sqlite::DbInt64 MemoryLocationsTable::insert(MemoryLocation* mem_loc) {
   ikos_assert(mem_loc != nullptr);
 
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+
   auto it = this->_map.find(mem_loc);
   if (it != this->_map.end()) {
     return it->second;
@@ -93,6 +117,37 @@ sqlite::DbInt64 MemoryLocationsTable::insert(MemoryLocation* mem_loc) {
   return id;
 }
 
+MemoryLocationsTable::JsonRef MemoryLocationsTable::ref(
+    MemoryLocation* mem_loc) const {
+  ikos_assert(mem_loc != nullptr);
+  return JsonRef(mem_loc);
+}
+
+std::string MemoryLocationsTable::resolve(StringRef json) {
+  std::string r;
+  r.reserve(json.size());
+
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+
+  while (true) {
+    std::size_t begin = json.find(RefDelimiter);
+    if (begin == StringRef::npos) {
+      r.append(json.data(), json.size());
+      return r;
+    }
+    r.append(json.data(), begin);
+    json.remove_prefix(begin + 1);
+
+    std::size_t end = json.find(RefDelimiter);
+    ikos_assert_msg(end != StringRef::npos, "unterminated memory location");
+    std::string address = json.substr(0, end).to_string();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto mem_loc = reinterpret_cast< MemoryLocation* >(std::stoull(address));
+    r.append(std::to_string(this->insert(mem_loc)));
+    json.remove_prefix(end + 1);
+  }
+}
+
 JsonDict MemoryLocationsTable::info(MemoryLocation* mem_loc) {
   if (auto local_mem_loc = dyn_cast< LocalMemoryLocation >(mem_loc)) {
     ar::LocalVariable* lv = local_mem_loc->local_var();
@@ -76,6 +76,8 @@ OperandsTable::OperandsTable(sqlite::DbConnection& db)
 sqlite::DbInt64 OperandsTable::insert(ar::Value* value) {
   ikos_assert(value != nullptr);
 
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+
   auto it = this->_map.find(value);
   if (it != this->_map.end()) {
     return it->second;
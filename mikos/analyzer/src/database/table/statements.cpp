@@ -63,9 +63,16 @@ StatementsTable::StatementsTable(sqlite::DbConnection& db,
       _functions(functions),
       _row(db, "statements", 6) {}
 
+void StatementsTable::set_columnar(columnar::Store& store) {
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+  this->_row.set_columnar(store.add_table(this->_name, this->_columns));
+}
+
 sqlite::DbInt64 StatementsTable::insert(ar::Statement* stmt) {
   ikos_assert(stmt != nullptr);
 
+  std::lock_guard< std::recursive_mutex > lock(this->_db.mutex());
+
   auto it = this->_map.find(stmt);
   if (it != this->_map.end()) {
     return it->second;
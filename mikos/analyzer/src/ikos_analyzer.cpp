@@ -52,7 +52,9 @@
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/Debug.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/InitLLVM.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Process.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/WithColor.h>
@@ -81,6 +83,7 @@
 #include <ikos/analyzer/analysis/option.hpp>
 #include <ikos/analyzer/analysis/pointer/function.hpp>
 #include <ikos/analyzer/analysis/pointer/pointer.hpp>
+#include <ikos/analyzer/analysis/preanalysis_cache.hpp>
 #include <ikos/analyzer/analysis/result.hpp>
 #include <ikos/analyzer/analysis/value/interprocedural/analysis.hpp>
 #include <ikos/analyzer/analysis/value/intraprocedural/analysis.hpp>
@@ -88,6 +91,7 @@
 #include <ikos/analyzer/analysis/widening_hint.hpp>
 #include <ikos/analyzer/checker/name.hpp>
 #include <ikos/analyzer/database/output.hpp>
+#include <ikos/analyzer/util/ar_cache.hpp>
 #include <ikos/analyzer/util/color.hpp>
 #include <ikos/analyzer/util/log.hpp>
 #include <ikos/analyzer/util/timer.hpp>
@@ -114,6 +118,20 @@ static llvm::cl::opt< std::string > OutputFilename(
     llvm::cl::init("output.db"),
     llvm::cl::cat(MainCategory));
 
+static llvm::cl::opt< analyzer::OutputFormat > OutputFormat(
+    "output-format",
+    llvm::cl::desc("Output format:"),
+    llvm::cl::values(
+        clEnumValN(analyzer::OutputFormat::SQLite,
+                   "sqlite",
+                   "Write all results in the database (default)"),
+        clEnumValN(analyzer::OutputFormat::Columnar,
+                   "columnar",
+                   "Write statements, call contexts and checks in columnar "
+                   "files, in <output>.columnar")),
+    llvm::cl::init(analyzer::OutputFormat::SQLite),
+    llvm::cl::cat(MainCategory));
+
 static llvm::cl::opt< analyzer::LogLevel > LogLevel(
     "log",
     llvm::cl::desc("Log level:"),
@@ -235,10 +253,19 @@ static llvm::cl::opt< analyzer::MachineIntDomainOption > Domain(
                    machine_int_domain_option_str(
                        analyzer::MachineIntDomainOption::DBM),
                    "Difference-Bound Matrices domain"),
+        clEnumValN(analyzer::MachineIntDomainOption::SparseDBM,
+                   machine_int_domain_option_str(
+                       analyzer::MachineIntDomainOption::SparseDBM),
+                   "Sparse Difference-Bound Matrices domain"),
         clEnumValN(analyzer::MachineIntDomainOption::VarPackDBM,
                    machine_int_domain_option_str(
                        analyzer::MachineIntDomainOption::VarPackDBM),
                    "Difference-Bound Matrices domain with variable packing"),
+        clEnumValN(
+            analyzer::MachineIntDomainOption::VarPackSparseDBM,
+            machine_int_domain_option_str(
+                analyzer::MachineIntDomainOption::VarPackSparseDBM),
+            "Sparse Difference-Bound Matrices domain with variable packing"),
         clEnumValN(
             analyzer::MachineIntDomainOption::VarPackDBMCongruence,
             machine_int_domain_option_str(
@@ -325,6 +352,13 @@ static llvm::cl::opt< bool > MemoryOptimization(
     llvm::cl::desc("Use memory optimization (MIKOS)"),
     llvm::cl::cat(AnalysisCategory));
 
+static llvm::cl::opt< bool > MemoptDeltaInvariants(
+    "memopt-delta-invariants",
+    llvm::cl::desc("With -memopt, recompute the cached invariants of blocks "
+                   "with a single predecessor from it instead of storing "
+                   "them"),
+    llvm::cl::cat(AnalysisCategory));
+
 static llvm::cl::list< std::string > EntryPoints(
     "entry-points",
     llvm::cl::desc("List of program entry points (ex: main)"),
@@ -353,6 +387,39 @@ static llvm::cl::opt< analyzer::Procedural > Procedural(
     llvm::cl::init(analyzer::Procedural::Interprocedural),
     llvm::cl::cat(AnalysisCategory));
 
+static llvm::cl::opt< unsigned > Jobs(
+    "j",
+    llvm::cl::desc("Number of threads for the value analysis "
+                   "(default: 1, 0 for one per core)"),
+    llvm::cl::init(1),
+    llvm::cl::value_desc("int"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > FixpointJobs(
+    "fixpoint-jobs",
+    llvm::cl::desc("Number of threads for the fixpoint on a function body, "
+                   "with -proc=intra and without -memopt (default: 1)"),
+    llvm::cl::init(1),
+    llvm::cl::value_desc("int"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > WorkerMem(
+    "worker-mem",
+    llvm::cl::desc("Memory budget of a thread of the value analysis, in MB "
+                   "(default: 0, no budget)"),
+    llvm::cl::init(0),
+    llvm::cl::value_desc("int"),
+    llvm::cl::cat(AnalysisCategory));
+
+static llvm::cl::opt< unsigned > MemoryLimit(
+    "memory-limit",
+    llvm::cl::desc("Memory limit of the value analysis with -memopt, in MB. "
+                   "Cached callees are analyzed again instead of exceeding it "
+                   "(default: 0, no limit)"),
+    llvm::cl::init(0),
+    llvm::cl::value_desc("int"),
+    llvm::cl::cat(AnalysisCategory));
+
 static llvm::cl::opt< analyzer::WideningStrategy > WideningStrategy(
     "widening-strategy",
     llvm::cl::desc("Strategy for increasing iterations"),
@@ -422,16 +489,37 @@ static llvm::cl::opt< bool > NoWideningHints(
     llvm::cl::desc("Disable the widening hint analysis"),
     llvm::cl::cat(AnalysisCategory));
 
+static llvm::cl::opt< std::string > ReusePreanalysis(
+    "reuse-preanalysis",
+    llvm::cl::desc("Cache directory for the results of the liveness, widening "
+                   "hint and pointer analyses, reused across runs on the same "
+                   "AR"),
+    llvm::cl::value_desc("directory"),
+    llvm::cl::cat(AnalysisCategory));
+
 static llvm::cl::opt< bool > NoFixpointCache(
     "no-fixpoint-cache",
     llvm::cl::desc("Disable the cache of fixpoints"),
     llvm::cl::cat(AnalysisCategory));
 
+static llvm::cl::opt< unsigned > SummaryCacheSize(
+    "summary-cache",
+    llvm::cl::desc("Maximum number of function summaries reused across call "
+                   "sites, without -memopt (default: 0, disabled)"),
+    llvm::cl::init(0),
+    llvm::cl::value_desc("int"),
+    llvm::cl::cat(AnalysisCategory));
+
 static llvm::cl::opt< bool > EnablePartitioningDomain(
     "enable-partitioning-domain",
     llvm::cl::desc("Enable the partitioning abstract domain"),
     llvm::cl::cat(AnalysisCategory));
 
+static llvm::cl::opt< bool > UseLazyNormalization(
+    "lazy-normalization",
+    llvm::cl::desc("Only normalize the variable packs needed by queries"),
+    llvm::cl::cat(AnalysisCategory));
+
 static llvm::cl::opt< analyzer::GlobalsInitPolicy > GlobalsInitPolicy(
     "globals-init",
     llvm::cl::desc("Policy of initialization for global variables"),
@@ -502,6 +590,13 @@ static llvm::cl::opt< bool > AllowDebugInfoMismatch(
     llvm::cl::desc("Allow incorrect debug information in the module"),
     llvm::cl::cat(ImportCategory));
 
+static llvm::cl::opt< std::string > ArCacheDirectory(
+    "ar-cache",
+    llvm::cl::desc("Cache directory for the AR, reused across runs on the same "
+                   "bitcode with the same import and pass options"),
+    llvm::cl::value_desc("directory"),
+    llvm::cl::cat(ImportCategory));
+
 /// @}
 /// \name Passes options
 /// @{
@@ -670,6 +765,43 @@ static llvm_to_ar::Importer::ImportOptions make_import_options() {
   return opts;
 }
 
+/// \brief Return the path, size and modification time of the analyzer
+///
+/// This is part of the keys of the caches, so that cache entries are not
+/// reused after a rebuild of the analyzer.
+static std::string executable_stamp(const char* argv0) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  auto addr = reinterpret_cast< void* >(&executable_stamp);
+  std::string exe = llvm::sys::fs::getMainExecutable(argv0, addr);
+  boost::system::error_code ec;
+  std::string stamp = exe;
+  stamp += ":" + std::to_string(boost::filesystem::file_size(exe, ec));
+  stamp += ":" + std::to_string(boost::filesystem::last_write_time(exe, ec));
+  return stamp;
+}
+
+/// \brief Build the options identifying a cached AR, from command line
+/// arguments
+static std::string make_ar_cache_options(const char* argv0) {
+  std::string opts = executable_stamp(argv0);
+  opts += ":";
+  for (bool flag : {NoVerify.getValue(),
+                    NoLibIkos.getValue(),
+                    NoLibc.getValue(),
+                    NoLibcpp.getValue(),
+                    AllowDebugInfoMismatch.getValue(),
+                    NoTypeCheck.getValue(),
+                    NoSimplifyCFG.getValue(),
+                    AddLoopCounters.getValue(),
+                    AddPartitioningVariables.getValue(),
+                    NoSimplifyUpcastComparison.getValue(),
+                    NameValues.getValue(),
+                    NoNamePrefix.getValue()}) {
+    opts += flag ? '1' : '0';
+  }
+  return opts;
+}
+
 /// \brief Build format options from command line arguments
 static ar::Formatter::FormatOptions make_format_options() {
   ar::Formatter::FormatOptions opts;
@@ -785,7 +917,12 @@ static analyzer::AnalysisOptions make_analysis_options(ar::Bundle* bundle) {
       .no_init_globals = parse_function_names(NoInitGlobals, bundle),
       .machine_int_domain = Domain,
       .use_memopt = MemoryOptimization,
+      .memopt_delta_invariants = MemoptDeltaInvariants,
       .procedural = Procedural,
+      .jobs = Jobs,
+      .worker_mem = WorkerMem,
+      .memory_limit = MemoryLimit,
+      .fixpoint_jobs = FixpointJobs,
       .widening_strategy = WideningStrategy,
       .narrowing_strategy = NarrowingStrategy,
       .widening_delay = WideningDelay,
@@ -800,7 +937,9 @@ static analyzer::AnalysisOptions make_analysis_options(ar::Bundle* bundle) {
       .use_pointer = !NoPointer,
       .use_widening_hints = !NoWideningHints,
       .use_fixpoint_cache = !NoFixpointCache,
+      .summary_cache_size = SummaryCacheSize,
       .use_partitioning_domain = EnablePartitioningDomain,
+      .lazy_normalization = UseLazyNormalization,
       .globals_init_policy = GlobalsInitPolicy,
       .progress = Progress,
       .display_invariants = DisplayInvariants,
@@ -851,6 +990,41 @@ static void generate_dot(ar::Bundle* bundle,
   }
 }
 
+/// \brief Load the results of a pre-analysis from the cache, if any
+///
+/// On success, the loading time is saved as `<timer>(reused)` instead of the
+/// time of the pre-analysis.
+template < typename Fn >
+static bool reuse_preanalysis(analyzer::PreanalysisCache* cache,
+                              analyzer::TimesTable& times,
+                              const std::string& name,
+                              const std::string& timer_name,
+                              Fn load) {
+  if (cache == nullptr) {
+    return false;
+  }
+  analyzer::Timer timer;
+  timer.start();
+  bool reused = load(*cache);
+  timer.stop();
+  if (reused) {
+    analyzer::log::info("Reusing " + name + " results");
+    times.insert(timer_name + "(reused)", timer.elapsed().count());
+  }
+  return reused;
+}
+
+/// \brief Save the results of a pre-analysis in the cache, if any
+template < typename Fn >
+static void save_preanalysis(analyzer::PreanalysisCache* cache,
+                             const std::string& name,
+                             Fn save) {
+  if (cache != nullptr && !save(*cache)) {
+    analyzer::log::warning("Could not save " + name + " results in '" +
+                           ReusePreanalysis.getValue() + "'");
+  }
+}
+
 /// \brief Main for ikos-analyzer
 int main(int argc, char** argv) {
   llvm::InitLLVM x(argc, argv);
@@ -886,111 +1060,155 @@ int main(int argc, char** argv) {
     db.set_journal_mode(analyzer::sqlite::JournalMode::Off);
     db.set_synchronous_flag(analyzer::sqlite::SynchronousFlag::Off);
     analyzer::OutputDatabase output_db(db);
+    if (OutputFormat == analyzer::OutputFormat::Columnar) {
+      output_db.enable_columnar(OutputFilename + ".columnar");
+    }
 
     // Load the input module
     std::unique_ptr< llvm::Module > module = nullptr;
+    std::unique_ptr< analyzer::ArCache > ar_cache = nullptr;
     {
       analyzer::log::debug("Loading LLVM bitcode");
       analyzer::ScopeTimerDatabase t(output_db.times, "ikos-analyzer.load-bc");
+      llvm::ErrorOr< std::unique_ptr< llvm::MemoryBuffer > > buffer =
+          llvm::MemoryBuffer::getFileOrSTDIN(InputFilename);
+      if (std::error_code ec = buffer.getError()) {
+        llvm::errs() << progname << ": " << InputFilename
+                     << ": error: " << ec.message() << "\n";
+        return 2;
+      }
+      if (!ArCacheDirectory.empty()) {
+        ar_cache = std::make_unique< analyzer::ArCache >(
+            ArCacheDirectory.getValue(),
+            (*buffer)->getBuffer(),
+            make_ar_cache_options(argv[0]));
+      }
       llvm::SMDiagnostic err; // Error diagnostic
-      module = llvm::parseIRFile(InputFilename, err, llvm_context);
+      module = llvm::parseIR((*buffer)->getMemBufferRef(), err, llvm_context);
       if (!module) {
         err.print(progname.c_str(), llvm::errs());
         return 2;
       }
     }
 
-    // Immediately run the verifier to catch any problems
-    if (!NoVerify) {
-      analyzer::log::debug("Verifying integrity of LLVM bitcode");
+    // AR context
+    ar::Context ar_context;
+
+    // Load the AR from the cache
+    ar::Bundle* bundle = nullptr;
+    if (ar_cache) {
+      analyzer::log::debug("Loading AR from cache '" +
+                           ar_cache->path().string() + "'");
       analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.verify-bc");
-      if (verifyModule(*module, &llvm::errs())) {
-        llvm::errs() << progname << ": " << InputFilename
-                     << ": error: input module is broken!\n";
-        return 3;
+                                     "ikos-analyzer.load-ar-cache");
+      bundle = ar_cache->load(ar_context, *module);
+      if (bundle != nullptr) {
+        analyzer::log::info("Loaded AR from cache");
       }
     }
 
-    // Check for debug information in LLVM
-    {
-      analyzer::log::debug("Checking for debug information");
-      if (!llvm_to_ar::has_debug_info(*module)) {
-        llvm::errs() << progname << ": " << InputFilename
-                     << ": error: llvm bitcode has no debug information\n";
-        return 4;
+    // Translate the LLVM bitcode, unless the AR was loaded from the cache
+    if (bundle == nullptr) {
+      // Immediately run the verifier to catch any problems
+      if (!NoVerify) {
+        analyzer::log::debug("Verifying integrity of LLVM bitcode");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.verify-bc");
+        if (verifyModule(*module, &llvm::errs())) {
+          llvm::errs() << progname << ": " << InputFilename
+                       << ": error: input module is broken!\n";
+          return 3;
+        }
       }
-    }
 
-    // AR context
-    ar::Context ar_context;
+      // Check for debug information in LLVM
+      {
+        analyzer::log::debug("Checking for debug information");
+        if (!llvm_to_ar::has_debug_info(*module)) {
+          llvm::errs() << progname << ": " << InputFilename
+                       << ": error: llvm bitcode has no debug information\n";
+          return 4;
+        }
+      }
 
-    // Translate LLVM bitcode into AR
-    // This might throw ImportError, see catch()
-    ar::Bundle* bundle = nullptr;
-    {
-      analyzer::log::info("Translating LLVM bitcode to AR");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.llvm-to-ar");
-      llvm_to_ar::Importer importer(ar_context);
-      bundle = importer.import(*module, make_import_options());
-    }
+      // Translate LLVM bitcode into AR
+      // This might throw ImportError, see catch()
+      {
+        analyzer::log::info("Translating LLVM bitcode to AR");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.llvm-to-ar");
+        llvm_to_ar::Importer importer(ar_context);
+        bundle = importer.import(*module, make_import_options());
+      }
 
-    // Run type checker
-    if (!NoTypeCheck) {
-      analyzer::log::debug("Running type verifier on AR");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.type-checker");
-      if (!ar::TypeVerifier(/*all = */ true).verify(bundle, std::cerr)) {
-        llvm::errs() << progname << ": " << InputFilename
-                     << ": error: type checker\n";
-        return 7;
+      // Run type checker
+      if (!NoTypeCheck) {
+        analyzer::log::debug("Running type verifier on AR");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.type-checker");
+        if (!ar::TypeVerifier(/*all = */ true).verify(bundle, std::cerr)) {
+          llvm::errs() << progname << ": " << InputFilename
+                       << ": error: type checker\n";
+          return 7;
+        }
       }
-    }
 
-    // Check for debug information in AR
-    if (!ar::FrontendVerifier(/*all = */ true).verify(bundle, std::cerr)) {
-      return 8;
-    }
+      // Check for debug information in AR
+      if (!ar::FrontendVerifier(/*all = */ true).verify(bundle, std::cerr)) {
+        return 8;
+      }
 
-    // Simplify the control flow graph
-    if (!NoSimplifyCFG) {
-      analyzer::log::debug("Running simplify-cfg pass on AR");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.simplify-cfg");
-      ar::SimplifyCFGPass().run(bundle);
-    }
+      // Simplify the control flow graph
+      if (!NoSimplifyCFG) {
+        analyzer::log::debug("Running simplify-cfg pass on AR");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.simplify-cfg");
+        ar::SimplifyCFGPass().run(bundle);
+      }
 
-    // Add a loop counter in each cycle, for the Gauge domain
-    if (AddLoopCounters) {
-      analyzer::log::debug("Running add-loop-counters pass on AR");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.add-loop-counters");
-      ar::AddLoopCountersPass().run(bundle);
-    }
+      // Add a loop counter in each cycle, for the Gauge domain
+      if (AddLoopCounters) {
+        analyzer::log::debug("Running add-loop-counters pass on AR");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.add-loop-counters");
+        ar::AddLoopCountersPass().run(bundle);
+      }
 
-    // Add partitioning variable annotations, for the Partitioning domain
-    if (AddPartitioningVariables) {
-      analyzer::log::debug("Running add-partitioning-variables pass on AR");
-      analyzer::ScopeTimerDatabase
-          t(output_db.times, "ikos-analyzer.add-partitioning-variables");
-      ar::AddPartitioningVariablesPass().run(bundle);
-    }
+      // Add partitioning variable annotations, for the Partitioning domain
+      if (AddPartitioningVariables) {
+        analyzer::log::debug("Running add-partitioning-variables pass on AR");
+        analyzer::ScopeTimerDatabase
+            t(output_db.times, "ikos-analyzer.add-partitioning-variables");
+        ar::AddPartitioningVariablesPass().run(bundle);
+      }
 
-    // Simplify upcast comparison loop
-    if (!NoSimplifyUpcastComparison) {
-      analyzer::log::debug("Running simplify-upcast-comparison pass on AR");
-      analyzer::ScopeTimerDatabase
-          t(output_db.times, "ikos-analyzer.simplify-upcast-comparison");
-      ar::SimplifyUpcastComparisonPass().run(bundle);
-    }
+      // Simplify upcast comparison loop
+      if (!NoSimplifyUpcastComparison) {
+        analyzer::log::debug("Running simplify-upcast-comparison pass on AR");
+        analyzer::ScopeTimerDatabase
+            t(output_db.times, "ikos-analyzer.simplify-upcast-comparison");
+        ar::SimplifyUpcastComparisonPass().run(bundle);
+      }
 
-    // Name variables and basic block, for debugging purpose only
-    if (NameValues) {
-      analyzer::log::debug("Running name-values pass on AR");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.name-values");
-      ar::NameValuesPass(!NoNamePrefix).run(bundle);
+      // Name variables and basic block, for debugging purpose only
+      if (NameValues) {
+        analyzer::log::debug("Running name-values pass on AR");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.name-values");
+        ar::NameValuesPass(!NoNamePrefix).run(bundle);
+      }
+
+      // Save the AR in the cache
+      if (ar_cache) {
+        analyzer::log::debug("Saving AR in cache '" +
+                             ar_cache->path().string() + "'");
+        analyzer::ScopeTimerDatabase t(output_db.times,
+                                       "ikos-analyzer.save-ar-cache");
+        if (!ar_cache->save(bundle, *module)) {
+          analyzer::log::warning("Could not write AR cache '" +
+                                 ar_cache->path().string() + "'");
+        }
+      }
     }
 
     // Display the abstract representation
@@ -1034,16 +1252,45 @@ int main(int argc, char** argv) {
                           call_context_factory,
                           fixpoint_parameters);
 
+    // Cache of the pre-analyses results
+    std::unique_ptr< analyzer::PreanalysisCache > preanalysis_cache = nullptr;
+    if (!ReusePreanalysis.empty()) {
+      analyzer::log::debug("Hashing the AR for the pre-analysis cache");
+      analyzer::ScopeTimerDatabase t(output_db.times,
+                                     "ikos-analyzer.hash-ar");
+      std::string stamp = executable_stamp(argv[0]);
+      preanalysis_cache =
+          std::make_unique< analyzer::PreanalysisCache >(ctx,
+                                                         ReusePreanalysis
+                                                             .getValue(),
+                                                         stamp);
+    }
+
     // Run a liveness analysis
     //
     // The goal is to detect unused variables to speed up the following
     // analyses
     analyzer::LivenessAnalysis liveness(ctx);
     if (!NoLiveness) {
-      analyzer::log::info("Running liveness analysis");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.liveness-analysis");
-      liveness.run();
+      if (!reuse_preanalysis(preanalysis_cache.get(),
+                             output_db.times,
+                             "liveness analysis",
+                             "ikos-analyzer.liveness-analysis",
+                             [&](analyzer::PreanalysisCache& cache) {
+                               return cache.load(liveness);
+                             })) {
+        {
+          analyzer::log::info("Running liveness analysis");
+          analyzer::ScopeTimerDatabase t(output_db.times,
+                                         "ikos-analyzer.liveness-analysis");
+          liveness.run();
+        }
+        save_preanalysis(preanalysis_cache.get(),
+                         "liveness analysis",
+                         [&](analyzer::PreanalysisCache& cache) {
+                           return cache.save(liveness);
+                         });
+      }
       ctx.liveness = &liveness;
     }
     if (DisplayLiveness) {
@@ -1054,11 +1301,28 @@ int main(int argc, char** argv) {
     //
     // This is used to detect widening hints, useful for other analyses
     if (!NoWideningHints) {
-      analyzer::WideningHintAnalysis widening_hint(ctx);
-      analyzer::log::info("Running widening hint analysis");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.widening-hint-analysis");
-      widening_hint.run();
+      if (!reuse_preanalysis(preanalysis_cache.get(),
+                             output_db.times,
+                             "widening hint analysis",
+                             "ikos-analyzer.widening-hint-analysis",
+                             [&](analyzer::PreanalysisCache& cache) {
+                               return cache.load_widening_hints(
+                                   fixpoint_parameters);
+                             })) {
+        {
+          analyzer::WideningHintAnalysis widening_hint(ctx);
+          analyzer::log::info("Running widening hint analysis");
+          analyzer::ScopeTimerDatabase
+              t(output_db.times, "ikos-analyzer.widening-hint-analysis");
+          widening_hint.run();
+        }
+        save_preanalysis(preanalysis_cache.get(),
+                         "widening hint analysis",
+                         [&](analyzer::PreanalysisCache& cache) {
+                           return cache.save_widening_hints(
+                               fixpoint_parameters);
+                         });
+      }
     }
     if (DisplayFixpointParameters) {
       fixpoint_parameters.dump(analyzer::log::msg().stream());
@@ -1070,10 +1334,25 @@ int main(int argc, char** argv) {
     // precisely indirect calls in the following analyses
     analyzer::FunctionPointerAnalysis function_pointer(ctx);
     if (Procedural == analyzer::Procedural::Intraprocedural && !NoPointer) {
-      analyzer::log::info("Running function pointer analysis");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.function-pointer-analysis");
-      function_pointer.run();
+      if (!reuse_preanalysis(preanalysis_cache.get(),
+                             output_db.times,
+                             "function pointer analysis",
+                             "ikos-analyzer.function-pointer-analysis",
+                             [&](analyzer::PreanalysisCache& cache) {
+                               return cache.load(function_pointer);
+                             })) {
+        {
+          analyzer::log::info("Running function pointer analysis");
+          analyzer::ScopeTimerDatabase
+              t(output_db.times, "ikos-analyzer.function-pointer-analysis");
+          function_pointer.run();
+        }
+        save_preanalysis(preanalysis_cache.get(),
+                         "function pointer analysis",
+                         [&](analyzer::PreanalysisCache& cache) {
+                           return cache.save(function_pointer);
+                         });
+      }
       ctx.function_pointer = &function_pointer;
     }
     if (DisplayFunctionPointer) {
@@ -1085,16 +1364,34 @@ int main(int argc, char** argv) {
     // That step uses the result of the previous function pointer analysis.
     analyzer::PointerAnalysis pointer(ctx, function_pointer);
     if (Procedural == analyzer::Procedural::Intraprocedural && !NoPointer) {
-      analyzer::log::info("Running pointer analysis");
-      analyzer::ScopeTimerDatabase t(output_db.times,
-                                     "ikos-analyzer.pointer-analysis");
-      pointer.run();
+      if (!reuse_preanalysis(preanalysis_cache.get(),
+                             output_db.times,
+                             "pointer analysis",
+                             "ikos-analyzer.pointer-analysis",
+                             [&](analyzer::PreanalysisCache& cache) {
+                               return cache.load(pointer);
+                             })) {
+        {
+          analyzer::log::info("Running pointer analysis");
+          analyzer::ScopeTimerDatabase t(output_db.times,
+                                         "ikos-analyzer.pointer-analysis");
+          pointer.run();
+        }
+        save_preanalysis(preanalysis_cache.get(),
+                         "pointer analysis",
+                         [&](analyzer::PreanalysisCache& cache) {
+                           return cache.save(pointer);
+                         });
+      }
       ctx.pointer = &pointer;
     }
     if (DisplayPointer) {
       pointer.dump(analyzer::log::msg().stream());
     }
 
+    // Checks are written in the output database by a background thread
+    analyzer::ChecksTable::ScopeAsyncWriter checks_writer(output_db.checks);
+
     // Final step, run a value analysis, and check properties on the results
     if (Procedural == analyzer::Procedural::Interprocedural) {
       analyzer::value::interprocedural::Analysis analysis(ctx);
@@ -1123,11 +1420,32 @@ int main(int argc, char** argv) {
     } else {
       ikos_unreachable("unreachable");
     }
+
+    // Wait for the remaining checks to be written
+    {
+      analyzer::log::debug("Writing checks in the output database");
+      analyzer::ScopeTimerDatabase t(output_db.times,
+                                     "ikos-analyzer.write-checks");
+      checks_writer.finish();
+      output_db.close_columnar();
+    }
+
+    // Indexes are created once the tables are filled, which is faster
+    {
+      analyzer::log::debug("Creating indexes of the output database");
+      analyzer::ScopeTimerDatabase t(output_db.times,
+                                     "ikos-analyzer.create-indexes");
+      output_db.create_indexes();
+    }
     return 0;
   } catch (analyzer::sqlite::DbError& err) {
     llvm::errs() << progname << ": " << OutputFilename
                  << ": error: " << err.what() << "\n";
     return 1;
+  } catch (analyzer::columnar::Error& err) {
+    llvm::errs() << progname << ": " << OutputFilename
+                 << ": error: " << err.what() << "\n";
+    return 1;
   } catch (llvm_to_ar::ImportError& err) {
     llvm::errs() << progname << ": " << InputFilename
                  << ": error: " << err.what() << "\n";
@@ -0,0 +1,286 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Persistent cache of the abstract representation, implementation
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <fstream>
+#include <typeinfo>
+#include <vector>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <ikos/ar/format/binary.hpp>
+
+#include <ikos/analyzer/util/ar_cache.hpp>
+
+namespace ikos {
+namespace analyzer {
+
+namespace {
+
+/// \brief Kind of front-end object, stored in the low bits of identifiers
+enum FrontendTag : uint64_t {
+  ModuleTag = 1,
+  GlobalVariableTag,
+  FunctionTag,
+  BasicBlockTag,
+  ValueTag,
+};
+
+/// \brief Front-end mapping for a LLVM module
+///
+/// Global variables, functions, arguments, basic blocks and instructions are
+/// numbered in the order of the module, which is stable for a given bitcode.
+/// Constant expressions are numbered in the order of their first use in a
+/// global variable initializer or an instruction.
+///
+/// If an object of the bundle has a front-end object that cannot be numbered,
+/// the mapping is marked as incomplete, and the bundle should not be cached:
+/// the analyzer relies on the front-end objects for debug information and
+/// checks.
+class LLVMFrontendMapping final : public ar::FrontendMapping {
+private:
+  // LLVM module
+  llvm::Module& _module;
+
+  // Numbered values
+  std::vector< llvm::Value* > _values;
+
+  // Map from values to their index
+  llvm::DenseMap< const llvm::Value*, uint64_t > _indexes;
+
+  // True if all the saved front-end objects were numbered
+  bool _complete = true;
+
+public:
+  /// \brief Constructor
+  explicit LLVMFrontendMapping(llvm::Module& module) : _module(module) {
+    for (llvm::GlobalVariable& gv : module.globals()) {
+      this->add(&gv);
+    }
+    for (llvm::Function& fun : module) {
+      this->add(&fun);
+      for (llvm::Argument& arg : fun.args()) {
+        this->add(&arg);
+      }
+      for (llvm::BasicBlock& bb : fun) {
+        this->add(&bb);
+        for (llvm::Instruction& inst : bb) {
+          this->add(&inst);
+        }
+      }
+    }
+
+    llvm::SmallPtrSet< const llvm::Constant*, 16 > visited;
+    for (llvm::GlobalVariable& gv : module.globals()) {
+      if (gv.hasInitializer()) {
+        this->add_constant_exprs(gv.getInitializer(), visited);
+      }
+    }
+    for (llvm::Function& fun : module) {
+      for (llvm::BasicBlock& bb : fun) {
+        for (llvm::Instruction& inst : bb) {
+          for (llvm::Value* operand : inst.operands()) {
+            if (auto cst = llvm::dyn_cast< llvm::Constant >(operand)) {
+              this->add_constant_exprs(cst, visited);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /// \brief Return true if all the saved front-end objects were numbered
+  bool complete() const { return this->_complete; }
+
+  uint64_t save(const ar::Traceable& object) override {
+    const std::type_info& type = object.frontend_type();
+    uint64_t id = 0;
+    if (type == typeid(llvm::Module)) {
+      id = ModuleTag;
+    } else if (type == typeid(llvm::GlobalVariable)) {
+      id = this->id(object.frontend< llvm::GlobalVariable >(),
+                    GlobalVariableTag);
+    } else if (type == typeid(llvm::Function)) {
+      id = this->id(object.frontend< llvm::Function >(), FunctionTag);
+    } else if (type == typeid(llvm::BasicBlock)) {
+      id = this->id(object.frontend< llvm::BasicBlock >(), BasicBlockTag);
+    } else if (type == typeid(llvm::Value)) {
+      id = this->id(object.frontend< llvm::Value >(), ValueTag);
+    }
+    if (id == 0) {
+      this->_complete = false;
+    }
+    return id;
+  }
+
+  void restore(ar::Traceable& object, uint64_t id) override {
+    if ((id & 7) == ModuleTag) {
+      object.set_frontend(&this->_module);
+      return;
+    }
+
+    llvm::Value* value = this->_values.at(id >> 3);
+    switch (id & 7) {
+      case GlobalVariableTag: {
+        object.set_frontend(llvm::cast< llvm::GlobalVariable >(value));
+      } break;
+      case FunctionTag: {
+        object.set_frontend(llvm::cast< llvm::Function >(value));
+      } break;
+      case BasicBlockTag: {
+        object.set_frontend(llvm::cast< llvm::BasicBlock >(value));
+      } break;
+      case ValueTag: {
+        object.set_frontend< llvm::Value >(value);
+      } break;
+      default: {
+        ikos_unreachable("unexpected front-end tag");
+      }
+    }
+  }
+
+private:
+  /// \brief Number the given value
+  void add(llvm::Value* value) {
+    this->_indexes.try_emplace(value, this->_values.size());
+    this->_values.push_back(value);
+  }
+
+  /// \brief Number the constant expressions used by the given constant
+  void add_constant_exprs(
+      const llvm::Constant* cst,
+      llvm::SmallPtrSet< const llvm::Constant*, 16 >& visited) {
+    if (llvm::isa< llvm::GlobalValue >(cst) || !visited.insert(cst).second) {
+      return;
+    }
+    if (llvm::isa< llvm::ConstantExpr >(cst)) {
+      this->add(const_cast< llvm::Constant* >(cst));
+    }
+    for (const llvm::Use& operand : cst->operands()) {
+      if (auto op = llvm::dyn_cast< llvm::Constant >(operand.get())) {
+        this->add_constant_exprs(op, visited);
+      }
+    }
+  }
+
+  /// \brief Return the identifier of the given value, or 0 if unknown
+  uint64_t id(const llvm::Value* value, FrontendTag tag) const {
+    auto it = this->_indexes.find(value);
+    if (it == this->_indexes.end()) {
+      return 0;
+    }
+    return (it->second << 3) | tag;
+  }
+
+}; // end class LLVMFrontendMapping
+
+} // end anonymous namespace
+
+ArCache::ArCache(const boost::filesystem::path& directory,
+                 llvm::StringRef bitcode,
+                 llvm::StringRef options) {
+  llvm::MD5 hash;
+  hash.update(bitcode);
+  hash.update(options);
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  llvm::SmallString< 32 > digest;
+  llvm::MD5::stringifyResult(result, digest);
+  this->_path = directory / (digest.str().str() + ".ar");
+}
+
+ar::Bundle* ArCache::load(ar::Context& ctx, llvm::Module& module) const {
+  llvm::ErrorOr< std::unique_ptr< llvm::MemoryBuffer > > buffer =
+      llvm::MemoryBuffer::getFile(this->_path.string(),
+                                  /*FileSize = */ -1,
+                                  /*RequiresNullTerminator = */ false);
+  if (!buffer ||
+      !ar::BinaryReader::is_valid((*buffer)->getBufferStart(),
+                                  (*buffer)->getBufferSize())) {
+    return nullptr;
+  }
+
+  LLVMFrontendMapping frontend(module);
+  return ar::BinaryReader(ctx, &frontend)
+      .read((*buffer)->getBufferStart(), (*buffer)->getBufferSize());
+}
+
+bool ArCache::save(ar::Bundle* bundle, llvm::Module& module) const {
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(this->_path.parent_path(), ec);
+  if (ec) {
+    return false;
+  }
+
+  // Write in a temporary file first, so that concurrent runs never read a
+  // partial cache entry
+  boost::filesystem::path tmp = this->_path;
+  tmp += boost::filesystem::unique_path(".%%%%-%%%%.tmp");
+  {
+    std::ofstream out(tmp.string(), std::ios::out | std::ios::binary);
+    LLVMFrontendMapping frontend(module);
+    if (out) {
+      ar::BinaryWriter(&frontend).write(out, bundle);
+    }
+    if (!out || !frontend.complete()) {
+      // Do not cache a bundle that would lose front-end objects when loaded
+      out.close();
+      boost::filesystem::remove(tmp, ec);
+      return false;
+    }
+  }
+
+  boost::filesystem::rename(tmp, this->_path, ec);
+  if (ec) {
+    boost::filesystem::remove(tmp, ec);
+    return false;
+  }
+  return true;
+}
+
+} // end namespace analyzer
+} // end namespace ikos
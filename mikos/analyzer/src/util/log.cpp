@@ -51,11 +51,13 @@ namespace analyzer {
 // LoggerOutputStream
 
 void LogMessage::start() {
+  this->_logger->_mutex.lock();
   this->_logger->start_message();
 }
 
 void LogMessage::end() {
   this->_logger->end_message();
+  this->_logger->_mutex.unlock();
 }
 
 // TerminalLogger
@@ -65,6 +65,8 @@ InteractiveProgressLogger::InteractiveProgressLogger(std::ostream& out,
       _out_columns(std::max(out_columns, std::size_t{3})) {}
 
 void InteractiveProgressLogger::start_task(StringRef status) {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
+
   // Update the current task
   this->_current_task++;
 
@@ -120,6 +122,7 @@ LinearProgressLogger::LinearProgressLogger(std::ostream& out,
     : ProgressLogger(out), _current_task(0), _num_tasks(num_tasks) {}
 
 void LinearProgressLogger::start_task(StringRef status) {
+  std::lock_guard< std::recursive_mutex > lock(this->_mutex);
   this->_current_task++;
   this->_out << "[" << this->_current_task << "/" << this->_num_tasks << "] "
              << status << "\n";
@@ -0,0 +1,29 @@
+// DEFINITE UNSAFE
+//
+// The two callers allocate different memory blocks through alloc(), thus a
+// function summary of alloc() cannot be reused from one to the other.
+#include <stdlib.h>
+
+static int* alloc(void) {
+  int* p = (int*)malloc(sizeof(int));
+  if (p == NULL) {
+    exit(1);
+  }
+  return p;
+}
+
+static int* first(void) {
+  return alloc();
+}
+
+static int* second(void) {
+  return alloc();
+}
+
+int main() {
+  int* a = first();
+  int* b = second();
+  *a = 0;
+  *b = 1;
+  return 10 / *a;
+}
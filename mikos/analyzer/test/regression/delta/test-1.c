@@ -0,0 +1,71 @@
+extern int __ikos_nondet_int(void);
+extern void __ikos_print_values(const char* desc, ...);
+
+// Chains of blocks with a single predecessor, in nested loops
+//
+// Each block prints values, so that its pre invariant is cached. The pre
+// invariant of a block whose single predecessor is not a loop head is derived
+// from the predecessor with -memopt-delta-invariants.
+int nested(int n) {
+  int s = 0;
+  for (int i = 0; i < n; i++) {
+    __ikos_print_values("outer body", i, s);
+    if (i % 2 == 0) {
+      __ikos_print_values("outer then", i, s);
+      s = s + 1;
+      if (s > 10) {
+        __ikos_print_values("outer then then", i, s);
+        s = 0;
+      }
+    }
+    for (int j = 0; j < i; j++) {
+      __ikos_print_values("inner body", i, j, s);
+      if (j > 3) {
+        __ikos_print_values("inner then", i, j, s);
+        for (int k = j; k < 10; k++) {
+          __ikos_print_values("innermost body", i, j, k);
+          if (k == 5) {
+            __ikos_print_values("innermost then", i, j, k);
+            s += k;
+          }
+        }
+        __ikos_print_values("after innermost", i, j, s);
+      }
+      s += j;
+    }
+    __ikos_print_values("after inner", i, s);
+  }
+  __ikos_print_values("after outer", n, s);
+  return s;
+}
+
+// Callee analyzed in the loop of its caller
+int callee(int x, int y) {
+  int r = 0;
+  while (r < x) {
+    __ikos_print_values("callee body", r, x);
+    if (r > y) {
+      __ikos_print_values("callee then", r, y);
+      r += 2;
+    } else {
+      r += 1;
+    }
+  }
+  return r;
+}
+
+int main(void) {
+  int n = __ikos_nondet_int();
+  int t = 0;
+  if (n > 0 && n < 100) {
+    t = nested(n);
+    for (int i = 0; i < 3; i++) {
+      __ikos_print_values("main body", i, t);
+      t += callee(i + 4, 2);
+      if (t > 5) {
+        __ikos_print_values("main then", i, t);
+      }
+    }
+  }
+  return t;
+}
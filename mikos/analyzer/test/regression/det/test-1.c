@@ -0,0 +1,50 @@
+#include <stdbool.h>
+#include <stdlib.h>
+
+extern int __ikos_nondet_int(void);
+
+int g1[10];
+int g2[20];
+int g3[30];
+
+void f1(int i) {
+  int local[5];
+  int* p = __ikos_nondet_int() ? g1 : local;
+  p[i] = 1;
+}
+
+void f2(int i) {
+  int* p = malloc(10 * sizeof(int));
+  int* q = __ikos_nondet_int() ? p : g2;
+  q[i] = 2;
+  free(p);
+}
+
+bool f3(int* a, int* b) {
+  int* p = __ikos_nondet_int() ? a : g3;
+  return p < b;
+}
+
+void f4(void) {
+  int* p = malloc(sizeof(int));
+  int* q = malloc(sizeof(int));
+  int* r = __ikos_nondet_int() ? p : q;
+  free(p);
+  free(r);
+  free(q);
+}
+
+void f5(void (*fun)(int)) {
+  void (*callee)(int) = __ikos_nondet_int() ? fun : f1;
+  callee(3);
+}
+
+int main(int argc, char** argv) {
+  int x[4];
+  f1(argc);
+  f2(argc);
+  f3(x, g1);
+  f4();
+  f5(f2);
+  return g3[argc];
+}
@@ -41,7 +41,9 @@
 ###############################################################################
 import argparse
 import atexit
+import collections
 import os
+import re
 import shutil
 import sqlite3
 import subprocess
@@ -204,6 +206,16 @@ def clang_ikos_flags():
     ]
 
 
+# Tables of the output database that do not depend on the number of threads
+DETERMINISTIC_TABLES = (
+    'functions',
+    'statements',
+    'call_contexts',
+    'memory_locations',
+    'checks',
+)
+
+
 class Result:
     OK = 0
     WARNING = 1
@@ -227,6 +239,16 @@ class Database:
         self.cursor.execute('SELECT COUNT(*) FROM checks %s' % where)
         return self.cursor.fetchone()[0]
 
+    def dump(self, table):
+        self.cursor.execute('SELECT * FROM %s ORDER BY id' % table)
+        return self.cursor.fetchall()
+
+    def get_statistic(self, name):
+        self.cursor.execute('SELECT value FROM statistics WHERE name=?',
+                            (name,))
+        row = self.cursor.fetchone()
+        return row[0] if row else None
+
     def get_line_status(self, line):
         self.cursor.execute('SELECT checks.status FROM checks INNER JOIN statements ON checks.statement_id = statements.id WHERE statements.line=%d' % line)
         return [row[0] for row in self.cursor.fetchall()]
@@ -254,7 +276,8 @@ class Test:
                  entry_points=None,
                  procedural=None,
                  options=None,
-                 line_checks=None):
+                 line_checks=None,
+                 memopt=True):
         if not isinstance(analyses, list):
             analyses = [analyses]
 
@@ -273,8 +296,10 @@ class Test:
         self.procedural = procedural or 'inter'
         self.options = options or []
         self.line_checks = line_checks or []
+        self.memopt = memopt
 
-    def run(self, root, output_db):
+    def compile(self, root):
+        ''' Compile and preprocess the test, return the path of the bitcode '''
         fullpath = os.path.join(root, self.filename)
         assert os.path.exists(fullpath)
 
@@ -304,23 +329,31 @@ class Test:
         subprocess.check_call(cmd,
                               stdout=subprocess.PIPE,
                               stderr=subprocess.PIPE)
+        return pp_path
 
-        # run ikos analyzer
+    def analyze(self, pp_path, output_db, options=()):
+        ''' Run ikos-analyzer on the given bitcode, return the command and
+        its output '''
         cmd = [find_ikos_analyzer(),
                '-a=%s' % ','.join(self.analyses),
-               '-memopt',
                '-d=%s' % self.domain,
                '-entry-points=%s' % ','.join(self.entry_points),
                '-proc=%s' % self.procedural]
+        if self.memopt:
+            cmd.append('-memopt')
         cmd.extend(self.options)
+        cmd.extend(options)
         if self.opt_level == 'aggressive':
             cmd.append('-allow-dbg-mismatch')
         if 'gauge' in self.domain:
             cmd.append('-add-loop-counters')
         cmd += [pp_path, '-o', output_db]
-        subprocess.check_call(cmd,
-                              stdout=subprocess.PIPE,
-                              stderr=subprocess.PIPE)
+        output = subprocess.check_output(cmd, stderr=subprocess.PIPE)
+        return cmd, output.decode('utf-8')
+
+    def run(self, root, output_db):
+        pp_path = self.compile(root)
+        cmd, _ = self.analyze(pp_path, output_db)
 
         with Database(output_db) as db:
             # Get the global result
@@ -390,6 +423,247 @@ class Test:
             return ret
 
 
+class DeterminismTest(Test):
+    ''' Run the analyzer twice and check that both output databases are equal '''
+
+    def run(self, root, output_db):
+        pp_path = self.compile(root)
+        cmd, _ = self.analyze(pp_path, output_db)
+        with Database(output_db) as db:
+            first = {table: db.dump(table) for table in DETERMINISTIC_TABLES}
+
+        self.analyze(pp_path, output_db)
+        with Database(output_db) as db:
+            second = {table: db.dump(table) for table in DETERMINISTIC_TABLES}
+
+        ret = TestResult('PASS')
+        for table in DETERMINISTIC_TABLES:
+            if first[table] != second[table]:
+                ret.code = 'FAIL'
+                ret.add_comment('Table "%s" differs between two runs.' % table)
+
+        if ret.code == 'FAIL':
+            ret.comments.insert(0, 'Running %r' % cmd)
+
+        return ret
+
+
+class DeltaInvariantsTest(Test):
+    ''' Run the analyzer with and without -memopt-delta-invariants, and check
+    that the invariants printed by the debug checker and both output databases
+    are equal '''
+
+    def run(self, root, output_db):
+        pp_path = self.compile(root)
+        cmd, stored = self.analyze(pp_path, output_db)
+        with Database(output_db) as db:
+            first = {table: db.dump(table) for table in DETERMINISTIC_TABLES}
+
+        _, derived = self.analyze(pp_path, output_db,
+                                  ['-memopt-delta-invariants'])
+        with Database(output_db) as db:
+            second = {table: db.dump(table) for table in DETERMINISTIC_TABLES}
+
+        ret = TestResult('PASS')
+        if '__ikos_print_values' not in stored:
+            ret.code = 'FAIL'
+            ret.add_comment('No invariants printed.')
+        elif stored != derived:
+            ret.code = 'FAIL'
+            ret.add_comment('Printed invariants differ with '
+                            '-memopt-delta-invariants.')
+        for table in DETERMINISTIC_TABLES:
+            if first[table] != second[table]:
+                ret.code = 'FAIL'
+                ret.add_comment('Table "%s" differs with '
+                                '-memopt-delta-invariants.' % table)
+
+        if ret.code == 'FAIL':
+            ret.comments.insert(0, 'Running %r' % cmd)
+
+        return ret
+
+
+class SummaryCacheTest(Test):
+    ''' Run the analyzer with -summary-cache, and check the results and the
+    number of calls that used a function summary '''
+
+    def __init__(self, filename, description, analyses, result, hits,
+                 **kwargs):
+        # function summaries are not supported with -memopt
+        Test.__init__(self, filename, description, analyses, result,
+                      memopt=False, **kwargs)
+        self.options = self.options + ['-summary-cache=16']
+        self.hits = hits
+
+    def run(self, root, output_db):
+        ret = Test.run(self, root, output_db)
+        with Database(output_db) as db:
+            hits = db.get_statistic('summary-cache.hits')
+
+        if hits is None or hits < self.hits:
+            ret.code = 'FAIL'
+            ret.add_comment('Got %s summary hits, was expecting at least %d.'
+                            % (hits, self.hits))
+
+        return ret
+
+
+class LivenessTest(Test):
+    ''' Check the liveness analysis against a reference computed on the
+    abstract representation printed by -display-ar '''
+
+    def __init__(self, filename, description, **kwargs):
+        # the checks are not compared, only the liveness results
+        Test.__init__(self, filename, description, 'boa', 'safe', **kwargs)
+
+    @staticmethod
+    def parse(output):
+        ''' Parse the output of -display-liveness
+
+        Return a map from (code, 'live_at_entry(block)' or 'dead_at_end(block)')
+        to the sorted list of variables, or 'none' '''
+        results = {}
+        code = None
+        for line in output.splitlines():
+            if line.startswith('Liveness analysis results for '):
+                code = line
+            elif line.startswith(('live_at_entry(', 'dead_at_end(')):
+                key, _, value = line.partition(' = ')
+                if value != 'none':
+                    value = sorted(v for v in value[1:-1].split(', ') if v)
+                results[(code, key)] = value
+        return results
+
+    @staticmethod
+    def parse_ar(output):
+        ''' Parse the output of -display-ar -no-show-result-type
+
+        Return a map from the header of the liveness results of each code to
+        a (blocks, exit) pair, where blocks is a map from block name to a
+        (successors, statements) pair '''
+        codes = {}
+        blocks = None
+        block = None
+        for line in output.splitlines():
+            if line.startswith('define ') and line.endswith(' {'):
+                name = re.search(r' (@[^\s(,]+)', line).group(1)
+                if line.endswith(', init {'):
+                    code = ('Liveness analysis results for initializer of '
+                            'global variable %s:' % name)
+                else:
+                    code = 'Liveness analysis results for function %s:' % name
+                blocks = collections.OrderedDict()
+                codes[code] = [blocks, None]
+            elif blocks is None:
+                continue
+            elif line.startswith('#'):
+                name = line.split(' ', 1)[0]
+                succs = re.search(r' successors=\{([^}]*)\}', line)
+                succs = succs.group(1).split(', ') if succs else []
+                block = (succs, [])
+                blocks[name] = block
+                if ' !exit' in line:
+                    codes[code][1] = name
+            elif line.startswith('  ') and block is not None:
+                block[1].append(line.strip())
+            elif line == '}':
+                if block is not None:
+                    block = None
+                else:
+                    blocks = None
+        return codes
+
+    @staticmethod
+    def reference(blocks, exit):
+        ''' Compute the liveness of a code by round-robin iteration
+
+        Return the same map as parse(), for one code '''
+        results = {}
+        for name in blocks:
+            results['live_at_entry(%s)' % name] = 'none'
+            results['dead_at_end(%s)' % name] = 'none'
+        if exit is None:
+            return results
+
+        # only the blocks that can reach the exit block are analyzed
+        preds = collections.defaultdict(set)
+        for name, (succs, _) in blocks.items():
+            for succ in succs:
+                preds[succ].add(name)
+        reach = set([exit])
+        worklist = [exit]
+        while worklist:
+            for pred in preds[worklist.pop()]:
+                if pred not in reach:
+                    reach.add(pred)
+                    worklist.append(pred)
+
+        # kill, gen and all sets of each block
+        kill, gen, used = {}, {}, {}
+        for name in reach:
+            kill[name], gen[name], used[name] = set(), set(), set()
+            for stmt in reversed(blocks[name][1]):
+                match = re.match(r'([%$@][^\s,()]+) = (.*)$', stmt)
+                if match:
+                    kill[name].add(match.group(1))
+                    gen[name].discard(match.group(1))
+                    used[name].add(match.group(1))
+                    stmt = match.group(2)
+                for var in re.findall(r'[%$@][^\s,()\[\]{}<>]+', stmt):
+                    gen[name].add(var)
+                    used[name].add(var)
+
+        live_in = dict((name, set()) for name in reach)
+        live_out = dict((name, set()) for name in reach)
+        changed = True
+        while changed:
+            changed = False
+            for name in reach:
+                out = set()
+                for succ in blocks[name][0]:
+                    out |= live_in.get(succ, set())
+                live_out[name] = out
+                new = (out - kill[name]) | gen[name]
+                if new != live_in[name]:
+                    live_in[name] = new
+                    changed = True
+
+        for name in reach:
+            results['live_at_entry(%s)' % name] = sorted(live_in[name])
+            results['dead_at_end(%s)' % name] = sorted(used[name] -
+                                                       live_out[name])
+        return results
+
+    def run(self, root, output_db):
+        pp_path = self.compile(root)
+        cmd, output = self.analyze(pp_path, output_db,
+                                   ['-display-ar',
+                                    '-no-show-result-type',
+                                    '-display-liveness'])
+        got = self.parse(output)
+        expected = {}
+        for code, (blocks, exit) in self.parse_ar(output).items():
+            for key, value in self.reference(blocks, exit).items():
+                expected[(code, key)] = value
+
+        ret = TestResult('PASS')
+        if not got or not expected:
+            ret.code = 'FAIL'
+            ret.add_comment('No liveness results.')
+        for key in sorted(set(got) | set(expected), key=str):
+            if got.get(key) != expected.get(key):
+                ret.code = 'FAIL'
+                ret.add_comment('%s, %s: got %s, was expecting %s.'
+                                % (key[0], key[1],
+                                   got.get(key), expected.get(key)))
+
+        if ret.code == 'FAIL':
+            ret.comments.insert(0, 'Running %r' % cmd)
+
+        return ret
+
+
 class TestManager:
     def __init__(self, root):
         self.root = root
@@ -0,0 +1,105 @@
+#include <stdlib.h>
+
+extern int __ikos_nondet_int(void);
+
+int g;
+
+// Variables merged after a branch (phi nodes)
+int branch(int x, int y) {
+  int z;
+  if (x > y) {
+    z = x - y;
+  } else {
+    z = y - x;
+  }
+  return z + x;
+}
+
+// Loop-carried variables (phi nodes on the loop head)
+int sum(int n) {
+  int s = 0;
+  int p = 1;
+  for (int i = 0; i < n; i++) {
+    s += i;
+    p = p * 2 + s;
+  }
+  return s + p;
+}
+
+// Nested loops, with break and continue
+int nested(int n, int m) {
+  int total = 0;
+  int last = -1;
+  for (int i = 0; i < n; i++) {
+    int j = 0;
+    while (j < m) {
+      if ((i + j) % 3 == 0) {
+        j++;
+        continue;
+      }
+      if (total > 1000) {
+        break;
+      }
+      total += i * j;
+      last = j;
+      j++;
+    }
+    g = last;
+  }
+  return total;
+}
+
+// Variables swapped in a loop, used on the exit edge only
+int swap(int a, int b, int n) {
+  int k = 0;
+  do {
+    int t = a;
+    a = b;
+    b = t;
+    k++;
+  } while (k < n);
+  return a - b;
+}
+
+// Loop without exit, followed by unreachable code
+void spin(int* p) {
+  int x = 0;
+  for (;;) {
+    x = x + *p;
+    *p = x;
+  }
+}
+
+// Switch with fall-through
+int sw(int x) {
+  int r = 0;
+  switch (x) {
+    case 0:
+      r = 1;
+    case 1:
+      r += 2;
+      break;
+    case 2:
+      r = x * 3;
+      break;
+    default:
+      r = -x;
+  }
+  return r;
+}
+
+int main(int argc, char** argv) {
+  int* p = (int*)malloc(sizeof(int));
+  if (p == NULL) {
+    return 1;
+  }
+  *p = 0;
+  int n = __ikos_nondet_int();
+  int r = branch(argc, n) + sum(n) + nested(n, argc) + swap(argc, n, 3) +
+          sw(n);
+  if (n == 42) {
+    spin(p);
+  }
+  free(p);
+  return r;
+}
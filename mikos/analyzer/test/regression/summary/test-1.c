@@ -0,0 +1,26 @@
+extern void __ikos_assert(int);
+extern int __ikos_nondet_int(void);
+
+// Cannot allocate memory, so its summaries can be reused
+int inc(int a) {
+  return a + 1;
+}
+
+int main(void) {
+  int x = __ikos_nondet_int();
+  int r = 0;
+  if (x >= 0 && x <= 10) {
+    // Analyzed, the summary has x in [0, 10] at the entry
+    int r1 = inc(x);
+    __ikos_assert(r1 >= 1 && r1 <= 11);
+    r += r1;
+    if (x == 5) {
+      // Another call site, with a smaller entry invariant: uses the summary,
+      // hence r2 is in [1, 11] instead of 6
+      int r2 = inc(x);
+      __ikos_assert(r2 >= 1 && r2 <= 11);
+      r += r2;
+    }
+  }
+  return r;
+}
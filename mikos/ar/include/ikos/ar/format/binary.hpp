@@ -0,0 +1,143 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Binary format for the abstract representation
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+#include <ikos/ar/semantic/bundle.hpp>
+#include <ikos/ar/semantic/context.hpp>
+#include <ikos/ar/support/traceable.hpp>
+
+namespace ikos {
+namespace ar {
+
+/// \brief Mapping between front-end objects and integers
+///
+/// The binary format cannot store front-end pointers. Instead, the writer asks
+/// the mapping for an integer identifying the front-end object of each
+/// traceable object (bundle, global variable, function, code, basic block,
+/// statement and variable), and the reader asks the mapping to attach the
+/// front-end object back.
+class FrontendMapping {
+public:
+  /// \brief Default constructor
+  FrontendMapping() = default;
+
+  /// \brief No copy constructor
+  FrontendMapping(const FrontendMapping&) = delete;
+
+  /// \brief No move constructor
+  FrontendMapping(FrontendMapping&&) = delete;
+
+  /// \brief No copy assignment operator
+  FrontendMapping& operator=(const FrontendMapping&) = delete;
+
+  /// \brief No move assignment operator
+  FrontendMapping& operator=(FrontendMapping&&) = delete;
+
+  /// \brief Destructor
+  virtual ~FrontendMapping();
+
+  /// \brief Return a non-zero identifier for the front-end object of the given
+  /// traceable object, or 0 if it should not be saved
+  virtual uint64_t save(const Traceable& object) = 0;
+
+  /// \brief Attach the front-end object with the given non-zero identifier to
+  /// the given traceable object
+  virtual void restore(Traceable& object, uint64_t id) = 0;
+
+}; // end class FrontendMapping
+
+/// \brief Binary format writer
+///
+/// Writes a whole bundle (data layout, types, constants, global variables,
+/// functions and their code) in a compact binary format that can be loaded
+/// back with BinaryReader.
+class BinaryWriter {
+private:
+  // Front-end mapping, or null
+  FrontendMapping* _frontend;
+
+public:
+  /// \brief Public constructor
+  ///
+  /// \param frontend Front-end mapping, or null to drop front-end pointers
+  explicit BinaryWriter(FrontendMapping* frontend = nullptr)
+      : _frontend(frontend) {}
+
+  /// \brief Write the given bundle
+  void write(std::ostream&, Bundle*) const;
+
+}; // end class BinaryWriter
+
+/// \brief Binary format reader
+class BinaryReader {
+private:
+  // AR context
+  Context& _context;
+
+  // Front-end mapping, or null
+  FrontendMapping* _frontend;
+
+public:
+  /// \brief Public constructor
+  ///
+  /// \param ctx AR context
+  /// \param frontend Front-end mapping, or null to ignore front-end pointers
+  explicit BinaryReader(Context& ctx, FrontendMapping* frontend = nullptr)
+      : _context(ctx), _frontend(frontend) {}
+
+  /// \brief Return true if the given buffer holds a bundle in binary format
+  ///
+  /// This checks the header, the format version and the checksum.
+  static bool is_valid(const char* data, std::size_t size);
+
+  /// \brief Read a bundle from the given buffer
+  ///
+  /// The buffer does not need to outlive the bundle.
+  ///
+  /// Returns null if the buffer is not valid (see is_valid()).
+  Bundle* read(const char* data, std::size_t size) const;
+
+}; // end class BinaryReader
+
+} // end namespace ar
+} // end namespace ikos
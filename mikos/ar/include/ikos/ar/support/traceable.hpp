@@ -114,6 +114,14 @@ public:
   /// \brief Return true if this object has a pointer to a front-end object
   bool has_frontend() const { return this->_frontend != nullptr; }
 
+  /// \brief Return the type of the front-end object
+  ///
+  /// Precondition: has_frontend() is true
+  const std::type_info& frontend_type() const {
+    ikos_assert_msg(this->_frontend, "no front-end pointer");
+    return *this->_frontend_type_info;
+  }
+
   /// \brief Return the pointer to a front-end object
   ///
   /// Precondition: has_frontend() is true
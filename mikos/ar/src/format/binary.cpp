@@ -0,0 +1,1255 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Binary format for the abstract representation, implementation
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ikos/ar/format/binary.hpp>
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/data_layout.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/semantic/type.hpp>
+#include <ikos/ar/semantic/value.hpp>
+#include <ikos/ar/support/assert.hpp>
+#include <ikos/ar/support/cast.hpp>
+
+namespace ikos {
+namespace ar {
+
+// FrontendMapping
+
+FrontendMapping::~FrontendMapping() = default;
+
+namespace {
+
+/// \brief Magic number at the beginning of a binary bundle
+const char Magic[8] = {'I', 'K', 'O', 'S', '-', 'A', 'R', '\0'};
+
+/// \brief Version of the binary format
+///
+/// This must be incremented whenever the format or the enumerations of the
+/// abstract representation (types, values, statements, intrinsics) change.
+const uint64_t Version = 1;
+
+/// \brief Size of the header: magic, version, payload size and checksum
+const std::size_t HeaderSize = 32;
+
+/// \brief Return the FNV-1a hash of the given buffer
+uint64_t checksum(const char* data, std::size_t size) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (std::size_t i = 0; i < size; i++) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    h ^= static_cast< unsigned char >(data[i]);
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+/// \brief Write a 64-bit little-endian integer at the given position
+void write_u64(char* p, uint64_t n) {
+  for (std::size_t i = 0; i < 8; i++) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    p[i] = static_cast< char >((n >> (8 * i)) & 0xff);
+  }
+}
+
+/// \brief Read a 64-bit little-endian integer at the given position
+uint64_t read_u64(const char* p) {
+  uint64_t n = 0;
+  for (std::size_t i = 0; i < 8; i++) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    n |= uint64_t(static_cast< unsigned char >(p[i])) << (8 * i);
+  }
+  return n;
+}
+
+/// \brief Tag of a reference to a value
+///
+/// A value reference is encoded as `(index << 3) | tag`.
+enum ValueTag : uint64_t {
+  NullTag,
+  ConstantTag,
+  GlobalVariableTag,
+  LocalVariableTag,
+  InternalVariableTag,
+};
+
+/// \brief Output buffer
+///
+/// Integers are encoded in LEB128, so that small integers take one byte.
+class Output {
+private:
+  std::string _buf;
+
+public:
+  /// \brief Write an unsigned integer
+  void uint(uint64_t n) {
+    while (n >= 0x80) {
+      this->_buf.push_back(static_cast< char >((n & 0x7f) | 0x80));
+      n >>= 7;
+    }
+    this->_buf.push_back(static_cast< char >(n));
+  }
+
+  /// \brief Write a signed integer
+  void sint(int64_t n) {
+    // Zig-zag encoding
+    this->uint((static_cast< uint64_t >(n) << 1) ^
+               static_cast< uint64_t >(n >> 63));
+  }
+
+  /// \brief Write a boolean
+  void boolean(bool b) { this->_buf.push_back(b ? 1 : 0); }
+
+  /// \brief Write a string
+  void string(const std::string& s) {
+    this->uint(s.size());
+    this->_buf.append(s);
+  }
+
+  /// \brief Write an unlimited precision integer
+  void znumber(const ZNumber& n) {
+    if (n.fits< int64_t >()) {
+      this->boolean(false);
+      this->sint(n.to< int64_t >());
+    } else {
+      this->boolean(true);
+      this->string(n.str(16));
+    }
+  }
+
+  /// \brief Append another buffer
+  void append(const Output& o) { this->_buf.append(o._buf); }
+
+  /// \brief Return the content of the buffer
+  const std::string& str() const { return this->_buf; }
+
+}; // end class Output
+
+/// \brief Input buffer
+///
+/// The buffer was validated by its checksum, hence reads are only checked by
+/// assertions.
+class Input {
+private:
+  const char* _cur;
+  const char* _end;
+
+public:
+  /// \brief Constructor
+  Input(const char* begin, const char* end) : _cur(begin), _end(end) {}
+
+  /// \brief Read an unsigned integer
+  uint64_t uint() {
+    uint64_t n = 0;
+    unsigned shift = 0;
+    while (true) {
+      ikos_assert_msg(this->_cur != this->_end, "unexpected end of buffer");
+      auto byte = static_cast< unsigned char >(*this->_cur++);
+      n |= uint64_t(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return n;
+      }
+      shift += 7;
+    }
+  }
+
+  /// \brief Read a signed integer
+  int64_t sint() {
+    uint64_t n = this->uint();
+    return static_cast< int64_t >((n >> 1) ^ (~(n & 1) + 1));
+  }
+
+  /// \brief Read a boolean
+  bool boolean() {
+    ikos_assert_msg(this->_cur != this->_end, "unexpected end of buffer");
+    return *this->_cur++ != 0;
+  }
+
+  /// \brief Read a string
+  std::string string() {
+    auto size = static_cast< std::size_t >(this->uint());
+    ikos_assert_msg(size <= static_cast< std::size_t >(this->_end - this->_cur),
+                    "unexpected end of buffer");
+    std::string s(this->_cur, size);
+    this->_cur += size;
+    return s;
+  }
+
+  /// \brief Read an unlimited precision integer
+  ZNumber znumber() {
+    if (this->boolean()) {
+      return ZNumber::from_string(this->string(), 16);
+    } else {
+      return ZNumber(this->sint());
+    }
+  }
+
+  /// \brief Return true if the whole buffer was read
+  bool at_end() const { return this->_cur == this->_end; }
+
+}; // end class Input
+
+/// \brief Implementation of the binary writer
+///
+/// The payload is made of the following sections, in order:
+///   * the target triple and the data layout
+///   * the types (structure types first created empty)
+///   * the structure layouts
+///   * the global variables and functions (names, types and attributes)
+///   * the constants
+///   * the code of global variable initializers and function bodies
+///
+/// Each section only refers to objects of the previous sections or to
+/// objects defined earlier in the same section, so that the reader builds the
+/// bundle in a single pass.
+class BinaryWriterImpl {
+private:
+  // AR context
+  Context& _context;
+
+  // Front-end mapping, or null
+  FrontendMapping* _frontend;
+
+  // Types
+  Output _types;
+  uint64_t _num_types = 0;
+  std::unordered_map< Type*, uint64_t > _type_ids;
+  std::vector< StructType* > _structs;
+
+  // Constants
+  Output _constants;
+  uint64_t _num_constants = 0;
+  std::unordered_map< Value*, uint64_t > _constant_ids;
+
+  // Global variables and functions
+  std::unordered_map< GlobalVariable*, uint64_t > _global_ids;
+  std::unordered_map< Function*, uint64_t > _function_ids;
+
+  // Local variables of the current function
+  std::unordered_map< LocalVariable*, uint64_t > _local_ids;
+
+  // Internal variables of the current code
+  std::unordered_map< InternalVariable*, uint64_t > _internal_ids;
+
+  // Basic blocks of the current code
+  std::unordered_map< BasicBlock*, uint64_t > _block_ids;
+
+public:
+  /// \brief Constructor
+  BinaryWriterImpl(Context& ctx, FrontendMapping* frontend)
+      : _context(ctx), _frontend(frontend) {}
+
+  /// \brief Write the payload of the given bundle
+  void write(Output& o, Bundle* bundle) {
+    Output head;
+    this->write_data_layout(head, bundle);
+    head.uint(this->frontend(*bundle));
+
+    // Symbols are written in reverse order, so that the symbol tables of the
+    // loaded bundle, filled in that order, iterate in the original order
+    std::vector< GlobalVariable* > globals(bundle->global_begin(),
+                                           bundle->global_end());
+    std::reverse(globals.begin(), globals.end());
+    std::vector< Function* > functions(bundle->function_begin(),
+                                       bundle->function_end());
+    std::reverse(functions.begin(), functions.end());
+
+    // Global variables and functions
+    Output symbols;
+    symbols.uint(globals.size());
+    for (GlobalVariable* gv : globals) {
+      this->_global_ids.emplace(gv, this->_global_ids.size());
+      symbols.string(gv->name());
+      symbols.uint(this->type(gv->type()));
+      symbols.boolean(gv->is_definition());
+      symbols.uint(gv->alignment());
+      symbols.uint(this->frontend(*gv));
+    }
+    symbols.uint(functions.size());
+    for (Function* fun : functions) {
+      this->_function_ids.emplace(fun, this->_function_ids.size());
+      symbols.string(fun->name());
+      symbols.uint(this->type(fun->type()));
+      symbols.boolean(fun->is_definition());
+      symbols.uint(fun->intrinsic_id());
+      symbols.uint(this->frontend(*fun));
+    }
+
+    // Global variable initializers and function bodies
+    Output bodies;
+    for (GlobalVariable* gv : globals) {
+      if (gv->is_definition()) {
+        this->write_code(bodies, gv->initializer());
+      }
+    }
+    for (Function* fun : functions) {
+      if (fun->is_definition()) {
+        this->write_function_body(bodies, fun);
+      }
+    }
+
+    // Structure layouts
+    Output layouts;
+    for (StructType* s : this->_structs) {
+      layouts.uint(s->num_fields());
+      for (auto it = s->field_begin(), et = s->field_end(); it != et; ++it) {
+        layouts.znumber(it->offset);
+        layouts.uint(this->_type_ids.at(it->type));
+      }
+    }
+
+    o.append(head);
+    o.uint(this->_num_types);
+    o.append(this->_types);
+    o.append(layouts);
+    o.append(symbols);
+    o.uint(this->_num_constants);
+    o.append(this->_constants);
+    o.append(bodies);
+  }
+
+private:
+  /// \brief Return the identifier of the front-end object, or 0
+  uint64_t frontend(const Traceable& object) const {
+    if (this->_frontend == nullptr || !object.has_frontend()) {
+      return 0;
+    }
+    return this->_frontend->save(object);
+  }
+
+  /// \brief Write the target triple and the data layout
+  void write_data_layout(Output& o, Bundle* bundle) const {
+    const DataLayout& dl = bundle->data_layout();
+    o.string(bundle->target_triple());
+    o.uint(dl.endianness);
+    write_data_layout_info(o, dl.pointers);
+    o.uint(dl.integers.size());
+    for (const DataLayoutInfo& info : dl.integers) {
+      write_data_layout_info(o, info);
+    }
+    o.uint(dl.floats.size());
+    for (const DataLayoutInfo& info : dl.floats) {
+      write_data_layout_info(o, info);
+    }
+  }
+
+  /// \brief Write information about a data type
+  static void write_data_layout_info(Output& o, const DataLayoutInfo& info) {
+    o.uint(info.bit_width);
+    o.uint(info.abi_alignment);
+    o.uint(info.pref_alignment);
+  }
+
+  /// \brief Return the index of the given type, adding it if necessary
+  uint64_t type(Type* type) {
+    auto it = this->_type_ids.find(type);
+    if (it != this->_type_ids.end()) {
+      return it->second;
+    }
+
+    Output entry;
+    entry.uint(type->kind());
+    switch (type->kind()) {
+      case Type::VoidKind: {
+      } break;
+      case Type::IntegerKind: {
+        auto t = cast< IntegerType >(type);
+        entry.uint(t->bit_width());
+        entry.uint(t->sign());
+      } break;
+      case Type::FloatKind: {
+        entry.uint(cast< FloatType >(type)->float_semantic());
+      } break;
+      case Type::PointerKind: {
+        entry.uint(this->type(cast< PointerType >(type)->pointee()));
+      } break;
+      case Type::StructKind: {
+        // Structures can be recursive, add them before their fields
+        auto t = cast< StructType >(type);
+        entry.boolean(t->packed());
+        uint64_t id = this->add_type(type, entry);
+        this->_structs.push_back(t);
+        for (auto f = t->field_begin(), e = t->field_end(); f != e; ++f) {
+          this->type(f->type);
+        }
+        return id;
+      }
+      case Type::ArrayKind:
+      case Type::VectorKind: {
+        auto t = cast< SequentialType >(type);
+        entry.uint(this->type(t->element_type()));
+        entry.znumber(t->num_elements());
+      } break;
+      case Type::OpaqueKind: {
+        entry.boolean(type == OpaqueType::libc_file_type(this->_context));
+      } break;
+      case Type::FunctionKind: {
+        auto t = cast< FunctionType >(type);
+        entry.uint(this->type(t->return_type()));
+        entry.uint(t->num_parameters());
+        for (auto p = t->param_begin(), e = t->param_end(); p != e; ++p) {
+          entry.uint(this->type(*p));
+        }
+        entry.boolean(t->is_var_arg());
+      } break;
+      default: {
+        ikos_unreachable("unexpected type kind");
+      }
+    }
+    return this->add_type(type, entry);
+  }
+
+  /// \brief Add a type entry
+  uint64_t add_type(Type* type, const Output& entry) {
+    uint64_t id = this->_num_types++;
+    this->_types.append(entry);
+    this->_type_ids.emplace(type, id);
+    return id;
+  }
+
+  /// \brief Return the index of the given constant, adding it if necessary
+  uint64_t constant(Constant* cst) {
+    auto it = this->_constant_ids.find(cst);
+    if (it != this->_constant_ids.end()) {
+      return it->second;
+    }
+
+    Output entry;
+    entry.uint(cst->kind());
+    switch (cst->kind()) {
+      case Value::UndefinedConstantKind:
+      case Value::NullConstantKind:
+      case Value::AggregateZeroConstantKind: {
+        entry.uint(this->type(cst->type()));
+      } break;
+      case Value::IntegerConstantKind: {
+        auto c = cast< IntegerConstant >(cst);
+        entry.uint(this->type(c->type()));
+        entry.znumber(c->value().to_z_number());
+      } break;
+      case Value::FloatConstantKind: {
+        auto c = cast< FloatConstant >(cst);
+        entry.uint(this->type(c->type()));
+        entry.string(c->value());
+      } break;
+      case Value::StructConstantKind: {
+        auto c = cast< StructConstant >(cst);
+        entry.uint(this->type(c->type()));
+        entry.uint(c->num_fields());
+        for (auto f = c->field_begin(), e = c->field_end(); f != e; ++f) {
+          entry.znumber(f->offset);
+          this->value(entry, f->value);
+        }
+      } break;
+      case Value::ArrayConstantKind:
+      case Value::VectorConstantKind: {
+        auto c = cast< SequentialConstant >(cst);
+        entry.uint(this->type(c->type()));
+        entry.uint(c->num_elements());
+        for (auto v = c->element_begin(), e = c->element_end(); v != e; ++v) {
+          this->value(entry, *v);
+        }
+      } break;
+      case Value::FunctionPointerConstantKind: {
+        auto c = cast< FunctionPointerConstant >(cst);
+        entry.uint(this->_function_ids.at(c->function()));
+      } break;
+      case Value::InlineAssemblyConstantKind: {
+        auto c = cast< InlineAssemblyConstant >(cst);
+        entry.uint(this->type(c->type()));
+        entry.string(c->code());
+      } break;
+      default: {
+        ikos_unreachable("unexpected constant kind");
+      }
+    }
+
+    uint64_t id = this->_num_constants++;
+    this->_constants.append(entry);
+    this->_constant_ids.emplace(cst, id);
+    return id;
+  }
+
+  /// \brief Write a reference to the given value, or null
+  void value(Output& o, Value* value) {
+    if (value == nullptr) {
+      o.uint(NullTag);
+    } else if (auto gv = dyn_cast< GlobalVariable >(value)) {
+      o.uint((this->_global_ids.at(gv) << 3) | GlobalVariableTag);
+    } else if (auto lv = dyn_cast< LocalVariable >(value)) {
+      o.uint((this->_local_ids.at(lv) << 3) | LocalVariableTag);
+    } else if (auto iv = dyn_cast< InternalVariable >(value)) {
+      o.uint((this->_internal_ids.at(iv) << 3) | InternalVariableTag);
+    } else {
+      o.uint((this->constant(cast< Constant >(value)) << 3) | ConstantTag);
+    }
+  }
+
+  /// \brief Write a reference to a basic block of the current code
+  void block(Output& o, BasicBlock* bb) const {
+    o.uint(this->_block_ids.at(bb));
+  }
+
+  /// \brief Write a function body, with its local variables
+  void write_function_body(Output& o, Function* fun) {
+    this->_local_ids.clear();
+    o.uint(this->_function_ids.at(fun));
+    o.uint(static_cast< uint64_t >(
+        std::distance(fun->local_variable_begin(), fun->local_variable_end())));
+    for (auto it = fun->local_variable_begin(), et = fun->local_variable_end();
+         it != et;
+         ++it) {
+      LocalVariable* lv = *it;
+      this->_local_ids.emplace(lv, this->_local_ids.size());
+      o.uint(this->type(lv->type()));
+      o.uint(lv->alignment());
+      o.string(lv->name_or_empty());
+      o.uint(this->frontend(*lv));
+    }
+    this->write_code(o, fun->body());
+  }
+
+  /// \brief Write a code
+  void write_code(Output& o, Code* code) {
+    this->_internal_ids.clear();
+    this->_block_ids.clear();
+
+    if (code->is_global_var_initializer()) {
+      o.uint(this->_global_ids.at(code->global_var()));
+    }
+    o.uint(this->frontend(*code));
+
+    // Internal variables, starting with the function parameters
+    auto num_internals = std::distance(code->internal_variable_begin(),
+                                       code->internal_variable_end());
+    o.uint(static_cast< uint64_t >(num_internals));
+    for (auto it = code->internal_variable_begin(),
+              et = code->internal_variable_end();
+         it != et;
+         ++it) {
+      InternalVariable* iv = *it;
+      this->_internal_ids.emplace(iv, this->_internal_ids.size());
+      o.uint(this->type(iv->type()));
+      o.string(iv->name_or_empty());
+      o.uint(this->frontend(*iv));
+    }
+
+    // Basic blocks
+    o.uint(static_cast< uint64_t >(std::distance(code->begin(), code->end())));
+    for (BasicBlock* bb : *code) {
+      this->_block_ids.emplace(bb, this->_block_ids.size());
+      o.string(bb->name_or_empty());
+      o.uint(this->frontend(*bb));
+    }
+    for (BasicBlock* bb : *code) {
+      o.uint(bb->num_statements());
+      for (Statement* stmt : *bb) {
+        this->write_statement(o, stmt);
+      }
+      o.uint(bb->num_successors());
+      for (auto it = bb->successor_begin(), et = bb->successor_end(); it != et;
+           ++it) {
+        this->block(o, *it);
+      }
+    }
+
+    o.uint(code->has_entry_block()
+               ? this->_block_ids.at(code->entry_block()) + 1
+               : 0);
+    o.uint(code->has_exit_block() ? this->_block_ids.at(code->exit_block()) + 1
+                                  : 0);
+  }
+
+  /// \brief Write a statement
+  void write_statement(Output& o, Statement* stmt) {
+    o.uint(stmt->kind());
+    switch (stmt->kind()) {
+      case Statement::AssignmentKind:
+      case Statement::ReturnValueKind:
+      case Statement::UnreachableKind:
+      case Statement::ExtractElementKind:
+      case Statement::InsertElementKind:
+      case Statement::ShuffleVectorKind:
+      case Statement::LandingPadKind:
+      case Statement::ResumeKind: {
+        // These statements are defined by their result and operands
+      } break;
+      case Statement::UnaryOperationKind: {
+        o.uint(cast< UnaryOperation >(stmt)->op());
+      } break;
+      case Statement::BinaryOperationKind: {
+        auto s = cast< BinaryOperation >(stmt);
+        o.uint(s->op());
+        o.boolean(s->has_no_wrap());
+        o.boolean(s->is_exact());
+      } break;
+      case Statement::ComparisonKind: {
+        o.uint(cast< Comparison >(stmt)->predicate());
+      } break;
+      case Statement::AllocateKind: {
+        o.uint(this->type(cast< Allocate >(stmt)->allocated_type()));
+      } break;
+      case Statement::PointerShiftKind: {
+        auto s = cast< PointerShift >(stmt);
+        o.uint(s->num_terms());
+        for (auto it = s->term_begin(), et = s->term_end(); it != et; ++it) {
+          const MachineInt& factor = (*it).first;
+          o.uint(factor.bit_width());
+          o.uint(factor.sign());
+          o.znumber(factor.to_z_number());
+        }
+      } break;
+      case Statement::LoadKind: {
+        auto s = cast< Load >(stmt);
+        o.uint(s->alignment());
+        o.boolean(s->is_volatile());
+      } break;
+      case Statement::StoreKind: {
+        auto s = cast< Store >(stmt);
+        o.uint(s->alignment());
+        o.boolean(s->is_volatile());
+      } break;
+      case Statement::CallKind: {
+      } break;
+      case Statement::InvokeKind: {
+        auto s = cast< Invoke >(stmt);
+        this->block(o, s->normal_dest());
+        this->block(o, s->exception_dest());
+      } break;
+      default: {
+        ikos_unreachable("unexpected statement kind");
+      }
+    }
+
+    this->value(o, stmt->result_or_null());
+    o.uint(stmt->num_operands());
+    for (auto it = stmt->op_begin(), et = stmt->op_end(); it != et; ++it) {
+      this->value(o, *it);
+    }
+    o.uint(this->frontend(*stmt));
+  }
+
+}; // end class BinaryWriterImpl
+
+/// \brief Implementation of the binary reader
+class BinaryReaderImpl {
+private:
+  // AR context
+  Context& _context;
+
+  // Front-end mapping, or null
+  FrontendMapping* _frontend;
+
+  // Input buffer
+  Input _in;
+
+  // Tables
+  std::vector< Type* > _types;
+  std::vector< Value* > _constants;
+  std::vector< GlobalVariable* > _globals;
+  std::vector< Function* > _functions;
+  std::vector< LocalVariable* > _locals;
+  std::vector< InternalVariable* > _internals;
+  std::vector< BasicBlock* > _blocks;
+
+public:
+  /// \brief Constructor
+  BinaryReaderImpl(Context& ctx,
+                   FrontendMapping* frontend,
+                   const char* begin,
+                   const char* end)
+      : _context(ctx), _frontend(frontend), _in(begin, end) {}
+
+  /// \brief Read the payload
+  Bundle* read() {
+    std::string triple = this->_in.string();
+    Bundle* bundle =
+        Bundle::create(this->_context, this->read_data_layout(), triple);
+    this->frontend(*bundle);
+
+    this->read_types();
+
+    // Global variables and functions
+    this->_globals.resize(this->_in.uint());
+    for (auto& gv : this->_globals) {
+      std::string name = this->_in.string();
+      auto type = cast< PointerType >(this->type());
+      bool is_definition = this->_in.boolean();
+      auto alignment = static_cast< unsigned >(this->_in.uint());
+      gv = GlobalVariable::create(bundle,
+                                  type,
+                                  std::move(name),
+                                  is_definition,
+                                  alignment);
+      this->frontend(*gv);
+    }
+    this->_functions.resize(this->_in.uint());
+    for (auto& fun : this->_functions) {
+      std::string name = this->_in.string();
+      auto type = cast< FunctionType >(this->type());
+      bool is_definition = this->_in.boolean();
+      auto id = static_cast< Intrinsic::ID >(this->_in.uint());
+      fun = Function::create(bundle, type, std::move(name), is_definition, id);
+      this->frontend(*fun);
+    }
+
+    this->read_constants();
+
+    // Global variable initializers and function bodies
+    for (std::size_t i = 0; i < this->_globals.size(); i++) {
+      if (this->_globals[i]->is_definition()) {
+        uint64_t id = this->_in.uint();
+        ikos_assert_msg(id == i, "unexpected global variable");
+        ikos_ignore(id);
+        this->read_code(this->_globals[i]->initializer());
+      }
+    }
+    for (std::size_t i = 0; i < this->_functions.size(); i++) {
+      if (this->_functions[i]->is_definition()) {
+        uint64_t id = this->_in.uint();
+        ikos_assert_msg(id == i, "unexpected function");
+        ikos_ignore(id);
+        this->read_function_body(this->_functions[i]);
+      }
+    }
+
+    ikos_assert_msg(this->_in.at_end(), "unexpected trailing data");
+    return bundle;
+  }
+
+private:
+  /// \brief Attach the front-end object, if any
+  void frontend(Traceable& object) {
+    uint64_t id = this->_in.uint();
+    if (id != 0 && this->_frontend != nullptr) {
+      this->_frontend->restore(object, id);
+    }
+  }
+
+  /// \brief Read the data layout
+  std::unique_ptr< DataLayout > read_data_layout() {
+    auto endianness = static_cast< Endianness >(this->_in.uint());
+    std::unique_ptr< DataLayout > dl =
+        DataLayout::create(endianness, this->read_data_layout_info());
+    for (uint64_t n = this->_in.uint(); n > 0; n--) {
+      dl->set_integer_alignment(this->read_data_layout_info());
+    }
+    for (uint64_t n = this->_in.uint(); n > 0; n--) {
+      dl->set_float_alignment(this->read_data_layout_info());
+    }
+    return dl;
+  }
+
+  /// \brief Read information about a data type
+  DataLayoutInfo read_data_layout_info() {
+    auto bit_width = static_cast< unsigned >(this->_in.uint());
+    auto abi_alignment = static_cast< unsigned >(this->_in.uint());
+    auto pref_alignment = static_cast< unsigned >(this->_in.uint());
+    return DataLayoutInfo(bit_width, abi_alignment, pref_alignment);
+  }
+
+  /// \brief Read a reference to a type
+  Type* type() {
+    uint64_t id = this->_in.uint();
+    ikos_assert_msg(id < this->_types.size(), "invalid type index");
+    return this->_types[id];
+  }
+
+  /// \brief Read the types and the structure layouts
+  void read_types() {
+    std::vector< StructType* > structs;
+    this->_types.resize(this->_in.uint());
+    for (auto& type : this->_types) {
+      auto kind = static_cast< Type::TypeKind >(this->_in.uint());
+      switch (kind) {
+        case Type::VoidKind: {
+          type = VoidType::get(this->_context);
+        } break;
+        case Type::IntegerKind: {
+          auto bit_width = static_cast< unsigned >(this->_in.uint());
+          auto sign = static_cast< Signedness >(this->_in.uint());
+          type = IntegerType::get(this->_context, bit_width, sign);
+        } break;
+        case Type::FloatKind: {
+          auto sem = static_cast< FloatSemantic >(this->_in.uint());
+          type = FloatType::get(this->_context, sem);
+        } break;
+        case Type::PointerKind: {
+          type = PointerType::get(this->_context, this->type());
+        } break;
+        case Type::StructKind: {
+          auto t = StructType::create(this->_context, this->_in.boolean());
+          structs.push_back(t);
+          type = t;
+        } break;
+        case Type::ArrayKind: {
+          Type* element = this->type();
+          type = ArrayType::get(this->_context, element, this->_in.znumber());
+        } break;
+        case Type::VectorKind: {
+          auto element = cast< ScalarType >(this->type());
+          type = VectorType::get(this->_context, element, this->_in.znumber());
+        } break;
+        case Type::OpaqueKind: {
+          if (this->_in.boolean()) {
+            type = OpaqueType::libc_file_type(this->_context);
+          } else {
+            type = OpaqueType::create(this->_context);
+          }
+        } break;
+        case Type::FunctionKind: {
+          Type* return_type = this->type();
+          FunctionType::ParamTypes params(this->_in.uint());
+          for (auto& param : params) {
+            param = this->type();
+          }
+          bool is_var_arg = this->_in.boolean();
+          type = FunctionType::get(this->_context,
+                                   return_type,
+                                   params,
+                                   is_var_arg);
+        } break;
+        default: {
+          ikos_unreachable("unexpected type kind");
+        }
+      }
+    }
+
+    for (StructType* s : structs) {
+      StructType::Layout layout(this->_in.uint());
+      for (auto& field : layout) {
+        field.offset = this->_in.znumber();
+        field.type = this->type();
+      }
+      s->set_layout(std::move(layout));
+    }
+  }
+
+  /// \brief Read the constants
+  void read_constants() {
+    this->_constants.resize(this->_in.uint());
+    for (auto& cst : this->_constants) {
+      auto kind = static_cast< Value::ValueKind >(this->_in.uint());
+      switch (kind) {
+        case Value::UndefinedConstantKind: {
+          cst = UndefinedConstant::get(this->_context, this->type());
+        } break;
+        case Value::IntegerConstantKind: {
+          auto type = cast< IntegerType >(this->type());
+          cst = IntegerConstant::get(this->_context,
+                                     type,
+                                     MachineInt(this->_in.znumber(),
+                                                type->bit_width(),
+                                                type->sign()));
+        } break;
+        case Value::FloatConstantKind: {
+          auto type = cast< FloatType >(this->type());
+          cst = FloatConstant::get(this->_context, type, this->_in.string());
+        } break;
+        case Value::NullConstantKind: {
+          auto type = cast< PointerType >(this->type());
+          cst = NullConstant::get(this->_context, type);
+        } break;
+        case Value::StructConstantKind: {
+          auto type = cast< StructType >(this->type());
+          StructConstant::Values values(this->_in.uint());
+          for (auto& field : values) {
+            field.offset = this->_in.znumber();
+            field.value = this->value();
+          }
+          cst = StructConstant::get(this->_context, type, values);
+        } break;
+        case Value::ArrayConstantKind: {
+          auto type = cast< ArrayType >(this->type());
+          cst = ArrayConstant::get(this->_context, type, this->values());
+        } break;
+        case Value::VectorConstantKind: {
+          auto type = cast< VectorType >(this->type());
+          cst = VectorConstant::get(this->_context, type, this->values());
+        } break;
+        case Value::AggregateZeroConstantKind: {
+          auto type = cast< AggregateType >(this->type());
+          cst = AggregateZeroConstant::get(this->_context, type);
+        } break;
+        case Value::FunctionPointerConstantKind: {
+          uint64_t id = this->_in.uint();
+          ikos_assert_msg(id < this->_functions.size(), "invalid function");
+          cst = FunctionPointerConstant::get(this->_context,
+                                             this->_functions[id]);
+        } break;
+        case Value::InlineAssemblyConstantKind: {
+          auto type = cast< PointerType >(this->type());
+          cst = InlineAssemblyConstant::get(this->_context,
+                                            type,
+                                            this->_in.string());
+        } break;
+        default: {
+          ikos_unreachable("unexpected constant kind");
+        }
+      }
+    }
+  }
+
+  /// \brief Read a reference to a value, or null
+  Value* value() {
+    uint64_t ref = this->_in.uint();
+    auto id = static_cast< std::size_t >(ref >> 3);
+    switch (ref & 7) {
+      case NullTag: {
+        return nullptr;
+      }
+      case ConstantTag: {
+        ikos_assert_msg(id < this->_constants.size(), "invalid constant");
+        return this->_constants[id];
+      }
+      case GlobalVariableTag: {
+        ikos_assert_msg(id < this->_globals.size(), "invalid global variable");
+        return this->_globals[id];
+      }
+      case LocalVariableTag: {
+        ikos_assert_msg(id < this->_locals.size(), "invalid local variable");
+        return this->_locals[id];
+      }
+      case InternalVariableTag: {
+        ikos_assert_msg(id < this->_internals.size(),
+                        "invalid internal variable");
+        return this->_internals[id];
+      }
+      default: {
+        ikos_unreachable("unexpected value tag");
+      }
+    }
+  }
+
+  /// \brief Read a list of values
+  std::vector< Value* > values() {
+    std::vector< Value* > values(this->_in.uint());
+    for (auto& value : values) {
+      value = this->value();
+    }
+    return values;
+  }
+
+  /// \brief Read a reference to a basic block of the current code
+  BasicBlock* block() {
+    uint64_t id = this->_in.uint();
+    ikos_assert_msg(id < this->_blocks.size(), "invalid basic block");
+    return this->_blocks[id];
+  }
+
+  /// \brief Read a function body, with its local variables
+  void read_function_body(Function* fun) {
+    this->_locals.resize(this->_in.uint());
+    for (auto& lv : this->_locals) {
+      auto type = cast< PointerType >(this->type());
+      auto alignment = static_cast< unsigned >(this->_in.uint());
+      lv = LocalVariable::create(fun, type, alignment);
+      std::string name = this->_in.string();
+      if (!name.empty()) {
+        lv->set_name(std::move(name));
+      }
+      this->frontend(*lv);
+    }
+    this->read_code(fun->body());
+  }
+
+  /// \brief Read a code
+  void read_code(Code* code) {
+    this->frontend(*code);
+
+    // Internal variables, the function parameters already exist
+    this->_internals.assign(code->internal_variable_begin(),
+                            code->internal_variable_end());
+    std::size_t num_existing = this->_internals.size();
+    this->_internals.resize(this->_in.uint());
+    for (std::size_t i = 0; i < this->_internals.size(); i++) {
+      Type* type = this->type();
+      if (i >= num_existing) {
+        this->_internals[i] = InternalVariable::create(code, type);
+      }
+      std::string name = this->_in.string();
+      if (!name.empty()) {
+        this->_internals[i]->set_name(std::move(name));
+      }
+      this->frontend(*this->_internals[i]);
+    }
+
+    // Basic blocks
+    this->_blocks.resize(this->_in.uint());
+    for (auto& bb : this->_blocks) {
+      bb = BasicBlock::create(code);
+      std::string name = this->_in.string();
+      if (!name.empty()) {
+        bb->set_name(std::move(name));
+      }
+      this->frontend(*bb);
+    }
+    for (BasicBlock* bb : this->_blocks) {
+      for (uint64_t n = this->_in.uint(); n > 0; n--) {
+        bb->push_back(this->read_statement());
+      }
+      for (uint64_t n = this->_in.uint(); n > 0; n--) {
+        bb->add_successor(this->block());
+      }
+    }
+
+    if (uint64_t entry = this->_in.uint()) {
+      code->set_entry_block(this->_blocks.at(entry - 1));
+    }
+    if (uint64_t exit = this->_in.uint()) {
+      code->set_exit_block(this->_blocks.at(exit - 1));
+    }
+  }
+
+  /// \brief Read a statement
+  std::unique_ptr< Statement > read_statement() {
+    auto kind = static_cast< Statement::StatementKind >(this->_in.uint());
+
+    // Kind specific attributes
+    uint64_t op = 0;
+    bool no_wrap = false;
+    bool exact = false;
+    Type* allocated_type = nullptr;
+    std::vector< MachineInt > factors;
+    unsigned alignment = 0;
+    bool is_volatile = false;
+    BasicBlock* normal_dest = nullptr;
+    BasicBlock* exception_dest = nullptr;
+
+    switch (kind) {
+      case Statement::UnaryOperationKind:
+      case Statement::ComparisonKind: {
+        op = this->_in.uint();
+      } break;
+      case Statement::BinaryOperationKind: {
+        op = this->_in.uint();
+        no_wrap = this->_in.boolean();
+        exact = this->_in.boolean();
+      } break;
+      case Statement::AllocateKind: {
+        allocated_type = this->type();
+      } break;
+      case Statement::LoadKind:
+      case Statement::StoreKind: {
+        alignment = static_cast< unsigned >(this->_in.uint());
+        is_volatile = this->_in.boolean();
+      } break;
+      case Statement::PointerShiftKind: {
+        factors.reserve(this->_in.uint());
+        for (std::size_t i = 0; i < factors.capacity(); i++) {
+          auto bit_width = static_cast< unsigned >(this->_in.uint());
+          auto sign = static_cast< Signedness >(this->_in.uint());
+          factors.emplace_back(this->_in.znumber(), bit_width, sign);
+        }
+      } break;
+      case Statement::InvokeKind: {
+        normal_dest = this->block();
+        exception_dest = this->block();
+      } break;
+      default: {
+      } break;
+    }
+
+    Value* result = this->value();
+    std::vector< Value* > operands = this->values();
+
+    std::unique_ptr< Statement > stmt;
+    switch (kind) {
+      case Statement::AssignmentKind: {
+        stmt = Assignment::create(cast< InternalVariable >(result),
+                                  operands.at(0));
+      } break;
+      case Statement::UnaryOperationKind: {
+        stmt = UnaryOperation::create(static_cast< UnaryOperation::Operator >(
+                                          op),
+                                      cast< InternalVariable >(result),
+                                      operands.at(0));
+      } break;
+      case Statement::BinaryOperationKind: {
+        stmt =
+            BinaryOperation::create(static_cast< BinaryOperation::Operator >(
+                                        op),
+                                    cast< InternalVariable >(result),
+                                    operands.at(0),
+                                    operands.at(1),
+                                    no_wrap,
+                                    exact);
+      } break;
+      case Statement::ComparisonKind: {
+        stmt = Comparison::create(static_cast< Comparison::Predicate >(op),
+                                  operands.at(0),
+                                  operands.at(1));
+      } break;
+      case Statement::ReturnValueKind: {
+        stmt = ReturnValue::create(operands.empty() ? nullptr : operands[0]);
+      } break;
+      case Statement::UnreachableKind: {
+        stmt = Unreachable::create();
+      } break;
+      case Statement::AllocateKind: {
+        stmt = Allocate::create(cast< LocalVariable >(result),
+                                allocated_type,
+                                operands.at(0));
+      } break;
+      case Statement::PointerShiftKind: {
+        std::vector< PointerShift::Term > terms;
+        terms.reserve(factors.size());
+        for (std::size_t i = 0; i < factors.size(); i++) {
+          terms.emplace_back(factors[i], operands.at(i + 1));
+        }
+        stmt = PointerShift::create(cast< InternalVariable >(result),
+                                    operands.at(0),
+                                    terms);
+      } break;
+      case Statement::LoadKind: {
+        stmt = Load::create(cast< InternalVariable >(result),
+                            operands.at(0),
+                            alignment,
+                            is_volatile);
+      } break;
+      case Statement::StoreKind: {
+        stmt = Store::create(operands.at(0),
+                             operands.at(1),
+                             alignment,
+                             is_volatile);
+      } break;
+      case Statement::ExtractElementKind: {
+        stmt = ExtractElement::create(cast< InternalVariable >(result),
+                                      operands.at(0),
+                                      operands.at(1));
+      } break;
+      case Statement::InsertElementKind: {
+        stmt = InsertElement::create(cast< InternalVariable >(result),
+                                     operands.at(0),
+                                     operands.at(1),
+                                     operands.at(2));
+      } break;
+      case Statement::ShuffleVectorKind: {
+        stmt = ShuffleVector::create(cast< InternalVariable >(result),
+                                     operands.at(0),
+                                     operands.at(1),
+                                     operands.at(2));
+      } break;
+      case Statement::CallKind: {
+        std::vector< Value* > arguments(operands.begin() + 1, operands.end());
+        stmt = Call::create(cast_or_null< InternalVariable >(result),
+                            operands.at(0),
+                            arguments);
+      } break;
+      case Statement::InvokeKind: {
+        std::vector< Value* > arguments(operands.begin() + 1, operands.end());
+        stmt = Invoke::create(cast_or_null< InternalVariable >(result),
+                              operands.at(0),
+                              arguments,
+                              normal_dest,
+                              exception_dest);
+      } break;
+      case Statement::LandingPadKind: {
+        stmt = LandingPad::create(cast< InternalVariable >(result));
+      } break;
+      case Statement::ResumeKind: {
+        stmt = Resume::create(cast< InternalVariable >(operands.at(0)));
+      } break;
+      default: {
+        ikos_unreachable("unexpected statement kind");
+      }
+    }
+
+    this->frontend(*stmt);
+    return stmt;
+  }
+
+}; // end class BinaryReaderImpl
+
+} // end anonymous namespace
+
+// BinaryWriter
+
+void BinaryWriter::write(std::ostream& o, Bundle* bundle) const {
+  Output payload;
+  BinaryWriterImpl(bundle->context(), this->_frontend).write(payload, bundle);
+
+  const std::string& data = payload.str();
+  std::array< char, HeaderSize > header{};
+  std::memcpy(header.data(), Magic, sizeof(Magic));
+  write_u64(header.data() + 8, Version);
+  write_u64(header.data() + 16, data.size());
+  write_u64(header.data() + 24, checksum(data.data(), data.size()));
+  o.write(header.data(), header.size());
+  o.write(data.data(), static_cast< std::streamsize >(data.size()));
+}
+
+// BinaryReader
+
+bool BinaryReader::is_valid(const char* data, std::size_t size) {
+  if (size < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+    return false;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  const char* payload = data + HeaderSize;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return read_u64(data + 8) == Version &&
+         // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+         read_u64(data + 16) == size - HeaderSize &&
+         // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+         read_u64(data + 24) == checksum(payload, size - HeaderSize);
+}
+
+Bundle* BinaryReader::read(const char* data, std::size_t size) const {
+  if (!is_valid(data, size)) {
+    return nullptr;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  BinaryReaderImpl impl(this->_context,
+                        this->_frontend,
+                        data + HeaderSize,
+                        data + size);
+  return impl.read();
+}
+
+} // end namespace ar
+} // end namespace ikos
@@ -44,6 +44,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -59,6 +60,9 @@ namespace ar {
 
 class ContextImpl {
 private:
+  // Mutex protecting the maps below, for concurrent analyses
+  std::recursive_mutex _mutex;
+
   // List of owned bundles
   std::vector< std::unique_ptr< Bundle > > _bundles;
 
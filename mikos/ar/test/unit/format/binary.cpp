@@ -0,0 +1,352 @@
+/*******************************************************************************
+ *
+ * Tests for the binary format of the abstract representation
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#define BOOST_TEST_MODULE test_binary_format
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ikos/ar/format/binary.hpp>
+#include <ikos/ar/format/text.hpp>
+#include <ikos/ar/semantic/bundle.hpp>
+#include <ikos/ar/semantic/code.hpp>
+#include <ikos/ar/semantic/context.hpp>
+#include <ikos/ar/semantic/data_layout.hpp>
+#include <ikos/ar/semantic/function.hpp>
+#include <ikos/ar/semantic/statement.hpp>
+#include <ikos/ar/semantic/type.hpp>
+#include <ikos/ar/semantic/value.hpp>
+
+namespace ar = ikos::ar;
+
+namespace {
+
+/// \brief Front-end object attached to the AR
+struct FrontendObject {
+  std::size_t id;
+};
+
+/// \brief Front-end mapping for a list of FrontendObject
+class TestFrontendMapping final : public ar::FrontendMapping {
+private:
+  std::vector< FrontendObject >& _objects;
+
+public:
+  explicit TestFrontendMapping(std::vector< FrontendObject >& objects)
+      : _objects(objects) {}
+
+  uint64_t save(const ar::Traceable& object) override {
+    if (object.frontend_type() != typeid(FrontendObject)) {
+      return 0;
+    }
+    return object.frontend< FrontendObject >()->id + 1;
+  }
+
+  void restore(ar::Traceable& object, uint64_t id) override {
+    object.set_frontend(&this->_objects.at(id - 1));
+  }
+};
+
+/// \brief Attach a new front-end object to the given traceable object
+void trace(ar::Traceable& object, std::vector< FrontendObject >& objects) {
+  // Objects are reserved beforehand, so pointers stay valid
+  BOOST_REQUIRE(objects.size() < objects.capacity());
+  objects.push_back(FrontendObject{objects.size()});
+  object.set_frontend(&objects.back());
+}
+
+/// \brief Attach front-end objects to a code and all its statements
+void trace(ar::Code* code, std::vector< FrontendObject >& objects) {
+  trace(*code, objects);
+  for (auto it = code->internal_variable_begin(),
+            et = code->internal_variable_end();
+       it != et;
+       ++it) {
+    trace(**it, objects);
+  }
+  for (ar::BasicBlock* bb : *code) {
+    trace(*bb, objects);
+    for (ar::Statement* stmt : *bb) {
+      trace(*stmt, objects);
+    }
+  }
+}
+
+/// \brief Build a bundle exercising globals, functions, locals, calls,
+/// comparisons and several basic blocks
+ar::Bundle* build_bundle(ar::Context& ctx,
+                         std::vector< FrontendObject >* objects) {
+  std::unique_ptr< ar::DataLayout > dl =
+      ar::DataLayout::create(ar::LittleEndian, ar::DataLayoutInfo(64, 8, 8));
+  dl->set_integer_alignment(ar::DataLayoutInfo(32, 4, 4));
+  ar::Bundle* bundle =
+      ar::Bundle::create(ctx, std::move(dl), "x86_64-unknown-linux-gnu");
+
+  ar::IntegerType* si32 = ar::IntegerType::si32(ctx);
+  ar::PointerType* si32_ptr = ar::PointerType::get(ctx, si32);
+  ar::FunctionType* binary_fun_type =
+      ar::FunctionType::get(ctx, si32, {si32, si32}, false);
+  ar::FunctionType* main_type = ar::FunctionType::get(ctx, si32, {}, false);
+
+  // int g = 42;
+  ar::GlobalVariable* g =
+      ar::GlobalVariable::create(bundle, si32_ptr, "g", true, 4);
+  {
+    ar::Code* code = g->initializer();
+    ar::BasicBlock* bb = ar::BasicBlock::create(code);
+    code->set_entry_block(bb);
+    code->set_exit_block(bb);
+    bb->push_back(ar::Store::create(g,
+                                    ar::IntegerConstant::get(ctx, si32, 42),
+                                    4,
+                                    false));
+  }
+
+  // int ext(int, int);
+  ar::Function* ext =
+      ar::Function::create(bundle, binary_fun_type, "ext", false);
+
+  // int max_add(int a, int b) { int r = a + b; return a > b ? r : ext(a, b); }
+  ar::Function* max_add =
+      ar::Function::create(bundle, binary_fun_type, "max_add", true);
+  {
+    ar::Code* code = max_add->body();
+    ar::InternalVariable* a = max_add->param(0);
+    ar::InternalVariable* b = max_add->param(1);
+    ar::InternalVariable* r = ar::InternalVariable::create(code, si32);
+    ar::InternalVariable* e = ar::InternalVariable::create(code, si32);
+    r->set_name("r");
+
+    ar::BasicBlock* entry = ar::BasicBlock::create(code);
+    ar::BasicBlock* then_bb = ar::BasicBlock::create(code);
+    ar::BasicBlock* else_bb = ar::BasicBlock::create(code);
+    ar::BasicBlock* exit_bb = ar::BasicBlock::create(code);
+    entry->set_name("entry");
+    code->set_entry_block(entry);
+    code->set_exit_block(exit_bb);
+    entry->add_successor(then_bb);
+    entry->add_successor(else_bb);
+    then_bb->add_successor(exit_bb);
+    else_bb->add_successor(exit_bb);
+
+    entry->push_back(
+        ar::BinaryOperation::create(ar::BinaryOperation::SAdd, r, a, b, true));
+    then_bb->push_back(ar::Comparison::create(ar::Comparison::SIGT, a, b));
+    else_bb->push_back(ar::Comparison::create(ar::Comparison::SILE, a, b));
+    else_bb->push_back(ar::Call::create(e, ext, {a, b}));
+    else_bb->push_back(ar::Assignment::create(r, e));
+    exit_bb->push_back(ar::ReturnValue::create(r));
+  }
+
+  // int main() { int x; x = g; return max_add(x, 1); }
+  ar::Function* main_fun =
+      ar::Function::create(bundle, main_type, "main", true);
+  ar::LocalVariable* x = ar::LocalVariable::create(main_fun, si32_ptr, 4);
+  {
+    ar::Code* code = main_fun->body();
+    ar::InternalVariable* v = ar::InternalVariable::create(code, si32);
+    ar::InternalVariable* w = ar::InternalVariable::create(code, si32);
+
+    ar::BasicBlock* bb = ar::BasicBlock::create(code);
+    code->set_entry_block(bb);
+    code->set_exit_block(bb);
+    ar::IntegerType* size_type = ar::IntegerType::size_type(bundle);
+    bb->push_back(
+        ar::Allocate::create(x,
+                             si32,
+                             ar::IntegerConstant::get(ctx, size_type, 1)));
+    bb->push_back(ar::Load::create(v, g, 4, false));
+    bb->push_back(ar::Store::create(x, v, 4, false));
+    bb->push_back(
+        ar::Call::create(w,
+                         max_add,
+                         {v, ar::IntegerConstant::get(ctx, si32, 1)}));
+    bb->push_back(ar::ReturnValue::create(w));
+  }
+
+  if (objects != nullptr) {
+    trace(*bundle, *objects);
+    trace(*g, *objects);
+    trace(g->initializer(), *objects);
+    trace(*ext, *objects);
+    trace(*max_add, *objects);
+    trace(max_add->body(), *objects);
+    trace(*main_fun, *objects);
+    trace(*x, *objects);
+    trace(main_fun->body(), *objects);
+  }
+
+  return bundle;
+}
+
+/// \brief Return the text representation of a bundle
+std::string to_text(ar::Bundle* bundle) {
+  std::ostringstream out;
+  ar::TextFormatter().format(out, bundle);
+  return out.str();
+}
+
+/// \brief Append the front-end objects of a code, in order
+void collect(ar::Code* code, std::vector< const void* >& frontends);
+
+/// \brief Return the front-end object of a traceable object, or null
+const void* frontend(const ar::Traceable& object) {
+  if (!object.has_frontend()) {
+    return nullptr;
+  }
+  return object.frontend< FrontendObject >();
+}
+
+/// \brief Return the front-end objects of a bundle, in order
+std::vector< const void* > collect(ar::Bundle* bundle) {
+  std::vector< const void* > frontends;
+  frontends.push_back(frontend(*bundle));
+  for (auto it = bundle->global_begin(), et = bundle->global_end(); it != et;
+       ++it) {
+    ar::GlobalVariable* gv = *it;
+    frontends.push_back(frontend(*gv));
+    if (gv->is_definition()) {
+      collect(gv->initializer(), frontends);
+    }
+  }
+  for (auto it = bundle->function_begin(), et = bundle->function_end();
+       it != et;
+       ++it) {
+    ar::Function* fun = *it;
+    frontends.push_back(frontend(*fun));
+    if (fun->is_definition()) {
+      for (auto lv = fun->local_variable_begin(),
+                lv_end = fun->local_variable_end();
+           lv != lv_end;
+           ++lv) {
+        frontends.push_back(frontend(**lv));
+      }
+      collect(fun->body(), frontends);
+    }
+  }
+  return frontends;
+}
+
+void collect(ar::Code* code, std::vector< const void* >& frontends) {
+  frontends.push_back(frontend(*code));
+  for (auto it = code->internal_variable_begin(),
+            et = code->internal_variable_end();
+       it != et;
+       ++it) {
+    frontends.push_back(frontend(**it));
+  }
+  for (ar::BasicBlock* bb : *code) {
+    frontends.push_back(frontend(*bb));
+    for (ar::Statement* stmt : *bb) {
+      frontends.push_back(frontend(*stmt));
+    }
+  }
+}
+
+/// \brief Write a bundle and read it back in another context
+ar::Bundle* round_trip(ar::Bundle* bundle,
+                       ar::Context& ctx,
+                       ar::FrontendMapping* frontend) {
+  std::ostringstream out;
+  ar::BinaryWriter(frontend).write(out, bundle);
+  std::string data = out.str();
+  BOOST_REQUIRE(ar::BinaryReader::is_valid(data.data(), data.size()));
+  ar::Bundle* result =
+      ar::BinaryReader(ctx, frontend).read(data.data(), data.size());
+  BOOST_REQUIRE(result != nullptr);
+  return result;
+}
+
+} // end anonymous namespace
+
+BOOST_AUTO_TEST_CASE(round_trip_without_frontend) {
+  ar::Context ctx;
+  ar::Bundle* bundle = build_bundle(ctx, nullptr);
+
+  ar::Context loaded_ctx;
+  ar::Bundle* loaded = round_trip(bundle, loaded_ctx, nullptr);
+
+  BOOST_CHECK_EQUAL(to_text(bundle), to_text(loaded));
+  for (const void* frontend : collect(loaded)) {
+    BOOST_CHECK(frontend == nullptr);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_with_frontend) {
+  std::vector< FrontendObject > objects;
+  objects.reserve(128);
+
+  ar::Context ctx;
+  ar::Bundle* bundle = build_bundle(ctx, &objects);
+  std::vector< const void* > frontends = collect(bundle);
+  BOOST_CHECK(std::find(frontends.begin(), frontends.end(), nullptr) ==
+              frontends.end());
+
+  TestFrontendMapping mapping(objects);
+  ar::Context loaded_ctx;
+  ar::Bundle* loaded = round_trip(bundle, loaded_ctx, &mapping);
+
+  BOOST_CHECK_EQUAL(to_text(bundle), to_text(loaded));
+  std::vector< const void* > loaded_frontends = collect(loaded);
+  BOOST_CHECK(frontends == loaded_frontends);
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_twice) {
+  std::vector< FrontendObject > objects;
+  objects.reserve(128);
+
+  ar::Context ctx;
+  ar::Bundle* bundle = build_bundle(ctx, &objects);
+
+  TestFrontendMapping mapping(objects);
+  ar::Context ctx1;
+  ar::Bundle* loaded = round_trip(bundle, ctx1, &mapping);
+  ar::Context ctx2;
+  ar::Bundle* reloaded = round_trip(loaded, ctx2, &mapping);
+
+  BOOST_CHECK_EQUAL(to_text(bundle), to_text(reloaded));
+  BOOST_CHECK(collect(bundle) == collect(reloaded));
+}
@@ -52,14 +52,27 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
-#include <stack>
+#include <vector>
+
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+#endif
 
 #include <boost/optional.hpp>
 
+#include <ikos/core/adt/patricia_tree/node_ptr.hpp>
 #include <ikos/core/adt/patricia_tree/utils.hpp>
 #include <ikos/core/semantic/dumpable.hpp>
 #include <ikos/core/semantic/indexable.hpp>
 #include <ikos/core/support/assert.hpp>
+#include <ikos/core/support/mpl.hpp>
 
 namespace ikos {
 namespace core {
@@ -77,74 +90,85 @@ template < typename Key, typename Value >
 class PatriciaTreeIterator;
 
 template < typename Key, typename Value >
-inline bool empty(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree);
+inline bool empty(const NodePtr< const PatriciaTree< Key, Value > >& tree);
 
 template < typename Key, typename Value >
 inline std::size_t size(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree);
+    const NodePtr< const PatriciaTree< Key, Value > >& tree);
 
 template < typename Key, typename Value >
 inline boost::optional< const Value& > find_value(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const Key& key);
 
 template < typename Key, typename Value, typename Compare >
-inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-                const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+inline bool leq(const NodePtr< const PatriciaTree< Key, Value > >& s,
+                const NodePtr< const PatriciaTree< Key, Value > >& t,
                 const Compare& cmp);
 
 template < typename Key, typename Value, typename Compare >
-inline bool equals(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-                   const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+inline bool equals(const NodePtr< const PatriciaTree< Key, Value > >& s,
+                   const NodePtr< const PatriciaTree< Key, Value > >& t,
                    const Compare& cmp);
 
 template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > insert_or_assign(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > insert_or_assign(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const Key& key,
     const Value& value);
 
 template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_insert(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > update_or_insert(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const CombiningFunction& combine,
     const Key& key,
     const Value& value);
 
 template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_ignore(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > update_or_ignore(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const CombiningFunction& combine,
     const Key& key,
     const Value& value);
 
 template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > erase(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > erase(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const Key& key);
 
 template < typename Key, typename Value, typename UnaryOp >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > transform(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > transform(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const UnaryOp& op);
 
 template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+inline NodePtr< const PatriciaTree< Key, Value > > join(
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
+    const CombiningFunction& combine);
+
+template < typename Key, typename Value, typename CombiningFunction >
+inline NodePtr< const PatriciaTree< Key, Value > > intersect(
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
     const CombiningFunction& combine);
 
 template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+inline NodePtr< const PatriciaTree< Key, Value > > cached_join(
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
+    const CombiningFunction& combine);
+
+template < typename Key, typename Value, typename CombiningFunction >
+inline NodePtr< const PatriciaTree< Key, Value > > cached_intersect(
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
     const CombiningFunction& combine);
 
 template < typename Key, typename Value, typename BinaryOp >
 inline typename BinaryOp::ResultType binary_operation(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
     const BinaryOp& op);
 
 } // end namespace patricia_tree_map_impl
@@ -164,17 +188,17 @@ public:
 
 private:
   using PatriciaTree = patricia_tree_map_impl::PatriciaTree< Key, Value >;
+  using TreePtr = patricia_tree_utils::NodePtr< const PatriciaTree >;
 
 public:
   using Iterator = patricia_tree_map_impl::PatriciaTreeIterator< Key, Value >;
 
 private:
-  std::shared_ptr< const PatriciaTree > _tree;
+  TreePtr _tree;
 
 private:
   /// \brief Private constructor
-  explicit PatriciaTreeMap(std::shared_ptr< const PatriciaTree > tree)
-      : _tree(std::move(tree)) {}
+  explicit PatriciaTreeMap(TreePtr tree) : _tree(std::move(tree)) {}
 
 public:
   /// \brief Create an empty patricia tree map
@@ -294,8 +318,9 @@ public:
   template < typename CombiningFunction >
   void join_with(const PatriciaTreeMap& other,
                  const CombiningFunction& combine) {
-    this->_tree =
-        patricia_tree_map_impl::join(this->_tree, other._tree, combine);
+    this->_tree = patricia_tree_map_impl::cached_join(this->_tree,
+                                                      other._tree,
+                                                      combine);
   }
 
   /// \brief Perform the union of two patricia tree maps
@@ -305,8 +330,9 @@ public:
   template < typename CombiningFunction >
   PatriciaTreeMap join(const PatriciaTreeMap& other,
                        const CombiningFunction& combine) const {
-    return PatriciaTreeMap(
-        patricia_tree_map_impl::join(this->_tree, other._tree, combine));
+    return PatriciaTreeMap(patricia_tree_map_impl::cached_join(this->_tree,
+                                                               other._tree,
+                                                               combine));
   }
 
   /// \brief Perform the intersection of two patricia tree maps
@@ -316,8 +342,9 @@ public:
   template < typename CombiningFunction >
   void intersect_with(const PatriciaTreeMap& other,
                       const CombiningFunction& combine) {
-    this->_tree =
-        patricia_tree_map_impl::intersect(this->_tree, other._tree, combine);
+    this->_tree = patricia_tree_map_impl::cached_intersect(this->_tree,
+                                                           other._tree,
+                                                           combine);
   }
 
   /// \brief Perform the intersection of two patricia tree maps
@@ -328,7 +355,9 @@ public:
   PatriciaTreeMap intersect(const PatriciaTreeMap& other,
                             const CombiningFunction& combine) const {
     return PatriciaTreeMap(
-        patricia_tree_map_impl::intersect(this->_tree, other._tree, combine));
+        patricia_tree_map_impl::cached_intersect(this->_tree,
+                                                 other._tree,
+                                                 combine));
   }
 
   /// \brief Perform a generic binary operation
@@ -403,9 +432,9 @@ public:
   // Allow binary_operation to call the private constructor
   template < typename K, typename V, typename BinaryOp >
   friend typename BinaryOp::ResultType patricia_tree_map_impl::binary_operation(
-      const std::shared_ptr<
+      const patricia_tree_utils::NodePtr<
           const patricia_tree_map_impl::PatriciaTree< K, V > >& s,
-      const std::shared_ptr<
+      const patricia_tree_utils::NodePtr<
           const patricia_tree_map_impl::PatriciaTree< K, V > >& t,
       const BinaryOp& op);
 
@@ -413,21 +442,53 @@ public:
 
 namespace patricia_tree_map_impl {
 
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+
+/// \brief Return a new identifier for a hash-consed tree
+///
+/// Unlike addresses, identifiers are never reused by other trees.
+inline std::uint64_t next_tree_id() {
+  static std::atomic< std::uint64_t > counter(1);
+  return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+#endif // IKOS_PATRICIA_TREE_HASH_CONSING
+
 template < typename Key, typename Value >
-class PatriciaTree {
+class PatriciaTree : public NodeBase {
 private:
   std::size_t _size;
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+  std::size_t _hash = 0;
+  std::uint64_t _id = 0;
+#endif
 
 public:
   explicit PatriciaTree(std::size_t size) : _size(size) {}
 
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+  PatriciaTree(std::size_t size, std::size_t hash)
+      : _size(size), _hash(hash), _id(next_tree_id()) {}
+#endif
+
   // PatriciaTree is immutable
   PatriciaTree(const PatriciaTree&) = delete;
   PatriciaTree(PatriciaTree&&) = delete;
   PatriciaTree& operator=(const PatriciaTree&) = delete;
   PatriciaTree& operator=(PatriciaTree&&) = delete;
 
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+  /// \brief Destructor, removes the tree from the hash-consing table
+  virtual ~PatriciaTree();
+
+  /// \brief Return the hash of the content of the tree
+  std::size_t hash() const { return this->_hash; }
+
+  /// \brief Return the unique identifier of the tree
+  std::uint64_t id() const { return this->_id; }
+#else
   virtual ~PatriciaTree() = default;
+#endif
 
   std::size_t size() const { return this->_size; }
 
@@ -442,31 +503,43 @@ class PatriciaTreeNode final : public PatriciaTree< Key, Value > {
 private:
   Index _prefix;
   Index _branching_bit;
-  std::shared_ptr< const PatriciaTree< Key, Value > > _left_tree;
-  std::shared_ptr< const PatriciaTree< Key, Value > > _right_tree;
+  NodePtr< const PatriciaTree< Key, Value > > _left_tree;
+  NodePtr< const PatriciaTree< Key, Value > > _right_tree;
 
 public:
-  PatriciaTreeNode(
-      Index prefix,
-      Index branching_bit,
-      std::shared_ptr< const PatriciaTree< Key, Value > > left_tree,
-      std::shared_ptr< const PatriciaTree< Key, Value > > right_tree)
+  PatriciaTreeNode(Index prefix,
+                   Index branching_bit,
+                   NodePtr< const PatriciaTree< Key, Value > > left_tree,
+                   NodePtr< const PatriciaTree< Key, Value > > right_tree)
       : PatriciaTree< Key, Value >(left_tree->size() + right_tree->size()),
         _prefix(prefix),
         _branching_bit(branching_bit),
         _left_tree(std::move(left_tree)),
         _right_tree(std::move(right_tree)) {}
 
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+  PatriciaTreeNode(Index prefix,
+                   Index branching_bit,
+                   NodePtr< const PatriciaTree< Key, Value > > left_tree,
+                   NodePtr< const PatriciaTree< Key, Value > > right_tree,
+                   std::size_t hash)
+      : PatriciaTree< Key, Value >(left_tree->size() + right_tree->size(),
+                                   hash),
+        _prefix(prefix),
+        _branching_bit(branching_bit),
+        _left_tree(std::move(left_tree)),
+        _right_tree(std::move(right_tree)) {}
+#endif
+
   Index prefix() const { return this->_prefix; }
 
   Index branching_bit() const { return this->_branching_bit; }
 
-  const std::shared_ptr< const PatriciaTree< Key, Value > >& left_tree() const {
+  const NodePtr< const PatriciaTree< Key, Value > >& left_tree() const {
     return this->_left_tree;
   }
 
-  const std::shared_ptr< const PatriciaTree< Key, Value > >& right_tree()
-      const {
+  const NodePtr< const PatriciaTree< Key, Value > >& right_tree() const {
     return this->_right_tree;
   }
 
@@ -481,6 +554,11 @@ public:
   PatriciaTreeLeaf(const Key& key, const Value& value)
       : PatriciaTree< Key, Value >(1), _pair(key, value) {}
 
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+  PatriciaTreeLeaf(const Key& key, const Value& value, std::size_t hash)
+      : PatriciaTree< Key, Value >(1, hash), _pair(key, value) {}
+#endif
+
   const Key& key() const { return this->_pair.first; }
 
   const Value& value() const { return this->_pair.second; }
@@ -489,15 +567,268 @@ public:
 
 }; // end class PatriciaTreeLeaf
 
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+
+namespace hash_detail {
+
+using boost::hash_value;
+
+/// \brief Check if hash_value() is defined for a value
+template < typename Value, typename = void >
+struct IsHashable : std::false_type {};
+
+template < typename Value >
+struct IsHashable<
+    Value,
+    void_t< decltype(hash_value(std::declval< const Value& >())) > >
+    : std::true_type {};
+
+/// \brief Return the hash of a value
+template < typename Value >
+inline std::size_t value_hash(const Value& value) {
+  return hash_value(value);
+}
+
+/// \brief Return true if two machine integer values are equal
+///
+/// Values of different bit-widths or signedness cannot be compared with
+/// `operator==`, and the same key might be bound to both.
+template < typename Value >
+inline auto value_equals(const Value& x, const Value& y, int)
+    -> decltype(x.bit_width() == y.bit_width() && x.sign() == y.sign()) {
+  return x.bit_width() == y.bit_width() && x.sign() == y.sign() && x == y;
+}
+
+/// \brief Return true if two values are equal
+template < typename Value >
+inline bool value_equals(const Value& x, const Value& y, long) {
+  return x == y;
+}
+
+} // end namespace hash_detail
+
+/// \brief Table of the live patricia tree nodes, indexed by content
+///
+/// All leaves and nodes are created through the table, so that two trees with
+/// the same bindings are physically equal. Since children are themselves
+/// unique, nodes are hashed and compared on the addresses of their children.
+///
+/// The table does not own the nodes: a node removes itself on destruction.
+/// A node found in the table is only used if its reference count is not zero.
+///
+/// The table is split in shards on the hash of the trees, each with its own
+/// lock, so that threads creating different trees rarely wait for each other.
 template < typename Key, typename Value >
-inline bool empty(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree) {
+class HashConsTable final {
+public:
+  static_assert(hash_detail::IsHashable< Value >::value,
+                "hash-consed patricia tree maps require hash_value() on "
+                "values");
+
+private:
+  using Tree = PatriciaTree< Key, Value >;
+  using Node = PatriciaTreeNode< Key, Value >;
+  using Leaf = PatriciaTreeLeaf< Key, Value >;
+  using TreePtr = NodePtr< const Tree >;
+
+  static constexpr std::size_t NumShards = 64;
+
+  /// \brief Part of the table, with its own lock
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_multimap< std::size_t, const Tree* > trees;
+  };
+
+private:
+  std::array< Shard, NumShards > _shards;
+
+public:
+  HashConsTable() = default;
+
+  /// \brief No copy constructor
+  HashConsTable(const HashConsTable&) = delete;
+
+  /// \brief No move constructor
+  HashConsTable(HashConsTable&&) = delete;
+
+  /// \brief No copy assignment operator
+  HashConsTable& operator=(const HashConsTable&) = delete;
+
+  /// \brief No move assignment operator
+  HashConsTable& operator=(HashConsTable&&) = delete;
+
+  /// \brief Destructor
+  ~HashConsTable() = default;
+
+  /// \brief Return the table for this type of tree
+  ///
+  /// The table is never destroyed, since trees can outlive static objects.
+  static HashConsTable& get() {
+    static auto table = new HashConsTable();
+    return *table;
+  }
+
+  /// \brief Return the unique leaf binding `key` to `value`
+  NodePtr< const Leaf > leaf(const Key& key, const Value& value) {
+    std::size_t hash = IndexableTraits< Key >::index(key);
+    boost::hash_combine(hash, hash_detail::value_hash(value));
+    return this->find_or_create< Leaf >(
+        hash,
+        [&](const Tree& tree) {
+          if (tree.is_node()) {
+            return false;
+          }
+          const auto& leaf = static_cast< const Leaf& >(tree);
+          return leaf.key() == key &&
+                 hash_detail::value_equals(leaf.value(), value, 0);
+        },
+        [&] { return new Leaf(key, value, hash); });
+  }
+
+  /// \brief Return the unique node with the given prefix and children
+  NodePtr< const Node > node(Index prefix,
+                             Index branching_bit,
+                             const TreePtr& left_tree,
+                             const TreePtr& right_tree) {
+    std::size_t hash = prefix;
+    boost::hash_combine(hash, branching_bit);
+    boost::hash_combine(hash, left_tree.get());
+    boost::hash_combine(hash, right_tree.get());
+    return this->find_or_create< Node >(
+        hash,
+        [&](const Tree& tree) {
+          if (tree.is_leaf()) {
+            return false;
+          }
+          const auto& node = static_cast< const Node& >(tree);
+          return node.prefix() == prefix &&
+                 node.branching_bit() == branching_bit &&
+                 node.left_tree() == left_tree &&
+                 node.right_tree() == right_tree;
+        },
+        [&] {
+          return new Node(prefix, branching_bit, left_tree, right_tree, hash);
+        });
+  }
+
+  /// \brief Return the live tree at address `tree` with the given identifier
+  /// and hash, or nullptr
+  ///
+  /// The address is only dereferenced if it is still in the table.
+  TreePtr find(const Tree* tree, std::uint64_t id, std::size_t hash) {
+    // Released after the lock, since destruction also takes the lock
+    TreePtr result;
+    Shard& shard = this->shard(hash);
+    std::lock_guard< std::mutex > lock(shard.mutex);
+
+    auto range = shard.trees.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == tree) {
+        result = TreePtr::acquire(tree);
+        break;
+      }
+    }
+
+    if (result != nullptr && result->id() == id) {
+      return result;
+    }
+    return nullptr;
+  }
+
+  /// \brief Remove a tree being destroyed
+  void erase(const Tree* tree) {
+    Shard& shard = this->shard(tree->hash());
+    std::lock_guard< std::mutex > lock(shard.mutex);
+    auto range = shard.trees.equal_range(tree->hash());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == tree) {
+        shard.trees.erase(it);
+        return;
+      }
+    }
+  }
+
+private:
+  /// \brief Return the shard containing the trees with the given hash
+  Shard& shard(std::size_t hash) {
+    return this->_shards[(hash ^ (hash >> 16)) % NumShards];
+  }
+
+  template < typename T, typename Equal, typename Create >
+  NodePtr< const T > find_or_create(std::size_t hash,
+                                    const Equal& equal,
+                                    const Create& create) {
+    // Released after the lock, since destruction also takes the lock
+    std::vector< TreePtr > mismatches;
+    Shard& shard = this->shard(hash);
+    std::lock_guard< std::mutex > lock(shard.mutex);
+
+    auto range = shard.trees.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      TreePtr tree = TreePtr::acquire(it->second);
+      if (tree == nullptr) {
+        // Being destroyed
+        continue;
+      }
+      if (equal(*tree)) {
+        return static_node_cast< const T >(tree);
+      }
+      mismatches.push_back(std::move(tree));
+    }
+
+    NodePtr< const T > tree(create());
+    shard.trees.emplace(hash, tree.get());
+    return tree;
+  }
+
+}; // end class HashConsTable
+
+template < typename Key, typename Value >
+PatriciaTree< Key, Value >::~PatriciaTree() {
+  HashConsTable< Key, Value >::get().erase(this);
+}
+
+#endif // IKOS_PATRICIA_TREE_HASH_CONSING
+
+/// \brief Create a leaf
+template < typename Key, typename Value >
+inline NodePtr< const PatriciaTreeLeaf< Key, Value > > make_leaf(
+    const Key& key, const Value& value) {
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+  return HashConsTable< Key, Value >::get().leaf(key, value);
+#else
+  return make_node_ptr< const PatriciaTreeLeaf< Key, Value > >(key, value);
+#endif
+}
+
+/// \brief Create a node with two non-null children
+template < typename Key, typename Value >
+inline NodePtr< const PatriciaTreeNode< Key, Value > > make_branch(
+    Index prefix,
+    Index branching_bit,
+    const NodePtr< const PatriciaTree< Key, Value > >& left_tree,
+    const NodePtr< const PatriciaTree< Key, Value > >& right_tree) {
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+  return HashConsTable< Key, Value >::get().node(prefix,
+                                                 branching_bit,
+                                                 left_tree,
+                                                 right_tree);
+#else
+  return make_node_ptr< const PatriciaTreeNode< Key, Value > >(prefix,
+                                                               branching_bit,
+                                                               left_tree,
+                                                               right_tree);
+#endif
+}
+
+template < typename Key, typename Value >
+inline bool empty(const NodePtr< const PatriciaTree< Key, Value > >& tree) {
   return tree == nullptr;
 }
 
 template < typename Key, typename Value >
 inline std::size_t size(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree) {
+    const NodePtr< const PatriciaTree< Key, Value > >& tree) {
   if (tree != nullptr) {
     return tree->size();
   } else {
@@ -507,22 +838,20 @@ inline std::size_t size(
 
 /// \brief Return the leaf associated with the given key, or nullptr
 template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTreeLeaf< Key, Value > > find_leaf(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTreeLeaf< Key, Value > > find_leaf(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const Key& key) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
     if (leaf->key() != key) {
       return nullptr;
     }
     return leaf;
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key, Value > >(tree);
   if (is_zero_bit(IndexableTraits< Key >::index(key), node->branching_bit())) {
     return find_leaf(node->left_tree(), key);
   } else {
@@ -532,10 +861,24 @@ inline std::shared_ptr< const PatriciaTreeLeaf< Key, Value > > find_leaf(
 
 template < typename Key, typename Value >
 inline boost::optional< const Value& > find_value(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const Key& key) {
-  auto leaf = find_leaf(tree, key);
-  if (leaf == nullptr) {
+  // Walk down with raw pointers, to avoid updating reference counters
+  const PatriciaTree< Key, Value >* t = tree.get();
+  if (t == nullptr) {
+    return boost::none;
+  }
+  Index index = IndexableTraits< Key >::index(key);
+  while (!t->is_leaf()) {
+    const auto* node = static_cast< const PatriciaTreeNode< Key, Value >* >(t);
+    if (is_zero_bit(index, node->branching_bit())) {
+      t = node->left_tree().get();
+    } else {
+      t = node->right_tree().get();
+    }
+  }
+  const auto* leaf = static_cast< const PatriciaTreeLeaf< Key, Value >* >(t);
+  if (leaf->key() != key) {
     return boost::none;
   } else {
     return leaf->value();
@@ -543,8 +886,8 @@ inline boost::optional< const Value& > find_value(
 }
 
 template < typename Key, typename Value, typename Compare >
-inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-                const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+inline bool leq(const NodePtr< const PatriciaTree< Key, Value > >& s,
+                const NodePtr< const PatriciaTree< Key, Value > >& t,
                 const Compare& cmp) {
   if (s == t) {
     return true;
@@ -559,16 +902,13 @@ inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
     if (t->is_node()) {
       return false;
     }
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(s);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(t);
     return s_leaf->key() == t_leaf->key() &&
            cmp(s_leaf->value(), t_leaf->value());
   }
   if (t->is_leaf()) {
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(t);
     auto s_value = find_value(s, t_leaf->key());
     if (s_value) {
       return cmp(*s_value, t_leaf->value());
@@ -576,10 +916,8 @@ inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
       return false;
     }
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(t);
   if (s_node->size() < t_node->size()) {
     return false;
   }
@@ -602,8 +940,8 @@ inline bool leq(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
 }
 
 template < typename Key, typename Value, typename Compare >
-inline bool equals(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-                   const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+inline bool equals(const NodePtr< const PatriciaTree< Key, Value > >& s,
+                   const NodePtr< const PatriciaTree< Key, Value > >& t,
                    const Compare& cmp) {
   if (s == t) {
     return true;
@@ -615,20 +953,16 @@ inline bool equals(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
     if (t->is_node()) {
       return false;
     }
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(s);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(t);
     return s_leaf->key() == t_leaf->key() &&
            cmp(s_leaf->value(), t_leaf->value());
   }
   if (t->is_leaf()) {
     return false;
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(t);
   return s_node->size() == t_node->size() &&
          s_node->prefix() == t_node->prefix() &&
          s_node->branching_bit() == t_node->branching_bit() &&
@@ -640,71 +974,65 @@ inline bool equals(const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
 ///
 /// Prevent the creation of a node with only one child.
 template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > make_node(
+inline NodePtr< const PatriciaTree< Key, Value > > make_node(
     Index prefix,
     Index branching_bit,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& left_tree,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& right_tree) {
+    const NodePtr< const PatriciaTree< Key, Value > >& left_tree,
+    const NodePtr< const PatriciaTree< Key, Value > >& right_tree) {
   if (left_tree == nullptr) {
     return right_tree;
   }
   if (right_tree == nullptr) {
     return left_tree;
   }
-  return std::make_shared< const PatriciaTreeNode< Key, Value > >(prefix,
-                                                                  branching_bit,
-                                                                  left_tree,
-                                                                  right_tree);
+  return make_branch< Key, Value >(prefix,
+                                   branching_bit,
+                                   left_tree,
+                                   right_tree);
 }
 
 /// \brief Join non-null patricia trees
 template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTreeNode< Key, Value > > join_trees(
+inline NodePtr< const PatriciaTreeNode< Key, Value > > join_trees(
     Index prefix_s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
     Index prefix_t,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t) {
+    const NodePtr< const PatriciaTree< Key, Value > >& t) {
   ikos_assert(s != nullptr && t != nullptr);
 
   Index m = branching_bit(prefix_s, prefix_t);
 
   if (is_zero_bit(prefix_s, m)) {
-    return std::make_shared<
-        const PatriciaTreeNode< Key, Value > >(mask(prefix_s, m), m, s, t);
+    return make_branch< Key, Value >(mask(prefix_s, m), m, s, t);
   } else {
-    return std::make_shared<
-        const PatriciaTreeNode< Key, Value > >(mask(prefix_s, m), m, t, s);
+    return make_branch< Key, Value >(mask(prefix_s, m), m, t, s);
   }
 }
 
 template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > insert_or_assign(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > insert_or_assign(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const Key& key,
     const Value& value) {
   if (tree == nullptr) {
-    return std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
+    return make_leaf< Key, Value >(key, value);
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
     if (leaf->key() == key) {
       if (leaf->value() == value) {
         return tree;
       } else {
-        return std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key,
-                                                                        value);
+        return make_leaf< Key, Value >(key, value);
       }
     }
-    auto new_leaf =
-        std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
+    auto new_leaf = make_leaf< Key, Value >(key, value);
     return join_trees< Key, Value >(IndexableTraits< Key >::index(key),
                                     new_leaf,
                                     IndexableTraits< Key >::index(leaf->key()),
                                     leaf);
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key, Value > >(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -729,8 +1057,7 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > insert_or_assign(
                        new_right_tree);
     }
   }
-  auto new_leaf =
-      std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
+  auto new_leaf = make_leaf< Key, Value >(key, value);
   return join_trees< Key, Value >(IndexableTraits< Key >::index(key),
                                   new_leaf,
                                   node->prefix(),
@@ -738,38 +1065,34 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > insert_or_assign(
 }
 
 template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_insert(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > update_or_insert(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const CombiningFunction& combine,
     const Key& key,
     const Value& value) {
   if (tree == nullptr) {
-    return std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
+    return make_leaf< Key, Value >(key, value);
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
     if (leaf->key() == key) {
       boost::optional< Value > new_value = combine(leaf->value(), value);
       if (new_value) {
         if (leaf->value() == *new_value) {
           return tree;
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(key, *new_value);
+          return make_leaf< Key, Value >(key, *new_value);
         }
       }
       return nullptr;
     }
-    auto new_leaf =
-        std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
+    auto new_leaf = make_leaf< Key, Value >(key, value);
     return join_trees< Key, Value >(IndexableTraits< Key >::index(key),
                                     new_leaf,
                                     IndexableTraits< Key >::index(leaf->key()),
                                     leaf);
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key, Value > >(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -796,8 +1119,7 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_insert(
                        new_right_tree);
     }
   }
-  auto new_leaf =
-      std::make_shared< const PatriciaTreeLeaf< Key, Value > >(key, value);
+  auto new_leaf = make_leaf< Key, Value >(key, value);
   return join_trees< Key, Value >(IndexableTraits< Key >::index(key),
                                   new_leaf,
                                   node->prefix(),
@@ -805,8 +1127,8 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_insert(
 }
 
 template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_ignore(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > update_or_ignore(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const CombiningFunction& combine,
     const Key& key,
     const Value& value) {
@@ -814,24 +1136,21 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_ignore(
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
     if (leaf->key() == key) {
       boost::optional< Value > new_value = combine(leaf->value(), value);
       if (new_value) {
         if (leaf->value() == *new_value) {
           return tree;
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(key, *new_value);
+          return make_leaf< Key, Value >(key, *new_value);
         }
       }
       return nullptr;
     }
     return tree;
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key, Value > >(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -863,10 +1182,10 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > update_or_ignore(
 
 /// \brief Update or insert an existing leaf `t_leaf` in a tree `s`
 template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > >
+inline NodePtr< const PatriciaTree< Key, Value > >
 update_or_insert_leaf(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTreeLeaf< Key, Value > >& t_leaf,
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTreeLeaf< Key, Value > >& t_leaf,
     const CombiningFunction& combine) {
   if (s == t_leaf) {
     return s;
@@ -875,8 +1194,7 @@ update_or_insert_leaf(
     return t_leaf;
   }
   if (s->is_leaf()) {
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(s);
     if (s_leaf->key() == t_leaf->key()) {
       boost::optional< Value > new_value =
           combine(s_leaf->value(), t_leaf->value());
@@ -886,8 +1204,7 @@ update_or_insert_leaf(
         } else if (t_leaf->value() == *new_value) {
           return t_leaf;
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(s_leaf->key(), *new_value);
+          return make_leaf< Key, Value >(s_leaf->key(), *new_value);
         }
       }
       return nullptr;
@@ -899,8 +1216,7 @@ update_or_insert_leaf(
                                         t_leaf->key()),
                                     t_leaf);
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(s);
   if (match_prefix(IndexableTraits< Key >::index(t_leaf->key()),
                    s_node->prefix(),
                    s_node->branching_bit())) {
@@ -934,23 +1250,21 @@ update_or_insert_leaf(
 }
 
 template < typename Key, typename Value >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > erase(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > erase(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const Key& key) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
     if (leaf->key() == key) {
       return nullptr;
     } else {
       return tree;
     }
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key, Value > >(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -979,28 +1293,25 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > erase(
 }
 
 template < typename Key, typename Value, typename UnaryOp >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > transform(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& tree,
+inline NodePtr< const PatriciaTree< Key, Value > > transform(
+    const NodePtr< const PatriciaTree< Key, Value > >& tree,
     const UnaryOp& op) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(tree);
     boost::optional< Value > new_value = op(leaf->key(), leaf->value());
     if (new_value) {
       if (leaf->value() == *new_value) {
         return tree;
       } else {
-        return std::make_shared<
-            const PatriciaTreeLeaf< Key, Value > >(leaf->key(), *new_value);
+        return make_leaf< Key, Value >(leaf->key(), *new_value);
       }
     }
     return nullptr;
   }
-  auto node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key, Value > >(tree);
   auto new_left_tree = transform(node->left_tree(), op);
   auto new_right_tree = transform(node->right_tree(), op);
   if (node->left_tree() == new_left_tree &&
@@ -1015,9 +1326,9 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > transform(
 }
 
 template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+inline NodePtr< const PatriciaTree< Key, Value > > join(
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
     const CombiningFunction& combine) {
   if (s == t) {
     return s;
@@ -1029,8 +1340,7 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
     return s;
   }
   if (s->is_leaf()) {
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(s);
     return update_or_insert_leaf(t,
                                  s_leaf,
                                  [=](const Value& t_value,
@@ -1040,14 +1350,11 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
                                  });
   }
   if (t->is_leaf()) {
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(t);
     return update_or_insert_leaf(s, t_leaf, combine);
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -1101,9 +1408,9 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > join(
 }
 
 template < typename Key, typename Value, typename CombiningFunction >
-inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+inline NodePtr< const PatriciaTree< Key, Value > > intersect(
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
     const CombiningFunction& combine) {
   if (s == t) {
     return s;
@@ -1112,8 +1419,7 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
     return nullptr;
   }
   if (s->is_leaf()) {
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(s);
     auto t_leaf = find_leaf(t, s_leaf->key());
     if (t_leaf) {
       boost::optional< Value > new_value =
@@ -1124,16 +1430,14 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
         } else if (t_leaf->value() == *new_value) {
           return std::move(t_leaf);
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(s_leaf->key(), *new_value);
+          return make_leaf< Key, Value >(s_leaf->key(), *new_value);
         }
       }
     }
     return nullptr;
   }
   if (t->is_leaf()) {
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(t);
     auto s_leaf = find_leaf(s, t_leaf->key());
     if (s_leaf) {
       boost::optional< Value > new_value =
@@ -1144,17 +1448,14 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
         } else if (t_leaf->value() == *new_value) {
           return std::move(t_leaf);
         } else {
-          return std::make_shared<
-              const PatriciaTreeLeaf< Key, Value > >(t_leaf->key(), *new_value);
+          return make_leaf< Key, Value >(t_leaf->key(), *new_value);
         }
       }
     }
     return nullptr;
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -1193,10 +1494,150 @@ inline std::shared_ptr< const PatriciaTree< Key, Value > > intersect(
   return nullptr;
 }
 
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+
+/// \brief Cache of the latest results of a binary operation
+///
+/// The cache is direct-mapped on the identifiers of the operands, which are
+/// never reused. Entries hold no reference on the trees, so that cached trees
+/// do not outlive the maps they come from. A cached result is only returned
+/// if it is still in the hash-consing table.
+template < typename Key, typename Value >
+class BinaryOperationCache final {
+private:
+  using Tree = PatriciaTree< Key, Value >;
+  using TreePtr = NodePtr< const Tree >;
+
+  static constexpr std::size_t Size = 256;
+
+  struct Entry {
+    std::uint64_t left = 0;
+    std::uint64_t right = 0;
+
+    // Result, or nullptr for an empty tree
+    const Tree* result = nullptr;
+    std::uint64_t result_id = 0;
+    std::size_t result_hash = 0;
+  };
+
+private:
+  std::array< Entry, Size > _entries;
+
+public:
+  /// \brief Find the cached result for (`s`, `t`)
+  ///
+  /// Return true and set `result` on success.
+  bool find(const TreePtr& s, const TreePtr& t, TreePtr& result) const {
+    const Entry& entry = this->_entries[index(s, t)];
+    if (entry.left != s->id() || entry.right != t->id()) {
+      return false;
+    }
+    if (entry.result == nullptr) {
+      result = nullptr;
+      return true;
+    }
+    result = HashConsTable< Key, Value >::get().find(entry.result,
+                                                     entry.result_id,
+                                                     entry.result_hash);
+    return result != nullptr;
+  }
+
+  /// \brief Cache the result for (`s`, `t`)
+  void insert(const TreePtr& s, const TreePtr& t, const TreePtr& result) {
+    Entry& entry = this->_entries[index(s, t)];
+    entry.left = s->id();
+    entry.right = t->id();
+    if (result == nullptr) {
+      entry.result = nullptr;
+      entry.result_id = 0;
+      entry.result_hash = 0;
+    } else {
+      entry.result = result.get();
+      entry.result_id = result->id();
+      entry.result_hash = result->hash();
+    }
+  }
+
+private:
+  static std::size_t index(const TreePtr& s, const TreePtr& t) {
+    std::size_t hash = s->id();
+    boost::hash_combine(hash, t->id());
+    return hash % Size;
+  }
+
+}; // end class BinaryOperationCache
+
+/// \brief Tags of the cached binary operations
+struct JoinOperation {};
+struct IntersectOperation {};
+
+/// \brief Apply `operation` on (`s`, `t`), using the per-thread cache of the
+/// given operation and combining function
+///
+/// Only stateless combining functions are cached, since the result must only
+/// depend on the operands.
+template < typename Tag,
+           typename Key,
+           typename Value,
+           typename CombiningFunction,
+           typename Operation >
+inline NodePtr< const PatriciaTree< Key, Value > > cached_binary_operation(
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
+    const CombiningFunction& /*combine*/,
+    const Operation& operation) {
+  if (!std::is_empty< CombiningFunction >::value || s == nullptr ||
+      t == nullptr || s == t) {
+    return operation();
+  }
+  static thread_local BinaryOperationCache< Key, Value > cache;
+  NodePtr< const PatriciaTree< Key, Value > > result;
+  if (cache.find(s, t, result)) {
+    return result;
+  }
+  result = operation();
+  cache.insert(s, t, result);
+  return result;
+}
+
+#endif // IKOS_PATRICIA_TREE_HASH_CONSING
+
+/// \brief Join two patricia trees, reusing recent results if hash-consing is
+/// enabled
+template < typename Key, typename Value, typename CombiningFunction >
+inline NodePtr< const PatriciaTree< Key, Value > > cached_join(
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
+    const CombiningFunction& combine) {
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+  return cached_binary_operation< JoinOperation >(s, t, combine, [&] {
+    return join(s, t, combine);
+  });
+#else
+  return join(s, t, combine);
+#endif
+}
+
+/// \brief Intersect two patricia trees, reusing recent results if
+/// hash-consing is enabled
+template < typename Key, typename Value, typename CombiningFunction >
+inline NodePtr< const PatriciaTree< Key, Value > > cached_intersect(
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
+    const CombiningFunction& combine) {
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+  return cached_binary_operation< IntersectOperation >(s, t, combine, [&] {
+    return intersect(s, t, combine);
+  });
+#else
+  return intersect(s, t, combine);
+#endif
+}
+
 template < typename Key, typename Value, typename BinaryOp >
 inline typename BinaryOp::ResultType binary_operation(
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& s,
-    const std::shared_ptr< const PatriciaTree< Key, Value > >& t,
+    const NodePtr< const PatriciaTree< Key, Value > >& s,
+    const NodePtr< const PatriciaTree< Key, Value > >& t,
     const BinaryOp& op) {
   if (op.has_equals() && s == t) {
     return op.equals(PatriciaTreeMap< Key, Value >(s));
@@ -1208,23 +1649,19 @@ inline typename BinaryOp::ResultType binary_operation(
     return op.left(PatriciaTreeMap< Key, Value >(s));
   }
   if (s->is_leaf()) {
-    auto s_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(s);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(s);
     return op.right_with_left_leaf(PatriciaTreeMap< Key, Value >(t),
                                    s_leaf->key(),
                                    s_leaf->value());
   }
   if (t->is_leaf()) {
-    auto t_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key, Value > >(t);
     return op.left_with_right_leaf(PatriciaTreeMap< Key, Value >(s),
                                    t_leaf->key(),
                                    t_leaf->value());
   }
-  auto s_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(s);
-  auto t_node =
-      std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key, Value > >(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -1277,8 +1714,14 @@ public:
   using reference = const std::pair< Key, Value >&;
 
 private:
-  std::shared_ptr< const PatriciaTreeLeaf< Key, Value > > _leaf;
-  std::stack< std::shared_ptr< const PatriciaTreeNode< Key, Value > > > _stack;
+  // Root of the iterated tree, keeps all the nodes below alive
+  NodePtr< const PatriciaTree< Key, Value > > _tree;
+
+  // Current leaf, or null
+  const PatriciaTreeLeaf< Key, Value >* _leaf = nullptr;
+
+  // Nodes whose right-hand subtree is still to be visited
+  std::vector< const PatriciaTreeNode< Key, Value >* > _stack;
 
 public:
   /// \brief Create an end iterator
@@ -1286,9 +1729,10 @@ public:
 
   /// \brief Create an iterator on the given patricia tree
   explicit PatriciaTreeIterator(
-      const std::shared_ptr< const PatriciaTree< Key, Value > >& tree) {
+      const NodePtr< const PatriciaTree< Key, Value > >& tree)
+      : _tree(tree) {
     if (tree != nullptr) {
-      this->look_for_next_leaf(tree);
+      this->look_for_next_leaf(tree.get());
     }
   }
 
@@ -1304,9 +1748,9 @@ public:
 
     // Otherwise, we pop out a branch from the stack and move to the leftmost
     // leaf in its right-hand subtree.
-    auto node = this->_stack.top();
-    this->_stack.pop();
-    this->look_for_next_leaf(node->right_tree());
+    const PatriciaTreeNode< Key, Value >* node = this->_stack.back();
+    this->_stack.pop_back();
+    this->look_for_next_leaf(node->right_tree().get());
     return *this;
   }
 
@@ -1337,19 +1781,19 @@ public:
 
 private:
   /// \brief Find the leftmost leaf, store all intermediate nodes
-  void look_for_next_leaf(
-      const std::shared_ptr< const PatriciaTree< Key, Value > >& tree) {
-    auto t = tree;
+  ///
+  /// Raw pointers are used to avoid updating reference counters, `_tree`
+  /// keeps the nodes alive.
+  void look_for_next_leaf(const PatriciaTree< Key, Value >* t) {
     ikos_assert(t != nullptr);
     while (t->is_node()) {
-      auto node =
-          std::static_pointer_cast< const PatriciaTreeNode< Key, Value > >(t);
-      this->_stack.push(node);
-      t = node->left_tree();
+      const auto* node =
+          static_cast< const PatriciaTreeNode< Key, Value >* >(t);
+      this->_stack.push_back(node);
+      t = node->left_tree().get();
       ikos_assert(t != nullptr); // a node always has two children
     }
-    this->_leaf =
-        std::static_pointer_cast< const PatriciaTreeLeaf< Key, Value > >(t);
+    this->_leaf = static_cast< const PatriciaTreeLeaf< Key, Value >* >(t);
   }
 
 }; // end class PatriciaTreeIterator
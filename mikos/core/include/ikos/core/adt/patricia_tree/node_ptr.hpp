@@ -0,0 +1,496 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Reference counted pointers on patricia tree nodes
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#ifndef IKOS_PATRICIA_TREE_SINGLE_THREAD
+#include <atomic>
+#endif
+
+/// \file
+///
+/// By default, patricia tree nodes are held by `std::shared_ptr` and allocated
+/// with `std::make_shared`.
+///
+/// If `IKOS_PATRICIA_TREE_POOL_ALLOCATOR` is defined, nodes carry an intrusive
+/// reference count and are allocated from per-thread free lists backed by
+/// large slabs. This removes the separate control block, the weak count and
+/// most calls to malloc/free.
+///
+/// If `IKOS_PATRICIA_TREE_SINGLE_THREAD` is also defined, the intrusive
+/// reference count is not atomic. This is only safe if patricia trees are
+/// never shared between threads.
+///
+/// `IKOS_PATRICIA_TREE_HASH_CONSING` (see map.hpp) requires the intrusive
+/// reference count.
+
+#if defined(IKOS_PATRICIA_TREE_HASH_CONSING) && \
+    !defined(IKOS_PATRICIA_TREE_POOL_ALLOCATOR)
+#error "IKOS_PATRICIA_TREE_HASH_CONSING requires IKOS_PATRICIA_TREE_POOL_ALLOCATOR"
+#endif
+
+namespace ikos {
+namespace core {
+namespace patricia_tree_utils {
+
+#ifdef IKOS_PATRICIA_TREE_POOL_ALLOCATOR
+
+/// \brief Pool allocator for patricia tree nodes
+///
+/// Memory is handed out in size classes of `Alignment` bytes. Each thread
+/// owns a free list per size class and a current slab. Blocks freed by a
+/// thread go to its own free lists, regardless of the allocating thread.
+/// When a thread exits, its free lists are moved to a global pool, guarded by
+/// a mutex, from which other threads refill.
+///
+/// Slabs are never returned to the system: the pool only grows up to the
+/// peak number of live nodes.
+class NodePool final {
+private:
+  static constexpr std::size_t Alignment = alignof(std::max_align_t);
+  static constexpr std::size_t NumSizeClasses = 16;
+  static constexpr std::size_t SlabSize = 64 * 1024;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct FreeLists {
+    FreeBlock* heads[NumSizeClasses];
+  };
+
+  /// \brief Blocks released by exited threads
+  struct GlobalPool {
+    std::mutex mutex;
+    FreeLists lists = {};
+  };
+
+  /// \brief Per-thread state, trivially destructible
+  ///
+  /// The storage remains valid until the thread terminates, which allows
+  /// trees destroyed by static destructors to release their nodes.
+  struct ThreadCache {
+    FreeLists lists;
+    char* slab_cur;
+    char* slab_end;
+    bool released;
+  };
+
+  /// \brief Move the free lists of the thread cache into the global pool
+  /// on thread exit
+  struct ThreadCacheReleaser {
+    ThreadCacheReleaser() = default;
+    ThreadCacheReleaser(const ThreadCacheReleaser&) = delete;
+    ThreadCacheReleaser(ThreadCacheReleaser&&) = delete;
+    ThreadCacheReleaser& operator=(const ThreadCacheReleaser&) = delete;
+    ThreadCacheReleaser& operator=(ThreadCacheReleaser&&) = delete;
+    ~ThreadCacheReleaser() { NodePool::release_thread_cache(); }
+  };
+
+public:
+  /// \brief Allocate a block of the given size
+  static void* allocate(std::size_t size) {
+    std::size_t idx = size_class(size);
+    if (idx >= NumSizeClasses) {
+      return ::operator new(size);
+    }
+
+    ThreadCache& cache = thread_cache();
+    if (cache.released) {
+      // Thread is exiting
+      return ::operator new(block_size(idx));
+    }
+    register_releaser();
+
+    FreeBlock*& head = cache.lists.heads[idx];
+    if (head == nullptr) {
+      refill(cache, idx);
+    }
+    if (head != nullptr) {
+      FreeBlock* block = head;
+      head = block->next;
+      return block;
+    }
+
+    std::size_t bsize = block_size(idx);
+    if (cache.slab_cur == nullptr ||
+        static_cast< std::size_t >(cache.slab_end - cache.slab_cur) < bsize) {
+      cache.slab_cur = static_cast< char* >(::operator new(SlabSize));
+      cache.slab_end = cache.slab_cur + SlabSize;
+    }
+    void* p = cache.slab_cur;
+    cache.slab_cur += bsize;
+    return p;
+  }
+
+  /// \brief Release a block previously returned by `allocate(size)`
+  static void deallocate(void* p, std::size_t size) {
+    std::size_t idx = size_class(size);
+    if (idx >= NumSizeClasses) {
+      ::operator delete(p);
+      return;
+    }
+
+    ThreadCache& cache = thread_cache();
+    if (cache.released) {
+      // Thread is exiting, give the block to the global pool
+      GlobalPool& global = global_pool();
+      std::lock_guard< std::mutex > lock(global.mutex);
+      auto block = static_cast< FreeBlock* >(p);
+      block->next = global.lists.heads[idx];
+      global.lists.heads[idx] = block;
+      return;
+    }
+    register_releaser();
+
+    auto block = static_cast< FreeBlock* >(p);
+    block->next = cache.lists.heads[idx];
+    cache.lists.heads[idx] = block;
+  }
+
+private:
+  /// \brief Return the size class for the given size, or NumSizeClasses if the
+  /// block should be allocated with ::operator new
+  static std::size_t size_class(std::size_t size) {
+    return (size + Alignment - 1) / Alignment - 1;
+  }
+
+  /// \brief Return the block size of the given size class
+  static std::size_t block_size(std::size_t idx) {
+    return (idx + 1) * Alignment;
+  }
+
+  static ThreadCache& thread_cache() {
+    static thread_local ThreadCache cache = {};
+    return cache;
+  }
+
+  static void register_releaser() {
+    static thread_local ThreadCacheReleaser releaser;
+    (void)releaser;
+  }
+
+  /// \brief The global pool is never destroyed, since trees can outlive
+  /// static objects
+  static GlobalPool& global_pool() {
+    static auto global = new GlobalPool();
+    return *global;
+  }
+
+  /// \brief Take all the free blocks of the given size class from the global
+  /// pool
+  static void refill(ThreadCache& cache, std::size_t idx) {
+    GlobalPool& global = global_pool();
+    std::lock_guard< std::mutex > lock(global.mutex);
+    cache.lists.heads[idx] = global.lists.heads[idx];
+    global.lists.heads[idx] = nullptr;
+  }
+
+  static void release_thread_cache() {
+    ThreadCache& cache = thread_cache();
+    GlobalPool& global = global_pool();
+    std::lock_guard< std::mutex > lock(global.mutex);
+    for (std::size_t idx = 0; idx < NumSizeClasses; idx++) {
+      FreeBlock* head = cache.lists.heads[idx];
+      if (head == nullptr) {
+        continue;
+      }
+      FreeBlock* tail = head;
+      while (tail->next != nullptr) {
+        tail = tail->next;
+      }
+      tail->next = global.lists.heads[idx];
+      global.lists.heads[idx] = head;
+      cache.lists.heads[idx] = nullptr;
+    }
+    cache.slab_cur = nullptr;
+    cache.slab_end = nullptr;
+    cache.released = true;
+  }
+
+}; // end class NodePool
+
+/// \brief Base class of patricia tree nodes
+///
+/// Holds the intrusive reference count and allocates from the NodePool.
+///
+/// Derived classes must have a virtual destructor, so that the sized
+/// deallocation function receives the size of the dynamic type.
+class NodeBase {
+private:
+#ifdef IKOS_PATRICIA_TREE_SINGLE_THREAD
+  mutable std::size_t _ref_count = 0;
+#else
+  mutable std::atomic< std::size_t > _ref_count{0};
+#endif
+
+public:
+  NodeBase() = default;
+
+  NodeBase(const NodeBase&) = delete;
+  NodeBase(NodeBase&&) = delete;
+  NodeBase& operator=(const NodeBase&) = delete;
+  NodeBase& operator=(NodeBase&&) = delete;
+
+  ~NodeBase() = default;
+
+  static void* operator new(std::size_t size) {
+    return NodePool::allocate(size);
+  }
+
+  static void operator delete(void* p, std::size_t size) {
+    NodePool::deallocate(p, size);
+  }
+
+  /// \brief Increment the reference count
+  void add_ref() const {
+#ifdef IKOS_PATRICIA_TREE_SINGLE_THREAD
+    ++this->_ref_count;
+#else
+    this->_ref_count.fetch_add(1, std::memory_order_relaxed);
+#endif
+  }
+
+  /// \brief Increment the reference count, unless it is zero
+  ///
+  /// Return false if the node is being destroyed.
+  bool try_add_ref() const {
+#ifdef IKOS_PATRICIA_TREE_SINGLE_THREAD
+    if (this->_ref_count == 0) {
+      return false;
+    }
+    ++this->_ref_count;
+    return true;
+#else
+    std::size_t count = this->_ref_count.load(std::memory_order_relaxed);
+    while (count != 0) {
+      if (this->_ref_count.compare_exchange_weak(count,
+                                                 count + 1,
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+#endif
+  }
+
+  /// \brief Decrement the reference count, return true if it reached zero
+  bool release() const {
+#ifdef IKOS_PATRICIA_TREE_SINGLE_THREAD
+    return --this->_ref_count == 0;
+#else
+    return this->_ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+#endif
+  }
+
+}; // end class NodeBase
+
+/// \brief Smart pointer on a node with an intrusive reference count
+///
+/// Provides the subset of the `std::shared_ptr` interface used by patricia
+/// trees.
+template < typename T >
+class NodePtr final {
+private:
+  T* _ptr = nullptr;
+
+  template < typename U >
+  friend class NodePtr;
+
+public:
+  /// \brief Create a null pointer
+  NodePtr() noexcept = default;
+
+  /// \brief Create a null pointer
+  NodePtr(std::nullptr_t) noexcept {} // NOLINT(google-explicit-constructor)
+
+  /// \brief Take a reference on the given node
+  explicit NodePtr(T* ptr) noexcept : _ptr(ptr) {
+    if (this->_ptr != nullptr) {
+      this->_ptr->add_ref();
+    }
+  }
+
+  /// \brief Copy constructor
+  NodePtr(const NodePtr& other) noexcept : NodePtr(other._ptr) {}
+
+  /// \brief Move constructor
+  NodePtr(NodePtr&& other) noexcept : _ptr(other._ptr) {
+    other._ptr = nullptr;
+  }
+
+  /// \brief Converting copy constructor
+  template < typename U >
+  NodePtr(const NodePtr< U >& other) noexcept // NOLINT
+      : NodePtr(static_cast< T* >(other._ptr)) {}
+
+  /// \brief Converting move constructor
+  template < typename U >
+  NodePtr(NodePtr< U >&& other) noexcept // NOLINT
+      : _ptr(other._ptr) {
+    other._ptr = nullptr;
+  }
+
+  /// \brief Copy assignment operator
+  NodePtr& operator=(const NodePtr& other) noexcept {
+    NodePtr(other).swap(*this);
+    return *this;
+  }
+
+  /// \brief Move assignment operator
+  NodePtr& operator=(NodePtr&& other) noexcept {
+    NodePtr(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /// \brief Assign a null pointer
+  NodePtr& operator=(std::nullptr_t) noexcept {
+    this->reset();
+    return *this;
+  }
+
+  /// \brief Destructor
+  ~NodePtr() {
+    if (this->_ptr != nullptr && this->_ptr->release()) {
+      delete this->_ptr;
+    }
+  }
+
+  /// \brief Take a reference on the given node, unless its reference count
+  /// already reached zero
+  static NodePtr acquire(T* ptr) noexcept {
+    NodePtr r;
+    if (ptr->try_add_ref()) {
+      r._ptr = ptr;
+    }
+    return r;
+  }
+
+  /// \brief Release the reference
+  void reset() noexcept { NodePtr().swap(*this); }
+
+  /// \brief Swap two pointers
+  void swap(NodePtr& other) noexcept { std::swap(this->_ptr, other._ptr); }
+
+  /// \brief Return the raw pointer
+  T* get() const noexcept { return this->_ptr; }
+
+  T& operator*() const noexcept { return *this->_ptr; }
+
+  T* operator->() const noexcept { return this->_ptr; }
+
+  explicit operator bool() const noexcept { return this->_ptr != nullptr; }
+
+}; // end class NodePtr
+
+template < typename T, typename U >
+inline bool operator==(const NodePtr< T >& a, const NodePtr< U >& b) {
+  return a.get() == b.get();
+}
+
+template < typename T, typename U >
+inline bool operator!=(const NodePtr< T >& a, const NodePtr< U >& b) {
+  return a.get() != b.get();
+}
+
+template < typename T >
+inline bool operator==(const NodePtr< T >& a, std::nullptr_t) {
+  return a.get() == nullptr;
+}
+
+template < typename T >
+inline bool operator!=(const NodePtr< T >& a, std::nullptr_t) {
+  return a.get() != nullptr;
+}
+
+template < typename T >
+inline bool operator==(std::nullptr_t, const NodePtr< T >& a) {
+  return a.get() == nullptr;
+}
+
+template < typename T >
+inline bool operator!=(std::nullptr_t, const NodePtr< T >& a) {
+  return a.get() != nullptr;
+}
+
+/// \brief Allocate a node and return a pointer on it
+template < typename T, typename... Args >
+inline NodePtr< T > make_node_ptr(Args&&... args) {
+  return NodePtr< T >(new T(std::forward< Args >(args)...));
+}
+
+/// \brief Static cast on node pointers
+template < typename T, typename U >
+inline NodePtr< T > static_node_cast(const NodePtr< U >& ptr) {
+  return NodePtr< T >(static_cast< T* >(ptr.get()));
+}
+
+#else // IKOS_PATRICIA_TREE_POOL_ALLOCATOR
+
+/// \brief Base class of patricia tree nodes
+class NodeBase {};
+
+/// \brief Smart pointer on a node
+template < typename T >
+using NodePtr = std::shared_ptr< T >;
+
+/// \brief Allocate a node and return a pointer on it
+template < typename T, typename... Args >
+inline NodePtr< T > make_node_ptr(Args&&... args) {
+  return std::make_shared< T >(std::forward< Args >(args)...);
+}
+
+/// \brief Static cast on node pointers
+template < typename T, typename U >
+inline NodePtr< T > static_node_cast(const NodePtr< U >& ptr) {
+  return std::static_pointer_cast< T >(ptr);
+}
+
+#endif // IKOS_PATRICIA_TREE_POOL_ALLOCATOR
+
+} // end namespace patricia_tree_utils
+} // end namespace core
+} // end namespace ikos
@@ -54,6 +54,9 @@
 #include <memory>
 #include <stack>
 
+#include <boost/functional/hash.hpp>
+
+#include <ikos/core/adt/patricia_tree/node_ptr.hpp>
 #include <ikos/core/adt/patricia_tree/utils.hpp>
 #include <ikos/core/semantic/dumpable.hpp>
 #include <ikos/core/semantic/indexable.hpp>
@@ -75,51 +78,50 @@ template < typename Key >
 class PatriciaTreeIterator;
 
 template < typename Key >
-inline bool empty(const std::shared_ptr< const PatriciaTree< Key > >& tree);
+inline bool empty(const NodePtr< const PatriciaTree< Key > >& tree);
 
 template < typename Key >
-inline std::size_t size(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree);
+inline std::size_t size(const NodePtr< const PatriciaTree< Key > >& tree);
 
 template < typename Key >
-inline bool contains(const std::shared_ptr< const PatriciaTree< Key > >& tree,
+inline bool contains(const NodePtr< const PatriciaTree< Key > >& tree,
                      const Key& key);
 
 template < typename Key >
-inline bool is_subset_of(const std::shared_ptr< const PatriciaTree< Key > >& s,
-                         const std::shared_ptr< const PatriciaTree< Key > >& t);
+inline bool is_subset_of(const NodePtr< const PatriciaTree< Key > >& s,
+                         const NodePtr< const PatriciaTree< Key > >& t);
 
 template < typename Key >
-inline bool equals(const std::shared_ptr< const PatriciaTree< Key > >& s,
-                   const std::shared_ptr< const PatriciaTree< Key > >& t);
+inline bool equals(const NodePtr< const PatriciaTree< Key > >& s,
+                   const NodePtr< const PatriciaTree< Key > >& t);
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > insert(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree, const Key& key);
+inline NodePtr< const PatriciaTree< Key > > insert(
+    const NodePtr< const PatriciaTree< Key > >& tree, const Key& key);
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > erase(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree, const Key& key);
+inline NodePtr< const PatriciaTree< Key > > erase(
+    const NodePtr< const PatriciaTree< Key > >& tree, const Key& key);
 
 template < typename Key, typename Predicate >
-inline std::shared_ptr< const PatriciaTree< Key > > filter(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree,
+inline NodePtr< const PatriciaTree< Key > > filter(
+    const NodePtr< const PatriciaTree< Key > >& tree,
     const Predicate& pred);
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > join(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t);
+inline NodePtr< const PatriciaTree< Key > > join(
+    const NodePtr< const PatriciaTree< Key > >& s,
+    const NodePtr< const PatriciaTree< Key > >& t);
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > intersect(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t);
+inline NodePtr< const PatriciaTree< Key > > intersect(
+    const NodePtr< const PatriciaTree< Key > >& s,
+    const NodePtr< const PatriciaTree< Key > >& t);
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > difference(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t);
+inline NodePtr< const PatriciaTree< Key > > difference(
+    const NodePtr< const PatriciaTree< Key > >& s,
+    const NodePtr< const PatriciaTree< Key > >& t);
 
 } // end namespace patricia_tree_set_impl
 
@@ -137,17 +139,17 @@ public:
 
 private:
   using PatriciaTree = patricia_tree_set_impl::PatriciaTree< Key >;
+  using TreePtr = patricia_tree_utils::NodePtr< const PatriciaTree >;
 
 public:
   using Iterator = patricia_tree_set_impl::PatriciaTreeIterator< Key >;
 
 private:
-  std::shared_ptr< const PatriciaTree > _tree;
+  TreePtr _tree;
 
 private:
   /// \brief Private constructor
-  explicit PatriciaTreeSet(std::shared_ptr< const PatriciaTree > tree)
-      : _tree(std::move(tree)) {}
+  explicit PatriciaTreeSet(TreePtr tree) : _tree(std::move(tree)) {}
 
 public:
   /// \brief Create an empty patricia tree set
@@ -285,6 +287,18 @@ public:
 
 }; // end class PatriciaTreeSet
 
+/// \brief Return the hash of a patricia tree set
+///
+/// Linear in the size of the set.
+template < typename Key >
+inline std::size_t hash_value(const PatriciaTreeSet< Key >& set) {
+  std::size_t hash = 0;
+  for (const Key& key : set) {
+    boost::hash_combine(hash, IndexableTraits< Key >::index(key));
+  }
+  return hash;
+}
+
 /// \brief Write a patricia tree set on a stream
 template < typename Key >
 inline std::ostream& operator<<(std::ostream& o,
@@ -296,7 +310,7 @@ inline std::ostream& operator<<(std::ostream& o,
 namespace patricia_tree_set_impl {
 
 template < typename Key >
-class PatriciaTree {
+class PatriciaTree : public NodeBase {
 private:
   std::size_t _size;
 
@@ -324,14 +338,14 @@ class PatriciaTreeNode final : public PatriciaTree< Key > {
 private:
   Index _prefix;
   Index _branching_bit;
-  std::shared_ptr< const PatriciaTree< Key > > _left_tree;
-  std::shared_ptr< const PatriciaTree< Key > > _right_tree;
+  NodePtr< const PatriciaTree< Key > > _left_tree;
+  NodePtr< const PatriciaTree< Key > > _right_tree;
 
 public:
   PatriciaTreeNode(Index prefix,
                    Index branching_bit,
-                   std::shared_ptr< const PatriciaTree< Key > > left_tree,
-                   std::shared_ptr< const PatriciaTree< Key > > right_tree)
+                   NodePtr< const PatriciaTree< Key > > left_tree,
+                   NodePtr< const PatriciaTree< Key > > right_tree)
       : PatriciaTree< Key >(left_tree->size() + right_tree->size()),
         _prefix(prefix),
         _branching_bit(branching_bit),
@@ -342,11 +356,11 @@ public:
 
   Index branching_bit() const { return this->_branching_bit; }
 
-  const std::shared_ptr< const PatriciaTree< Key > >& left_tree() const {
+  const NodePtr< const PatriciaTree< Key > >& left_tree() const {
     return this->_left_tree;
   }
 
-  const std::shared_ptr< const PatriciaTree< Key > >& right_tree() const {
+  const NodePtr< const PatriciaTree< Key > >& right_tree() const {
     return this->_right_tree;
   }
 
@@ -366,13 +380,12 @@ public:
 }; // end class PatriciaTreeLeaf
 
 template < typename Key >
-inline bool empty(const std::shared_ptr< const PatriciaTree< Key > >& tree) {
+inline bool empty(const NodePtr< const PatriciaTree< Key > >& tree) {
   return tree == nullptr;
 }
 
 template < typename Key >
-inline std::size_t size(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree) {
+inline std::size_t size(const NodePtr< const PatriciaTree< Key > >& tree) {
   if (tree != nullptr) {
     return tree->size();
   } else {
@@ -381,16 +394,16 @@ inline std::size_t size(
 }
 
 template < typename Key >
-inline bool contains(const std::shared_ptr< const PatriciaTree< Key > >& tree,
+inline bool contains(const NodePtr< const PatriciaTree< Key > >& tree,
                      const Key& key) {
   if (tree == nullptr) {
     return false;
   }
   if (tree->is_leaf()) {
-    auto leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(tree);
     return leaf->key() == key;
   }
-  auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key > >(tree);
   if (is_zero_bit(IndexableTraits< Key >::index(key), node->branching_bit())) {
     return contains(node->left_tree(), key);
   } else {
@@ -399,9 +412,8 @@ inline bool contains(const std::shared_ptr< const PatriciaTree< Key > >& tree,
 }
 
 template < typename Key >
-inline bool is_subset_of(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+inline bool is_subset_of(const NodePtr< const PatriciaTree< Key > >& s,
+                         const NodePtr< const PatriciaTree< Key > >& t) {
   if (s == t) {
     return true;
   }
@@ -412,14 +424,14 @@ inline bool is_subset_of(
     return false;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(s);
     return contains(t, s_leaf->key());
   }
   if (t->is_leaf()) {
     return false;
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key > >(t);
   if (s_node->size() > t_node->size()) {
     return false;
   }
@@ -444,8 +456,8 @@ inline bool is_subset_of(
 }
 
 template < typename Key >
-inline bool equals(const std::shared_ptr< const PatriciaTree< Key > >& s,
-                   const std::shared_ptr< const PatriciaTree< Key > >& t) {
+inline bool equals(const NodePtr< const PatriciaTree< Key > >& s,
+                   const NodePtr< const PatriciaTree< Key > >& t) {
   if (s == t) {
     return true;
   }
@@ -456,15 +468,15 @@ inline bool equals(const std::shared_ptr< const PatriciaTree< Key > >& s,
     if (t->is_node()) {
       return false;
     }
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
-    auto t_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(t);
     return s_leaf->key() == t_leaf->key();
   }
   if (t->is_leaf()) {
     return false;
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key > >(t);
   return s_node->size() == t_node->size() &&
          s_node->prefix() == t_node->prefix() &&
          s_node->branching_bit() == t_node->branching_bit() &&
@@ -476,18 +488,18 @@ inline bool equals(const std::shared_ptr< const PatriciaTree< Key > >& s,
 ///
 /// Prevent the creation of a node with only one child.
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > make_node(
+inline NodePtr< const PatriciaTree< Key > > make_node(
     Index prefix,
     Index branching_bit,
-    const std::shared_ptr< const PatriciaTree< Key > >& left_tree,
-    const std::shared_ptr< const PatriciaTree< Key > >& right_tree) {
+    const NodePtr< const PatriciaTree< Key > >& left_tree,
+    const NodePtr< const PatriciaTree< Key > >& right_tree) {
   if (left_tree == nullptr) {
     return right_tree;
   }
   if (right_tree == nullptr) {
     return left_tree;
   }
-  return std::make_shared< const PatriciaTreeNode< Key > >(prefix,
+  return make_node_ptr< const PatriciaTreeNode< Key > >(prefix,
                                                            branching_bit,
                                                            left_tree,
                                                            right_tree);
@@ -495,22 +507,22 @@ inline std::shared_ptr< const PatriciaTree< Key > > make_node(
 
 /// \brief Join non-null patricia trees
 template < typename Key >
-inline std::shared_ptr< const PatriciaTreeNode< Key > > join_trees(
+inline NodePtr< const PatriciaTreeNode< Key > > join_trees(
     Index prefix_s,
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
+    const NodePtr< const PatriciaTree< Key > >& s,
     Index prefix_t,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+    const NodePtr< const PatriciaTree< Key > >& t) {
   ikos_assert(s != nullptr && t != nullptr);
 
   Index m = branching_bit(prefix_s, prefix_t);
 
   if (is_zero_bit(prefix_s, m)) {
-    return std::make_shared< const PatriciaTreeNode< Key > >(mask(prefix_s, m),
+    return make_node_ptr< const PatriciaTreeNode< Key > >(mask(prefix_s, m),
                                                              m,
                                                              s,
                                                              t);
   } else {
-    return std::make_shared< const PatriciaTreeNode< Key > >(mask(prefix_s, m),
+    return make_node_ptr< const PatriciaTreeNode< Key > >(mask(prefix_s, m),
                                                              m,
                                                              t,
                                                              s);
@@ -518,23 +530,23 @@ inline std::shared_ptr< const PatriciaTreeNode< Key > > join_trees(
 }
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > insert(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree, const Key& key) {
+inline NodePtr< const PatriciaTree< Key > > insert(
+    const NodePtr< const PatriciaTree< Key > >& tree, const Key& key) {
   if (tree == nullptr) {
-    return std::make_shared< const PatriciaTreeLeaf< Key > >(key);
+    return make_node_ptr< const PatriciaTreeLeaf< Key > >(key);
   }
   if (tree->is_leaf()) {
-    auto leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(tree);
     if (leaf->key() == key) {
       return tree;
     }
-    auto new_leaf = std::make_shared< const PatriciaTreeLeaf< Key > >(key);
+    auto new_leaf = make_node_ptr< const PatriciaTreeLeaf< Key > >(key);
     return join_trees< Key >(IndexableTraits< Key >::index(key),
                              new_leaf,
                              IndexableTraits< Key >::index(leaf->key()),
                              leaf);
   }
-  auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key > >(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -559,7 +571,7 @@ inline std::shared_ptr< const PatriciaTree< Key > > insert(
                        new_right_tree);
     }
   }
-  auto new_leaf = std::make_shared< const PatriciaTreeLeaf< Key > >(key);
+  auto new_leaf = make_node_ptr< const PatriciaTreeLeaf< Key > >(key);
   return join_trees< Key >(IndexableTraits< Key >::index(key),
                            new_leaf,
                            node->prefix(),
@@ -568,9 +580,9 @@ inline std::shared_ptr< const PatriciaTree< Key > > insert(
 
 /// \brief Insert the leaf `t_leaf` into the patricia tree `s`
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > insert_leaf(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTreeLeaf< Key > >& t_leaf) {
+inline NodePtr< const PatriciaTree< Key > > insert_leaf(
+    const NodePtr< const PatriciaTree< Key > >& s,
+    const NodePtr< const PatriciaTreeLeaf< Key > >& t_leaf) {
   if (s == t_leaf) {
     return s;
   }
@@ -578,7 +590,7 @@ inline std::shared_ptr< const PatriciaTree< Key > > insert_leaf(
     return t_leaf;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(s);
     if (s_leaf->key() == t_leaf->key()) {
       return std::move(s_leaf);
     }
@@ -587,7 +599,7 @@ inline std::shared_ptr< const PatriciaTree< Key > > insert_leaf(
                              IndexableTraits< Key >::index(t_leaf->key()),
                              t_leaf);
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key > >(s);
   if (match_prefix(IndexableTraits< Key >::index(t_leaf->key()),
                    s_node->prefix(),
                    s_node->branching_bit())) {
@@ -619,20 +631,20 @@ inline std::shared_ptr< const PatriciaTree< Key > > insert_leaf(
 }
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > erase(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree, const Key& key) {
+inline NodePtr< const PatriciaTree< Key > > erase(
+    const NodePtr< const PatriciaTree< Key > >& tree, const Key& key) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(tree);
     if (leaf->key() == key) {
       return nullptr;
     } else {
       return tree;
     }
   }
-  auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key > >(tree);
   if (match_prefix(IndexableTraits< Key >::index(key),
                    node->prefix(),
                    node->branching_bit())) {
@@ -661,21 +673,21 @@ inline std::shared_ptr< const PatriciaTree< Key > > erase(
 }
 
 template < typename Key, typename Predicate >
-inline std::shared_ptr< const PatriciaTree< Key > > filter(
-    const std::shared_ptr< const PatriciaTree< Key > >& tree,
+inline NodePtr< const PatriciaTree< Key > > filter(
+    const NodePtr< const PatriciaTree< Key > >& tree,
     const Predicate& pred) {
   if (tree == nullptr) {
     return nullptr;
   }
   if (tree->is_leaf()) {
-    auto leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(tree);
+    auto leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(tree);
     if (pred(leaf->key())) {
       return tree;
     } else {
       return nullptr;
     }
   }
-  auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(tree);
+  auto node = static_node_cast< const PatriciaTreeNode< Key > >(tree);
   auto new_left_tree = filter(node->left_tree(), pred);
   auto new_right_tree = filter(node->right_tree(), pred);
   if (new_left_tree == node->left_tree() &&
@@ -690,9 +702,9 @@ inline std::shared_ptr< const PatriciaTree< Key > > filter(
 }
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > join(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+inline NodePtr< const PatriciaTree< Key > > join(
+    const NodePtr< const PatriciaTree< Key > >& s,
+    const NodePtr< const PatriciaTree< Key > >& t) {
   if (s == t) {
     return s;
   }
@@ -703,15 +715,15 @@ inline std::shared_ptr< const PatriciaTree< Key > > join(
     return s;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(s);
     return insert_leaf(t, s_leaf);
   }
   if (t->is_leaf()) {
-    auto t_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(t);
     return insert_leaf(s, t_leaf);
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key > >(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -765,9 +777,9 @@ inline std::shared_ptr< const PatriciaTree< Key > > join(
 }
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > intersect(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+inline NodePtr< const PatriciaTree< Key > > intersect(
+    const NodePtr< const PatriciaTree< Key > >& s,
+    const NodePtr< const PatriciaTree< Key > >& t) {
   if (s == t) {
     return s;
   }
@@ -775,7 +787,7 @@ inline std::shared_ptr< const PatriciaTree< Key > > intersect(
     return nullptr;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(s);
     if (contains(t, s_leaf->key())) {
       return s;
     } else {
@@ -783,15 +795,15 @@ inline std::shared_ptr< const PatriciaTree< Key > > intersect(
     }
   }
   if (t->is_leaf()) {
-    auto t_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(t);
     if (contains(s, t_leaf->key())) {
       return t;
     } else {
       return nullptr;
     }
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key > >(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -829,9 +841,9 @@ inline std::shared_ptr< const PatriciaTree< Key > > intersect(
 }
 
 template < typename Key >
-inline std::shared_ptr< const PatriciaTree< Key > > difference(
-    const std::shared_ptr< const PatriciaTree< Key > >& s,
-    const std::shared_ptr< const PatriciaTree< Key > >& t) {
+inline NodePtr< const PatriciaTree< Key > > difference(
+    const NodePtr< const PatriciaTree< Key > >& s,
+    const NodePtr< const PatriciaTree< Key > >& t) {
   if (s == t) {
     return nullptr;
   }
@@ -842,7 +854,7 @@ inline std::shared_ptr< const PatriciaTree< Key > > difference(
     return s;
   }
   if (s->is_leaf()) {
-    auto s_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(s);
+    auto s_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(s);
     if (contains(t, s_leaf->key())) {
       return nullptr;
     } else {
@@ -850,11 +862,11 @@ inline std::shared_ptr< const PatriciaTree< Key > > difference(
     }
   }
   if (t->is_leaf()) {
-    auto t_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    auto t_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(t);
     return erase(s, t_leaf->key());
   }
-  auto s_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(s);
-  auto t_node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+  auto s_node = static_node_cast< const PatriciaTreeNode< Key > >(s);
+  auto t_node = static_node_cast< const PatriciaTreeNode< Key > >(t);
   Index m = s_node->branching_bit();
   Index n = t_node->branching_bit();
   Index p = s_node->prefix();
@@ -910,8 +922,8 @@ public:
   using reference = const Key&;
 
 private:
-  std::shared_ptr< const PatriciaTreeLeaf< Key > > _leaf;
-  std::stack< std::shared_ptr< const PatriciaTreeNode< Key > > > _stack;
+  NodePtr< const PatriciaTreeLeaf< Key > > _leaf;
+  std::stack< NodePtr< const PatriciaTreeNode< Key > > > _stack;
 
 public:
   /// \brief Create an end iterator
@@ -919,7 +931,7 @@ public:
 
   /// \brief Create an iterator on the given patricia tree
   explicit PatriciaTreeIterator(
-      const std::shared_ptr< const PatriciaTree< Key > >& tree) {
+      const NodePtr< const PatriciaTree< Key > >& tree) {
     if (tree != nullptr) {
       this->look_for_next_leaf(tree);
     }
@@ -970,17 +982,16 @@ public:
 
 private:
   /// \brief Find the leftmost leaf, store all intermediate nodes
-  void look_for_next_leaf(
-      const std::shared_ptr< const PatriciaTree< Key > >& tree) {
+  void look_for_next_leaf(const NodePtr< const PatriciaTree< Key > >& tree) {
     auto t = tree;
     ikos_assert(t != nullptr);
     while (t->is_node()) {
-      auto node = std::static_pointer_cast< const PatriciaTreeNode< Key > >(t);
+      auto node = static_node_cast< const PatriciaTreeNode< Key > >(t);
       this->_stack.push(node);
       t = node->left_tree();
       ikos_assert(t != nullptr); // a node always has two children
     }
-    this->_leaf = std::static_pointer_cast< const PatriciaTreeLeaf< Key > >(t);
+    this->_leaf = static_node_cast< const PatriciaTreeLeaf< Key > >(t);
   }
 
 }; // end class PatriciaTreeIterator
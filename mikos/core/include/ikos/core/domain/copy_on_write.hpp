@@ -0,0 +1,107 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Statistics on copy-on-write abstract values
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace ikos {
+namespace core {
+
+/// \brief Counters of copy-on-write abstract values
+///
+/// Abstract values with copy-on-write semantics share their representation
+/// on copy, and only clone it when one of the copies is modified. A copy that
+/// is never modified is an avoided deep copy.
+///
+/// Counters are global and can be updated from several threads.
+class CopyOnWriteStats {
+public:
+  CopyOnWriteStats() = delete;
+
+  /// \brief Record that a copy shared its representation
+  static void add_share() {
+    shares_counter().fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief Record that a shared representation was cloned before a
+  /// modification
+  static void add_clone() {
+    clones_counter().fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief Return the number of copies that shared their representation
+  static std::size_t shares() {
+    return shares_counter().load(std::memory_order_relaxed);
+  }
+
+  /// \brief Return the number of shared representations that were cloned
+  static std::size_t clones() {
+    return clones_counter().load(std::memory_order_relaxed);
+  }
+
+  /// \brief Return the number of deep copies avoided so far
+  static std::size_t avoided_copies() {
+    std::size_t s = shares();
+    std::size_t c = clones();
+    return s > c ? s - c : 0;
+  }
+
+  /// \brief Reset the counters
+  static void reset() {
+    shares_counter().store(0, std::memory_order_relaxed);
+    clones_counter().store(0, std::memory_order_relaxed);
+  }
+
+private:
+  static std::atomic< std::size_t >& shares_counter() {
+    static std::atomic< std::size_t > counter(0);
+    return counter;
+  }
+
+  static std::atomic< std::size_t >& clones_counter() {
+    static std::atomic< std::size_t > counter(0);
+    return counter;
+  }
+
+}; // end class CopyOnWriteStats
+
+} // end namespace core
+} // end namespace ikos
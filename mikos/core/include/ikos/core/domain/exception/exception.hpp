@@ -322,6 +322,13 @@ public:
 
   /// @}
 
+  /// \brief Normalize the abstract value
+  void normalize() const {
+    this->_normal.normalize();
+    this->_caught_exceptions.normalize();
+    this->_propagated_exceptions.normalize();
+  }
+
   void dump(std::ostream& o) const override {
     o << "(normal=";
     this->_normal.dump(o);
@@ -0,0 +1,513 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Non-relational interval domain with a flat table for small integers
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <ikos/core/domain/abstract_domain.hpp>
+#include <ikos/core/domain/machine_int/interval_table.hpp>
+#include <ikos/core/domain/machine_int/operator.hpp>
+#include <ikos/core/domain/machine_int/separate_domain.hpp>
+#include <ikos/core/linear_expression.hpp>
+#include <ikos/core/number/machine_int.hpp>
+#include <ikos/core/semantic/dumpable.hpp>
+#include <ikos/core/semantic/indexable.hpp>
+#include <ikos/core/semantic/machine_int/variable.hpp>
+#include <ikos/core/semantic/variable.hpp>
+#include <ikos/core/value/machine_int/interval.hpp>
+
+namespace ikos {
+namespace core {
+namespace machine_int {
+
+/// \brief Non-relational interval domain with a flat table for small integers
+///
+/// Intervals of at most 64 bits are stored in an `IntervalTable`, so that the
+/// join, widening, meet, narrowing and inclusion run over flat arrays of
+/// bounds. Larger intervals are stored in a `SeparateDomain`.
+///
+/// It provides the same interface as `SeparateDomain< VariableRef, Interval >`
+/// and the same semantics.
+template < typename VariableRef >
+class FlatSeparateDomain final
+    : public core::AbstractDomain< FlatSeparateDomain< VariableRef > > {
+public:
+  static_assert(
+      core::IsVariable< VariableRef >::value,
+      "VariableRef does not meet the requirements for variable types");
+  static_assert(machine_int::IsVariable< VariableRef >::value,
+                "VariableRef must implement machine_int::VariableTraits");
+
+private:
+  using VariableTrait = machine_int::VariableTraits< VariableRef >;
+  using IntervalTableT = IntervalTable< VariableRef >;
+  using SeparateDomainT = SeparateDomain< VariableRef, Interval >;
+
+public:
+  using LinearExpressionT = LinearExpression< MachineInt, VariableRef >;
+
+  /// \brief Iterator over the pairs (variable, interval)
+  ///
+  /// Yields the intervals of the table, then the larger intervals.
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair< VariableRef, Interval >;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+  private:
+    using LargeIterator = typename SeparateDomainT::Iterator;
+
+  private:
+    const IntervalTableT* _table;
+    std::size_t _i;
+    LargeIterator _it;
+    LargeIterator _et;
+    boost::optional< value_type > _value;
+
+  public:
+    /// \brief Create an iterator
+    Iterator(const IntervalTableT& table,
+             std::size_t i,
+             LargeIterator it,
+             LargeIterator et)
+        : _table(&table), _i(i), _it(std::move(it)), _et(std::move(et)) {
+      this->load();
+    }
+
+    /// \brief Pre-increment
+    Iterator& operator++() {
+      if (this->_i < this->_table->size()) {
+        this->_i++;
+      } else {
+        ++this->_it;
+      }
+      this->load();
+      return *this;
+    }
+
+    /// \brief Post-increment
+    Iterator operator++(int) {
+      Iterator r = *this;
+      this->operator++();
+      return r;
+    }
+
+    /// \brief Equality
+    bool operator==(const Iterator& other) const {
+      return this->_i == other._i && this->_it == other._it;
+    }
+
+    /// \brief Inequality
+    bool operator!=(const Iterator& other) const {
+      return !this->operator==(other);
+    }
+
+    /// \brief Dereference
+    reference operator*() const {
+      ikos_assert(this->_value);
+      return *this->_value;
+    }
+
+    /// \brief Dereference
+    pointer operator->() const { return &this->operator*(); }
+
+  private:
+    /// \brief Load the current pair
+    void load() {
+      if (this->_i < this->_table->size()) {
+        this->_value = value_type(this->_table->variable(this->_i),
+                                  this->_table->interval(this->_i));
+      } else if (this->_it != this->_et) {
+        this->_value = value_type(this->_it->first, this->_it->second);
+      } else {
+        this->_value = boost::none;
+      }
+    }
+
+  }; // end class Iterator
+
+private:
+  /// \brief Intervals of at most 64 bits
+  IntervalTableT _table;
+
+  /// \brief Intervals of more than 64 bits
+  ///
+  /// It also records whether the abstract value is bottom.
+  SeparateDomainT _large;
+
+private:
+  /// \brief Private constructor
+  explicit FlatSeparateDomain(SeparateDomainT large)
+      : _large(std::move(large)) {}
+
+  /// \brief Return true if the given variable is stored in the table
+  static bool in_table(VariableRef x) {
+    return VariableTrait::bit_width(x) <= 64;
+  }
+
+public:
+  /// \brief Create the top abstract value
+  static FlatSeparateDomain top() {
+    return FlatSeparateDomain(SeparateDomainT::top());
+  }
+
+  /// \brief Create the bottom abstract value
+  static FlatSeparateDomain bottom() {
+    return FlatSeparateDomain(SeparateDomainT::bottom());
+  }
+
+  /// \brief Copy constructor
+  FlatSeparateDomain(const FlatSeparateDomain&) noexcept = default;
+
+  /// \brief Move constructor
+  FlatSeparateDomain(FlatSeparateDomain&&) noexcept = default;
+
+  /// \brief Copy assignment operator
+  FlatSeparateDomain& operator=(const FlatSeparateDomain&) noexcept = default;
+
+  /// \brief Move assignment operator
+  FlatSeparateDomain& operator=(FlatSeparateDomain&&) noexcept = default;
+
+  /// \brief Destructor
+  ~FlatSeparateDomain() override = default;
+
+  /// \brief Begin iterator over the pairs (variable, interval)
+  Iterator begin() const {
+    ikos_assert(!this->is_bottom());
+    return Iterator(this->_table,
+                    0,
+                    this->_large.begin(),
+                    this->_large.end());
+  }
+
+  /// \brief End iterator over the pairs (variable, interval)
+  Iterator end() const {
+    ikos_assert(!this->is_bottom());
+    return Iterator(this->_table,
+                    this->_table.size(),
+                    this->_large.end(),
+                    this->_large.end());
+  }
+
+  bool is_bottom() const override { return this->_large.is_bottom(); }
+
+  bool is_top() const override {
+    return this->_large.is_top() && this->_table.empty();
+  }
+
+  void set_to_bottom() override {
+    this->_large.set_to_bottom();
+    this->_table.clear();
+  }
+
+  void set_to_top() override {
+    this->_large.set_to_top();
+    this->_table.clear();
+  }
+
+  bool leq(const FlatSeparateDomain& other) const override {
+    if (this->is_bottom()) {
+      return true;
+    } else if (other.is_bottom()) {
+      return false;
+    } else {
+      return this->_table.leq(other._table) && this->_large.leq(other._large);
+    }
+  }
+
+  bool equals(const FlatSeparateDomain& other) const override {
+    if (this->is_bottom()) {
+      return other.is_bottom();
+    } else if (other.is_bottom()) {
+      return false;
+    } else {
+      return this->_table.equals(other._table) &&
+             this->_large.equals(other._large);
+    }
+  }
+
+  void join_with(const FlatSeparateDomain& other) override {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+    } else {
+      this->_table.join_with(other._table);
+      this->_large.join_with(other._large);
+    }
+  }
+
+  void widen_with(const FlatSeparateDomain& other) override {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+    } else {
+      this->_table.widen_with(other._table);
+      this->_large.widen_with(other._large);
+    }
+  }
+
+  void widen_threshold_with(const FlatSeparateDomain& other,
+                            const MachineInt& threshold) {
+    if (other.is_bottom()) {
+      return;
+    } else if (this->is_bottom()) {
+      this->operator=(other);
+    } else {
+      this->_table.widen_threshold_with(other._table, threshold);
+      this->_large.widen_threshold_with(other._large, threshold);
+    }
+  }
+
+  void meet_with(const FlatSeparateDomain& other) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (other.is_bottom() || !this->_table.meet_with(other._table)) {
+      this->set_to_bottom();
+    } else {
+      this->_large.meet_with(other._large);
+      if (this->_large.is_bottom()) {
+        this->_table.clear();
+      }
+    }
+  }
+
+  void narrow_with(const FlatSeparateDomain& other) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (other.is_bottom() || !this->_table.narrow_with(other._table)) {
+      this->set_to_bottom();
+    } else {
+      this->_large.narrow_with(other._large);
+      if (this->_large.is_bottom()) {
+        this->_table.clear();
+      }
+    }
+  }
+
+  void narrow_threshold_with(const FlatSeparateDomain& other,
+                             const MachineInt& threshold) {
+    if (this->is_bottom()) {
+      return;
+    } else if (other.is_bottom() ||
+               !this->_table.narrow_threshold_with(other._table, threshold)) {
+      this->set_to_bottom();
+    } else {
+      this->_large.narrow_threshold_with(other._large, threshold);
+      if (this->_large.is_bottom()) {
+        this->_table.clear();
+      }
+    }
+  }
+
+  /// \brief Get the interval of the given variable
+  Interval get(VariableRef x) const {
+    if (this->is_bottom()) {
+      return Interval::bottom(VariableTrait::bit_width(x),
+                              VariableTrait::sign(x));
+    } else if (in_table(x)) {
+      boost::optional< Interval > v = this->_table.get(x);
+      if (v) {
+        return *v;
+      } else {
+        return Interval::top(VariableTrait::bit_width(x),
+                             VariableTrait::sign(x));
+      }
+    } else {
+      return this->_large.get(x);
+    }
+  }
+
+  /// \brief Set the interval of the given variable
+  void set(VariableRef x, const Interval& value) {
+    if (this->is_bottom()) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else if (!in_table(x)) {
+      this->_large.set(x, value);
+    } else if (value.is_top()) {
+      this->_table.erase(x);
+    } else {
+      this->_table.set(x, value);
+    }
+  }
+
+  /// \brief Refine the interval of the given variable
+  void refine(VariableRef x, const Interval& value) {
+    if (this->is_bottom()) {
+      return;
+    } else if (!in_table(x)) {
+      this->_large.refine(x, value);
+      if (this->_large.is_bottom()) {
+        this->_table.clear();
+      }
+    } else {
+      this->set(x, this->get(x).meet(value));
+    }
+  }
+
+  /// \brief Projection
+  ///
+  /// Return an overapproximation of the linear expression e as an interval
+  ///
+  /// Note that it wraps on integer overflow.
+  /// Note that it will automatically cast variables to the type of
+  /// `e.constant()`.
+  Interval project(const LinearExpressionT& e) const {
+    // Result type
+    unsigned bit_width = e.constant().bit_width();
+    Signedness sign = e.constant().sign();
+
+    if (this->is_bottom()) {
+      return Interval::bottom(bit_width, sign);
+    }
+
+    Interval r(e.constant());
+    for (const auto& term : e) {
+      r = add(r,
+              mul(Interval(term.second),
+                  this->get(term.first).cast(bit_width, sign)));
+    }
+    return r;
+  }
+
+  /// \brief Forget the interval of the given variable
+  void forget(VariableRef x) {
+    if (this->is_bottom()) {
+      return;
+    } else if (in_table(x)) {
+      this->_table.erase(x);
+    } else {
+      this->_large.forget(x);
+    }
+  }
+
+  /// \brief Assign `x = n`
+  void assign(VariableRef x, const MachineInt& n) {
+    this->set(x, Interval(n));
+  }
+
+  /// \brief Assign `x = n`
+  void assign(VariableRef x, VariableRef y) { this->set(x, this->get(y)); }
+
+  /// \brief Assign `x = e`
+  ///
+  /// Note that it wraps on integer overflow.
+  /// Note that it will automatically cast variables to the type of `x`.
+  void assign(VariableRef x, const LinearExpressionT& e) {
+    this->set(x, this->project(e));
+  }
+
+  /// \brief Apply `x = op y`
+  void apply(UnaryOperator op, VariableRef x, VariableRef y) {
+    this->set(x,
+              apply_unary_operator(op,
+                                   this->get(y),
+                                   VariableTrait::bit_width(x),
+                                   VariableTrait::sign(x)));
+  }
+
+  /// \brief Apply `x = y op z`
+  void apply(BinaryOperator op, VariableRef x, VariableRef y, VariableRef z) {
+    this->set(x, apply_bin_operator(op, this->get(y), this->get(z)));
+  }
+
+  /// \brief Apply `x = y op z`
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             const MachineInt& z) {
+    this->set(x, apply_bin_operator(op, this->get(y), Interval(z)));
+  }
+
+  /// \brief Apply `x = y op z`
+  void apply(BinaryOperator op,
+             VariableRef x,
+             const MachineInt& y,
+             VariableRef z) {
+    this->set(x, apply_bin_operator(op, Interval(y), this->get(z)));
+  }
+
+  void dump(std::ostream& o) const override {
+    if (this->is_bottom()) {
+      o << "⊥";
+      return;
+    }
+
+    std::vector< std::pair< VariableRef, Interval > > entries(this->begin(),
+                                                              this->end());
+    std::sort(entries.begin(),
+              entries.end(),
+              [](const std::pair< VariableRef, Interval >& a,
+                 const std::pair< VariableRef, Interval >& b) {
+                return IndexableTraits< VariableRef >::index(a.first) <
+                       IndexableTraits< VariableRef >::index(b.first);
+              });
+    o << "{";
+    for (auto it = entries.begin(), et = entries.end(); it != et;) {
+      DumpableTraits< VariableRef >::dump(o, it->first);
+      o << " -> ";
+      it->second.dump(o);
+      ++it;
+      if (it != et) {
+        o << "; ";
+      }
+    }
+    o << "}";
+  }
+
+  static std::string name() { return "flat separate domain of intervals"; }
+
+}; // end class FlatSeparateDomain
+
+} // end namespace machine_int
+} // end namespace core
+} // end namespace ikos
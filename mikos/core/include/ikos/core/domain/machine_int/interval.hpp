@@ -44,7 +44,11 @@
 #pragma once
 
 #include <ikos/core/domain/machine_int/abstract_domain.hpp>
+#ifdef IKOS_MACHINE_INT_FLAT_INTERVALS
+#include <ikos/core/domain/machine_int/flat_separate_domain.hpp>
+#else
 #include <ikos/core/domain/machine_int/separate_domain.hpp>
+#endif
 #include <ikos/core/value/machine_int/interval.hpp>
 
 namespace ikos {
@@ -78,7 +82,11 @@ class IntervalDomain final
 private:
   using Parent =
       machine_int::AbstractDomain< VariableRef, IntervalDomain< VariableRef > >;
+#ifdef IKOS_MACHINE_INT_FLAT_INTERVALS
+  using SeparateDomainT = machine_int::FlatSeparateDomain< VariableRef >;
+#else
   using SeparateDomainT = machine_int::SeparateDomain< VariableRef, Interval >;
+#endif
   using VariableTrait = machine_int::VariableTraits< VariableRef >;
 
 public:
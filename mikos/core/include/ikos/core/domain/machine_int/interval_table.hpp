@@ -0,0 +1,931 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Flat table of machine integer intervals of at most 64 bits
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <boost/optional.hpp>
+
+#include <ikos/core/domain/copy_on_write.hpp>
+#include <ikos/core/number/machine_int.hpp>
+#include <ikos/core/semantic/indexable.hpp>
+#include <ikos/core/semantic/machine_int/variable.hpp>
+#include <ikos/core/support/assert.hpp>
+#include <ikos/core/value/machine_int/interval.hpp>
+
+namespace ikos {
+namespace core {
+namespace machine_int {
+
+namespace interval_table_impl {
+
+/// \brief Encoding of the maximum integer of any bit-width
+constexpr uint64_t Ones = ~uint64_t(0);
+
+/// \brief Return the bits of the given machine integer of at most 64 bits,
+/// with the sign bit flipped for signed integers
+///
+/// The unsigned order of the result is the order of the integers.
+inline uint64_t ordered_bits(const MachineInt& n) {
+  ikos_assert(n.bit_width() <= 64);
+
+  if (n.is_signed()) {
+    auto bits = static_cast< uint64_t >(n.to< int64_t >());
+    uint64_t sign_bit = uint64_t(1) << (n.bit_width() - 1);
+    return (bits ^ sign_bit) & (Ones >> (64 - n.bit_width()));
+  } else {
+    return n.to< uint64_t >();
+  }
+}
+
+/// \brief Return the machine integer with the given ordered bits
+inline MachineInt from_ordered_bits(uint64_t bits,
+                                    unsigned bit_width,
+                                    Signedness sign) {
+  if (sign == Signed) {
+    bits ^= uint64_t(1) << (bit_width - 1);
+  }
+  return MachineInt(bits, bit_width, sign);
+}
+
+/// \brief Encode a lower bound
+///
+/// The ordered bits are aligned on the left, so that the minimum integer of
+/// any bit-width and signedness is encoded as 0.
+inline uint64_t encode_lb(const MachineInt& n) {
+  return ordered_bits(n) << (64 - n.bit_width());
+}
+
+/// \brief Encode an upper bound
+///
+/// The ordered bits are aligned on the left and padded with ones, so that the
+/// maximum integer of any bit-width and signedness is encoded as `Ones`.
+inline uint64_t encode_ub(const MachineInt& n) {
+  unsigned shift = 64 - n.bit_width();
+  return (ordered_bits(n) << shift) | ~(Ones << shift);
+}
+
+/// \brief Decode an interval
+inline Interval decode(uint64_t lb,
+                       uint64_t ub,
+                       unsigned bit_width,
+                       Signedness sign) {
+  unsigned shift = 64 - bit_width;
+  return Interval(from_ordered_bits(lb >> shift, bit_width, sign),
+                  from_ordered_bits(ub >> shift, bit_width, sign));
+}
+
+#if defined(__AVX2__)
+
+/// \brief Load 4 encoded bounds
+inline __m256i load(const uint64_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast< const __m256i* >(p));
+}
+
+/// \brief Store 4 encoded bounds
+inline void store(uint64_t* p, __m256i v) {
+  _mm256_storeu_si256(reinterpret_cast< __m256i* >(p), v);
+}
+
+/// \brief Return all ones in the lanes where `a > b`, as unsigned integers
+///
+/// AVX2 only compares signed integers, hence flip the sign bits first.
+inline __m256i cmpgt_epu64(__m256i a, __m256i b) {
+  const __m256i sign_bit =
+      _mm256_set1_epi64x(std::numeric_limits< long long >::min());
+  return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign_bit),
+                            _mm256_xor_si256(b, sign_bit));
+}
+
+/// \brief Return the unsigned minimum of each lane
+inline __m256i min_epu64(__m256i a, __m256i b) {
+  return _mm256_blendv_epi8(a, b, cmpgt_epu64(a, b));
+}
+
+/// \brief Return the unsigned maximum of each lane
+inline __m256i max_epu64(__m256i a, __m256i b) {
+  return _mm256_blendv_epi8(b, a, cmpgt_epu64(a, b));
+}
+
+#endif // defined(__AVX2__)
+
+/// \name Kernels on encoded intervals
+///
+/// The kernels combine the `n` intervals (`lbs[i]`, `ubs[i]`) with the
+/// intervals (`o_lbs[i]`, `o_ubs[i]`) of the same variables, in place. Since
+/// the encoding of the bounds does not depend on the bit-width and the
+/// signedness, they handle all the variables uniformly.
+///
+/// With AVX2, the intervals are processed 4 at a time.
+/// @{
+
+/// \brief Join
+inline void join(std::size_t n,
+                 uint64_t* lbs,
+                 uint64_t* ubs,
+                 const uint64_t* o_lbs,
+                 const uint64_t* o_ubs) {
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 4 <= n; i += 4) {
+    store(lbs + i, min_epu64(load(lbs + i), load(o_lbs + i)));
+    store(ubs + i, max_epu64(load(ubs + i), load(o_ubs + i)));
+  }
+#endif
+  for (; i < n; i++) {
+    lbs[i] = std::min(lbs[i], o_lbs[i]);
+    ubs[i] = std::max(ubs[i], o_ubs[i]);
+  }
+}
+
+/// \brief Widening
+inline void widening(std::size_t n,
+                     uint64_t* lbs,
+                     uint64_t* ubs,
+                     const uint64_t* o_lbs,
+                     const uint64_t* o_ubs) {
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 4 <= n; i += 4) {
+    __m256i lb = load(lbs + i);
+    __m256i ub = load(ubs + i);
+    // lb = (o_lb < lb) ? 0 : lb
+    store(lbs + i, _mm256_andnot_si256(cmpgt_epu64(lb, load(o_lbs + i)), lb));
+    // ub = (ub < o_ub) ? Ones : ub
+    store(ubs + i, _mm256_or_si256(cmpgt_epu64(load(o_ubs + i), ub), ub));
+  }
+#endif
+  for (; i < n; i++) {
+    lbs[i] = (o_lbs[i] < lbs[i]) ? 0 : lbs[i];
+    ubs[i] = (ubs[i] < o_ubs[i]) ? Ones : ubs[i];
+  }
+}
+
+/// \brief Meet
+///
+/// \returns false if one of the intervals is empty
+inline bool meet(std::size_t n,
+                 uint64_t* lbs,
+                 uint64_t* ubs,
+                 const uint64_t* o_lbs,
+                 const uint64_t* o_ubs) {
+  std::size_t i = 0;
+  bool is_bottom = false;
+#if defined(__AVX2__)
+  __m256i bottom = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4) {
+    __m256i lb = max_epu64(load(lbs + i), load(o_lbs + i));
+    __m256i ub = min_epu64(load(ubs + i), load(o_ubs + i));
+    store(lbs + i, lb);
+    store(ubs + i, ub);
+    bottom = _mm256_or_si256(bottom, cmpgt_epu64(lb, ub));
+  }
+  is_bottom = _mm256_testz_si256(bottom, bottom) == 0;
+#endif
+  for (; i < n; i++) {
+    lbs[i] = std::max(lbs[i], o_lbs[i]);
+    ubs[i] = std::min(ubs[i], o_ubs[i]);
+    is_bottom |= lbs[i] > ubs[i];
+  }
+  return !is_bottom;
+}
+
+/// \brief Narrowing
+///
+/// \returns false if one of the intervals is empty
+inline bool narrowing(std::size_t n,
+                      uint64_t* lbs,
+                      uint64_t* ubs,
+                      const uint64_t* o_lbs,
+                      const uint64_t* o_ubs) {
+  std::size_t i = 0;
+  bool is_bottom = false;
+#if defined(__AVX2__)
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  __m256i bottom = zero;
+  for (; i + 4 <= n; i += 4) {
+    __m256i lb = load(lbs + i);
+    __m256i ub = load(ubs + i);
+    // lb = (lb == 0) ? o_lb : lb
+    lb = _mm256_blendv_epi8(lb, load(o_lbs + i), _mm256_cmpeq_epi64(lb, zero));
+    // ub = (ub == Ones) ? o_ub : ub
+    ub = _mm256_blendv_epi8(ub, load(o_ubs + i), _mm256_cmpeq_epi64(ub, ones));
+    store(lbs + i, lb);
+    store(ubs + i, ub);
+    bottom = _mm256_or_si256(bottom, cmpgt_epu64(lb, ub));
+  }
+  is_bottom = _mm256_testz_si256(bottom, bottom) == 0;
+#endif
+  for (; i < n; i++) {
+    lbs[i] = (lbs[i] == 0) ? o_lbs[i] : lbs[i];
+    ubs[i] = (ubs[i] == Ones) ? o_ubs[i] : ubs[i];
+    is_bottom |= lbs[i] > ubs[i];
+  }
+  return !is_bottom;
+}
+
+/// \brief Inclusion
+///
+/// \returns true if each interval is included in the other interval
+inline bool leq(std::size_t n,
+                const uint64_t* lbs,
+                const uint64_t* ubs,
+                const uint64_t* o_lbs,
+                const uint64_t* o_ubs) {
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 4 <= n; i += 4) {
+    __m256i greater =
+        _mm256_or_si256(cmpgt_epu64(load(o_lbs + i), load(lbs + i)),
+                        cmpgt_epu64(load(ubs + i), load(o_ubs + i)));
+    if (_mm256_testz_si256(greater, greater) == 0) {
+      return false;
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    if (o_lbs[i] > lbs[i] || ubs[i] > o_ubs[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Return the number of intervals that are top
+inline std::size_t count_top(std::size_t n,
+                             const uint64_t* lbs,
+                             const uint64_t* ubs) {
+  std::size_t i = 0;
+  std::size_t count = 0;
+#if defined(__AVX2__)
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  for (; i + 4 <= n; i += 4) {
+    __m256i top = _mm256_and_si256(_mm256_cmpeq_epi64(load(lbs + i), zero),
+                                   _mm256_cmpeq_epi64(load(ubs + i), ones));
+    auto mask = static_cast< unsigned >(
+        _mm256_movemask_pd(_mm256_castsi256_pd(top)));
+    count += static_cast< std::size_t >(__builtin_popcount(mask));
+  }
+#endif
+  for (; i < n; i++) {
+    count += static_cast< std::size_t >(lbs[i] == 0 && ubs[i] == Ones);
+  }
+  return count;
+}
+
+/// @}
+
+} // end namespace interval_table_impl
+
+/// \brief Flat table of machine integer intervals of at most 64 bits
+///
+/// The table is a structure of arrays sorted by variable index: the indexes
+/// and the variables on one side, the encoded lower and upper bounds on the
+/// other side (see `interval_table_impl::encode_lb()`). Operations on tables
+/// with the same variables run the kernels of `interval_table_impl` on whole
+/// arrays of bounds, otherwise the variables are aligned first.
+///
+/// Variables that are not in the table are top. Variables and bounds are
+/// shared between copies, and cloned on the first modification
+/// (copy-on-write).
+template < typename VariableRef >
+class IntervalTable {
+private:
+  using VariableTrait = machine_int::VariableTraits< VariableRef >;
+
+  /// \brief Variables of the table, sorted by index
+  struct Keys {
+    std::vector< Index > indexes;
+    std::vector< VariableRef > variables;
+  };
+
+  /// \brief Encoded bounds, in the order of the variables
+  struct Bounds {
+    std::vector< uint64_t > lbs;
+    std::vector< uint64_t > ubs;
+  };
+
+private:
+  std::shared_ptr< Keys > _keys; // null if empty
+  std::shared_ptr< Bounds > _bounds; // null if empty
+
+public:
+  /// \brief Create an empty table
+  IntervalTable() = default;
+
+  /// \brief Copy constructor
+  IntervalTable(const IntervalTable& other) noexcept
+      : _keys(other._keys), _bounds(other._bounds) {
+    if (this->_bounds != nullptr) {
+      CopyOnWriteStats::add_share();
+    }
+  }
+
+  /// \brief Move constructor
+  IntervalTable(IntervalTable&&) noexcept = default;
+
+  /// \brief Copy assignment operator
+  IntervalTable& operator=(const IntervalTable& other) noexcept {
+    if (this->_bounds != other._bounds && other._bounds != nullptr) {
+      CopyOnWriteStats::add_share();
+    }
+    this->_keys = other._keys;
+    this->_bounds = other._bounds;
+    return *this;
+  }
+
+  /// \brief Move assignment operator
+  IntervalTable& operator=(IntervalTable&&) noexcept = default;
+
+  /// \brief Destructor
+  ~IntervalTable() = default;
+
+private:
+  /// \brief Return true if the given part of the table is shared with another
+  /// table
+  ///
+  /// Other tables might be used by other threads. If the part is no longer
+  /// shared, the fence synchronizes with the release of the other references,
+  /// so that reads from other threads happen before the writes.
+  template < typename T >
+  static bool is_shared(const std::shared_ptr< T >& p) {
+    if (p.use_count() > 1) {
+      return true;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return false;
+  }
+
+  /// \brief Return a copy of `v` with room for `extra` more elements
+  template < typename T >
+  static std::vector< T > clone(const std::vector< T >& v, std::size_t extra) {
+    std::vector< T > r;
+    r.reserve(v.size() + extra);
+    r.insert(r.end(), v.begin(), v.end());
+    return r;
+  }
+
+  /// \brief Return the variables for a modification
+  ///
+  /// Clone the variables if they are shared with another table, with room for
+  /// `extra` more variables.
+  Keys& keys(std::size_t extra = 0) {
+    ikos_assert(this->_keys != nullptr);
+    if (is_shared(this->_keys)) {
+      this->_keys = std::make_shared< Keys >(
+          Keys{clone(this->_keys->indexes, extra),
+               clone(this->_keys->variables, extra)});
+    }
+    return *this->_keys;
+  }
+
+  /// \brief Return the bounds for a modification
+  ///
+  /// Clone the bounds if they are shared with another table, with room for
+  /// `extra` more variables.
+  Bounds& bounds(std::size_t extra = 0) {
+    ikos_assert(this->_bounds != nullptr);
+    if (is_shared(this->_bounds)) {
+      this->_bounds = std::make_shared< Bounds >(
+          Bounds{clone(this->_bounds->lbs, extra),
+                 clone(this->_bounds->ubs, extra)});
+      CopyOnWriteStats::add_clone();
+    }
+    return *this->_bounds;
+  }
+
+  /// \brief Return the position of the first variable with an index greater
+  /// or equal to `index`
+  std::size_t lower_bound(Index index) const {
+    const std::vector< Index >& indexes = this->_keys->indexes;
+    return static_cast< std::size_t >(
+        std::lower_bound(indexes.begin(), indexes.end(), index) -
+        indexes.begin());
+  }
+
+  /// \brief Return the position of the given variable, if it is in the table
+  boost::optional< std::size_t > find(VariableRef x) const {
+    if (this->_keys == nullptr) {
+      return boost::none;
+    }
+    Index index = IndexableTraits< VariableRef >::index(x);
+    std::size_t i = this->lower_bound(index);
+    if (i < this->size() && this->_keys->indexes[i] == index) {
+      return i;
+    } else {
+      return boost::none;
+    }
+  }
+
+  /// \brief Return true if both non-empty tables have the same variables
+  bool same_keys(const IntervalTable& other) const {
+    return this->_keys == other._keys ||
+           this->_keys->indexes == other._keys->indexes;
+  }
+
+  /// \brief Remove the variables that are top
+  void remove_top() {
+    std::size_t n = this->size();
+    if (interval_table_impl::count_top(n,
+                                       this->_bounds->lbs.data(),
+                                       this->_bounds->ubs.data()) == 0) {
+      return;
+    }
+
+    Keys& keys = this->keys();
+    Bounds& bounds = this->bounds();
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      if (bounds.lbs[i] != 0 || bounds.ubs[i] != interval_table_impl::Ones) {
+        keys.indexes[j] = keys.indexes[i];
+        keys.variables[j] = keys.variables[i];
+        bounds.lbs[j] = bounds.lbs[i];
+        bounds.ubs[j] = bounds.ubs[i];
+        j++;
+      }
+    }
+
+    if (j == 0) {
+      this->clear();
+    } else {
+      keys.indexes.resize(j);
+      keys.variables.resize(j, keys.variables[0]);
+      bounds.lbs.resize(j);
+      bounds.ubs.resize(j);
+    }
+  }
+
+  /// \brief Combine the intervals of the variables in both tables with
+  /// `kernel`, and remove the other variables
+  ///
+  /// Variables that become top are removed.
+  template < typename Kernel >
+  void intersect_with(const IntervalTable& other, const Kernel& kernel) {
+    if (this->_bounds == other._bounds) {
+      return;
+    } else if (this->empty() || other.empty()) {
+      this->clear();
+      return;
+    }
+
+    const Bounds& o = *other._bounds;
+    if (this->same_keys(other)) {
+      this->_keys = other._keys;
+      Bounds& bounds = this->bounds();
+      kernel(this->size(),
+             this->_keys->variables.data(),
+             bounds.lbs.data(),
+             bounds.ubs.data(),
+             o.lbs.data(),
+             o.ubs.data());
+    } else {
+      // Align the variables in both tables
+      const Keys& x = *this->_keys;
+      const Keys& y = *other._keys;
+      const Bounds& b = *this->_bounds;
+      auto keys = std::make_shared< Keys >();
+      auto bounds = std::make_shared< Bounds >();
+      std::vector< uint64_t > o_lbs;
+      std::vector< uint64_t > o_ubs;
+      for (std::size_t i = 0, j = 0; i < x.indexes.size() &&
+                                     j < y.indexes.size();) {
+        if (x.indexes[i] < y.indexes[j]) {
+          i++;
+        } else if (y.indexes[j] < x.indexes[i]) {
+          j++;
+        } else {
+          keys->indexes.push_back(x.indexes[i]);
+          keys->variables.push_back(x.variables[i]);
+          bounds->lbs.push_back(b.lbs[i]);
+          bounds->ubs.push_back(b.ubs[i]);
+          o_lbs.push_back(o.lbs[j]);
+          o_ubs.push_back(o.ubs[j]);
+          i++;
+          j++;
+        }
+      }
+
+      if (keys->indexes.empty()) {
+        this->clear();
+        return;
+      }
+
+      kernel(keys->indexes.size(),
+             keys->variables.data(),
+             bounds->lbs.data(),
+             bounds->ubs.data(),
+             o_lbs.data(),
+             o_ubs.data());
+      this->_keys = std::move(keys);
+      this->_bounds = std::move(bounds);
+    }
+
+    this->remove_top();
+  }
+
+  /// \brief Combine the intervals of the variables in both tables with
+  /// `kernel`, and add the variables of `other` that are not in this table
+  ///
+  /// \returns false if one of the intervals is empty
+  template < typename Kernel >
+  bool union_with(const IntervalTable& other, const Kernel& kernel) {
+    if (this->_bounds == other._bounds || other.empty()) {
+      return true;
+    } else if (this->empty()) {
+      this->operator=(other);
+      return true;
+    }
+
+    const Bounds& o = *other._bounds;
+    if (this->same_keys(other)) {
+      this->_keys = other._keys;
+      Bounds& bounds = this->bounds();
+      return kernel(this->size(),
+                    this->_keys->variables.data(),
+                    bounds.lbs.data(),
+                    bounds.ubs.data(),
+                    o.lbs.data(),
+                    o.ubs.data());
+    }
+
+    // Align the variables in both tables. A variable in only one table is
+    // combined with itself, which leaves it unchanged.
+    const Keys& x = *this->_keys;
+    const Keys& y = *other._keys;
+    const Bounds& b = *this->_bounds;
+    auto keys = std::make_shared< Keys >();
+    auto bounds = std::make_shared< Bounds >();
+    std::vector< uint64_t > o_lbs;
+    std::vector< uint64_t > o_ubs;
+    for (std::size_t i = 0, j = 0; i < x.indexes.size() ||
+                                   j < y.indexes.size();) {
+      if (j == y.indexes.size() ||
+          (i < x.indexes.size() && x.indexes[i] < y.indexes[j])) {
+        keys->indexes.push_back(x.indexes[i]);
+        keys->variables.push_back(x.variables[i]);
+        bounds->lbs.push_back(b.lbs[i]);
+        bounds->ubs.push_back(b.ubs[i]);
+        o_lbs.push_back(b.lbs[i]);
+        o_ubs.push_back(b.ubs[i]);
+        i++;
+      } else if (i == x.indexes.size() || y.indexes[j] < x.indexes[i]) {
+        keys->indexes.push_back(y.indexes[j]);
+        keys->variables.push_back(y.variables[j]);
+        bounds->lbs.push_back(o.lbs[j]);
+        bounds->ubs.push_back(o.ubs[j]);
+        o_lbs.push_back(o.lbs[j]);
+        o_ubs.push_back(o.ubs[j]);
+        j++;
+      } else {
+        keys->indexes.push_back(x.indexes[i]);
+        keys->variables.push_back(x.variables[i]);
+        bounds->lbs.push_back(b.lbs[i]);
+        bounds->ubs.push_back(b.ubs[i]);
+        o_lbs.push_back(o.lbs[j]);
+        o_ubs.push_back(o.ubs[j]);
+        i++;
+        j++;
+      }
+    }
+
+    bool r = kernel(keys->indexes.size(),
+                    keys->variables.data(),
+                    bounds->lbs.data(),
+                    bounds->ubs.data(),
+                    o_lbs.data(),
+                    o_ubs.data());
+    this->_keys = std::move(keys);
+    this->_bounds = std::move(bounds);
+    return r;
+  }
+
+public:
+  /// \brief Return true if the table is empty
+  bool empty() const { return this->_keys == nullptr; }
+
+  /// \brief Return the number of variables in the table
+  std::size_t size() const {
+    return this->_keys == nullptr ? 0 : this->_keys->indexes.size();
+  }
+
+  /// \brief Remove all the variables
+  void clear() {
+    this->_keys.reset();
+    this->_bounds.reset();
+  }
+
+  /// \brief Return the i-th variable, in the order of the indexes
+  VariableRef variable(std::size_t i) const {
+    ikos_assert(i < this->size());
+    return this->_keys->variables[i];
+  }
+
+  /// \brief Return the interval of the i-th variable
+  Interval interval(std::size_t i) const {
+    ikos_assert(i < this->size());
+    VariableRef x = this->_keys->variables[i];
+    return interval_table_impl::decode(this->_bounds->lbs[i],
+                                       this->_bounds->ubs[i],
+                                       VariableTrait::bit_width(x),
+                                       VariableTrait::sign(x));
+  }
+
+  /// \brief Return the interval of the given variable, or boost::none if it
+  /// is top
+  boost::optional< Interval > get(VariableRef x) const {
+    boost::optional< std::size_t > i = this->find(x);
+    if (i) {
+      return this->interval(*i);
+    } else {
+      return boost::none;
+    }
+  }
+
+  /// \brief Set the interval of the given variable
+  ///
+  /// The interval must be neither bottom nor top.
+  void set(VariableRef x, const Interval& value) {
+    ikos_assert(value.bit_width() <= 64);
+    ikos_assert(!value.is_bottom() && !value.is_top());
+
+    uint64_t lb = interval_table_impl::encode_lb(value.lb());
+    uint64_t ub = interval_table_impl::encode_ub(value.ub());
+    Index index = IndexableTraits< VariableRef >::index(x);
+
+    if (this->_keys == nullptr) {
+      this->_keys = std::make_shared< Keys >(Keys{{index}, {x}});
+      this->_bounds = std::make_shared< Bounds >(Bounds{{lb}, {ub}});
+      return;
+    }
+
+    std::size_t i = this->lower_bound(index);
+    auto pos = static_cast< std::ptrdiff_t >(i);
+    if (i < this->size() && this->_keys->indexes[i] == index) {
+      Bounds& bounds = this->bounds();
+      bounds.lbs[i] = lb;
+      bounds.ubs[i] = ub;
+    } else {
+      Keys& keys = this->keys(1);
+      keys.indexes.insert(keys.indexes.begin() + pos, index);
+      keys.variables.insert(keys.variables.begin() + pos, x);
+      Bounds& bounds = this->bounds(1);
+      bounds.lbs.insert(bounds.lbs.begin() + pos, lb);
+      bounds.ubs.insert(bounds.ubs.begin() + pos, ub);
+    }
+  }
+
+  /// \brief Remove the given variable
+  void erase(VariableRef x) {
+    boost::optional< std::size_t > i = this->find(x);
+    if (!i) {
+      return;
+    } else if (this->size() == 1) {
+      this->clear();
+      return;
+    }
+
+    auto pos = static_cast< std::ptrdiff_t >(*i);
+    Keys& keys = this->keys();
+    keys.indexes.erase(keys.indexes.begin() + pos);
+    keys.variables.erase(keys.variables.begin() + pos);
+    Bounds& bounds = this->bounds();
+    bounds.lbs.erase(bounds.lbs.begin() + pos);
+    bounds.ubs.erase(bounds.ubs.begin() + pos);
+  }
+
+  /// \brief Inclusion test
+  bool leq(const IntervalTable& other) const {
+    if (this->_bounds == other._bounds || other.empty()) {
+      return true;
+    } else if (this->empty() || this->size() < other.size()) {
+      return false;
+    }
+
+    const Bounds& b = *this->_bounds;
+    const Bounds& o = *other._bounds;
+    if (this->same_keys(other)) {
+      return interval_table_impl::leq(this->size(),
+                                      b.lbs.data(),
+                                      b.ubs.data(),
+                                      o.lbs.data(),
+                                      o.ubs.data());
+    }
+
+    // Each variable of `other` must be in this table
+    const std::vector< Index >& x = this->_keys->indexes;
+    const std::vector< Index >& y = other._keys->indexes;
+    std::size_t i = 0;
+    for (std::size_t j = 0; j < y.size(); j++) {
+      while (i < x.size() && x[i] < y[j]) {
+        i++;
+      }
+      if (i == x.size() || x[i] != y[j] ||
+          !interval_table_impl::leq(1,
+                                    &b.lbs[i],
+                                    &b.ubs[i],
+                                    &o.lbs[j],
+                                    &o.ubs[j])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// \brief Equality test
+  bool equals(const IntervalTable& other) const {
+    if (this->_bounds == other._bounds) {
+      return true;
+    } else if (this->empty() || other.empty()) {
+      return false;
+    } else {
+      return this->same_keys(other) &&
+             this->_bounds->lbs == other._bounds->lbs &&
+             this->_bounds->ubs == other._bounds->ubs;
+    }
+  }
+
+  /// \brief Join
+  void join_with(const IntervalTable& other) {
+    this->intersect_with(other,
+                         [](std::size_t n,
+                            const VariableRef*,
+                            uint64_t* lbs,
+                            uint64_t* ubs,
+                            const uint64_t* o_lbs,
+                            const uint64_t* o_ubs) {
+                           interval_table_impl::join(n, lbs, ubs, o_lbs, o_ubs);
+                         });
+  }
+
+  /// \brief Widening
+  void widen_with(const IntervalTable& other) {
+    this->intersect_with(other,
+                         [](std::size_t n,
+                            const VariableRef*,
+                            uint64_t* lbs,
+                            uint64_t* ubs,
+                            const uint64_t* o_lbs,
+                            const uint64_t* o_ubs) {
+                           interval_table_impl::widening(n,
+                                                         lbs,
+                                                         ubs,
+                                                         o_lbs,
+                                                         o_ubs);
+                         });
+  }
+
+  /// \brief Widening with a threshold
+  void widen_threshold_with(const IntervalTable& other,
+                            const MachineInt& threshold) {
+    this->intersect_with(other,
+                         [&threshold](std::size_t n,
+                                      const VariableRef* variables,
+                                      uint64_t* lbs,
+                                      uint64_t* ubs,
+                                      const uint64_t* o_lbs,
+                                      const uint64_t* o_ubs) {
+                           for (std::size_t i = 0; i < n; i++) {
+                             MachineInt th = threshold.cast(
+                                 VariableTrait::bit_width(variables[i]),
+                                 VariableTrait::sign(variables[i]));
+                             uint64_t th_lb =
+                                 interval_table_impl::encode_lb(th);
+                             uint64_t th_ub =
+                                 interval_table_impl::encode_ub(th);
+                             if (o_lbs[i] < lbs[i]) {
+                               lbs[i] = (th_lb <= o_lbs[i]) ? th_lb : 0;
+                             }
+                             if (o_ubs[i] > ubs[i]) {
+                               ubs[i] = (th_ub >= o_ubs[i])
+                                            ? th_ub
+                                            : interval_table_impl::Ones;
+                             }
+                           }
+                         });
+  }
+
+  /// \brief Meet
+  ///
+  /// \returns false if the result is bottom
+  bool meet_with(const IntervalTable& other) {
+    return this->union_with(other,
+                            [](std::size_t n,
+                               const VariableRef*,
+                               uint64_t* lbs,
+                               uint64_t* ubs,
+                               const uint64_t* o_lbs,
+                               const uint64_t* o_ubs) {
+                              return interval_table_impl::meet(n,
+                                                               lbs,
+                                                               ubs,
+                                                               o_lbs,
+                                                               o_ubs);
+                            });
+  }
+
+  /// \brief Narrowing
+  ///
+  /// \returns false if the result is bottom
+  bool narrow_with(const IntervalTable& other) {
+    return this->union_with(other,
+                            [](std::size_t n,
+                               const VariableRef*,
+                               uint64_t* lbs,
+                               uint64_t* ubs,
+                               const uint64_t* o_lbs,
+                               const uint64_t* o_ubs) {
+                              return interval_table_impl::narrowing(n,
+                                                                    lbs,
+                                                                    ubs,
+                                                                    o_lbs,
+                                                                    o_ubs);
+                            });
+  }
+
+  /// \brief Narrowing with a threshold
+  ///
+  /// \returns false if the result is bottom
+  bool narrow_threshold_with(const IntervalTable& other,
+                             const MachineInt& threshold) {
+    return this->union_with(other,
+                            [&threshold](std::size_t n,
+                                         const VariableRef* variables,
+                                         uint64_t* lbs,
+                                         uint64_t* ubs,
+                                         const uint64_t* o_lbs,
+                                         const uint64_t* o_ubs) {
+                              bool is_bottom = false;
+                              for (std::size_t i = 0; i < n; i++) {
+                                MachineInt th = threshold.cast(
+                                    VariableTrait::bit_width(variables[i]),
+                                    VariableTrait::sign(variables[i]));
+                                if (lbs[i] == 0 ||
+                                    lbs[i] ==
+                                        interval_table_impl::encode_lb(th)) {
+                                  lbs[i] = o_lbs[i];
+                                }
+                                if (ubs[i] == interval_table_impl::Ones ||
+                                    ubs[i] ==
+                                        interval_table_impl::encode_ub(th)) {
+                                  ubs[i] = o_ubs[i];
+                                }
+                                is_bottom |= lbs[i] > ubs[i];
+                              }
+                              return !is_bottom;
+                            });
+  }
+
+}; // end class IntervalTable
+
+} // end namespace machine_int
+} // end namespace core
+} // end namespace ikos
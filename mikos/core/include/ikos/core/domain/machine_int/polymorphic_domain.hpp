@@ -49,6 +49,7 @@
 
 #include <memory>
 
+#include <ikos/core/domain/copy_on_write.hpp>
 #include <ikos/core/domain/machine_int/abstract_domain.hpp>
 #include <ikos/core/support/assert.hpp>
 #include <ikos/core/support/mpl.hpp>
@@ -508,26 +509,33 @@ private:
 
 private:
   /// \brief Pointer on the polymorphic base class
-  std::unique_ptr< PolymorphicBase > _ptr;
+  ///
+  /// The abstract value is shared between copies, and cloned on the first
+  /// modification (copy-on-write).
+  std::shared_ptr< PolymorphicBase > _ptr;
 
 public:
   /// \brief Create a polymorphic domain with the given abstract value
   template < typename RuntimeDomain >
   explicit PolymorphicDomain(RuntimeDomain inv)
-      : _ptr(std::make_unique<
+      : _ptr(std::make_shared<
              PolymorphicDerived< remove_cvref_t< RuntimeDomain > > >(
             std::move(inv))) {}
 
   /// \brief Copy constructor
-  PolymorphicDomain(const PolymorphicDomain& other)
-      : _ptr(other._ptr->clone()) {}
+  PolymorphicDomain(const PolymorphicDomain& other) : _ptr(other._ptr) {
+    CopyOnWriteStats::add_share();
+  }
 
   /// \brief Move constructor
   PolymorphicDomain(PolymorphicDomain&&) noexcept = default;
 
   /// \brief Copy assignment operator
   PolymorphicDomain& operator=(const PolymorphicDomain& other) {
-    this->_ptr = other._ptr->clone();
+    if (this->_ptr != other._ptr) {
+      this->_ptr = other._ptr;
+      CopyOnWriteStats::add_share();
+    }
     return *this;
   }
 
@@ -537,6 +545,20 @@ public:
   /// \brief Destructor
   ~PolymorphicDomain() override = default;
 
+private:
+  /// \brief Return the abstract value for a modification
+  ///
+  /// Clone the abstract value if it is shared with another copy.
+  PolymorphicBase* mutable_ptr() {
+    if (this->_ptr.use_count() > 1) {
+      this->_ptr = this->_ptr->clone();
+      CopyOnWriteStats::add_clone();
+    }
+    return this->_ptr.get();
+  }
+
+public:
+
   /// \name Core abstract domain methods
   /// @{
 
@@ -544,50 +566,68 @@ public:
 
   bool is_top() const override { return this->_ptr->is_top(); }
 
-  void set_to_bottom() override { this->_ptr->set_to_bottom(); }
+  void set_to_bottom() override { this->mutable_ptr()->set_to_bottom(); }
 
-  void set_to_top() override { this->_ptr->set_to_top(); }
+  void set_to_top() override { this->mutable_ptr()->set_to_top(); }
 
   bool leq(const PolymorphicDomain& other) const override {
+    if (this->_ptr == other._ptr) {
+      return true;
+    }
     return this->_ptr->leq(*other._ptr);
   }
 
   bool equals(const PolymorphicDomain& other) const override {
+    if (this->_ptr == other._ptr) {
+      return true;
+    }
     return this->_ptr->equals(*other._ptr);
   }
 
   void join_with(const PolymorphicDomain& other) override {
-    this->_ptr->join_with(*other._ptr);
+    if (this->_ptr == other._ptr) {
+      return;
+    }
+    this->mutable_ptr()->join_with(*other._ptr);
   }
 
   void join_loop_with(const PolymorphicDomain& other) override {
-    this->_ptr->join_loop_with(*other._ptr);
+    if (this->_ptr == other._ptr) {
+      return;
+    }
+    this->mutable_ptr()->join_loop_with(*other._ptr);
   }
 
   void join_iter_with(const PolymorphicDomain& other) override {
-    this->_ptr->join_iter_with(*other._ptr);
+    if (this->_ptr == other._ptr) {
+      return;
+    }
+    this->mutable_ptr()->join_iter_with(*other._ptr);
   }
 
   void widen_with(const PolymorphicDomain& other) override {
-    this->_ptr->widen_with(*other._ptr);
+    this->mutable_ptr()->widen_with(*other._ptr);
   }
 
   void widen_threshold_with(const PolymorphicDomain& other,
                             const MachineInt& threshold) override {
-    this->_ptr->widen_threshold_with(*other._ptr, threshold);
+    this->mutable_ptr()->widen_threshold_with(*other._ptr, threshold);
   }
 
   void meet_with(const PolymorphicDomain& other) override {
-    this->_ptr->meet_with(*other._ptr);
+    if (this->_ptr == other._ptr) {
+      return;
+    }
+    this->mutable_ptr()->meet_with(*other._ptr);
   }
 
   void narrow_with(const PolymorphicDomain& other) override {
-    this->_ptr->narrow_with(*other._ptr);
+    this->mutable_ptr()->narrow_with(*other._ptr);
   }
 
   void narrow_threshold_with(const PolymorphicDomain& other,
                              const MachineInt& threshold) override {
-    this->_ptr->narrow_threshold_with(*other._ptr, threshold);
+    this->mutable_ptr()->narrow_threshold_with(*other._ptr, threshold);
   }
 
   /// @}
@@ -595,79 +635,79 @@ public:
   /// @{
 
   void assign(VariableRef x, const MachineInt& n) override {
-    this->_ptr->assign(x, n);
+    this->mutable_ptr()->assign(x, n);
   }
 
   void assign(VariableRef x, VariableRef y) override {
-    this->_ptr->assign(x, y);
+    this->mutable_ptr()->assign(x, y);
   }
 
   void assign(VariableRef x, const LinearExpressionT& e) override {
-    this->_ptr->assign(x, e);
+    this->mutable_ptr()->assign(x, e);
   }
 
   void apply(UnaryOperator op, VariableRef x, VariableRef y) override {
-    this->_ptr->apply(op, x, y);
+    this->mutable_ptr()->apply(op, x, y);
   }
 
   void apply(BinaryOperator op,
              VariableRef x,
              VariableRef y,
              VariableRef z) override {
-    this->_ptr->apply(op, x, y, z);
+    this->mutable_ptr()->apply(op, x, y, z);
   }
 
   void apply(BinaryOperator op,
              VariableRef x,
              VariableRef y,
              const MachineInt& z) override {
-    this->_ptr->apply(op, x, y, z);
+    this->mutable_ptr()->apply(op, x, y, z);
   }
 
   void apply(BinaryOperator op,
              VariableRef x,
              const MachineInt& y,
              VariableRef z) override {
-    this->_ptr->apply(op, x, y, z);
+    this->mutable_ptr()->apply(op, x, y, z);
   }
 
   void add(Predicate pred, VariableRef x, VariableRef y) override {
-    this->_ptr->add(pred, x, y);
+    this->mutable_ptr()->add(pred, x, y);
   }
 
   void add(Predicate pred, VariableRef x, const MachineInt& y) override {
-    this->_ptr->add(pred, x, y);
+    this->mutable_ptr()->add(pred, x, y);
   }
 
   void add(Predicate pred, const MachineInt& x, VariableRef y) override {
-    this->_ptr->add(pred, x, y);
+    this->mutable_ptr()->add(pred, x, y);
   }
 
   void set(VariableRef x, const Interval& value) override {
-    this->_ptr->set(x, value);
+    this->mutable_ptr()->set(x, value);
   }
 
   void set(VariableRef x, const Congruence& value) override {
-    this->_ptr->set(x, value);
+    this->mutable_ptr()->set(x, value);
   }
 
   void set(VariableRef x, const IntervalCongruence& value) override {
-    this->_ptr->set(x, value);
+    this->mutable_ptr()->set(x, value);
   }
 
   void refine(VariableRef x, const Interval& value) override {
-    this->_ptr->refine(x, value);
+    this->mutable_ptr()->refine(x, value);
   }
 
   void refine(VariableRef x, const Congruence& value) override {
-    this->_ptr->refine(x, value);
+    this->mutable_ptr()->refine(x, value);
   }
 
   void refine(VariableRef x, const IntervalCongruence& value) override {
-    this->_ptr->refine(x, value);
+    this->mutable_ptr()->refine(x, value);
   }
 
-  void forget(VariableRef x) override { this->_ptr->forget(x); }
+  void forget(VariableRef x) override { this->mutable_ptr()->forget(x); }
 
   void normalize() const override { this->_ptr->normalize(); }
 
@@ -700,19 +740,25 @@ public:
   /// \name Non-negative loop counter abstract domain methods
   /// @{
 
-  void counter_mark(VariableRef x) override { this->_ptr->counter_mark(x); }
+  void counter_mark(VariableRef x) override {
+    this->mutable_ptr()->counter_mark(x);
+  }
 
-  void counter_unmark(VariableRef x) override { this->_ptr->counter_unmark(x); }
+  void counter_unmark(VariableRef x) override {
+    this->mutable_ptr()->counter_unmark(x);
+  }
 
   void counter_init(VariableRef x, const MachineInt& c) override {
-    this->_ptr->counter_init(x, c);
+    this->mutable_ptr()->counter_init(x, c);
   }
 
   void counter_incr(VariableRef x, const MachineInt& k) override {
-    this->_ptr->counter_incr(x, k);
+    this->mutable_ptr()->counter_incr(x, k);
   }
 
-  void counter_forget(VariableRef x) override { this->_ptr->counter_forget(x); }
+  void counter_forget(VariableRef x) override {
+    this->mutable_ptr()->counter_forget(x);
+  }
 
   /// @}
 
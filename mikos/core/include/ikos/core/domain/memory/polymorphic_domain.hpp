@@ -49,6 +49,7 @@
 
 #include <memory>
 
+#include <ikos/core/domain/copy_on_write.hpp>
 #include <ikos/core/domain/memory/abstract_domain.hpp>
 #include <ikos/core/support/assert.hpp>
 #include <ikos/core/support/mpl.hpp>
@@ -1333,26 +1334,33 @@ private:
 
 private:
   /// \brief Pointer on the polymorphic base class
-  std::unique_ptr< PolymorphicBase > _ptr;
+  ///
+  /// The abstract value is shared between copies, and cloned on the first
+  /// modification (copy-on-write).
+  std::shared_ptr< PolymorphicBase > _ptr;
 
 public:
   /// \brief Create a polymorphic domain with the given abstract value
   template < typename RuntimeDomain >
   explicit PolymorphicDomain(RuntimeDomain inv)
-      : _ptr(std::make_unique<
+      : _ptr(std::make_shared<
              PolymorphicDerived< remove_cvref_t< RuntimeDomain > > >(
             std::move(inv))) {}
 
   /// \brief Copy constructor
-  PolymorphicDomain(const PolymorphicDomain& other)
-      : _ptr(other._ptr->clone()) {}
+  PolymorphicDomain(const PolymorphicDomain& other) : _ptr(other._ptr) {
+    CopyOnWriteStats::add_share();
+  }
 
   /// \brief Move constructor
   PolymorphicDomain(PolymorphicDomain&&) noexcept = default;
 
   /// \brief Copy assignment operator
   PolymorphicDomain& operator=(const PolymorphicDomain& other) {
-    this->_ptr = other._ptr->clone();
+    if (this->_ptr != other._ptr) {
+      this->_ptr = other._ptr;
+      CopyOnWriteStats::add_share();
+    }
     return *this;
   }
 
@@ -1362,6 +1370,20 @@ public:
   /// \brief Destructor
   ~PolymorphicDomain() override = default;
 
+private:
+  /// \brief Return the abstract value for a modification
+  ///
+  /// Clone the abstract value if it is shared with another copy.
+  PolymorphicBase* mutable_ptr() {
+    if (this->_ptr.use_count() > 1) {
+      this->_ptr = this->_ptr->clone();
+      CopyOnWriteStats::add_clone();
+    }
+    return this->_ptr.get();
+  }
+
+public:
+
   /// \name Core abstract domain methods
   /// @{
 
@@ -1369,50 +1391,68 @@ public:
 
   bool is_top() const override { return this->_ptr->is_top(); }
 
-  void set_to_bottom() override { this->_ptr->set_to_bottom(); }
+  void set_to_bottom() override { this->mutable_ptr()->set_to_bottom(); }
 
-  void set_to_top() override { this->_ptr->set_to_top(); }
+  void set_to_top() override { this->mutable_ptr()->set_to_top(); }
 
   bool leq(const PolymorphicDomain& other) const override {
+    if (this->_ptr == other._ptr) {
+      return true;
+    }
     return this->_ptr->leq(*other._ptr);
   }
 
   bool equals(const PolymorphicDomain& other) const override {
+    if (this->_ptr == other._ptr) {
+      return true;
+    }
     return this->_ptr->equals(*other._ptr);
   }
 
   void join_with(const PolymorphicDomain& other) override {
-    this->_ptr->join_with(*other._ptr);
+    if (this->_ptr == other._ptr) {
+      return;
+    }
+    this->mutable_ptr()->join_with(*other._ptr);
   }
 
   void join_loop_with(const PolymorphicDomain& other) override {
-    this->_ptr->join_loop_with(*other._ptr);
+    if (this->_ptr == other._ptr) {
+      return;
+    }
+    this->mutable_ptr()->join_loop_with(*other._ptr);
   }
 
   void join_iter_with(const PolymorphicDomain& other) override {
-    this->_ptr->join_iter_with(*other._ptr);
+    if (this->_ptr == other._ptr) {
+      return;
+    }
+    this->mutable_ptr()->join_iter_with(*other._ptr);
   }
 
   void widen_with(const PolymorphicDomain& other) override {
-    this->_ptr->widen_with(*other._ptr);
+    this->mutable_ptr()->widen_with(*other._ptr);
   }
 
   void widen_threshold_with(const PolymorphicDomain& other,
                             const MachineInt& threshold) override {
-    this->_ptr->widen_threshold_with(*other._ptr, threshold);
+    this->mutable_ptr()->widen_threshold_with(*other._ptr, threshold);
   }
 
   void meet_with(const PolymorphicDomain& other) override {
-    this->_ptr->meet_with(*other._ptr);
+    if (this->_ptr == other._ptr) {
+      return;
+    }
+    this->mutable_ptr()->meet_with(*other._ptr);
   }
 
   void narrow_with(const PolymorphicDomain& other) override {
-    this->_ptr->narrow_with(*other._ptr);
+    this->mutable_ptr()->narrow_with(*other._ptr);
   }
 
   void narrow_threshold_with(const PolymorphicDomain& other,
                              const MachineInt& threshold) override {
-    this->_ptr->narrow_threshold_with(*other._ptr, threshold);
+    this->mutable_ptr()->narrow_threshold_with(*other._ptr, threshold);
   }
 
   /// @}
@@ -1420,7 +1460,7 @@ public:
   /// @{
 
   void uninit_assert_initialized(VariableRef x) override {
-    this->_ptr->uninit_assert_initialized(x);
+    this->mutable_ptr()->uninit_assert_initialized(x);
   }
 
   bool uninit_is_initialized(VariableRef x) const override {
@@ -1432,7 +1472,7 @@ public:
   }
 
   void uninit_refine(VariableRef x, Uninitialized value) override {
-    this->_ptr->uninit_refine(x, value);
+    this->mutable_ptr()->uninit_refine(x, value);
   }
 
   Uninitialized uninit_to_uninitialized(VariableRef x) const override {
@@ -1444,87 +1484,89 @@ public:
   /// @{
 
   void int_assign(VariableRef x, const MachineInt& n) override {
-    this->_ptr->int_assign(x, n);
+    this->mutable_ptr()->int_assign(x, n);
   }
 
   void int_assign_undef(VariableRef x) override {
-    this->_ptr->int_assign_undef(x);
+    this->mutable_ptr()->int_assign_undef(x);
   }
 
   void int_assign_nondet(VariableRef x) override {
-    this->_ptr->int_assign_nondet(x);
+    this->mutable_ptr()->int_assign_nondet(x);
   }
 
   void int_assign(VariableRef x, VariableRef y) override {
-    this->_ptr->int_assign(x, y);
+    this->mutable_ptr()->int_assign(x, y);
   }
 
   void int_assign(VariableRef x, const IntLinearExpression& e) override {
-    this->_ptr->int_assign(x, e);
+    this->mutable_ptr()->int_assign(x, e);
   }
 
   void int_apply(IntUnaryOperator op, VariableRef x, VariableRef y) override {
-    this->_ptr->int_apply(op, x, y);
+    this->mutable_ptr()->int_apply(op, x, y);
   }
 
   void int_apply(IntBinaryOperator op,
                  VariableRef x,
                  VariableRef y,
                  VariableRef z) override {
-    this->_ptr->int_apply(op, x, y, z);
+    this->mutable_ptr()->int_apply(op, x, y, z);
   }
 
   void int_apply(IntBinaryOperator op,
                  VariableRef x,
                  VariableRef y,
                  const MachineInt& z) override {
-    this->_ptr->int_apply(op, x, y, z);
+    this->mutable_ptr()->int_apply(op, x, y, z);
   }
 
   void int_apply(IntBinaryOperator op,
                  VariableRef x,
                  const MachineInt& y,
                  VariableRef z) override {
-    this->_ptr->int_apply(op, x, y, z);
+    this->mutable_ptr()->int_apply(op, x, y, z);
   }
 
   void int_add(IntPredicate pred, VariableRef x, VariableRef y) override {
-    this->_ptr->int_add(pred, x, y);
+    this->mutable_ptr()->int_add(pred, x, y);
   }
 
   void int_add(IntPredicate pred, VariableRef x, const MachineInt& y) override {
-    this->_ptr->int_add(pred, x, y);
+    this->mutable_ptr()->int_add(pred, x, y);
   }
 
   void int_add(IntPredicate pred, const MachineInt& x, VariableRef y) override {
-    this->_ptr->int_add(pred, x, y);
+    this->mutable_ptr()->int_add(pred, x, y);
   }
 
   void int_set(VariableRef x, const IntInterval& value) override {
-    this->_ptr->int_set(x, value);
+    this->mutable_ptr()->int_set(x, value);
   }
 
   void int_set(VariableRef x, const IntCongruence& value) override {
-    this->_ptr->int_set(x, value);
+    this->mutable_ptr()->int_set(x, value);
   }
 
   void int_set(VariableRef x, const IntIntervalCongruence& value) override {
-    this->_ptr->int_set(x, value);
+    this->mutable_ptr()->int_set(x, value);
   }
 
   void int_refine(VariableRef x, const IntInterval& value) override {
-    this->_ptr->int_refine(x, value);
+    this->mutable_ptr()->int_refine(x, value);
   }
 
   void int_refine(VariableRef x, const IntCongruence& value) override {
-    this->_ptr->int_refine(x, value);
+    this->mutable_ptr()->int_refine(x, value);
   }
 
   void int_refine(VariableRef x, const IntIntervalCongruence& value) override {
-    this->_ptr->int_refine(x, value);
+    this->mutable_ptr()->int_refine(x, value);
   }
 
-  void int_forget(VariableRef x) override { this->_ptr->int_forget(x); }
+  void int_forget(VariableRef x) override {
+    this->mutable_ptr()->int_forget(x);
+  }
 
   IntInterval int_to_interval(VariableRef x) const override {
     return this->_ptr->int_to_interval(x);
@@ -1556,48 +1598,56 @@ public:
   /// \name Non-negative loop counter abstract domain methods
   /// @{
 
-  void counter_mark(VariableRef x) override { this->_ptr->counter_mark(x); }
+  void counter_mark(VariableRef x) override {
+    this->mutable_ptr()->counter_mark(x);
+  }
 
-  void counter_unmark(VariableRef x) override { this->_ptr->counter_unmark(x); }
+  void counter_unmark(VariableRef x) override {
+    this->mutable_ptr()->counter_unmark(x);
+  }
 
   void counter_init(VariableRef x, const MachineInt& c) override {
-    this->_ptr->counter_init(x, c);
+    this->mutable_ptr()->counter_init(x, c);
   }
 
   void counter_incr(VariableRef x, const MachineInt& k) override {
-    this->_ptr->counter_incr(x, k);
+    this->mutable_ptr()->counter_incr(x, k);
   }
 
-  void counter_forget(VariableRef x) override { this->_ptr->counter_forget(x); }
+  void counter_forget(VariableRef x) override {
+    this->mutable_ptr()->counter_forget(x);
+  }
 
   /// @}
   /// \name Floating point abstract domain methods
   /// @{
 
   void float_assign_undef(VariableRef x) override {
-    this->_ptr->float_assign_undef(x);
+    this->mutable_ptr()->float_assign_undef(x);
   }
 
   void float_assign_nondet(VariableRef x) override {
-    this->_ptr->float_assign_nondet(x);
+    this->mutable_ptr()->float_assign_nondet(x);
   }
 
   void float_assign(VariableRef x, VariableRef y) override {
-    this->_ptr->float_assign(x, y);
+    this->mutable_ptr()->float_assign(x, y);
   }
 
-  void float_forget(VariableRef x) override { this->_ptr->float_forget(x); }
+  void float_forget(VariableRef x) override {
+    this->mutable_ptr()->float_forget(x);
+  }
 
   /// @}
   /// \name Nullity abstract domain methods
   /// @{
 
   void nullity_assert_null(VariableRef p) override {
-    this->_ptr->nullity_assert_null(p);
+    this->mutable_ptr()->nullity_assert_null(p);
   }
 
   void nullity_assert_non_null(VariableRef p) override {
-    this->_ptr->nullity_assert_non_null(p);
+    this->mutable_ptr()->nullity_assert_non_null(p);
   }
 
   bool nullity_is_null(VariableRef p) const override {
@@ -1609,11 +1659,11 @@ public:
   }
 
   void nullity_set(VariableRef p, Nullity value) override {
-    this->_ptr->nullity_set(p, value);
+    this->mutable_ptr()->nullity_set(p, value);
   }
 
   void nullity_refine(VariableRef p, Nullity value) override {
-    this->_ptr->nullity_refine(p, value);
+    this->mutable_ptr()->nullity_refine(p, value);
   }
 
   Nullity nullity_to_nullity(VariableRef p) const override {
@@ -1627,67 +1677,67 @@ public:
   void pointer_assign(VariableRef p,
                       MemoryLocationRef addr,
                       Nullity nullity) override {
-    this->_ptr->pointer_assign(p, addr, nullity);
+    this->mutable_ptr()->pointer_assign(p, addr, nullity);
   }
 
   void pointer_assign_null(VariableRef p) override {
-    this->_ptr->pointer_assign_null(p);
+    this->mutable_ptr()->pointer_assign_null(p);
   }
 
   void pointer_assign_undef(VariableRef p) override {
-    this->_ptr->pointer_assign_undef(p);
+    this->mutable_ptr()->pointer_assign_undef(p);
   }
 
   void pointer_assign_nondet(VariableRef p) override {
-    this->_ptr->pointer_assign_nondet(p);
+    this->mutable_ptr()->pointer_assign_nondet(p);
   }
 
   void pointer_assign(VariableRef p, VariableRef q) override {
-    this->_ptr->pointer_assign(p, q);
+    this->mutable_ptr()->pointer_assign(p, q);
   }
 
   void pointer_assign(VariableRef p, VariableRef q, VariableRef o) override {
-    this->_ptr->pointer_assign(p, q, o);
+    this->mutable_ptr()->pointer_assign(p, q, o);
   }
 
   void pointer_assign(VariableRef p,
                       VariableRef q,
                       const MachineInt& o) override {
-    this->_ptr->pointer_assign(p, q, o);
+    this->mutable_ptr()->pointer_assign(p, q, o);
   }
 
   void pointer_assign(VariableRef p,
                       VariableRef q,
                       const IntLinearExpression& o) override {
-    this->_ptr->pointer_assign(p, q, o);
+    this->mutable_ptr()->pointer_assign(p, q, o);
   }
 
   void pointer_add(PointerPredicate pred,
                    VariableRef p,
                    VariableRef q) override {
-    this->_ptr->pointer_add(pred, p, q);
+    this->mutable_ptr()->pointer_add(pred, p, q);
   }
 
   void pointer_refine(VariableRef p, const PointsToSetT& addrs) override {
-    this->_ptr->pointer_refine(p, addrs);
+    this->mutable_ptr()->pointer_refine(p, addrs);
   }
 
   void pointer_refine(VariableRef p,
                       const PointsToSetT& addrs,
                       const IntInterval& offset) override {
-    this->_ptr->pointer_refine(p, addrs, offset);
+    this->mutable_ptr()->pointer_refine(p, addrs, offset);
   }
 
   void pointer_refine(VariableRef p, const PointerAbsValueT& value) override {
-    this->_ptr->pointer_refine(p, value);
+    this->mutable_ptr()->pointer_refine(p, value);
   }
 
   void pointer_refine(VariableRef p, const PointerSetT& set) override {
-    this->_ptr->pointer_refine(p, set);
+    this->mutable_ptr()->pointer_refine(p, set);
   }
 
   void pointer_offset_to_int(VariableRef x, VariableRef p) override {
-    this->_ptr->pointer_offset_to_int(x, p);
+    this->mutable_ptr()->pointer_offset_to_int(x, p);
   }
 
   IntInterval pointer_offset_to_interval(VariableRef p) const override {
@@ -1712,63 +1762,65 @@ public:
   }
 
   void pointer_forget_offset(VariableRef p) override {
-    this->_ptr->pointer_forget_offset(p);
+    this->mutable_ptr()->pointer_forget_offset(p);
   }
 
-  void pointer_forget(VariableRef p) override { this->_ptr->pointer_forget(p); }
+  void pointer_forget(VariableRef p) override {
+    this->mutable_ptr()->pointer_forget(p);
+  }
 
   /// @}
   /// \name Dynamically typed variables abstract domain methods
   /// @{
 
   void dynamic_assign(VariableRef x, VariableRef y) override {
-    this->_ptr->dynamic_assign(x, y);
+    this->mutable_ptr()->dynamic_assign(x, y);
   }
 
   void dynamic_write_undef(VariableRef x) override {
-    this->_ptr->dynamic_write_undef(x);
+    this->mutable_ptr()->dynamic_write_undef(x);
   }
 
   void dynamic_write_nondet(VariableRef x) override {
-    this->_ptr->dynamic_write_nondet(x);
+    this->mutable_ptr()->dynamic_write_nondet(x);
   }
 
   void dynamic_write_int(VariableRef x, const MachineInt& n) override {
-    this->_ptr->dynamic_write_int(x, n);
+    this->mutable_ptr()->dynamic_write_int(x, n);
   }
 
   void dynamic_write_nondet_int(VariableRef x) override {
-    this->_ptr->dynamic_write_nondet_int(x);
+    this->mutable_ptr()->dynamic_write_nondet_int(x);
   }
 
   void dynamic_write_int(VariableRef x, VariableRef y) override {
-    this->_ptr->dynamic_write_int(x, y);
+    this->mutable_ptr()->dynamic_write_int(x, y);
   }
 
   void dynamic_write_nondet_float(VariableRef x) override {
-    this->_ptr->dynamic_write_nondet_float(x);
+    this->mutable_ptr()->dynamic_write_nondet_float(x);
   }
 
   void dynamic_write_null(VariableRef x) override {
-    this->_ptr->dynamic_write_null(x);
+    this->mutable_ptr()->dynamic_write_null(x);
   }
 
   void dynamic_write_pointer(VariableRef x,
                              MemoryLocationRef addr,
                              Nullity nullity) override {
-    this->_ptr->dynamic_write_pointer(x, addr, nullity);
+    this->mutable_ptr()->dynamic_write_pointer(x, addr, nullity);
   }
 
   void dynamic_write_pointer(VariableRef x, VariableRef y) override {
-    this->_ptr->dynamic_write_pointer(x, y);
+    this->mutable_ptr()->dynamic_write_pointer(x, y);
   }
 
   void dynamic_read_int(VariableRef x, VariableRef y) override {
-    this->_ptr->dynamic_read_int(x, y);
+    this->mutable_ptr()->dynamic_read_int(x, y);
   }
 
   void dynamic_read_pointer(VariableRef x, VariableRef y) override {
-    this->_ptr->dynamic_read_pointer(x, y);
+    this->mutable_ptr()->dynamic_read_pointer(x, y);
   }
 
   bool dynamic_is_zero(VariableRef x) const override {
@@ -1779,33 +1831,37 @@ public:
     return this->_ptr->dynamic_is_null(x);
   }
 
-  void dynamic_forget(VariableRef x) override { this->_ptr->dynamic_forget(x); }
+  void dynamic_forget(VariableRef x) override {
+    this->mutable_ptr()->dynamic_forget(x);
+  }
 
   /// @}
   /// \name Scalar abstract domain methods
   /// @{
 
   void scalar_assign_undef(VariableRef x) override {
-    this->_ptr->scalar_assign_undef(x);
+    this->mutable_ptr()->scalar_assign_undef(x);
   }
 
   void scalar_assign_nondet(VariableRef x) override {
-    this->_ptr->scalar_assign_nondet(x);
+    this->mutable_ptr()->scalar_assign_nondet(x);
   }
 
   void scalar_pointer_to_int(VariableRef x,
                              VariableRef p,
                              MemoryLocationRef absolute_zero) override {
-    this->_ptr->scalar_pointer_to_int(x, p, absolute_zero);
+    this->mutable_ptr()->scalar_pointer_to_int(x, p, absolute_zero);
   }
 
   void scalar_int_to_pointer(VariableRef p,
                              VariableRef x,
                              MemoryLocationRef absolute_zero) override {
-    this->_ptr->scalar_int_to_pointer(p, x, absolute_zero);
+    this->mutable_ptr()->scalar_int_to_pointer(p, x, absolute_zero);
   }
 
-  void scalar_forget(VariableRef x) override { this->_ptr->scalar_forget(x); }
+  void scalar_forget(VariableRef x) override {
+    this->mutable_ptr()->scalar_forget(x);
+  }
 
   /// @}
   /// \name Memory abstract domain methods
@@ -1814,65 +1870,65 @@ public:
   void mem_write(VariableRef p,
                  const LiteralT& v,
                  const MachineInt& size) override {
-    this->_ptr->mem_write(p, v, size);
+    this->mutable_ptr()->mem_write(p, v, size);
   }
 
   void mem_read(const LiteralT& x,
                 VariableRef p,
                 const MachineInt& size) override {
-    this->_ptr->mem_read(x, p, size);
+    this->mutable_ptr()->mem_read(x, p, size);
   }
 
   void mem_copy(VariableRef dest,
                 VariableRef src,
                 const LiteralT& size) override {
-    this->_ptr->mem_copy(dest, src, size);
+    this->mutable_ptr()->mem_copy(dest, src, size);
   }
 
   void mem_set(VariableRef dest,
                const LiteralT& value,
                const LiteralT& size) override {
-    this->_ptr->mem_set(dest, value, size);
+    this->mutable_ptr()->mem_set(dest, value, size);
   }
 
-  void mem_forget_all() override { this->_ptr->mem_forget_all(); }
+  void mem_forget_all() override { this->mutable_ptr()->mem_forget_all(); }
 
   void mem_forget(MemoryLocationRef addr) override {
-    this->_ptr->mem_forget(addr);
+    this->mutable_ptr()->mem_forget(addr);
   }
 
   void mem_forget(MemoryLocationRef addr,
                   const IntInterval& offset,
                   const MachineInt& size) override {
-    this->_ptr->mem_forget(addr, offset, size);
+    this->mutable_ptr()->mem_forget(addr, offset, size);
   }
 
   void mem_forget(MemoryLocationRef addr, const IntInterval& range) override {
-    this->_ptr->mem_forget(addr, range);
+    this->mutable_ptr()->mem_forget(addr, range);
   }
 
   void mem_forget_reachable(VariableRef p) override {
-    this->_ptr->mem_forget_reachable(p);
+    this->mutable_ptr()->mem_forget_reachable(p);
   }
 
   void mem_forget_reachable(VariableRef p, const MachineInt& size) override {
-    this->_ptr->mem_forget_reachable(p, size);
+    this->mutable_ptr()->mem_forget_reachable(p, size);
   }
 
   void mem_abstract_reachable(VariableRef p) override {
-    this->_ptr->mem_abstract_reachable(p);
+    this->mutable_ptr()->mem_abstract_reachable(p);
   }
 
   void mem_abstract_reachable(VariableRef p, const MachineInt& size) override {
-    this->_ptr->mem_abstract_reachable(p, size);
+    this->mutable_ptr()->mem_abstract_reachable(p, size);
   }
 
   void mem_zero_reachable(VariableRef p) override {
-    this->_ptr->mem_zero_reachable(p);
+    this->mutable_ptr()->mem_zero_reachable(p);
   }
 
   void mem_uninitialize_reachable(VariableRef p) override {
-    this->_ptr->mem_uninitialize_reachable(p);
+    this->mutable_ptr()->mem_uninitialize_reachable(p);
   }
 
   /// @}
@@ -1880,27 +1936,27 @@ public:
   /// @{
 
   void lifetime_assign_allocated(MemoryLocationRef m) override {
-    this->_ptr->lifetime_assign_allocated(m);
+    this->mutable_ptr()->lifetime_assign_allocated(m);
   }
 
   void lifetime_assign_deallocated(MemoryLocationRef m) override {
-    this->_ptr->lifetime_assign_deallocated(m);
+    this->mutable_ptr()->lifetime_assign_deallocated(m);
   }
 
   void lifetime_assert_allocated(MemoryLocationRef m) override {
-    this->_ptr->lifetime_assert_allocated(m);
+    this->mutable_ptr()->lifetime_assert_allocated(m);
   }
 
   void lifetime_assert_deallocated(MemoryLocationRef m) override {
-    this->_ptr->lifetime_assert_deallocated(m);
+    this->mutable_ptr()->lifetime_assert_deallocated(m);
   }
 
   void lifetime_forget(MemoryLocationRef m) override {
-    this->_ptr->lifetime_forget(m);
+    this->mutable_ptr()->lifetime_forget(m);
   }
 
   void lifetime_set(MemoryLocationRef m, Lifetime value) override {
-    this->_ptr->lifetime_set(m, value);
+    this->mutable_ptr()->lifetime_set(m, value);
   }
 
   Lifetime lifetime_to_lifetime(MemoryLocationRef m) const override {
@@ -1912,16 +1968,20 @@ public:
   /// @{
 
   void partitioning_set_variable(VariableRef x) override {
-    this->_ptr->partitioning_set_variable(x);
+    this->mutable_ptr()->partitioning_set_variable(x);
   }
 
   boost::optional< VariableRef > partitioning_variable() const override {
     return this->_ptr->partitioning_variable();
   }
 
-  void partitioning_join() override { this->_ptr->partitioning_join(); }
+  void partitioning_join() override {
+    this->mutable_ptr()->partitioning_join();
+  }
 
-  void partitioning_disable() override { this->_ptr->partitioning_disable(); }
+  void partitioning_disable() override {
+    this->mutable_ptr()->partitioning_disable();
+  }
 
   /// @}
 
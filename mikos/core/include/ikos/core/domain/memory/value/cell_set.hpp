@@ -43,6 +43,7 @@
 
 #pragma once
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/adt/patricia_tree/set.hpp>
@@ -204,6 +205,16 @@ public:
 
 }; // end class CellSet
 
+/// \brief Return the hash of a cell set
+template < typename VariableRef >
+inline std::size_t hash_value(const CellSet< VariableRef >& cells) {
+  std::size_t hash = 0;
+  for (auto it = cells.begin(), et = cells.end(); it != et; ++it) {
+    boost::hash_combine(hash, IndexableTraits< VariableRef >::index(*it));
+  }
+  return hash;
+}
+
 } // end namespace memory
 } // end namespace core
 } // end namespace ikos
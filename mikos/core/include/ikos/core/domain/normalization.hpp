@@ -0,0 +1,119 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Normalization policy of the variable packing domains
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace ikos {
+namespace core {
+
+/// \brief Normalization policy and counters of the variable packing domains
+///
+/// Variable packing domains keep a dirty flag on each pack, telling whether
+/// the pack was updated since it was last normalized (e.g, the closure of a
+/// difference-bound matrix).
+///
+/// By default, operations normalize all the packs of their operands first.
+/// In lazy mode, a pack is only normalized when a query needs it, e.g,
+/// `to_interval(x)` on a variable of the pack, or a comparison with a
+/// different pack. Dirty packs that are never queried are never normalized.
+///
+/// The mode and the counters are global and can be used from several threads.
+class LazyNormalization {
+public:
+  LazyNormalization() = delete;
+
+  /// \brief Enable or disable the lazy normalization
+  static void enable(bool enabled) {
+    enabled_flag().store(enabled, std::memory_order_relaxed);
+  }
+
+  /// \brief Return true if the lazy normalization is enabled
+  static bool enabled() {
+    return enabled_flag().load(std::memory_order_relaxed);
+  }
+
+  /// \brief Record that a dirty pack was normalized
+  static void add_closure() {
+    closures_counter().fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief Record that a dirty pack was destroyed without being normalized
+  static void add_avoided_closure() {
+    avoided_closures_counter().fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief Return the number of dirty packs normalized so far
+  static std::size_t closures() {
+    return closures_counter().load(std::memory_order_relaxed);
+  }
+
+  /// \brief Return the number of dirty packs never normalized so far
+  static std::size_t avoided_closures() {
+    return avoided_closures_counter().load(std::memory_order_relaxed);
+  }
+
+  /// \brief Reset the counters
+  static void reset() {
+    closures_counter().store(0, std::memory_order_relaxed);
+    avoided_closures_counter().store(0, std::memory_order_relaxed);
+  }
+
+private:
+  static std::atomic< bool >& enabled_flag() {
+    static std::atomic< bool > flag(false);
+    return flag;
+  }
+
+  static std::atomic< std::size_t >& closures_counter() {
+    static std::atomic< std::size_t > counter(0);
+    return counter;
+  }
+
+  static std::atomic< std::size_t >& avoided_closures_counter() {
+    static std::atomic< std::size_t > counter(0);
+    return counter;
+  }
+
+}; // end class LazyNormalization
+
+} // end namespace core
+} // end namespace ikos
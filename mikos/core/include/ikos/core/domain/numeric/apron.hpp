@@ -70,65 +70,6 @@ namespace numeric {
 
 namespace apron {
 
-/// \brief Wrapper for ap_abstract0_t*
-using InvPtr = std::shared_ptr< ap_abstract0_t >;
-
-/// \brief Deleter for InvPtr
-struct InvDeleter {
-  void operator()(ap_abstract0_t* inv) {
-    ap_abstract0_free(ap_abstract0_manager(inv), inv);
-  }
-};
-
-/// \brief Create a InvPtr from a ap_abstract0_t*
-inline InvPtr inv_ptr(ap_abstract0_t* inv) {
-  return std::shared_ptr< ap_abstract0_t >(inv, InvDeleter());
-}
-
-/// \returns the size of a ap_abstract0_t
-inline std::size_t dims(ap_abstract0_t* inv) {
-  return ap_abstract0_dimension(ap_abstract0_manager(inv), inv).intdim;
-}
-
-/// \brief Add some dimensions to a ap_abstract0_t
-inline InvPtr add_dimensions(ap_abstract0_t* inv, std::size_t dims) {
-  ikos_assert(dims > 0);
-
-  ap_dimchange_t* dimchange = ap_dimchange_alloc(dims, 0);
-  for (std::size_t i = 0; i < dims; i++) {
-    // add dimension at the end
-    dimchange->dim[i] = static_cast< ap_dim_t >(apron::dims(inv));
-  }
-
-  ap_manager_t* manager = ap_abstract0_manager(inv);
-  InvPtr r = inv_ptr(
-      ap_abstract0_add_dimensions(manager, false, inv, dimchange, false));
-  ap_dimchange_free(dimchange);
-  return r;
-}
-
-/// \brief Remove some dimensions of a ap_abstract0_t
-inline InvPtr remove_dimensions(ap_abstract0_t* inv,
-                                const std::vector< ap_dim_t >& dims) {
-  ikos_assert(!dims.empty());
-  ikos_assert(std::is_sorted(dims.begin(), dims.end()));
-
-  // make sure that the removing dimensions are in ascending order
-
-  ap_dimchange_t* dimchange = ap_dimchange_alloc(dims.size(), 0);
-  for (std::size_t i = 0; i < dims.size(); i++) {
-    // remove dimension dims[i] and shift to the left all the dimensions greater
-    // than dims[i]
-    dimchange->dim[i] = dims[i];
-  }
-
-  ap_manager_t* manager = ap_abstract0_manager(inv);
-  InvPtr r =
-      inv_ptr(ap_abstract0_remove_dimensions(manager, false, inv, dimchange));
-  ap_dimchange_free(dimchange);
-  return r;
-}
-
 /// \brief Create a binary expression
 template < typename Number >
 inline ap_texpr0_t* binop_expr(ap_texpr_op_t, ap_texpr0_t*, ap_texpr0_t*);
@@ -282,14 +223,178 @@ inline ap_manager_t* alloc_domain_manager(Domain d) {
       return ap_ppl_poly_manager_alloc(false);
     case PplLinearCongruences:
       return ap_ppl_grid_manager_alloc();
-    case PkgridPolyhedraLinCongruences:
-      return ap_pkgrid_manager_alloc(pk_manager_alloc(false),
-                                     ap_ppl_grid_manager_alloc());
+    case PkgridPolyhedraLinCongruences: {
+      // The reduced product holds its own references on both managers
+      ap_manager_t* pk = pk_manager_alloc(false);
+      ap_manager_t* grid = ap_ppl_grid_manager_alloc();
+      ap_manager_t* manager = ap_pkgrid_manager_alloc(pk, grid);
+      ap_manager_free(pk);
+      ap_manager_free(grid);
+      return manager;
+    }
     default:
       ikos_unreachable("unexpected domain");
   }
 }
 
+/// \brief APRON managers of an abstract domain
+///
+/// Managers hold internal buffers, thus each thread runs the operations with
+/// its own manager, see `Managers::thread()`.
+///
+/// An abstract value also holds a reference on a manager, and the reference
+/// count of a manager is not atomic, while values are shared and released by
+/// any thread. Hence, values returned by an operation are bound to a manager
+/// shared by all threads, whose reference count is never updated, see
+/// `Managers::bind()`. They are bound back to the manager of the calling
+/// thread to be released, see `Managers::release()`. The reference count of a
+/// thread manager is thus only updated by its own thread, and the manager is
+/// freed when the thread exits. A thread must not release abstract values
+/// once its thread-local objects are destroyed.
+template < Domain D >
+class Managers {
+private:
+  /// \brief Manager of a thread, freed when the thread exits
+  class ThreadManager {
+  private:
+    ap_manager_t* _manager;
+
+  public:
+    /// \brief Constructor
+    ThreadManager() : _manager(alloc_domain_manager(D)) {}
+
+    /// \brief No copy constructor
+    ThreadManager(const ThreadManager&) = delete;
+
+    /// \brief No move constructor
+    ThreadManager(ThreadManager&&) = delete;
+
+    /// \brief No copy assignment operator
+    ThreadManager& operator=(const ThreadManager&) = delete;
+
+    /// \brief No move assignment operator
+    ThreadManager& operator=(ThreadManager&&) = delete;
+
+    /// \brief Destructor
+    ~ThreadManager() { ap_manager_free(this->_manager); }
+
+    /// \brief Return the manager
+    ap_manager_t* get() const { return this->_manager; }
+
+  }; // end class ThreadManager
+
+public:
+  /// \brief Return the manager of the calling thread
+  static ap_manager_t* thread() {
+    // Initialized at first call in each thread
+    static thread_local ThreadManager Man;
+    return Man.get();
+  }
+
+  /// \brief Return the manager shared by all threads
+  ///
+  /// It is only referenced by abstract values, to identify their library, and
+  /// lives until the end of the program.
+  static ap_manager_t* shared() {
+    static ap_manager_t* Man = alloc_domain_manager(D);
+    return Man;
+  }
+
+  /// \brief Bind an abstract value returned by an operation of the calling
+  /// thread to the shared manager
+  static ap_abstract0_t* bind(ap_abstract0_t* inv) {
+    ikos_assert(inv->man == thread());
+    ap_manager_free(inv->man);
+    inv->man = shared();
+    return inv;
+  }
+
+  /// \brief Release an abstract value from the calling thread
+  static void release(ap_abstract0_t* inv) {
+    ikos_assert(inv->man == shared());
+    ap_manager_t* manager = thread();
+    inv->man = ap_manager_copy(manager);
+    ap_abstract0_free(manager, inv);
+  }
+
+}; // end class Managers
+
+/// \brief Wrapper for ap_abstract0_t*
+using InvPtr = std::shared_ptr< ap_abstract0_t >;
+
+/// \brief Deleter for InvPtr
+template < Domain D >
+struct InvDeleter {
+  void operator()(ap_abstract0_t* inv) { Managers< D >::release(inv); }
+};
+
+/// \brief Create a InvPtr from a ap_abstract0_t* returned by an operation of
+/// the calling thread
+template < Domain D >
+inline InvPtr inv_ptr(ap_abstract0_t* inv) {
+  return std::shared_ptr< ap_abstract0_t >(Managers< D >::bind(inv),
+                                           InvDeleter< D >());
+}
+
+/// \returns the size of a ap_abstract0_t
+template < Domain D >
+inline std::size_t dims(ap_abstract0_t* inv) {
+  return ap_abstract0_dimension(Managers< D >::thread(), inv).intdim;
+}
+
+/// \brief Return a buffer of at least `size` dimensions
+///
+/// The buffer belongs to the calling thread and is reused by the next call,
+/// to avoid an allocation for each dimension change or permutation.
+inline ap_dim_t* dim_buffer(std::size_t size) {
+  static thread_local std::vector< ap_dim_t > buffer;
+  if (buffer.size() < size) {
+    buffer.resize(size);
+  }
+  return buffer.data();
+}
+
+/// \brief Add some dimensions to a ap_abstract0_t
+template < Domain D >
+inline InvPtr add_dimensions(ap_abstract0_t* inv, std::size_t dims) {
+  ikos_assert(dims > 0);
+
+  ap_dimchange_t dimchange;
+  dimchange.dim = dim_buffer(dims);
+  dimchange.intdim = dims;
+  dimchange.realdim = 0;
+
+  // add dimensions at the end
+  auto end = static_cast< ap_dim_t >(apron::dims< D >(inv));
+  std::fill(dimchange.dim, dimchange.dim + dims, end);
+
+  ap_manager_t* manager = Managers< D >::thread();
+  return inv_ptr< D >(
+      ap_abstract0_add_dimensions(manager, false, inv, &dimchange, false));
+}
+
+/// \brief Remove some dimensions of a ap_abstract0_t
+template < Domain D >
+inline InvPtr remove_dimensions(ap_abstract0_t* inv,
+                                const std::vector< ap_dim_t >& dims) {
+  ikos_assert(!dims.empty());
+
+  // make sure that the removing dimensions are in ascending order
+  ikos_assert(std::is_sorted(dims.begin(), dims.end()));
+
+  // remove dimension dims[i] and shift to the left all the dimensions greater
+  // than dims[i]
+  ap_dimchange_t dimchange;
+  dimchange.dim = dim_buffer(dims.size());
+  dimchange.intdim = dims.size();
+  dimchange.realdim = 0;
+  std::copy(dims.begin(), dims.end(), dimchange.dim);
+
+  ap_manager_t* manager = Managers< D >::thread();
+  return inv_ptr< D >(
+      ap_abstract0_remove_dimensions(manager, false, inv, &dimchange));
+}
+
 inline ap_abstract0_t* domain_narrowing(Domain d,
                                         ap_manager_t* manager,
                                         ap_abstract0_t* a,
@@ -328,41 +433,108 @@ private:
   apron::InvPtr _inv;
   VariableMap _var_map;
 
+  /// \brief Dimensions of `_inv` not associated to a variable
+  ///
+  /// These dimensions are unconstrained. They are reused by new variables, or
+  /// removed all at once by `compact()`.
+  std::vector< ap_dim_t > _unused_dims;
+
 private:
-  /// \brief Get the manager for the given apron domain
-  static ap_manager_t* manager() {
-    // Initialized at first call
-    static ap_manager_t* Man = apron::alloc_domain_manager(Domain);
-    return Man;
-  }
+  /// \brief Get the manager of the calling thread for the given apron domain
+  ///
+  /// Abstract values can still be shared between threads, see
+  /// apron::Managers.
+  static ap_manager_t* manager() { return apron::Managers< Domain >::thread(); }
 
   /// \brief Get the dimension associated to a variable
   boost::optional< const ap_dim_t& > var_dim(VariableRef v) const {
     return this->_var_map.at(v);
   }
 
+  /// \brief Return the number of dimensions of the abstract value
+  std::size_t num_dims() const {
+    return this->_var_map.size() + this->_unused_dims.size();
+  }
+
   /// \brief Get the dimension associated to a variable, or create one
   ap_dim_t var_dim_insert(VariableRef v) {
     boost::optional< const ap_dim_t& > dim = var_dim(v);
 
     if (dim) {
       return *dim;
+    } else if (!this->_unused_dims.empty()) {
+      ap_dim_t new_dim = this->_unused_dims.back();
+      this->_unused_dims.pop_back();
+      this->_var_map.insert_or_assign(v, new_dim);
+      return new_dim;
     } else {
-      auto new_dim = static_cast< ap_dim_t >(this->_var_map.size());
-      this->_inv = apron::add_dimensions(this->_inv.get(), 1);
+      auto new_dim = static_cast< ap_dim_t >(this->num_dims());
+      this->_inv = apron::add_dimensions< Domain >(this->_inv.get(), 1);
       this->_var_map.insert_or_assign(v, new_dim);
-      ikos_assert(this->_var_map.size() == apron::dims(this->_inv.get()));
+      ikos_assert(this->num_dims() == apron::dims< Domain >(this->_inv.get()));
       return new_dim;
     }
   }
 
+  /// \brief Create the dimensions of the given variables, at once
+  ///
+  /// Unused dimensions are reused first, then the missing dimensions are added
+  /// in a single step, instead of one copy of the abstract value per variable.
+  void var_dims_insert(const std::vector< VariableRef >& vars) {
+    auto end = static_cast< ap_dim_t >(this->num_dims());
+    ap_dim_t new_dim = end;
+
+    for (VariableRef v : vars) {
+      if (this->var_dim(v)) {
+        continue;
+      } else if (!this->_unused_dims.empty()) {
+        this->_var_map.insert_or_assign(v, this->_unused_dims.back());
+        this->_unused_dims.pop_back();
+      } else {
+        this->_var_map.insert_or_assign(v, new_dim++);
+      }
+    }
+
+    if (new_dim > end) {
+      this->_inv =
+          apron::add_dimensions< Domain >(this->_inv.get(), new_dim - end);
+    }
+    ikos_assert(this->num_dims() == apron::dims< Domain >(this->_inv.get()));
+  }
+
+  /// \brief Remove the unused dimensions, and renumber the other ones
+  void compact() {
+    if (this->_unused_dims.empty()) {
+      return;
+    }
+
+    std::vector< ap_dim_t >& removed = this->_unused_dims;
+    std::sort(removed.begin(), removed.end());
+    this->_inv = apron::remove_dimensions< Domain >(this->_inv.get(), removed);
+    this->_var_map.transform([&removed](VariableRef, ap_dim_t d) {
+      // shift d by the number of removed dimensions lower than d
+      auto shift = std::lower_bound(removed.begin(), removed.end(), d) -
+                   removed.begin();
+      return boost::optional< ap_dim_t >(d - static_cast< ap_dim_t >(shift));
+    });
+    removed.clear();
+    ikos_assert(this->num_dims() == apron::dims< Domain >(this->_inv.get()));
+  }
+
+  /// \brief Return a copy of the abstract value without unused dimensions
+  ApronDomain compacted() const {
+    ApronDomain r(*this);
+    r.compact();
+    return r;
+  }
+
   /// \brief Merge two variable maps, updating the associated abstract values
   static VariableMap merge_var_maps(const VariableMap& var_map_x,
                                     apron::InvPtr& inv_x,
                                     const VariableMap& var_map_y,
                                     apron::InvPtr& inv_y) {
-    ikos_assert(var_map_x.size() == apron::dims(inv_x.get()));
-    ikos_assert(var_map_y.size() == apron::dims(inv_y.get()));
+    ikos_assert(var_map_x.size() == apron::dims< Domain >(inv_x.get()));
+    ikos_assert(var_map_y.size() == apron::dims< Domain >(inv_y.get()));
 
     // build a result variable map, based on var_map_x
     VariableMap result_var_map(var_map_x);
@@ -389,33 +561,43 @@ private:
 
     // add the necessary dimensions to inv_x and inv_y
     if (result_var_map.size() > var_map_x.size()) {
-      inv_x = apron::add_dimensions(inv_x.get(),
-                                    result_var_map.size() - var_map_x.size());
+      inv_x = apron::add_dimensions< Domain >(inv_x.get(),
+                                              result_var_map.size() -
+                                                  var_map_x.size());
     }
     if (result_var_map.size() > var_map_y.size()) {
-      inv_y = apron::add_dimensions(inv_y.get(),
-                                    result_var_map.size() - var_map_y.size());
+      inv_y = apron::add_dimensions< Domain >(inv_y.get(),
+                                              result_var_map.size() -
+                                                  var_map_y.size());
     }
 
-    ikos_assert(result_var_map.size() == apron::dims(inv_x.get()));
-    ikos_assert(result_var_map.size() == apron::dims(inv_y.get()));
+    ikos_assert(result_var_map.size() == apron::dims< Domain >(inv_x.get()));
+    ikos_assert(result_var_map.size() == apron::dims< Domain >(inv_y.get()));
 
     // build and apply the permutation map for inv_y
-    ap_dimperm_t* perm_y = build_perm_map(var_map_y, result_var_map);
-    inv_y = apron::inv_ptr(
-        ap_abstract0_permute_dimensions(manager(), false, inv_y.get(), perm_y));
-    ap_dimperm_free(perm_y);
+    ap_dimperm_t perm_y = build_perm_map(var_map_y, result_var_map);
+    inv_y = apron::inv_ptr< Domain >(
+        ap_abstract0_permute_dimensions(manager(),
+                                        false,
+                                        inv_y.get(),
+                                        &perm_y));
 
-    ikos_assert(result_var_map.size() == apron::dims(inv_x.get()));
-    ikos_assert(result_var_map.size() == apron::dims(inv_y.get()));
+    ikos_assert(result_var_map.size() == apron::dims< Domain >(inv_x.get()));
+    ikos_assert(result_var_map.size() == apron::dims< Domain >(inv_y.get()));
 
     return result_var_map;
   }
 
-  static ap_dimperm_t* build_perm_map(const VariableMap& old_map,
-                                      const VariableMap& new_map) {
+  /// \brief Build the permutation map from `old_map` to `new_map`
+  ///
+  /// The permutation uses the dimension buffer of the calling thread (see
+  /// `apron::dim_buffer()`), and is only valid until its next use.
+  static ap_dimperm_t build_perm_map(const VariableMap& old_map,
+                                     const VariableMap& new_map) {
     std::size_t n = new_map.size();
-    ap_dimperm_t* perm = ap_dimperm_alloc(n);
+    ap_dimperm_t perm;
+    perm.dim = apron::dim_buffer(n);
+    perm.size = n;
     std::vector< bool > index_assigned(n, false);
     std::vector< bool > value_assigned(n, false);
 
@@ -423,7 +605,7 @@ private:
       boost::optional< const ap_dim_t& > dim = new_map.at(it->first);
       ikos_assert(dim);
 
-      perm->dim[it->second] = *dim;
+      perm.dim[it->second] = *dim;
       index_assigned[it->second] = true;
       value_assigned[*dim] = true;
     }
@@ -438,7 +620,7 @@ private:
         counter++;
       }
 
-      perm->dim[i] = counter;
+      perm.dim[i] = counter;
       counter++;
     }
 
@@ -530,11 +712,12 @@ private:
 
   /// \brief Create the top abstract value
   explicit ApronDomain(TopTag)
-      : _inv(apron::inv_ptr(ap_abstract0_top(manager(), 0, 0))) {}
+      : _inv(apron::inv_ptr< Domain >(ap_abstract0_top(manager(), 0, 0))) {}
 
   /// \brief Create the bottom abstract value
   explicit ApronDomain(BottomTag)
-      : _inv(apron::inv_ptr(ap_abstract0_bottom(manager(), 0, 0))) {}
+      : _inv(
+            apron::inv_ptr< Domain >(ap_abstract0_bottom(manager(), 0, 0))) {}
 
 public:
   /// \brief Create the top abstract value
@@ -544,13 +727,13 @@ public:
   static ApronDomain bottom() { return ApronDomain(BottomTag{}); }
 
   /// \brief Copy constructor
-  ApronDomain(const ApronDomain&) noexcept = default;
+  ApronDomain(const ApronDomain&) = default;
 
   /// \brief Move constructor
   ApronDomain(ApronDomain&&) noexcept = default;
 
   /// \brief Copy assignment operator
-  ApronDomain& operator=(const ApronDomain&) noexcept = default;
+  ApronDomain& operator=(const ApronDomain&) = default;
 
   /// \brief Move assignment operator
   ApronDomain& operator=(ApronDomain&&) noexcept = default;
@@ -580,10 +763,10 @@ public:
     } else if (this->is_top()) {
       return false;
     } else {
-      apron::InvPtr inv_x(this->_inv);
-      apron::InvPtr inv_y(other._inv);
-      merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      return ap_abstract0_is_leq(manager(), inv_x.get(), inv_y.get());
+      ApronDomain x = this->compacted();
+      ApronDomain y = other.compacted();
+      merge_var_maps(x._var_map, x._inv, y._var_map, y._inv);
+      return ap_abstract0_is_leq(manager(), x._inv.get(), y._inv.get());
     }
   }
 
@@ -597,10 +780,10 @@ public:
     } else if (other.is_top()) {
       return false;
     } else {
-      apron::InvPtr inv_x(this->_inv);
-      apron::InvPtr inv_y(other._inv);
-      merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      return ap_abstract0_is_eq(manager(), inv_x.get(), inv_y.get());
+      ApronDomain x = this->compacted();
+      ApronDomain y = other.compacted();
+      merge_var_maps(x._var_map, x._inv, y._var_map, y._inv);
+      return ap_abstract0_is_eq(manager(), x._inv.get(), y._inv.get());
     }
   }
 
@@ -610,12 +793,12 @@ public:
     } else if (this->is_top() || other.is_bottom()) {
       return *this;
     } else {
-      apron::InvPtr inv_x(this->_inv);
-      apron::InvPtr inv_y(other._inv);
+      ApronDomain x = this->compacted();
+      ApronDomain y = other.compacted();
       VariableMap var_map =
-          merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      apron::InvPtr inv = apron::inv_ptr(
-          ap_abstract0_join(manager(), false, inv_x.get(), inv_y.get()));
+          merge_var_maps(x._var_map, x._inv, y._var_map, y._inv);
+      apron::InvPtr inv = apron::inv_ptr< Domain >(
+          ap_abstract0_join(manager(), false, x._inv.get(), y._inv.get()));
       return ApronDomain(inv, var_map);
     }
   }
@@ -630,12 +813,12 @@ public:
     } else if (other.is_bottom()) {
       return *this;
     } else {
-      apron::InvPtr inv_x(this->_inv);
-      apron::InvPtr inv_y(other._inv);
+      ApronDomain x = this->compacted();
+      ApronDomain y = other.compacted();
       VariableMap var_map =
-          merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      apron::InvPtr inv = apron::inv_ptr(
-          ap_abstract0_widening(manager(), inv_x.get(), inv_y.get()));
+          merge_var_maps(x._var_map, x._inv, y._var_map, y._inv);
+      apron::InvPtr inv = apron::inv_ptr< Domain >(
+          ap_abstract0_widening(manager(), x._inv.get(), y._inv.get()));
       return ApronDomain(inv, var_map);
     }
   }
@@ -662,12 +845,12 @@ public:
     } else if (other.is_top()) {
       return *this;
     } else {
-      apron::InvPtr inv_x(this->_inv);
-      apron::InvPtr inv_y(other._inv);
+      ApronDomain x = this->compacted();
+      ApronDomain y = other.compacted();
       VariableMap var_map =
-          merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      apron::InvPtr inv = apron::inv_ptr(
-          ap_abstract0_meet(manager(), false, inv_x.get(), inv_y.get()));
+          merge_var_maps(x._var_map, x._inv, y._var_map, y._inv);
+      apron::InvPtr inv = apron::inv_ptr< Domain >(
+          ap_abstract0_meet(manager(), false, x._inv.get(), y._inv.get()));
       return ApronDomain(inv, var_map);
     }
   }
@@ -684,12 +867,15 @@ public:
     } else if (other.is_top()) {
       return *this;
     } else {
-      apron::InvPtr inv_x(this->_inv);
-      apron::InvPtr inv_y(other._inv);
+      ApronDomain x = this->compacted();
+      ApronDomain y = other.compacted();
       VariableMap var_map =
-          merge_var_maps(this->_var_map, inv_x, other._var_map, inv_y);
-      apron::InvPtr inv = apron::inv_ptr(
-          apron::domain_narrowing(Domain, manager(), inv_x.get(), inv_y.get()));
+          merge_var_maps(x._var_map, x._inv, y._var_map, y._inv);
+      apron::InvPtr inv = apron::inv_ptr< Domain >(
+          apron::domain_narrowing(Domain,
+                                  manager(),
+                                  x._inv.get(),
+                                  y._inv.get()));
       return ApronDomain(inv, var_map);
     }
   }
@@ -725,14 +911,21 @@ public:
       return;
     }
 
+    std::vector< VariableRef > vars{x};
+    for (auto it = e.begin(), et = e.end(); it != et; ++it) {
+      vars.push_back(it->first);
+    }
+    this->var_dims_insert(vars);
+
     ap_texpr0_t* t = to_ap_expr(e);
     ap_dim_t v_dim = var_dim_insert(x);
-    this->_inv = apron::inv_ptr(ap_abstract0_assign_texpr(manager(),
-                                                          false,
-                                                          this->_inv.get(),
-                                                          v_dim,
-                                                          t,
-                                                          nullptr));
+    this->_inv = apron::inv_ptr< Domain >(
+        ap_abstract0_assign_texpr(manager(),
+                                  false,
+                                  this->_inv.get(),
+                                  v_dim,
+                                  t,
+                                  nullptr));
     ap_texpr0_free(t);
   }
 
@@ -779,12 +972,13 @@ private:
     }
 
     ap_dim_t x_dim = var_dim_insert(x);
-    this->_inv = apron::inv_ptr(ap_abstract0_assign_texpr(manager(),
-                                                          false,
-                                                          this->_inv.get(),
-                                                          x_dim,
-                                                          t,
-                                                          nullptr));
+    this->_inv = apron::inv_ptr< Domain >(
+        ap_abstract0_assign_texpr(manager(),
+                                  false,
+                                  this->_inv.get(),
+                                  x_dim,
+                                  t,
+                                  nullptr));
     ap_texpr0_free(t);
   }
 
@@ -798,6 +992,7 @@ public:
     }
 
     if (this->is_supported(op)) {
+      this->var_dims_insert({x, y, z});
       this->apply(op, x, to_ap_expr(y), to_ap_expr(z));
     } else {
       this->set(x,
@@ -816,6 +1011,7 @@ public:
     }
 
     if (this->is_supported(op)) {
+      this->var_dims_insert({x, y});
       this->apply(op, x, to_ap_expr(y), apron::to_ap_expr(z));
     } else if (op == BinaryOperator::Mod) {
       // Optimized version, because mod is heavily used on machine integers
@@ -847,6 +1043,7 @@ public:
     }
 
     if (this->is_supported(op)) {
+      this->var_dims_insert({x, z});
       this->apply(op, x, apron::to_ap_expr(y), to_ap_expr(z));
     } else {
       this->set(x, apply_bin_operator(op, IntervalT(y), this->to_interval(z)));
@@ -866,6 +1063,15 @@ public:
       return;
     }
 
+    std::vector< VariableRef > vars;
+    for (const LinearConstraintT& cst : csts) {
+      const LinearExpressionT& exp = cst.expression();
+      for (auto it = exp.begin(), et = exp.end(); it != et; ++it) {
+        vars.push_back(it->first);
+      }
+    }
+    this->var_dims_insert(vars);
+
     ap_tcons0_array_t ap_csts = ap_tcons0_array_make(csts.size());
 
     std::size_t i = 0;
@@ -873,10 +1079,11 @@ public:
       ap_csts.p[i++] = to_ap_constraint(cst);
     }
 
-    this->_inv = apron::inv_ptr(ap_abstract0_meet_tcons_array(manager(),
-                                                              false,
-                                                              this->_inv.get(),
-                                                              &ap_csts));
+    this->_inv = apron::inv_ptr< Domain >(
+        ap_abstract0_meet_tcons_array(manager(),
+                                      false,
+                                      this->_inv.get(),
+                                      &ap_csts));
 
     // this step allows to improve the precision
     for (i = 0; i < csts.size() && !this->is_bottom(); i++) {
@@ -961,11 +1168,11 @@ public:
       csts.p[0] = ap_tcons0_make(AP_CONS_EQMOD,
                                  to_ap_expr(VariableExprT(x) - value.residue()),
                                  apron::to_ap_scalar(value.modulus()));
-      this->_inv =
-          apron::inv_ptr(ap_abstract0_meet_tcons_array(manager(),
-                                                       false,
-                                                       this->_inv.get(),
-                                                       &csts));
+      this->_inv = apron::inv_ptr< Domain >(
+          ap_abstract0_meet_tcons_array(manager(),
+                                        false,
+                                        this->_inv.get(),
+                                        &csts));
       ap_tcons0_array_clear(&csts);
     }
   }
@@ -989,24 +1196,23 @@ public:
     }
 
     ap_dim_t dim = *has_dim;
-    std::vector< ap_dim_t > vector_dims{dim};
-    this->_inv = apron::inv_ptr(ap_abstract0_forget_array(manager(),
-                                                          false,
-                                                          this->_inv.get(),
-                                                          &vector_dims[0],
-                                                          vector_dims.size(),
-                                                          false));
-    this->_inv = apron::remove_dimensions(this->_inv.get(), vector_dims);
-    this->_var_map.transform([dim](VariableRef, ap_dim_t d) {
-      if (d < dim) {
-        return boost::optional< ap_dim_t >(d);
-      } else if (d == dim) {
-        return boost::optional< ap_dim_t >(boost::none);
-      } else { // d > dim
-        return boost::optional< ap_dim_t >(d - 1);
-      }
-    });
-    ikos_assert(this->_var_map.size() == apron::dims(this->_inv.get()));
+    this->_inv = apron::inv_ptr< Domain >(
+        ap_abstract0_forget_array(manager(),
+                                  false,
+                                  this->_inv.get(),
+                                  &dim,
+                                  1,
+                                  false));
+
+    // Keep the unconstrained dimension for a later variable, instead of
+    // removing it and renumbering all the greater dimensions right away
+    this->_var_map.erase(x);
+    this->_unused_dims.push_back(dim);
+
+    if (this->_unused_dims.size() * 4 > this->num_dims()) {
+      this->compact();
+    }
+    ikos_assert(this->num_dims() == apron::dims< Domain >(this->_inv.get()));
   }
 
   void normalize() const override {
@@ -46,8 +46,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <boost/iterator/transform_iterator.hpp>
 
+#include <ikos/core/domain/copy_on_write.hpp>
 #include <ikos/core/domain/numeric/abstract_domain.hpp>
 #include <ikos/core/domain/numeric/linear_interval_solver.hpp>
 #include <ikos/core/number/bound.hpp>
@@ -94,9 +100,17 @@ private:
   /// \brief Parent
   using Parent = numeric::AbstractDomain< Number, VariableRef, DBM >;
 
+  /// \brief Square matrix of bounds
+  ///
+  /// The elements are shared between copies, and cloned on the first
+  /// modification (copy-on-write). This makes copies of the abstract value
+  /// cheap, e.g. when the fixpoint iterator saves an invariant.
   class Matrix {
   private:
-    std::vector< BoundT > _matrix;
+    using Elements = std::vector< BoundT >;
+
+  private:
+    std::shared_ptr< Elements > _matrix; // null if empty
     MatrixIndex _num_vars = 0; // size of the matrix
 
   public:
@@ -104,20 +118,67 @@ private:
     Matrix() = default;
 
     /// \brief Copy constructor
-    Matrix(const Matrix&) = default;
+    Matrix(const Matrix& other)
+        : _matrix(other._matrix), _num_vars(other._num_vars) {
+      if (this->_matrix != nullptr) {
+        CopyOnWriteStats::add_share();
+      }
+    }
 
     /// \brief Move constructor
-    Matrix(Matrix&&) = default;
+    Matrix(Matrix&& other) noexcept
+        : _matrix(std::move(other._matrix)), _num_vars(other._num_vars) {
+      other._num_vars = 0;
+    }
 
     /// \brief Copy assignment operator
-    Matrix& operator=(const Matrix&) = default;
+    Matrix& operator=(const Matrix& other) {
+      if (this->_matrix != other._matrix && other._matrix != nullptr) {
+        CopyOnWriteStats::add_share();
+      }
+      this->_matrix = other._matrix;
+      this->_num_vars = other._num_vars;
+      return *this;
+    }
 
     /// \brief Move assignment operator
-    Matrix& operator=(Matrix&&) = default;
+    Matrix& operator=(Matrix&& other) noexcept {
+      this->_matrix = std::move(other._matrix);
+      this->_num_vars = other._num_vars;
+      other._num_vars = 0;
+      return *this;
+    }
 
     /// \brief Destructor
     ~Matrix() = default;
 
+  private:
+    /// \brief Return true if the elements are shared with another matrix
+    ///
+    /// Other matrices might be used by other threads. If the elements are no
+    /// longer shared, the fence synchronizes with the release of the other
+    /// references, so that reads from other threads happen before the writes.
+    bool is_shared() const {
+      if (this->_matrix.use_count() > 1) {
+        return true;
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return false;
+    }
+
+    /// \brief Return the elements for a modification
+    ///
+    /// Clone the elements if they are shared with another matrix.
+    Elements& elements() {
+      ikos_assert(this->_matrix != nullptr);
+      if (this->is_shared()) {
+        this->_matrix = std::make_shared< Elements >(*this->_matrix);
+        CopyOnWriteStats::add_clone();
+      }
+      return *this->_matrix;
+    }
+
+  public:
     /// \brief Return the number of variables in the matrix
     MatrixIndex num_vars() const { return this->_num_vars; }
 
@@ -125,75 +186,133 @@ private:
     const BoundT& operator()(MatrixIndex i, MatrixIndex j) const {
       ikos_assert_msg(i < this->_num_vars && j < this->_num_vars,
                       "ouf of bounds matrix access");
-      return this->_matrix[this->_num_vars * i + j];
+      return (*this->_matrix)[this->_num_vars * i + j];
     }
 
     /// \brief Return the element (i, j)
     BoundT& operator()(MatrixIndex i, MatrixIndex j) {
       ikos_assert_msg(i < this->_num_vars && j < this->_num_vars,
                       "ouf of bounds matrix access");
-      return this->_matrix[this->_num_vars * i + j];
+      return this->elements()[this->_num_vars * i + j];
     }
 
     /// \brief Clear the matrix
     void clear() {
       this->_num_vars = 0;
-      this->_matrix.clear();
+      this->_matrix.reset();
     }
 
     /// \brief Clear and resize the matrix
     void clear_resize(MatrixIndex num_vars) {
       this->_num_vars = num_vars;
-      this->_matrix.clear();
-      this->_matrix.resize(num_vars * num_vars, BoundT::plus_infinity());
+      if (num_vars == 0) {
+        this->_matrix.reset();
+      } else {
+        this->_matrix =
+            std::make_shared< Elements >(num_vars * num_vars,
+                                         BoundT::plus_infinity());
+      }
     }
 
     /// \brief Resize the matrix to handle a new variable
     ///
     /// \returns the index of the new variable
     MatrixIndex add_variable() {
-      if (this->_num_vars == 0) {
-        this->_num_vars = 2;
-        this->_matrix.resize(this->_num_vars * this->_num_vars,
-                             BoundT::plus_infinity());
-      } else {
-        std::vector< BoundT > new_matrix((this->_num_vars + 1) *
-                                             (this->_num_vars + 1),
-                                         BoundT::plus_infinity());
-
-        for (MatrixIndex i = 0; i < this->_num_vars; i++) {
-          for (MatrixIndex j = 0; j < this->_num_vars; j++) {
-            new_matrix[(this->_num_vars + 1) * i + j] =
-                std::move(this->_matrix[this->_num_vars * i + j]);
+      const MatrixIndex n = this->_num_vars;
+      auto new_matrix =
+          std::make_shared< Elements >(n == 0 ? 4 : (n + 1) * (n + 1),
+                                       BoundT::plus_infinity());
+
+      if (n > 0) {
+        // Elements can only be moved if they are not shared
+        Elements& old_matrix = *this->_matrix;
+        bool shared = this->is_shared();
+        for (MatrixIndex i = 0; i < n; i++) {
+          for (MatrixIndex j = 0; j < n; j++) {
+            if (shared) {
+              (*new_matrix)[(n + 1) * i + j] = old_matrix[n * i + j];
+            } else {
+              (*new_matrix)[(n + 1) * i + j] = std::move(old_matrix[n * i + j]);
+            }
           }
         }
+        if (shared) {
+          CopyOnWriteStats::add_clone();
+        }
+      }
+
+      this->_matrix = std::move(new_matrix);
+      this->_num_vars = (n == 0) ? 2 : n + 1;
 
-        std::swap(this->_matrix, new_matrix);
-        this->_num_vars++;
+      // Keep the diagonal at 0, so that a normalized matrix stays normalized
+      Elements& m = *this->_matrix;
+      for (MatrixIndex i = 0; i < this->_num_vars; i++) {
+        m[this->_num_vars * i + i] = BoundT(0);
       }
 
       return this->_num_vars - 1;
     }
 
     /// \brief Apply Floyd-Warshall algorithm to normalize the matrix
+    ///
+    /// The elements are cloned first if they are shared with another matrix,
+    /// so that other matrices are never modified.
     void normalize() {
       const MatrixIndex n = this->_num_vars;
+      if (n == 0) {
+        return;
+      }
 
+      Elements& m = this->elements();
       for (MatrixIndex i = 0; i < n; i++) {
-        this->_matrix[n * i + i] = BoundT(0);
+        m[n * i + i] = BoundT(0);
       }
 
       for (MatrixIndex k = 0; k < n; k++) {
-        for (MatrixIndex i = 0; i < n; i++) {
-          for (MatrixIndex j = 0; j < n; j++) {
-            this->_matrix[n * i + j] =
-                min(this->_matrix[n * i + j],
-                    this->_matrix[n * i + k] + this->_matrix[n * k + j]);
-          }
+        close_through(m, n, k);
+      }
+    }
+
+    /// \brief Normalize a matrix that was normalized before some of the
+    /// edges adjacent to the given variables were tightened
+    ///
+    /// A shortest path in the new matrix alternates between old edges, that
+    /// are already closed, and tightened edges. All its intermediate vertices
+    /// are thus in `vars`, and Floyd-Warshall only needs these pivots.
+    /// This runs in O(|vars| * n^2) instead of O(n^3).
+    ///
+    /// As normalize(), the elements are cloned first if they are shared.
+    void normalize(const std::vector< MatrixIndex >& vars) {
+      const MatrixIndex n = this->_num_vars;
+      if (n == 0) {
+        return;
+      }
+
+      Elements& m = this->elements();
+      for (MatrixIndex i = 0; i < n; i++) {
+        m[n * i + i] = BoundT(0);
+      }
+
+      for (MatrixIndex k : vars) {
+        close_through(m, n, k);
+      }
+    }
+
+  private:
+    /// \brief Floyd-Warshall step, using k as a pivot
+    static void close_through(Elements& m, MatrixIndex n, MatrixIndex k) {
+      for (MatrixIndex i = 0; i < n; i++) {
+        const BoundT& w_i_k = m[n * i + k];
+        if (w_i_k.is_plus_infinity()) {
+          continue;
+        }
+        for (MatrixIndex j = 0; j < n; j++) {
+          m[n * i + j] = min(m[n * i + j], w_i_k + m[n * k + j]);
         }
       }
     }
 
+  public:
     /// \brief Return true if the matrix has a negative cycle
     bool has_negative_cycle() const {
       for (MatrixIndex i = 0; i < this->_num_vars; i++) {
@@ -251,6 +370,14 @@ private:
   Matrix _matrix;
   VarIndexMap _var_index_map;
 
+  /// \brief Variables whose edges were tightened since the last
+  /// normalization
+  ///
+  /// If the matrix is not normalized and this is not empty, the matrix only
+  /// needs an incremental closure through these variables. Otherwise, it
+  /// needs a full closure.
+  std::vector< MatrixIndex > _dirty_vars;
+
 private:
   struct TopTag {};
   struct BottomTag {};
@@ -284,6 +411,12 @@ public:
   ~DBM() override = default;
 
   /// \brief Normalize the difference bound matrix
+  ///
+  /// This updates the matrix of a const abstract value. A matrix shared with
+  /// copies of the abstract value is cloned before it is updated, so copies
+  /// can be normalized concurrently by different threads. The same abstract
+  /// value is updated without synchronization: if it is read by several
+  /// threads, it must be normalized before it is shared.
   void normalize() const override {
     if (this->_is_normalized) {
       return;
@@ -293,11 +426,18 @@ public:
 
     if (this->_is_bottom) {
       self->_is_normalized = true;
+      self->_dirty_vars.clear();
       return;
     }
 
-    // Floyd-Warshall algorithm
-    self->_matrix.normalize();
+    if (this->_dirty_vars.empty()) {
+      // Floyd-Warshall algorithm
+      self->_matrix.normalize();
+    } else {
+      // Incremental closure
+      self->_matrix.normalize(this->_dirty_vars);
+      self->_dirty_vars.clear();
+    }
 
     // Check for negative cycle
     if (this->_matrix.has_negative_cycle()) {
@@ -329,6 +469,7 @@ public:
     this->_is_normalized = true;
     this->_matrix.clear();
     this->_var_index_map.clear();
+    this->_dirty_vars.clear();
   }
 
   void set_to_top() override {
@@ -336,6 +477,7 @@ public:
     this->_is_normalized = true;
     this->_matrix.clear();
     this->_var_index_map.clear();
+    this->_dirty_vars.clear();
   }
 
   bool leq(const DBM& other) const override {
@@ -741,12 +883,26 @@ private:
     }
   }
 
+  /// \brief Mark the edges of v_i as tightened
+  void mark_dirty(MatrixIndex i) {
+    if (this->_is_normalized) {
+      this->_is_normalized = false;
+      this->_dirty_vars.push_back(i);
+    } else if (!this->_dirty_vars.empty() &&
+               std::find(this->_dirty_vars.begin(),
+                         this->_dirty_vars.end(),
+                         i) == this->_dirty_vars.end()) {
+      this->_dirty_vars.push_back(i);
+    }
+  }
+
   /// \brief Add constraint v_i - v_j <= c
   void add_constraint(MatrixIndex i, MatrixIndex j, const BoundT& c) {
     const BoundT& w = this->_matrix(j, i);
     if (c < w) {
       this->_matrix(j, i) = c;
-      this->_is_normalized = false;
+      this->mark_dirty(i);
+      this->mark_dirty(j);
     }
   }
 
@@ -773,7 +929,7 @@ private:
       }
     }
 
-    this->_is_normalized = false;
+    // Shifting a variable preserves the closure
   }
 
   /// \brief Apply v_i = v_i + c
@@ -1287,6 +1443,15 @@ public:
 private:
   /// \brief Forget all informations about variable k
   void forget(MatrixIndex k) {
+    // Pivoting through k would create edges that are not adjacent to the
+    // dirty variables, finish the incremental closure instead
+    if (!this->_is_normalized && !this->_dirty_vars.empty()) {
+      this->normalize();
+      if (this->_is_bottom) {
+        return;
+      }
+    }
+
     // Use informations about k to improve all constraints
     // Not necessary if already normalized
     if (!this->_is_normalized) {
@@ -1313,7 +1478,7 @@ private:
     }
     this->_matrix(k, k) = BoundT(0);
 
-    this->_is_normalized = false;
+    // Removing a variable preserves the closure
   }
 
 public:
@@ -0,0 +1,1612 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Sparse domain of Difference-Bound Matrices
+ *
+ * Based on Graeme Gange, Jorge A. Navas, Peter Schachte, Harald Sondergaard
+ * and Peter J. Stuckey's paper: Exploiting Sparsity in Difference-Bound
+ * Matrices, in SAS, 2016.
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/optional.hpp>
+
+#include <ikos/core/domain/numeric/abstract_domain.hpp>
+#include <ikos/core/domain/numeric/linear_interval_solver.hpp>
+#include <ikos/core/number/bound.hpp>
+#include <ikos/core/support/assert.hpp>
+#include <ikos/core/value/numeric/congruence.hpp>
+#include <ikos/core/value/numeric/interval.hpp>
+#include <ikos/core/value/numeric/interval_congruence.hpp>
+
+namespace ikos {
+namespace core {
+namespace numeric {
+
+/// \brief Sparse Difference-Bound Matrices abstract domain
+///
+/// The abstract value is kept in split normal form: the bounds of each
+/// variable are stored in a separate vector of intervals, and the difference
+/// constraints are stored in a sparse graph. The memory footprint is linear
+/// in the number of variables and constraints, instead of quadratic in the
+/// number of variables for `DBM`.
+///
+/// A difference constraint that is implied by the intervals does not need to
+/// be stored in the graph. The tightest bound of v_j - v_i is thus
+/// min(w(i, j), ub(v_j) - lb(v_i)).
+///
+/// Note that this abstract domain is not thread-safe.
+template < typename Number,
+           typename VariableRef,
+           std::size_t MaxReductionCycles = 10 >
+class SparseDBM final
+    : public numeric::AbstractDomain<
+          Number,
+          VariableRef,
+          SparseDBM< Number, VariableRef, MaxReductionCycles > > {
+public:
+  using BoundT = Bound< Number >;
+  using IntervalT = Interval< Number >;
+  using CongruenceT = Congruence< Number >;
+  using IntervalCongruenceT = IntervalCongruence< Number >;
+  using VariableExprT = VariableExpression< Number, VariableRef >;
+  using LinearExpressionT = LinearExpression< Number, VariableRef >;
+  using LinearConstraintT = LinearConstraint< Number, VariableRef >;
+  using LinearConstraintSystemT = LinearConstraintSystem< Number, VariableRef >;
+
+private:
+  /// \brief Index of a variable in the graph
+  using VarIndex = unsigned;
+
+  // \brief Map from variable to index
+  using VarIndexMap = boost::container::flat_map< VariableRef, VarIndex >;
+
+  /// \brief Solver
+  using LinearIntervalSolverT =
+      LinearIntervalSolver< Number, VariableRef, SparseDBM >;
+
+  /// \brief Parent
+  using Parent = numeric::AbstractDomain< Number, VariableRef, SparseDBM >;
+
+  /// \brief Graph of difference constraints
+  ///
+  /// An edge i -> j of weight w represents the constraint v_j - v_i <= w.
+  /// Only finite weights are stored.
+  class Graph {
+  public:
+    /// \brief Successors of a vertex, with the weight of the edge
+    using Row = boost::container::flat_map< VarIndex, BoundT >;
+
+    /// \brief Predecessors of a vertex
+    using PredSet = boost::container::flat_set< VarIndex >;
+
+  private:
+    std::vector< Row > _succ;
+    std::vector< PredSet > _pred;
+
+  public:
+    /// \brief Create an empty graph
+    Graph() = default;
+
+    /// \brief Create a graph with the given number of vertices and no edges
+    explicit Graph(VarIndex num_vertices)
+        : _succ(num_vertices), _pred(num_vertices) {}
+
+    /// \brief Copy constructor
+    Graph(const Graph&) = default;
+
+    /// \brief Move constructor
+    Graph(Graph&&) = default;
+
+    /// \brief Copy assignment operator
+    Graph& operator=(const Graph&) = default;
+
+    /// \brief Move assignment operator
+    Graph& operator=(Graph&&) = default;
+
+    /// \brief Destructor
+    ~Graph() = default;
+
+    /// \brief Return the number of vertices
+    VarIndex num_vertices() const {
+      return static_cast< VarIndex >(this->_succ.size());
+    }
+
+    /// \brief Add a vertex without edges
+    ///
+    /// \returns the index of the new vertex
+    VarIndex add_vertex() {
+      this->_succ.emplace_back();
+      this->_pred.emplace_back();
+      return this->num_vertices() - 1;
+    }
+
+    /// \brief Return the successors of vertex i
+    const Row& succ(VarIndex i) const { return this->_succ[i]; }
+
+    /// \brief Return the successors of vertex i
+    Row& succ(VarIndex i) { return this->_succ[i]; }
+
+    /// \brief Return the predecessors of vertex i
+    const PredSet& pred(VarIndex i) const { return this->_pred[i]; }
+
+    /// \brief Return true if the graph has no edge
+    bool empty() const {
+      return std::all_of(this->_succ.begin(),
+                         this->_succ.end(),
+                         [](const Row& row) { return row.empty(); });
+    }
+
+    /// \brief Return the weight of the edge i -> j, if any
+    boost::optional< const BoundT& > edge(VarIndex i, VarIndex j) const {
+      const Row& row = this->_succ[i];
+      auto it = row.find(j);
+      if (it == row.end()) {
+        return boost::none;
+      } else {
+        return it->second;
+      }
+    }
+
+    /// \brief Tighten the weight of the edge i -> j to w
+    ///
+    /// \returns true if the graph changed
+    bool tighten(VarIndex i, VarIndex j, const BoundT& w) {
+      ikos_assert(i != j);
+      if (w.is_plus_infinity()) {
+        return false;
+      }
+
+      Row& row = this->_succ[i];
+      auto it = row.find(j);
+      if (it == row.end()) {
+        row.emplace(j, w);
+        this->_pred[j].insert(i);
+        return true;
+      } else if (w < it->second) {
+        it->second = w;
+        return true;
+      } else {
+        return false;
+      }
+    }
+
+    /// \brief Remove all edges adjacent to vertex k
+    void remove_edges(VarIndex k) {
+      for (const auto& e : this->_succ[k]) {
+        this->_pred[e.first].erase(k);
+      }
+      this->_succ[k].clear();
+      for (VarIndex i : this->_pred[k]) {
+        this->_succ[i].erase(k);
+      }
+      this->_pred[k].clear();
+    }
+
+    /// \brief Clear the graph
+    void clear() {
+      this->_succ.clear();
+      this->_pred.clear();
+    }
+
+    /// \brief Floyd-Warshall step, using k as a pivot
+    ///
+    /// Only the pairs (i, j) with an edge i -> k and k -> j are visited.
+    ///
+    /// \returns false if a negative cycle was found
+    bool close_through(VarIndex k) {
+      // Edges created here are not adjacent to k, thus `_pred[k]` and
+      // `_succ[k]` are not modified in the loop.
+      for (VarIndex i : this->_pred[k]) {
+        const BoundT w_i_k = this->_succ[i].find(k)->second;
+
+        for (const auto& e : this->_succ[k]) {
+          if (e.first == i) {
+            if (w_i_k + e.second < BoundT(0)) {
+              return false;
+            }
+          } else {
+            this->tighten(i, e.first, w_i_k + e.second);
+          }
+        }
+      }
+
+      return true;
+    }
+
+    /// \brief Print the graph, for debugging purpose
+    void dump(std::ostream& o) const {
+      for (VarIndex i = 0; i < this->num_vertices(); i++) {
+        for (const auto& e : this->_succ[i]) {
+          o << "w(" << i << ", " << e.first << ") = " << e.second << "; ";
+        }
+      }
+    }
+
+  }; // end class Graph
+
+private:
+  bool _is_bottom;
+  bool _is_normalized;
+
+  /// \brief True if the graph needs a full closure
+  ///
+  /// Otherwise, the graph only needs an incremental closure through
+  /// `_dirty_vars`.
+  bool _needs_full_closure;
+
+  /// \brief Bounds of the variables
+  std::vector< IntervalT > _intervals;
+
+  /// \brief Difference constraints
+  Graph _graph;
+
+  VarIndexMap _var_index_map;
+
+  /// \brief Indices of forgotten variables, that can be reused
+  std::vector< VarIndex > _free_indices;
+
+  /// \brief Variables whose edges were tightened since the last
+  /// normalization
+  std::vector< VarIndex > _dirty_vars;
+
+private:
+  struct TopTag {};
+  struct BottomTag {};
+
+  /// \brief Create the top abstract value
+  explicit SparseDBM(TopTag)
+      : _is_bottom(false), _is_normalized(true), _needs_full_closure(false) {}
+
+  /// \brief Create the bottom abstract value
+  explicit SparseDBM(BottomTag)
+      : _is_bottom(true), _is_normalized(true), _needs_full_closure(false) {}
+
+public:
+  /// \brief Create the top abstract value
+  static SparseDBM top() { return SparseDBM(TopTag{}); }
+
+  /// \brief Create the bottom abstract value
+  static SparseDBM bottom() { return SparseDBM(BottomTag{}); }
+
+  /// \brief Copy constructor
+  SparseDBM(const SparseDBM&) = default;
+
+  /// \brief Move constructor
+  SparseDBM(SparseDBM&&) = default;
+
+  /// \brief Copy assignment operator
+  SparseDBM& operator=(const SparseDBM&) = default;
+
+  /// \brief Move assignment operator
+  SparseDBM& operator=(SparseDBM&&) = default;
+
+  /// \brief Destructor
+  ~SparseDBM() override = default;
+
+  /// \brief Normalize the sparse difference bound matrix
+  ///
+  /// Close the graph of difference constraints, then propagate the bounds
+  /// of the variables along the edges.
+  void normalize() const override {
+    if (this->_is_normalized) {
+      return;
+    }
+
+    auto self = const_cast< SparseDBM* >(this);
+
+    if (this->_is_bottom) {
+      self->_is_normalized = true;
+      self->_needs_full_closure = false;
+      self->_dirty_vars.clear();
+      return;
+    }
+
+    bool consistent = true;
+    if (this->_needs_full_closure) {
+      // Floyd-Warshall algorithm
+      for (VarIndex k = 0; consistent && k < this->_graph.num_vertices();
+           k++) {
+        consistent = self->_graph.close_through(k);
+      }
+    } else {
+      // Incremental closure
+      for (auto it = this->_dirty_vars.begin();
+           consistent && it != this->_dirty_vars.end();
+           ++it) {
+        consistent = self->_graph.close_through(*it);
+      }
+    }
+
+    if (!consistent || !self->propagate_intervals()) {
+      self->set_to_bottom();
+      return;
+    }
+
+    self->_is_normalized = true;
+    self->_needs_full_closure = false;
+    self->_dirty_vars.clear();
+  }
+
+private:
+  /// \brief Propagate the bounds of the variables along the edges
+  ///
+  /// This is a Bellman-Ford algorithm from the implicit vertex 0, and
+  /// requires the graph to be free of negative cycles.
+  ///
+  /// \returns false if a variable has an empty interval
+  bool propagate_intervals() {
+    std::vector< VarIndex > worklist;
+    std::vector< bool > in_worklist(this->_intervals.size(), true);
+    worklist.reserve(this->_intervals.size());
+
+    for (VarIndex i = 0; i < this->_intervals.size(); i++) {
+      if (this->_intervals[i].is_bottom()) {
+        return false;
+      }
+      worklist.push_back(i);
+    }
+
+    while (!worklist.empty()) {
+      VarIndex i = worklist.back();
+      worklist.pop_back();
+      in_worklist[i] = false;
+
+      const IntervalT& itv_i = this->_intervals[i];
+
+      // v_j <= ub(v_i) + w(i, j)
+      if (!itv_i.ub().is_plus_infinity()) {
+        for (const auto& e : this->_graph.succ(i)) {
+          if (this->refine_bound(e.first,
+                                 BoundT::minus_infinity(),
+                                 itv_i.ub() + e.second)) {
+            if (this->_intervals[e.first].is_bottom()) {
+              return false;
+            }
+            if (!in_worklist[e.first]) {
+              in_worklist[e.first] = true;
+              worklist.push_back(e.first);
+            }
+          }
+        }
+      }
+
+      // v_j >= lb(v_i) - w(j, i)
+      if (!itv_i.lb().is_minus_infinity()) {
+        for (VarIndex j : this->_graph.pred(i)) {
+          const BoundT& w = *this->_graph.edge(j, i);
+          if (this->refine_bound(j,
+                                 itv_i.lb() - w,
+                                 BoundT::plus_infinity())) {
+            if (this->_intervals[j].is_bottom()) {
+              return false;
+            }
+            if (!in_worklist[j]) {
+              in_worklist[j] = true;
+              worklist.push_back(j);
+            }
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+
+  /// \brief Refine the interval of v_i with [lb, ub]
+  ///
+  /// \returns true if the interval changed
+  bool refine_bound(VarIndex i, const BoundT& lb, const BoundT& ub) {
+    IntervalT& itv = this->_intervals[i];
+    if (itv.is_bottom()) {
+      return false;
+    }
+
+    bool changed = false;
+    BoundT new_lb = itv.lb();
+    BoundT new_ub = itv.ub();
+    if (new_lb < lb) {
+      new_lb = lb;
+      changed = true;
+    }
+    if (ub < new_ub) {
+      new_ub = ub;
+      changed = true;
+    }
+
+    if (changed) {
+      itv = IntervalT(std::move(new_lb), std::move(new_ub));
+    }
+    return changed;
+  }
+
+  /// \brief Return the tightest bound of v_j - v_i
+  ///
+  /// Requires normalization.
+  BoundT tightest_bound(VarIndex i, VarIndex j) const {
+    BoundT w = this->implied_bound(i, j);
+    if (auto e = this->_graph.edge(i, j)) {
+      if (*e < w) {
+        w = *e;
+      }
+    }
+    return w;
+  }
+
+  /// \brief Return the bound of v_j - v_i implied by the intervals
+  BoundT implied_bound(VarIndex i, VarIndex j) const {
+    const IntervalT& itv_i = this->_intervals[i];
+    const IntervalT& itv_j = this->_intervals[j];
+    if (itv_j.ub().is_plus_infinity() || itv_i.lb().is_minus_infinity()) {
+      return BoundT::plus_infinity();
+    } else {
+      return itv_j.ub() - itv_i.lb();
+    }
+  }
+
+public:
+  bool is_bottom() const override {
+    this->normalize();
+    return this->_is_bottom;
+  }
+
+  bool is_top() const override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return false;
+    }
+
+    return this->_graph.empty() &&
+           std::all_of(this->_intervals.begin(),
+                       this->_intervals.end(),
+                       [](const IntervalT& itv) { return itv.is_top(); });
+  }
+
+  void set_to_bottom() override {
+    this->_is_bottom = true;
+    this->_is_normalized = true;
+    this->_needs_full_closure = false;
+    this->_intervals.clear();
+    this->_graph.clear();
+    this->_var_index_map.clear();
+    this->_free_indices.clear();
+    this->_dirty_vars.clear();
+  }
+
+  void set_to_top() override {
+    this->_is_bottom = false;
+    this->_is_normalized = true;
+    this->_needs_full_closure = false;
+    this->_intervals.clear();
+    this->_graph.clear();
+    this->_var_index_map.clear();
+    this->_free_indices.clear();
+    this->_dirty_vars.clear();
+  }
+
+  bool leq(const SparseDBM& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->_is_bottom) {
+      return true;
+    }
+
+    if (other._is_bottom) {
+      return false;
+    }
+
+    // Index of the variables of `other` in `this`
+    const VarIndex none = std::numeric_limits< VarIndex >::max();
+    std::vector< VarIndex > index(other._intervals.size(), none);
+
+    for (const auto& p : other._var_index_map) {
+      auto it = this->_var_index_map.find(p.first);
+      if (it != this->_var_index_map.end()) {
+        index[p.second] = it->second;
+        if (!this->_intervals[it->second].leq(other._intervals[p.second])) {
+          return false;
+        }
+      } else if (!other._intervals[p.second].is_top()) {
+        return false;
+      }
+    }
+
+    // Check that the constraints of `other` are implied by `this`
+    for (VarIndex i = 0; i < other._graph.num_vertices(); i++) {
+      for (const auto& e : other._graph.succ(i)) {
+        if (index[i] == none || index[e.first] == none ||
+            !(this->tightest_bound(index[i], index[e.first]) <= e.second)) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  bool equals(const SparseDBM& other) const override {
+    return this->leq(other) && other.leq(*this);
+  }
+
+private:
+  /// \brief Index of a variable in both operands of a binary operation
+  struct IndexPair {
+    VarIndex left;
+    VarIndex right;
+  };
+
+  /// \brief Build the variables of the result of a binary operation
+  ///
+  /// If `keep_all` is true, the result contains the variables of both
+  /// operands, otherwise it only contains the common variables.
+  ///
+  /// Returns the result, with top intervals, and fills `vars` with the
+  /// indices of the result variables in `this` and `other`, and the maps
+  /// from the indices in `this` and `other` to the result indices.
+  SparseDBM merge_variables(const SparseDBM& other,
+                            bool keep_all,
+                            std::vector< IndexPair >& vars,
+                            std::vector< VarIndex >& left_map,
+                            std::vector< VarIndex >& right_map) const {
+    const VarIndex none = std::numeric_limits< VarIndex >::max();
+    auto result = SparseDBM::top();
+
+    left_map.assign(this->_intervals.size(), none);
+    right_map.assign(other._intervals.size(), none);
+    vars.reserve(this->_var_index_map.size());
+
+    for (auto l = this->_var_index_map.begin(),
+              r = other._var_index_map.begin();
+         l != this->_var_index_map.end() || r != other._var_index_map.end();) {
+      auto next_index = static_cast< VarIndex >(vars.size());
+
+      if (l == this->_var_index_map.end() ||
+          (r != other._var_index_map.end() && r->first < l->first)) {
+        // Variable in `other` but not in `this`
+        if (keep_all) {
+          result._var_index_map.emplace_hint(result._var_index_map.end(),
+                                             r->first,
+                                             next_index);
+          vars.push_back(IndexPair{none, r->second});
+          right_map[r->second] = next_index;
+        }
+        ++r;
+      } else if (r == other._var_index_map.end() || l->first < r->first) {
+        // Variable in `this` but not in `other`
+        if (keep_all) {
+          result._var_index_map.emplace_hint(result._var_index_map.end(),
+                                             l->first,
+                                             next_index);
+          vars.push_back(IndexPair{l->second, none});
+          left_map[l->second] = next_index;
+        }
+        ++l;
+      } else {
+        ikos_assert(l->first == r->first);
+        result._var_index_map.emplace_hint(result._var_index_map.end(),
+                                           l->first,
+                                           next_index);
+        vars.push_back(IndexPair{l->second, r->second});
+        left_map[l->second] = next_index;
+        right_map[r->second] = next_index;
+        ++l;
+        ++r;
+      }
+    }
+
+    result._intervals.assign(vars.size(), IntervalT::top());
+    result._graph = Graph(static_cast< VarIndex >(vars.size()));
+    return result;
+  }
+
+  /// \brief Add the edges of `from` to `result`, using min
+  static void meet_edges(const SparseDBM& from,
+                         const std::vector< VarIndex >& map,
+                         SparseDBM& result) {
+    for (VarIndex i = 0; i < from._graph.num_vertices(); i++) {
+      for (const auto& e : from._graph.succ(i)) {
+        result._graph.tighten(map[i], map[e.first], e.second);
+      }
+    }
+  }
+
+public:
+  SparseDBM join(const SparseDBM& other) const override {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->_is_bottom) {
+      return other;
+    } else if (other._is_bottom) {
+      return *this;
+    }
+
+    const VarIndex none = std::numeric_limits< VarIndex >::max();
+    std::vector< IndexPair > vars;
+    std::vector< VarIndex > left_map;
+    std::vector< VarIndex > right_map;
+    SparseDBM result =
+        this->merge_variables(other, false, vars, left_map, right_map);
+
+    // Variables whose lower (resp. upper) bound is finite in both operands,
+    // but different. Otherwise, the join of the bounds implied by the
+    // intervals is implied by the result intervals.
+    std::vector< VarIndex > lb_changed;
+    std::vector< VarIndex > ub_changed;
+
+    for (VarIndex k = 0; k < vars.size(); k++) {
+      const IntervalT& left = this->_intervals[vars[k].left];
+      const IntervalT& right = other._intervals[vars[k].right];
+      result._intervals[k] = left.join(right);
+
+      if (left.lb().is_finite() && right.lb().is_finite() &&
+          left.lb() != right.lb()) {
+        lb_changed.push_back(k);
+      }
+      if (left.ub().is_finite() && right.ub().is_finite() &&
+          left.ub() != right.ub()) {
+        ub_changed.push_back(k);
+      }
+    }
+
+    // Join the tightest bounds of v_j - v_i, and only keep the ones that are
+    // not implied by the result intervals
+    auto join_edge = [&](VarIndex i, VarIndex j) {
+      if (i == j) {
+        return;
+      }
+      BoundT w = max(this->tightest_bound(vars[i].left, vars[j].left),
+                     other.tightest_bound(vars[i].right, vars[j].right));
+      if (w < result.implied_bound(i, j)) {
+        result._graph.tighten(i, j, w);
+      }
+    };
+
+    for (VarIndex i = 0; i < this->_graph.num_vertices(); i++) {
+      if (left_map[i] != none) {
+        for (const auto& e : this->_graph.succ(i)) {
+          if (left_map[e.first] != none) {
+            join_edge(left_map[i], left_map[e.first]);
+          }
+        }
+      }
+    }
+    for (VarIndex i = 0; i < other._graph.num_vertices(); i++) {
+      if (right_map[i] != none) {
+        for (const auto& e : other._graph.succ(i)) {
+          if (right_map[e.first] != none) {
+            join_edge(right_map[i], right_map[e.first]);
+          }
+        }
+      }
+    }
+    for (VarIndex i : lb_changed) {
+      for (VarIndex j : ub_changed) {
+        join_edge(i, j);
+      }
+    }
+
+    // The join is normalized by construction
+    return result;
+  }
+
+  void join_with(const SparseDBM& other) override {
+    this->operator=(this->join(other));
+  }
+
+private:
+  /// \brief Widening of the upper bounds x and y, with an optional threshold
+  static BoundT widen_bound(const BoundT& x,
+                            const BoundT& y,
+                            const boost::optional< Number >& threshold) {
+    if (y <= x) {
+      return x;
+    } else if (threshold && BoundT(*threshold) >= y) {
+      return BoundT(*threshold);
+    } else {
+      return BoundT::plus_infinity();
+    }
+  }
+
+  /// \brief Narrowing of the upper bounds x and y, with an optional threshold
+  static BoundT narrow_bound(const BoundT& x,
+                             const BoundT& y,
+                             const boost::optional< Number >& threshold) {
+    if (x.is_plus_infinity() || (threshold && x == BoundT(*threshold))) {
+      return y;
+    } else {
+      return x;
+    }
+  }
+
+  /// \brief Apply a binary operator on upper bounds to the bounds of two
+  /// intervals, as `DBM` does on the edges from and to the vertex 0
+  template < typename BoundOperator >
+  static IntervalT apply_on_bounds(const IntervalT& left,
+                                   const IntervalT& right,
+                                   const BoundOperator& op) {
+    if (left.is_bottom() || right.is_bottom()) {
+      return IntervalT::bottom();
+    }
+    return IntervalT(-op(-left.lb(), -right.lb()), op(left.ub(), right.ub()));
+  }
+
+  /// \brief Widening, with or without threshold
+  SparseDBM widening_op(const SparseDBM& other,
+                        const boost::optional< Number >& threshold) const {
+    // Requires the normalization of the right operand.
+    // The left operand (this) should not be normalized.
+    other.normalize();
+
+    if (this->_is_bottom) {
+      return other;
+    } else if (other._is_bottom) {
+      return *this;
+    }
+
+    std::vector< IndexPair > vars;
+    std::vector< VarIndex > left_map;
+    std::vector< VarIndex > right_map;
+    SparseDBM result =
+        this->merge_variables(other, false, vars, left_map, right_map);
+
+    for (VarIndex k = 0; k < vars.size(); k++) {
+      const IntervalT& left = this->_intervals[vars[k].left];
+      const IntervalT& right = other._intervals[vars[k].right];
+      if (left.is_bottom()) {
+        result._intervals[k] = right;
+      } else if (right.is_bottom()) {
+        result._intervals[k] = left;
+      } else {
+        result._intervals[k] =
+            apply_on_bounds(left,
+                            right,
+                            [&](const BoundT& x, const BoundT& y) {
+                              return widen_bound(x, y, threshold);
+                            });
+      }
+    }
+
+    // Only keep the stable edges of the left operand
+    const VarIndex none = std::numeric_limits< VarIndex >::max();
+    for (VarIndex i = 0; i < this->_graph.num_vertices(); i++) {
+      if (left_map[i] == none) {
+        continue;
+      }
+
+      for (const auto& e : this->_graph.succ(i)) {
+        VarIndex j = left_map[e.first];
+        if (j == none) {
+          continue;
+        }
+
+        BoundT w = other.tightest_bound(vars[left_map[i]].right,
+                                        vars[j].right);
+        result._graph.tighten(left_map[i],
+                              j,
+                              widen_bound(e.second, w, threshold));
+      }
+    }
+
+    result._is_normalized = false;
+    result._needs_full_closure = true;
+    return result;
+  }
+
+public:
+  SparseDBM widening(const SparseDBM& other) const override {
+    return this->widening_op(other, boost::none);
+  }
+
+  void widen_with(const SparseDBM& other) override {
+    this->operator=(this->widening(other));
+  }
+
+  SparseDBM widening_threshold(const SparseDBM& other,
+                               const Number& threshold) const override {
+    return this->widening_op(other, boost::optional< Number >(threshold));
+  }
+
+  void widen_threshold_with(const SparseDBM& other,
+                            const Number& threshold) override {
+    this->operator=(this->widening_threshold(other, threshold));
+  }
+
+  SparseDBM meet(const SparseDBM& other) const override {
+    // Does not require normalization
+
+    if (this->_is_bottom || other._is_bottom) {
+      return bottom();
+    }
+
+    const VarIndex none = std::numeric_limits< VarIndex >::max();
+    std::vector< IndexPair > vars;
+    std::vector< VarIndex > left_map;
+    std::vector< VarIndex > right_map;
+    SparseDBM result =
+        this->merge_variables(other, true, vars, left_map, right_map);
+
+    for (VarIndex k = 0; k < vars.size(); k++) {
+      if (vars[k].right == none) {
+        result._intervals[k] = this->_intervals[vars[k].left];
+      } else if (vars[k].left == none) {
+        result._intervals[k] = other._intervals[vars[k].right];
+      } else {
+        result._intervals[k] = this->_intervals[vars[k].left].meet(
+            other._intervals[vars[k].right]);
+      }
+    }
+
+    meet_edges(*this, left_map, result);
+    meet_edges(other, right_map, result);
+
+    result._is_normalized = false;
+    result._needs_full_closure = true;
+    return result;
+  }
+
+  void meet_with(const SparseDBM& other) override {
+    this->operator=(this->meet(other));
+  }
+
+private:
+  /// \brief Narrowing, with or without threshold
+  SparseDBM narrowing_op(const SparseDBM& other,
+                         const boost::optional< Number >& threshold) const {
+    // Requires normalization
+    this->normalize();
+    other.normalize();
+
+    if (this->_is_bottom || other._is_bottom) {
+      return bottom();
+    }
+
+    const VarIndex none = std::numeric_limits< VarIndex >::max();
+    std::vector< IndexPair > vars;
+    std::vector< VarIndex > left_map;
+    std::vector< VarIndex > right_map;
+    SparseDBM result =
+        this->merge_variables(other, true, vars, left_map, right_map);
+
+    for (VarIndex k = 0; k < vars.size(); k++) {
+      if (vars[k].right == none) {
+        result._intervals[k] = this->_intervals[vars[k].left];
+      } else if (vars[k].left == none) {
+        result._intervals[k] = other._intervals[vars[k].right];
+      } else {
+        result._intervals[k] =
+            apply_on_bounds(this->_intervals[vars[k].left],
+                            other._intervals[vars[k].right],
+                            [&](const BoundT& x, const BoundT& y) {
+                              return narrow_bound(x, y, threshold);
+                            });
+      }
+    }
+
+    // Keep the edges of the left operand, and use the edges of the right
+    // operand where the left operand is unbounded (or at the threshold)
+    for (VarIndex i = 0; i < this->_graph.num_vertices(); i++) {
+      for (const auto& e : this->_graph.succ(i)) {
+        if (!threshold || e.second != BoundT(*threshold)) {
+          result._graph.tighten(left_map[i], left_map[e.first], e.second);
+        }
+      }
+    }
+    for (VarIndex i = 0; i < other._graph.num_vertices(); i++) {
+      for (const auto& e : other._graph.succ(i)) {
+        VarIndex ri = right_map[i];
+        VarIndex rj = right_map[e.first];
+        boost::optional< const BoundT& > left_edge;
+        if (vars[ri].left != none && vars[rj].left != none) {
+          left_edge = this->_graph.edge(vars[ri].left, vars[rj].left);
+        }
+        if (!left_edge || (threshold && *left_edge == BoundT(*threshold))) {
+          result._graph.tighten(ri, rj, e.second);
+        }
+      }
+    }
+
+    result._is_normalized = false;
+    result._needs_full_closure = true;
+    return result;
+  }
+
+public:
+  SparseDBM narrowing(const SparseDBM& other) const override {
+    return this->narrowing_op(other, boost::none);
+  }
+
+  void narrow_with(const SparseDBM& other) override {
+    this->operator=(this->narrowing(other));
+  }
+
+  SparseDBM narrowing_threshold(const SparseDBM& other,
+                                const Number& threshold) const override {
+    return this->narrowing_op(other, boost::optional< Number >(threshold));
+  }
+
+  void narrow_threshold_with(const SparseDBM& other,
+                             const Number& threshold) override {
+    this->operator=(this->narrowing_threshold(other, threshold));
+  }
+
+private:
+  /// \brief Get the index of variable x in the graph
+  ///
+  /// Create a new one if not found
+  VarIndex var_index(VariableRef x) {
+    auto it = this->_var_index_map.find(x);
+    if (it != this->_var_index_map.end()) {
+      return it->second;
+    }
+
+    VarIndex i;
+    if (this->_free_indices.empty()) {
+      i = this->_graph.add_vertex();
+      this->_intervals.push_back(IntervalT::top());
+    } else {
+      i = this->_free_indices.back();
+      this->_free_indices.pop_back();
+    }
+    this->_var_index_map.emplace(x, i);
+    return i;
+  }
+
+  /// \brief Mark the edges of v_i as tightened
+  void mark_dirty(VarIndex i) {
+    this->_is_normalized = false;
+    if (!this->_needs_full_closure &&
+        std::find(this->_dirty_vars.begin(), this->_dirty_vars.end(), i) ==
+            this->_dirty_vars.end()) {
+      this->_dirty_vars.push_back(i);
+    }
+  }
+
+  /// \brief Add constraint v_i - v_j <= c
+  void add_difference(VarIndex i, VarIndex j, const BoundT& c) {
+    if (this->_graph.tighten(j, i, c)) {
+      this->mark_dirty(i);
+      this->mark_dirty(j);
+    }
+  }
+
+  /// \brief Add constraint v_i - v_j <= c
+  void add_difference(VarIndex i, VarIndex j, const Number& c) {
+    this->add_difference(i, j, BoundT(c));
+  }
+
+  /// \brief Add constraint lb <= v_i <= ub
+  void add_bounds(VarIndex i, const BoundT& lb, const BoundT& ub) {
+    if (this->refine_bound(i, lb, ub)) {
+      this->_is_normalized = false;
+    }
+  }
+
+  /// \brief Set the bounds of v_i, assuming it has no constraint
+  void set_bounds(VarIndex i, const IntervalT& value) {
+    ikos_assert(this->_graph.succ(i).empty() && this->_graph.pred(i).empty());
+    this->_intervals[i] = value;
+    if (value.is_bottom()) {
+      this->_is_normalized = false;
+    }
+  }
+
+  /// \brief Apply v_i = v_i + c
+  void increment(VarIndex i, const Number& c) {
+    if (c == 0) {
+      return;
+    }
+
+    const BoundT b(c);
+    this->_intervals[i] += IntervalT(c);
+    for (auto& e : this->_graph.succ(i)) {
+      e.second -= b;
+    }
+    for (VarIndex j : this->_graph.pred(i)) {
+      this->_graph.succ(j).find(i)->second += b;
+    }
+
+    // Shifting a variable preserves the closure
+  }
+
+  /// \brief Add constraint x = y + c
+  void assign_difference(VariableRef x, VariableRef y, const Number& c) {
+    VarIndex i = this->var_index(x);
+    if (x == y) {
+      this->increment(i, c);
+    } else {
+      VarIndex j = this->var_index(y);
+      this->forget(i);
+      if (this->_is_bottom) {
+        return;
+      }
+      this->add_difference(i, j, c);
+      this->add_difference(j, i, -c);
+    }
+  }
+
+  /// \brief Add a constraint of the form `+/- x <= c`, `+/- x = c`,
+  /// `x - y <= c` or `x - y = c`
+  ///
+  /// \returns false if the constraint has another form
+  bool add_difference_constraint(const LinearConstraintT& cst) {
+    if (!cst.is_inequality() && !cst.is_equality()) {
+      return false;
+    }
+
+    auto it = cst.begin();
+    auto it2 = ++cst.begin();
+    const Number& c = cst.constant();
+
+    if (cst.num_terms() == 1 && (it->second == 1 || it->second == -1)) {
+      VarIndex i = this->var_index(it->first);
+      BoundT ub = (it->second == 1) ? BoundT(c) : BoundT::plus_infinity();
+      BoundT lb = (it->second == 1) ? BoundT::minus_infinity() : BoundT(-c);
+      if (cst.is_equality()) {
+        ub = BoundT(it->second == 1 ? c : -c);
+        lb = ub;
+      }
+      this->add_bounds(i, lb, ub);
+      return true;
+    }
+
+    VarIndex i;
+    VarIndex j;
+    if (cst.num_terms() == 2 && it->second == 1 && it2->second == -1) {
+      i = this->var_index(it->first);
+      j = this->var_index(it2->first);
+    } else if (cst.num_terms() == 2 && it->second == -1 && it2->second == 1) {
+      i = this->var_index(it2->first);
+      j = this->var_index(it->first);
+    } else {
+      return false;
+    }
+
+    this->add_difference(i, j, c);
+    if (cst.is_equality()) {
+      this->add_difference(j, i, -c);
+    }
+    return true;
+  }
+
+public:
+  void assign(VariableRef x, int n) override { this->assign(x, Number(n)); }
+
+  void assign(VariableRef x, const Number& n) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    VarIndex i = this->var_index(x);
+    this->forget(i);
+    if (this->_is_bottom) {
+      return;
+    }
+    this->set_bounds(i, IntervalT(n));
+  }
+
+  void assign(VariableRef x, VariableRef y) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    this->assign_difference(x, y, Number(0));
+  }
+
+  void assign(VariableRef x, const LinearExpressionT& e) override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (e.is_constant()) { // x = c
+      this->assign(x, e.constant());
+      return;
+    }
+
+    if (e.num_terms() == 1 && e.begin()->second == 1) { // x = y + c
+      this->assign_difference(x, e.begin()->first, e.constant());
+      return;
+    }
+
+    // Projection using intervals, requires normalization
+    this->normalize();
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    this->set(x, this->to_interval(e));
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             VariableRef z) override {
+    // Requires normalization
+    this->normalize();
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    IntervalT v_y = this->to_interval(y);
+    IntervalT v_z = this->to_interval(z);
+
+    if (v_z.singleton()) {
+      this->apply(op, x, y, *v_z.singleton());
+    } else if (v_y.singleton()) {
+      this->apply(op, x, *v_y.singleton(), z);
+    } else {
+      this->set(x, apply_bin_operator(op, v_y, v_z));
+    }
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             VariableRef y,
+             const Number& z) override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    switch (op) {
+      case BinaryOperator::Add: {
+        this->assign_difference(x, y, z);
+      } break;
+      case BinaryOperator::Sub: {
+        this->assign_difference(x, y, -z);
+      } break;
+      case BinaryOperator::Mul:
+      case BinaryOperator::Div: {
+        if (z == 1) { // x = y
+          this->assign_difference(x, y, Number(0));
+        } else {
+          // Requires normalization
+          this->normalize();
+
+          if (this->_is_bottom) {
+            return;
+          }
+
+          this->set(x,
+                    apply_bin_operator(op, this->to_interval(y), IntervalT(z)));
+        }
+      } break;
+      case BinaryOperator::Mod: {
+        if (z == 0) {
+          this->set_to_bottom();
+          return;
+        }
+
+        // Requires normalization
+        this->normalize();
+
+        if (this->_is_bottom) {
+          return;
+        }
+
+        IntervalT v_y = this->to_interval(y);
+        boost::optional< Number > n = v_y.mod_to_sub(z);
+
+        if (n) {
+          // Equivalent to x = y - n
+          this->assign_difference(x, y, -(*n));
+        } else {
+          this->set(x, IntervalT(BoundT(0), BoundT(abs(z) - 1)));
+
+          if (this->_is_bottom) {
+            return;
+          }
+
+          // If y < abs(z) then x >= y
+          if (v_y.ub() < BoundT(abs(z))) {
+            VarIndex i = this->var_index(x);
+            VarIndex j = this->var_index(y);
+            this->add_difference(j, i, Number(0));
+          }
+
+          // If y >= -abs(z) then x <= y + abs(z)
+          if (v_y.lb() >= BoundT(-abs(z))) {
+            VarIndex i = this->var_index(x);
+            VarIndex j = this->var_index(y);
+            this->add_difference(i, j, abs(z));
+          }
+        }
+      } break;
+      case BinaryOperator::Rem:
+      case BinaryOperator::Shl:
+      case BinaryOperator::Shr:
+      case BinaryOperator::And:
+      case BinaryOperator::Or:
+      case BinaryOperator::Xor: {
+        // Requires normalization
+        this->normalize();
+
+        if (this->_is_bottom) {
+          return;
+        }
+
+        this->set(x,
+                  apply_bin_operator(op, this->to_interval(y), IntervalT(z)));
+      } break;
+    }
+  }
+
+  void apply(BinaryOperator op,
+             VariableRef x,
+             const Number& y,
+             VariableRef z) override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (op == BinaryOperator::Add) { // x = y + z
+      this->assign_difference(x, z, y);
+    } else if (op == BinaryOperator::Mul && y == 1) { // x = z
+      this->assign_difference(x, z, Number(0));
+    } else {
+      // Requires normalization
+      this->normalize();
+
+      if (this->_is_bottom) {
+        return;
+      }
+
+      this->set(x, apply_bin_operator(op, IntervalT(y), this->to_interval(z)));
+    }
+  }
+
+  void add(const LinearConstraintT& cst) override {
+    // Does not require normalization
+
+    if (this->_is_bottom) {
+      return;
+    }
+
+    if (cst.num_terms() == 0) {
+      if (cst.is_contradiction()) {
+        this->set_to_bottom();
+      }
+      return;
+    }
+
+    if (!this->add_difference_constraint(cst)) {
+      // use the linear interval solver
+      this->normalize();
+
+      if (this->_is_bottom) {
+        return;
+      }
+
+      LinearIntervalSolverT solver(MaxReductionCycles);
+      solver.add(cst);
+      solver.run(*this);
+    }
+  }
+
+  void add(const LinearConstraintSystemT& csts) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    LinearIntervalSolverT solver(MaxReductionCycles);
+
+    for (const LinearConstraintT& cst : csts) {
+      // process each constraint
+      if (cst.num_terms() == 0) {
+        if (cst.is_contradiction()) {
+          this->set_to_bottom();
+          return;
+        }
+      } else if (!this->add_difference_constraint(cst)) {
+        solver.add(cst);
+      }
+    }
+
+    if (!solver.empty()) {
+      // use the linear interval solver
+      this->normalize();
+
+      if (this->_is_bottom) {
+        return;
+      }
+
+      solver.run(*this);
+    }
+  }
+
+  void set(VariableRef x, const IntervalT& value) override {
+    if (this->_is_bottom) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      VarIndex i = this->var_index(x);
+      this->forget(i);
+      if (this->_is_bottom) {
+        return;
+      }
+      this->set_bounds(i, value);
+    }
+  }
+
+  void set(VariableRef x, const CongruenceT& value) override {
+    if (this->_is_bottom) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      VarIndex i = this->var_index(x);
+      this->forget(i);
+      if (this->_is_bottom) {
+        return;
+      }
+      boost::optional< Number > n = value.singleton();
+      if (n) {
+        this->set_bounds(i, IntervalT(*n));
+      }
+    }
+  }
+
+  void set(VariableRef x, const IntervalCongruenceT& value) override {
+    this->set(x, value.interval());
+  }
+
+  void refine(VariableRef x, const IntervalT& value) override {
+    if (this->_is_bottom) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      VarIndex i = this->var_index(x);
+      this->add_bounds(i, value.lb(), value.ub());
+    }
+  }
+
+  void refine(VariableRef x, const CongruenceT& value) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      IntervalCongruenceT iv(this->to_interval(x), value);
+      this->refine(x, iv.interval());
+    }
+  }
+
+  void refine(VariableRef x, const IntervalCongruenceT& value) override {
+    if (this->is_bottom()) {
+      return;
+    } else if (value.is_bottom()) {
+      this->set_to_bottom();
+    } else {
+      IntervalCongruenceT iv(this->to_interval(x));
+      iv.meet_with(value);
+      this->refine(x, iv.interval());
+    }
+  }
+
+private:
+  /// \brief Forget all informations about variable k
+  void forget(VarIndex k) {
+    // Pivoting through k would create edges that are not adjacent to the
+    // dirty variables, finish the incremental closure instead
+    if (!this->_is_normalized && !this->_needs_full_closure) {
+      this->normalize();
+      if (this->_is_bottom) {
+        return;
+      }
+    }
+
+    // Use informations about k to improve all constraints
+    // Not necessary if already normalized
+    if (!this->_is_normalized) {
+      if (!this->_graph.close_through(k)) {
+        this->set_to_bottom();
+        return;
+      }
+
+      const IntervalT itv_k = this->_intervals[k];
+      if (itv_k.is_bottom()) {
+        this->set_to_bottom();
+        return;
+      }
+      for (const auto& e : this->_graph.succ(k)) {
+        if (!itv_k.ub().is_plus_infinity()) {
+          this->refine_bound(e.first,
+                             BoundT::minus_infinity(),
+                             itv_k.ub() + e.second);
+        }
+      }
+      for (VarIndex j : this->_graph.pred(k)) {
+        if (!itv_k.lb().is_minus_infinity()) {
+          this->refine_bound(j,
+                             itv_k.lb() - *this->_graph.edge(j, k),
+                             BoundT::plus_infinity());
+        }
+      }
+    }
+
+    this->_graph.remove_edges(k);
+    this->_intervals[k] = IntervalT::top();
+
+    // Removing a variable preserves the closure
+  }
+
+public:
+  void forget(VariableRef x) override {
+    if (this->_is_bottom) {
+      return;
+    }
+
+    auto it = this->_var_index_map.find(x);
+    if (it != this->_var_index_map.end()) {
+      this->forget(it->second);
+      if (this->_is_bottom) {
+        return;
+      }
+      this->_free_indices.push_back(it->second);
+      this->_var_index_map.erase(it);
+    }
+  }
+
+private:
+  struct GetVar {
+    const VariableRef& operator()(
+        const std::pair< VariableRef, VarIndex >& p) const {
+      return p.first;
+    }
+  };
+
+public:
+  /// \brief Iterator over a list of variables
+  using VariableIterator =
+      boost::transform_iterator< GetVar, typename VarIndexMap::const_iterator >;
+
+  /// \brief Begin iterator over the list of variables
+  VariableIterator var_begin() const {
+    return boost::make_transform_iterator(this->_var_index_map.cbegin(),
+                                          GetVar());
+  }
+
+  /// \brief End iterator over the list of variables
+  VariableIterator var_end() const {
+    return boost::make_transform_iterator(this->_var_index_map.cend(),
+                                          GetVar());
+  }
+
+  IntervalT to_interval(VariableRef x) const override {
+    if (this->_is_bottom) {
+      return IntervalT::bottom();
+    } else {
+      auto it = this->_var_index_map.find(x);
+
+      if (it == this->_var_index_map.cend()) {
+        return IntervalT::top();
+      } else {
+        return this->_intervals[it->second];
+      }
+    }
+  }
+
+  IntervalT to_interval(const LinearExpressionT& e) const override {
+    return Parent::to_interval(e);
+  }
+
+  CongruenceT to_congruence(VariableRef x) const override {
+    if (this->_is_bottom) {
+      return CongruenceT::bottom();
+    } else {
+      boost::optional< Number > n = this->to_interval(x).singleton();
+      if (n) {
+        return CongruenceT(*n);
+      } else {
+        return CongruenceT::top();
+      }
+    }
+  }
+
+  CongruenceT to_congruence(const LinearExpressionT& e) const override {
+    return Parent::to_congruence(e);
+  }
+
+  IntervalCongruenceT to_interval_congruence(VariableRef x) const override {
+    return IntervalCongruenceT(this->to_interval(x));
+  }
+
+  IntervalCongruenceT to_interval_congruence(
+      const LinearExpressionT& e) const override {
+    return Parent::to_interval_congruence(e);
+  }
+
+  LinearConstraintSystemT to_linear_constraint_system() const override {
+    this->normalize();
+
+    if (this->_is_bottom) {
+      return LinearConstraintSystemT(LinearConstraintT::contradiction());
+    }
+
+    // Map from index to variable
+    std::vector< const VariableRef* > vars(this->_intervals.size(), nullptr);
+    for (const auto& p : this->_var_index_map) {
+      vars[p.second] = &p.first;
+    }
+
+    LinearConstraintSystemT csts;
+    for (const auto& p : this->_var_index_map) {
+      csts.add(within_interval(p.first, this->_intervals[p.second]));
+    }
+    for (VarIndex i = 0; i < this->_graph.num_vertices(); i++) {
+      for (const auto& e : this->_graph.succ(i)) {
+        csts.add(within_interval(VariableExprT(*vars[e.first]) -
+                                     VariableExprT(*vars[i]),
+                                 IntervalT(BoundT::minus_infinity(),
+                                           e.second)));
+      }
+    }
+
+    return csts;
+  }
+
+  void dump(std::ostream& o) const override {
+    this->to_linear_constraint_system().dump(o);
+  }
+
+  static std::string name() { return "sparse-dbm"; }
+
+}; // end class SparseDBM
+
+} // end namespace numeric
+} // end namespace core
+} // end namespace ikos
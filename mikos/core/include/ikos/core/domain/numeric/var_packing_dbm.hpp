@@ -184,7 +184,7 @@ public:
       this->_inv.assign(x, e);
     } else {
       // Projection using intervals
-      this->_inv.normalize();
+      this->_inv.normalize_for_queries();
       this->_inv.set(x, this->_inv.to_interval(e));
     }
   }
@@ -193,9 +193,9 @@ public:
              VariableRef x,
              VariableRef y,
              VariableRef z) override {
-    this->_inv.normalize();
+    this->_inv.normalize_for_queries();
 
-    if (this->_inv.is_bottom()) {
+    if (this->_inv._is_bottom) {
       return;
     }
 
@@ -215,9 +215,9 @@ public:
              VariableRef x,
              VariableRef y,
              const Number& z) override {
-    this->_inv.normalize();
+    this->_inv.normalize_for_queries();
 
-    if (this->_inv.is_bottom()) {
+    if (this->_inv._is_bottom) {
       return;
     }
 
@@ -238,9 +238,9 @@ public:
              VariableRef x,
              const Number& y,
              VariableRef z) override {
-    this->_inv.normalize();
+    this->_inv.normalize_for_queries();
 
-    if (this->_inv.is_bottom()) {
+    if (this->_inv._is_bottom) {
       return;
     }
 
@@ -277,9 +277,9 @@ public:
          (cst.num_terms() == 2 && it->second == -1 && it2->second == 1))) {
       this->_inv.add(cst);
     } else {
-      this->_inv.normalize();
+      this->_inv.normalize_for_queries();
 
-      if (this->_inv.is_bottom()) {
+      if (this->_inv._is_bottom) {
         return;
       }
 
@@ -321,9 +321,9 @@ public:
     }
 
     if (!solver.empty()) {
-      this->_inv.normalize();
+      this->_inv.normalize_for_queries();
 
-      if (this->_inv.is_bottom()) {
+      if (this->_inv._is_bottom) {
         return;
       }
 
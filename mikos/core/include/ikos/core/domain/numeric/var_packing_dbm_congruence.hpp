@@ -90,9 +90,7 @@ private:
   /// \brief Reduce the equivalence class containing the variable `v`
   ///
   /// Does not normalize the entire domain.
-  ///
-  /// `need_copy` is false if we know that a copy has already been made.
-  void reduce_equivalence_class(VariableRef v, bool need_copy = true) {
+  void reduce_equivalence_class(VariableRef v) {
     if (this->_product.first()._inv._is_bottom ||
         this->_product.second().is_bottom()) {
       return;
@@ -104,9 +102,9 @@ private:
       return;
     }
 
-    std::shared_ptr< DBM< Number, VariableRef > > subdomain =
-        equiv_relation.find_domain(v);
-    subdomain->normalize();
+    const DBM< Number, VariableRef >* subdomain =
+        &equiv_relation.find_normalized_domain(v);
+    DBM< Number, VariableRef >* mutable_subdomain = nullptr;
 
     if (subdomain->is_bottom()) {
       this->set_to_bottom();
@@ -137,14 +135,13 @@ private:
         }
 
         if (val.interval() != i) {
-          if (need_copy) {
-            // need to copy the subdomain before updating it
-            equiv_relation.find_equiv_class(v).copy_domain();
-            subdomain = equiv_relation.find_domain(v);
-            need_copy = false;
+          if (mutable_subdomain == nullptr) {
+            // copy the subdomain before updating it, unless it is owned
+            mutable_subdomain = &equiv_relation.find_mutable_domain(v);
+            subdomain = mutable_subdomain;
           }
 
-          subdomain->refine(x, val.interval());
+          mutable_subdomain->refine(x, val.interval());
           change_dbm = true;
         }
 
@@ -155,7 +152,8 @@ private:
       }
 
       if (change_dbm) {
-        subdomain->normalize();
+        subdomain = &equiv_relation.find_normalized_domain(v);
+        mutable_subdomain = nullptr;
 
         if (subdomain->is_bottom()) {
           this->set_to_bottom();
@@ -298,12 +296,12 @@ public:
 
   void assign(VariableRef x, VariableRef y) override {
     this->_product.assign(x, y);
-    this->reduce_equivalence_class(x, false);
+    this->reduce_equivalence_class(x);
   }
 
   void assign(VariableRef x, const LinearExpressionT& e) override {
     this->_product.assign(x, e);
-    this->reduce_equivalence_class(x, false);
+    this->reduce_equivalence_class(x);
   }
 
   void apply(BinaryOperator op,
@@ -311,7 +309,7 @@ public:
              VariableRef y,
              VariableRef z) override {
     this->_product.apply(op, x, y, z);
-    this->reduce_equivalence_class(x, false);
+    this->reduce_equivalence_class(x);
   }
 
   void apply(BinaryOperator op,
@@ -319,7 +317,7 @@ public:
              VariableRef y,
              const Number& z) override {
     this->_product.apply(op, x, y, z);
-    this->reduce_equivalence_class(x, false);
+    this->reduce_equivalence_class(x);
   }
 
   void apply(BinaryOperator op,
@@ -327,7 +325,7 @@ public:
              const Number& y,
              VariableRef z) override {
     this->_product.apply(op, x, y, z);
-    this->reduce_equivalence_class(x, false);
+    this->reduce_equivalence_class(x);
   }
 
   void add(const LinearConstraintT& cst) override {
@@ -351,7 +349,7 @@ public:
          (cst.num_terms() == 2 && it->second == 1 && it2->second == -1) ||
          (cst.num_terms() == 2 && it->second == -1 && it2->second == 1))) {
       // variables are together in the same equivalence class
-      this->reduce_equivalence_class(it->first, false);
+      this->reduce_equivalence_class(it->first);
     } else {
       for (const auto& term : cst) {
         this->reduce_equivalence_class(term.first);
@@ -380,7 +378,7 @@ public:
              (cst.num_terms() == 2 && it->second == 1 && it2->second == -1) ||
              (cst.num_terms() == 2 && it->second == -1 && it2->second == 1))) {
           // variables are together in the same equivalence class
-          this->reduce_equivalence_class(it->first, false);
+          this->reduce_equivalence_class(it->first);
         } else {
           for (const auto& term : cst) {
             this->reduce_equivalence_class(term.first);
@@ -53,13 +53,21 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <boost/container/flat_set.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/optional.hpp>
 
+#include <ikos/core/adt/patricia_tree/map.hpp>
+#include <ikos/core/domain/normalization.hpp>
 #include <ikos/core/domain/numeric/abstract_domain.hpp>
 #include <ikos/core/semantic/indexable.hpp>
 #include <ikos/core/support/assert.hpp>
@@ -112,9 +120,184 @@ public:
   template < typename, typename, std::size_t >
   friend class VarPackingDBMCongruence;
 
+  template < typename, typename, std::size_t >
+  friend class VarPackingSparseDBM;
+
 private:
-  /// \brief Shared pointer on the underlying abstract domain
-  using DomainPtr = std::shared_ptr< Domain >;
+  /*
+   * Domains are shared between copies of an abstract value, and copies can
+   * be used by different threads. A shared domain is never updated, except
+   * by `normalize()`, which closes it in place. Hence, domains are normalized
+   * under a lock, and a normalized domain can then be read without locking.
+   * A domain that is not normalized is only read under its lock.
+   *
+   * A domain can also be owned by an equivalence relation, which then updates
+   * it in place, see Ownership.
+   */
+
+  /// \brief Ownership of domains by an equivalence relation
+  ///
+  /// The domains created by a relation share its ownership, and the relation
+  /// updates them in place until the ownership is released. Releasing the
+  /// ownership clears it for all these domains at once.
+  class Ownership {
+  private:
+    std::atomic< bool > _is_released;
+
+  public:
+    /// \brief Create an ownership
+    Ownership() : _is_released(false) {}
+
+    /// \brief No copy constructor
+    Ownership(const Ownership&) = delete;
+
+    /// \brief No move constructor
+    Ownership(Ownership&&) = delete;
+
+    /// \brief No copy assignment operator
+    Ownership& operator=(const Ownership&) = delete;
+
+    /// \brief No move assignment operator
+    Ownership& operator=(Ownership&&) = delete;
+
+    /// \brief Destructor
+    ~Ownership() = default;
+
+    /// \brief Return true if the ownership was released
+    bool is_released() const {
+      return this->_is_released.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Release the ownership, before the domains are shared
+    void release() {
+      this->_is_released.store(true, std::memory_order_relaxed);
+    }
+
+  }; // end class Ownership
+
+  /// \brief Shared pointer on an ownership
+  using OwnershipPtr = std::shared_ptr< Ownership >;
+
+  /// \brief Abstract domain of an equivalence class
+  ///
+  /// The dirty flag tells whether the domain was updated since it was last
+  /// normalized, see LazyNormalization.
+  class Pack {
+  public:
+    Domain domain;
+
+  private:
+    mutable std::atomic< bool > _is_normalized;
+    OwnershipPtr _owner;
+
+  public:
+    /// \brief Create a pack
+    explicit Pack(Domain domain_, bool is_normalized = false)
+        : domain(std::move(domain_)), _is_normalized(is_normalized) {}
+
+    /// \brief No copy constructor, see `copy()`
+    Pack(const Pack&) = delete;
+
+    /// \brief No move constructor
+    Pack(Pack&&) = delete;
+
+    /// \brief No copy assignment operator
+    Pack& operator=(const Pack&) = delete;
+
+    /// \brief No move assignment operator
+    Pack& operator=(Pack&&) = delete;
+
+    /// \brief Destructor
+    ~Pack() {
+      if (!this->is_normalized()) {
+        LazyNormalization::add_avoided_closure();
+      }
+    }
+
+    /// \brief Return true if the domain is normalized
+    ///
+    /// The acquire load makes the normalized domain visible to this thread.
+    bool is_normalized() const {
+      return this->_is_normalized.load(std::memory_order_acquire);
+    }
+
+    /// \brief Mark the domain as normalized
+    void set_normalized() const {
+      this->_is_normalized.store(true, std::memory_order_release);
+    }
+
+    /// \brief Mark the domain as dirty, before an update in place
+    void set_dirty() {
+      this->_is_normalized.store(false, std::memory_order_relaxed);
+    }
+
+    /// \brief Return the ownership of the domain, or null
+    const OwnershipPtr& owner() const { return this->_owner; }
+
+    /// \brief Set the ownership of the domain
+    ///
+    /// Precondition: the pack is not shared yet
+    void set_owner(OwnershipPtr owner) { this->_owner = std::move(owner); }
+
+  }; // end class Pack
+
+  /// \brief Shared pointer on a pack
+  using DomainPtr = std::shared_ptr< Pack >;
+
+  /// \brief Return the lock protecting the given pack
+  ///
+  /// Packs are mapped to a fixed set of locks, using their address.
+  static std::mutex& domain_mutex(const Pack& pack) {
+    static std::array< std::mutex, 64 > mutexes;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto addr = reinterpret_cast< std::uintptr_t >(&pack);
+    return mutexes[((addr >> 4) ^ (addr >> 12)) % mutexes.size()];
+  }
+
+  /// \brief Normalize the domain of the given pack, and return it
+  static const Domain& normalized(const Pack& pack) {
+    if (pack.is_normalized()) {
+      return pack.domain;
+    }
+    std::lock_guard< std::mutex > lock(domain_mutex(pack));
+    if (!pack.is_normalized()) {
+      pack.domain.normalize();
+      pack.set_normalized();
+      LazyNormalization::add_closure();
+    }
+    return pack.domain;
+  }
+
+  /// \brief Return `f(domain)`, computed under the lock of the pack unless
+  /// it is normalized
+  template < typename Function >
+  static auto read(const Pack& pack, Function f) -> decltype(f(pack.domain)) {
+    if (pack.is_normalized()) {
+      return f(pack.domain);
+    }
+    std::lock_guard< std::mutex > lock(domain_mutex(pack));
+    return f(pack.domain);
+  }
+
+  /// \brief Return a copy of the given pack, without normalizing it
+  static DomainPtr copy(const Pack& pack) {
+    if (pack.is_normalized()) {
+      return std::make_shared< Pack >(pack.domain, /* is_normalized = */ true);
+    }
+    std::lock_guard< std::mutex > lock(domain_mutex(pack));
+    return std::make_shared< Pack >(pack.domain, pack.is_normalized());
+  }
+
+  /// \brief Return `f(domain)` for a query on the given pack
+  ///
+  /// In lazy mode, the pack is normalized first, see LazyNormalization.
+  template < typename Function >
+  static auto query(const Pack& pack, Function f) -> decltype(f(pack.domain)) {
+    if (LazyNormalization::enabled()) {
+      return f(normalized(pack));
+    }
+    return read(pack, f);
+  }
 
   /// \brief Hash function for VariableRef
   struct VariableRefHash {
@@ -127,6 +310,9 @@ private:
   using RootVariablesMap = std::
       unordered_map< VariableRef, std::vector< VariableRef >, VariableRefHash >;
 
+  /// \brief Set of root variables
+  using RootVariablesSet = std::unordered_set< VariableRef, VariableRefHash >;
+
   /// \brief Parent class
   using Parent =
       numeric::AbstractDomain< Number, VariableRef, VarPackingDomain >;
@@ -140,6 +326,18 @@ private:
     Bottom,
   };
 
+  /// \brief Variables on which two equivalence relations differ
+  struct Difference {
+    /// \brief Variables only in the left hand side relation
+    std::vector< VariableRef > left_only;
+
+    /// \brief Variables only in the right hand side relation
+    std::vector< VariableRef > right_only;
+
+    /// \brief Variables in both relations, with a different parent
+    std::vector< VariableRef > parent_changed;
+  };
+
   /*
    * Implementation of Union-Find
    */
@@ -157,14 +355,22 @@ private:
 
     // TODO(marthaud): We could store the list of variables in the class
 
-    // Note: The reason why sometimes we explicitly call domain->normalize() is
-    // because it is better to normalize a (probably) shared domain. If we don't
-    // do that, some methods will normalize a copy.
+    // Note: The reason why we explicitly normalize domains (see normalized())
+    // is because it is better to normalize a (probably) shared domain. If we
+    // don't do that, some methods will normalize a copy.
 
   public:
-    /// \brief Create an empty equivalence class
-    explicit EquivalenceClass()
-        : rank(0), domain(std::make_shared< Domain >(Domain::top())) {}
+    /// \brief Create an empty equivalence class, owned by `owner`
+    explicit EquivalenceClass(OwnershipPtr owner)
+        : rank(0),
+          domain(std::make_shared< Pack >(Domain::top(),
+                                          /* is_normalized = */ true)) {
+      this->domain->set_owner(std::move(owner));
+    }
+
+    /// \brief Create an equivalence class
+    EquivalenceClass(std::size_t rank_, DomainPtr domain_)
+        : rank(rank_), domain(std::move(domain_)) {}
 
     /// \brief Copy constructor
     EquivalenceClass(const EquivalenceClass&) noexcept = default;
@@ -181,13 +387,17 @@ private:
     /// \brief Destructor
     ~EquivalenceClass() = default;
 
-    /// \brief Copy before a write
-    void copy_domain() {
-      // XXX(marthaud): This is not thread safe.
-      if (this->domain.use_count() == 1) {
-        return; // copy is unnecessary
-      }
-      this->domain = std::make_shared< Domain >(*this->domain);
+    /// \brief Physical equality, required by the patricia tree
+    bool operator==(const EquivalenceClass& other) const {
+      return this->rank == other.rank && this->domain == other.domain;
+    }
+
+    /// \brief Physical hash, required by the patricia tree
+    friend std::size_t hash_value(const EquivalenceClass& c) {
+      std::size_t hash = 0;
+      boost::hash_combine(hash, c.rank);
+      boost::hash_combine(hash, c.domain.get());
+      return hash;
     }
 
   }; // end class EquivalenceClass
@@ -195,12 +405,101 @@ private:
   /// \brief Equivalence relation
   ///
   /// Hold the equivalence classes
+  ///
+  /// The relation is stored in persistent maps, so that copies are O(1) and
+  /// share their structure. Since the equivalence classes are shared as well,
+  /// a domain is only updated in place by the relation that owns it (see
+  /// Ownership). Otherwise, it is copied first (see `find_mutable_domain()`).
+  ///
+  /// Copying a relation hands off the ownership explicitly: the source
+  /// releases the ownership of its domains, and the copy starts without any.
+  /// Neither relation updates the shared domains in place afterwards, so
+  /// copies of a relation can be updated by different threads. The source
+  /// takes a new ownership on its next update.
+  ///
+  /// A relation must not be copied while the thread that owns it updates it,
+  /// since that thread could be writing in a domain that is being released.
+  ///
+  /// Union by rank keeps the trees shallow. Paths are not compressed, because
+  /// it would unshare the parent map on lookups.
   class EquivalenceRelation {
   private:
-    using ParentMap =
-        std::unordered_map< VariableRef, VariableRef, VariableRefHash >;
-    using ClassMap =
-        std::unordered_map< VariableRef, EquivalenceClass, VariableRefHash >;
+    using ParentMap = PatriciaTreeMap< VariableRef, VariableRef >;
+    using ClassMap = PatriciaTreeMap< VariableRef, EquivalenceClass >;
+
+    /// \brief Binary operation on parent maps computing a Difference
+    ///
+    /// Subtrees shared by both maps are skipped.
+    class DifferenceOperation {
+    private:
+      Difference& _diff;
+
+    public:
+      using ResultType = bool;
+
+      explicit DifferenceOperation(Difference& diff) : _diff(diff) {}
+
+      bool has_equals() const { return true; }
+
+      bool equals(const ParentMap&) const { return true; }
+
+      bool left(const ParentMap& l) const {
+        for (const auto& p : l) {
+          this->_diff.left_only.push_back(p.first);
+        }
+        return true;
+      }
+
+      bool right(const ParentMap& r) const {
+        for (const auto& p : r) {
+          this->_diff.right_only.push_back(p.first);
+        }
+        return true;
+      }
+
+      bool left_with_right_leaf(const ParentMap& l,
+                                const VariableRef& k,
+                                const VariableRef& v) const {
+        bool found = false;
+        for (const auto& p : l) {
+          if (p.first == k) {
+            found = true;
+            if (p.second != v) {
+              this->_diff.parent_changed.push_back(k);
+            }
+          } else {
+            this->_diff.left_only.push_back(p.first);
+          }
+        }
+        if (!found) {
+          this->_diff.right_only.push_back(k);
+        }
+        return true;
+      }
+
+      bool right_with_left_leaf(const ParentMap& r,
+                                const VariableRef& k,
+                                const VariableRef& v) const {
+        bool found = false;
+        for (const auto& p : r) {
+          if (p.first == k) {
+            found = true;
+            if (p.second != v) {
+              this->_diff.parent_changed.push_back(k);
+            }
+          } else {
+            this->_diff.right_only.push_back(p.first);
+          }
+        }
+        if (!found) {
+          this->_diff.left_only.push_back(k);
+        }
+        return true;
+      }
+
+      bool merge(bool, bool) const { return true; }
+
+    }; // end class DifferenceOperation
 
   private:
     // Map from variable to parent
@@ -209,31 +508,67 @@ private:
     // Map from root variable to equivalence class
     ClassMap _classes;
 
-    // Note: We are using at(key) instead of operator[](key) because VariableRef
-    // may not have a default constructor
+    // Ownership of the domains updated in place, or null
+    OwnershipPtr _owner;
+
+  private:
+    /// \brief Release the ownership of the domains, before they are shared
+    void release_domains() const {
+      if (this->_owner != nullptr) {
+        this->_owner->release();
+      }
+    }
+
+    /// \brief Return the ownership of the relation, before an update
+    ///
+    /// A new ownership is taken if it was released.
+    const OwnershipPtr& owner() {
+      if (this->_owner == nullptr || this->_owner->is_released()) {
+        this->_owner = std::make_shared< Ownership >();
+      }
+      return this->_owner;
+    }
+
+    /// \brief Return true if the given domain is owned by the relation
+    bool owns(const Pack& pack) const {
+      return this->_owner != nullptr && pack.owner() == this->_owner &&
+             !this->_owner->is_released();
+    }
 
   public:
     /// \brief Create an empty equivalence relation
     explicit EquivalenceRelation() = default;
 
     /// \brief Copy constructor
-    EquivalenceRelation(const EquivalenceRelation&) = default;
+    EquivalenceRelation(const EquivalenceRelation& other)
+        : _parents(other._parents), _classes(other._classes) {
+      other.release_domains();
+    }
 
     /// \brief Move constructor
-    EquivalenceRelation(EquivalenceRelation&&) = default;
+    EquivalenceRelation(EquivalenceRelation&& other) noexcept = default;
 
     /// \brief Copy assignment operator
-    EquivalenceRelation& operator=(const EquivalenceRelation&) = default;
+    EquivalenceRelation& operator=(const EquivalenceRelation& other) {
+      if (this != &other) {
+        this->_parents = other._parents;
+        this->_classes = other._classes;
+        this->_owner.reset();
+        other.release_domains();
+      }
+      return *this;
+    }
 
     /// \brief Move assignment operator
-    EquivalenceRelation& operator=(EquivalenceRelation&&) = default;
+    EquivalenceRelation& operator=(EquivalenceRelation&& other) noexcept =
+        default;
 
     /// \brief Destructor
     ~EquivalenceRelation() = default;
 
     /// \brief Return true if the equivalence relation contains `v`
     bool contains(VariableRef v) const {
-      return this->_parents.find(v) != this->_parents.end();
+      return static_cast< bool >(this->_parents.at(v));
     }
 
     /// \brief Create an equivalence class containing the given variable
@@ -241,8 +576,8 @@ private:
     /// Precondition: `v` is not already present in the relation
     void add_equiv_class(VariableRef v) {
       ikos_assert_msg(!this->contains(v), "variable already present");
-      this->_parents.emplace(v, v);
-      this->_classes.emplace(v, EquivalenceClass());
+      this->_parents.insert_or_assign(v, v);
+      this->_classes.insert_or_assign(v, EquivalenceClass(this->owner()));
     }
 
     /// \brief Add a variable in an equivalence class
@@ -254,54 +589,82 @@ private:
       ikos_assert_msg(this->contains(parent), "variable missing");
 
       VariableRef parent_root = this->find_root_var(parent);
-      EquivalenceClass& parent_class = this->_classes[parent_root];
+      const EquivalenceClass& parent_class = *this->_classes.at(parent_root);
 
       if (parent_class.rank == 0) {
-        parent_class.rank++;
+        EquivalenceClass new_class = parent_class;
+        new_class.rank++;
+        this->_classes.insert_or_assign(parent_root, new_class);
       }
-      this->_parents.emplace(v, parent_root);
+      this->_parents.insert_or_assign(v, parent_root);
     }
 
     /// \brief Find the root of the equivalence class containing `v`
-    VariableRef find_root_var(VariableRef v) {
-      VariableRef& parent = this->_parents.at(v);
+    VariableRef find_root_var(VariableRef v) const {
+      for (;;) {
+        auto parent = this->_parents.at(v);
+        ikos_assert_msg(parent, "variable missing");
 
-      if (parent == v) {
-        return v;
-      } else {
-        return parent = this->find_root_var(parent);
+        if (*parent == v) {
+          return v;
+        }
+        v = *parent;
       }
     }
 
-    /// \brief Find the root of the equivalence class containing `v`
-    VariableRef cfind_root_var(VariableRef v) const {
-      VariableRef parent = this->_parents.at(v);
-
-      if (parent == v) {
-        return v;
-      } else {
-        return this->cfind_root_var(parent);
-      }
+    /// \brief Find the equivalence class containing `v`
+    const EquivalenceClass& find_equiv_class(VariableRef v) const {
+      return *this->_classes.at(this->find_root_var(v));
     }
 
-    /// \brief Find the equivalence class containing `v`
-    EquivalenceClass& find_equiv_class(VariableRef v) {
-      return this->_classes[this->find_root_var(v)];
+    /// \brief Find the abstract domain containing `v`
+    ///
+    /// The domain might be shared, see `normalized()`.
+    const DomainPtr& find_domain(VariableRef v) const {
+      return this->find_equiv_class(v).domain;
     }
 
-    /// \brief Find the equivalence class containing `v`
-    const EquivalenceClass& cfind_equiv_class(VariableRef v) const {
-      return this->_classes.at(this->cfind_root_var(v));
+    /// \brief Find the abstract domain containing `v`, and normalize it
+    const Domain& find_normalized_domain(VariableRef v) const {
+      return normalized(*this->find_domain(v));
     }
 
-    /// \brief Find the abstract domain containing `v`
-    const DomainPtr& find_domain(VariableRef v) {
-      return this->find_equiv_class(v).domain;
+    /// \brief Find the abstract domain containing `v`, before a write
+    ///
+    /// The domain is copied unless it is owned by this relation, and marked
+    /// as dirty.
+    Domain& find_mutable_domain(VariableRef v) {
+      VariableRef root = this->find_root_var(v);
+      const EquivalenceClass& equiv_class = *this->_classes.at(root);
+
+      if (!this->owns(*equiv_class.domain)) {
+        DomainPtr domain = copy(*equiv_class.domain);
+        domain->set_owner(this->owner());
+        this->_classes.insert_or_assign(root,
+                                        EquivalenceClass(equiv_class.rank,
+                                                         std::move(domain)));
+      }
+
+      Pack& pack = *this->_classes.at(root)->domain;
+      pack.set_dirty();
+      return pack.domain;
     }
 
-    /// \brief Find the abstract domain containing `v`
-    const DomainPtr& cfind_domain(VariableRef v) const {
-      return this->cfind_equiv_class(v).domain;
+    /// \brief Replace the abstract domain of the class containing `v`
+    ///
+    /// `owned` is true if the domain is not referenced anywhere else.
+    /// Otherwise, the domain is shared, and its owner releases it.
+    void set_domain(VariableRef v, DomainPtr domain, bool owned) {
+      if (owned) {
+        domain->set_owner(this->owner());
+      } else if (domain->owner() != nullptr) {
+        domain->owner()->release();
+      }
+      VariableRef root = this->find_root_var(v);
+      std::size_t rank = this->_classes.at(root)->rank;
+      this->_classes.insert_or_assign(root,
+                                      EquivalenceClass(rank,
+                                                       std::move(domain)));
     }
 
     /// \brief Merge two equivalence classes
@@ -315,38 +678,122 @@ private:
         return false;
       }
 
-      EquivalenceClass& x_class = this->_classes[x_root];
-      EquivalenceClass& y_class = this->_classes[y_root];
+      // Copy the classes, since updating the map invalidates references
+      EquivalenceClass x_class = *this->_classes.at(x_root);
+      EquivalenceClass y_class = *this->_classes.at(y_root);
 
       // Merge the domains
-      auto merge_domain = std::make_shared< Domain >(Domain::top());
-      x_class.domain->normalize();
-      y_class.domain->normalize();
-      *merge_domain = (*x_class.domain).meet(*y_class.domain);
+      auto merge_domain = std::make_shared< Pack >(
+          normalized(*x_class.domain).meet(normalized(*y_class.domain)));
+      merge_domain->set_owner(this->owner());
 
       if (x_class.rank > y_class.rank) {
-        this->_parents.at(y_root) = x_root;
-
-        x_class.domain.swap(merge_domain);
+        this->_parents.insert_or_assign(y_root, x_root);
+        this->_classes.insert_or_assign(x_root,
+                                        EquivalenceClass(x_class.rank,
+                                                         std::move(
+                                                             merge_domain)));
         this->_classes.erase(y_root);
       } else {
-        this->_parents.at(x_root) = y_root;
-
+        this->_parents.insert_or_assign(x_root, y_root);
+        std::size_t rank = y_class.rank;
         if (x_class.rank == y_class.rank) {
-          y_class.rank++;
+          rank++;
         }
-
-        y_class.domain.swap(merge_domain);
+        this->_classes.insert_or_assign(y_root,
+                                        EquivalenceClass(rank,
+                                                         std::move(
+                                                             merge_domain)));
         this->_classes.erase(x_root);
       }
 
       return true;
     }
 
+    /// \brief Return true if both relations have the same equivalence classes
+    /// and the same roots
+    ///
+    /// This is fast if the relations share most of their structure.
+    bool same_partition(const EquivalenceRelation& other) const {
+      return this->_parents.equals(other._parents,
+                                   [](VariableRef x, VariableRef y) {
+                                     return x == y;
+                                   });
+    }
+
+    /// \brief Return the variables on which both relations differ
+    ///
+    /// This is fast if the relations share most of their structure.
+    Difference difference(const EquivalenceRelation& other) const {
+      Difference diff;
+      this->_parents.binary_operation(other._parents,
+                                       DifferenceOperation(diff));
+      return diff;
+    }
+
+    /// \brief Return the roots of the equivalence classes that might differ
+    /// between both relations
+    ///
+    /// Other equivalence classes have the same root and variables in both
+    /// relations, since their variables have the same parents.
+    RootVariablesSet changed_roots(const EquivalenceRelation& other) const {
+      Difference diff = this->difference(other);
+      RootVariablesSet roots;
+      for (VariableRef v : diff.left_only) {
+        roots.insert(this->find_root_var(v));
+      }
+      for (VariableRef v : diff.right_only) {
+        roots.insert(other.find_root_var(v));
+      }
+      for (VariableRef v : diff.parent_changed) {
+        roots.insert(this->find_root_var(v));
+        roots.insert(other.find_root_var(v));
+      }
+      return roots;
+    }
+
+    /// \brief Apply `op` on the domains of both relations
+    ///
+    /// Equivalence classes sharing the same domain are skipped.
+    ///
+    /// Precondition: `this->same_partition(other)`
+    template < typename BinaryOperator >
+    void combine_domains(const EquivalenceRelation& other,
+                         const BinaryOperator& op) {
+      const OwnershipPtr& owner = this->owner();
+      this->_classes.join_with(
+          other._classes,
+          [&](const EquivalenceClass& left, const EquivalenceClass& right)
+              -> boost::optional< EquivalenceClass > {
+            if (left.domain == right.domain) {
+              return left;
+            }
+            auto domain =
+                std::make_shared< Pack >(op(*left.domain, *right.domain));
+            domain->set_owner(owner);
+            return EquivalenceClass(left.rank, std::move(domain));
+          });
+    }
+
+    /// \brief Compare the domains of both relations
+    ///
+    /// Precondition: `this->same_partition(other)`
+    bool leq_domains(const EquivalenceRelation& other) const {
+      return this->_classes.leq(other._classes,
+                                [](const EquivalenceClass& left,
+                                   const EquivalenceClass& right) {
+                                  if (left.domain == right.domain) {
+                                    return true;
+                                  }
+                                  return normalized(*left.domain)
+                                      .leq(normalized(*right.domain));
+                                });
+    }
+
   private:
     struct GetVar {
       const VariableRef& operator()(
-          const std::pair< const VariableRef, VariableRef >& p) const {
+          const std::pair< VariableRef, VariableRef >& p) const {
         return p.first;
       }
     };
@@ -354,19 +801,22 @@ private:
   public:
     /// \brief Begin iterator on the variables
     auto var_begin() const {
-      return boost::make_transform_iterator(this->_parents.cbegin(), GetVar());
+      return boost::make_transform_iterator(this->_parents.begin(), GetVar());
     }
 
     /// \brief End iterator on the variables
     auto var_end() const {
-      return boost::make_transform_iterator(this->_parents.cend(), GetVar());
+      return boost::make_transform_iterator(this->_parents.end(), GetVar());
     }
 
     /// \brief Begin iterator on the equivalence classes
-    auto begin() const { return this->_classes.cbegin(); }
+    ///
+    /// Iterators hold a snapshot of the relation, and thus remain valid if
+    /// the relation is updated.
+    auto begin() const { return this->_classes.begin(); }
 
     /// \brief End iterator on the equivalence classes
-    auto end() const { return this->_classes.cend(); }
+    auto end() const { return this->_classes.end(); }
 
     /// \brief Return the list of variables
     std::vector< VariableRef > variables() const {
@@ -383,53 +833,49 @@ private:
     ///
     /// Note: calling forget() on an equivalence class might reduce it to bottom
     ForgetResult forget(VariableRef v) {
-      auto it = this->_parents.find(v);
+      auto parent = this->_parents.at(v);
 
-      if (it == this->_parents.end()) {
+      if (!parent) {
         return ForgetResult::Success;
       }
 
-      if (it->second != v) {
+      if (*parent != v) {
         // v is not the root of the equivalence class
-        VariableRef root = this->find_root_var(it->second);
+        VariableRef root = this->find_root_var(*parent);
 
         // update parents
-        for (auto& p : this->_parents) {
+        for (const auto& p : this->_parents) {
           if (p.second == v) {
-            p.second = root;
+            this->_parents.insert_or_assign(p.first, root);
           }
         }
 
-        EquivalenceClass& equiv_class = this->_classes[root];
-        equiv_class.copy_domain();
-        equiv_class.domain->forget(v);
+        this->find_mutable_domain(root).forget(v);
       } else {
         // v is the root of the equivalence class
         boost::optional< VariableRef > new_root;
 
-        for (auto& p : this->_parents) {
+        for (const auto& p : this->_parents) {
           if (p.second == v && p.first != v) {
             if (!new_root) {
               new_root = p.first;
             }
-            p.second = *new_root;
+            this->_parents.insert_or_assign(p.first, *new_root);
           }
         }
 
         if (new_root) {
-          EquivalenceClass equiv_class = std::move(this->_classes[v]);
-          equiv_class.copy_domain();
-          equiv_class.domain->forget(v);
-          this->_classes.emplace(*new_root, std::move(equiv_class));
+          EquivalenceClass equiv_class = *this->_classes.at(v);
+          this->_classes.erase(v);
+          this->_classes.insert_or_assign(*new_root, equiv_class);
+          this->find_mutable_domain(*new_root).forget(v);
         } else {
-          EquivalenceClass& equiv_class = this->_classes[v];
-          if (equiv_class.domain->is_bottom()) {
+          if (normalized(*this->_classes.at(v)->domain).is_bottom()) {
             // In that case, do nothing
             return ForgetResult::Bottom;
           }
+          this->_classes.erase(v);
         }
-
-        this->_classes.erase(v);
       }
 
       this->_parents.erase(v);
@@ -444,14 +890,17 @@ private:
 
       VariableRef root = this->find_root_var(v);
 
-      for (auto it = this->_parents.begin(); it != this->_parents.end();) {
-        if (this->find_root_var(it->second) == root) {
-          it = _parents.erase(it);
-        } else {
-          ++it;
+      // Collect the variables first, find_root_var() needs the whole path
+      std::vector< VariableRef > vars;
+      for (const auto& p : this->_parents) {
+        if (this->find_root_var(p.first) == root) {
+          vars.push_back(p.first);
         }
       }
 
+      for (VariableRef x : vars) {
+        this->_parents.erase(x);
+      }
       this->_classes.erase(root);
     }
 
@@ -459,12 +908,51 @@ private:
     /// equivalence class
     RootVariablesMap root_to_vars() const {
       RootVariablesMap roots;
+      roots.reserve(this->_classes.size());
+      for (const auto& equiv_class : this->_classes) {
+        roots[equiv_class.first];
+      }
       for (const auto& p : this->_parents) {
-        roots[this->cfind_root_var(p.second)].push_back(p.first);
+        // Most parents are roots, avoid a lookup in the parent map
+        auto it = roots.find(p.second);
+        if (it != roots.end()) {
+          it->second.push_back(p.first);
+        } else {
+          roots[this->find_root_var(p.second)].push_back(p.first);
+        }
       }
       return roots;
     }
 
+    /// \brief Return a map from the given root variables to the list of
+    /// variables in their equivalence class
+    ///
+    /// Variables of `roots` that are not roots in this relation are ignored.
+    /// This still scans the parent map, but skips the other classes.
+    RootVariablesMap root_to_vars(const RootVariablesSet& roots) const {
+      RootVariablesMap result;
+      if (roots.empty()) {
+        return result;
+      }
+      result.reserve(roots.size());
+      for (VariableRef root : roots) {
+        auto parent = this->_parents.at(root);
+        if (parent && *parent == root) {
+          result[root];
+        }
+      }
+      for (const auto& p : this->_parents) {
+        auto it = result.find(p.second);
+        if (it == result.end() && p.first != p.second) {
+          it = result.find(this->find_root_var(p.second));
+        }
+        if (it != result.end()) {
+          it->second.push_back(p.first);
+        }
+      }
+      return result;
+    }
+
     void dump(std::ostream& o) const {
       o << "({";
       for (auto it = this->_parents.begin(), et = this->_parents.end();
@@ -482,7 +970,7 @@ private:
            it != et;) {
         DumpableTraits< VariableRef >::dump(o, it->first);
         o << " -> ";
-        it->second.domain->dump(o);
+        normalized(*it->second.domain).dump(o);
         ++it;
         if (it != et) {
           o << ", ";
@@ -545,9 +1033,7 @@ public:
     }
 
     for (const auto& equiv_class : this->_equiv_relation) {
-      equiv_class.second.domain->normalize();
-
-      if (equiv_class.second.domain->is_bottom()) {
+      if (normalized(*equiv_class.second.domain).is_bottom()) {
         self->set_to_bottom();
         return;
       }
@@ -561,6 +1047,17 @@ public:
     return this->_is_bottom;
   }
 
+private:
+  /// \brief Normalize the abstract value before queries on a few variables
+  ///
+  /// In lazy mode, the queries normalize the packs they need instead.
+  void normalize_for_queries() const {
+    if (!LazyNormalization::enabled()) {
+      this->normalize();
+    }
+  }
+
+public:
   bool is_top() const override {
     // Does not require normalization
 
@@ -569,7 +1066,8 @@ public:
     }
 
     for (const auto& equiv_class : this->_equiv_relation) {
-      if (!equiv_class.second.domain->is_top()) {
+      if (!read(*equiv_class.second.domain,
+                [](const Domain& d) { return d.is_top(); })) {
         return false;
       }
     }
@@ -590,6 +1088,10 @@ public:
   }
 
   bool leq(const VarPackingDomain& other) const override {
+    if (this->is_lazy_with(other)) {
+      return this->_equiv_relation.leq_domains(other._equiv_relation);
+    }
+
     // Requires normalization
     this->normalize();
     other.normalize();
@@ -598,14 +1100,36 @@ public:
       return true;
     } else if (other.is_bottom()) {
       return false;
+    } else if (this->_equiv_relation.same_partition(other._equiv_relation)) {
+      return this->_equiv_relation.leq_domains(other._equiv_relation);
     } else {
-      RootVariablesMap other_roots = other._equiv_relation.root_to_vars();
+      // Equivalence classes with another root are the same in both relations
+      RootVariablesSet changed_roots =
+          this->_equiv_relation.changed_roots(other._equiv_relation);
 
-      // For each equivalence class in `other`
-      for (const auto& other_class : other_roots) {
+      // For each equivalence class in `other` that is the same in `this`
+      for (const auto& other_class : other._equiv_relation) {
         const VariableRef& other_root = other_class.first;
+        if (changed_roots.find(other_root) != changed_roots.end()) {
+          continue;
+        }
+
+        const DomainPtr& other_domain = other_class.second.domain;
+        const DomainPtr& domain = this->_equiv_relation.find_domain(other_root);
+        if (domain != other_domain) {
+          if (!normalized(*domain).leq(normalized(*other_domain))) {
+            return false;
+          }
+        }
+      }
+
+      RootVariablesMap other_roots =
+          other._equiv_relation.root_to_vars(changed_roots);
+
+      // For each changed equivalence class in `other`
+      for (const auto& other_class : other_roots) {
         const DomainPtr& other_domain =
-            other._equiv_relation.cfind_domain(other_root);
+            other._equiv_relation.find_domain(other_class.first);
 
         // Set of root variables of equivalence classes we have merged
         boost::container::flat_set< VariableRef > this_roots;
@@ -619,7 +1143,7 @@ public:
             continue; // v not in `this`
           }
 
-          VariableRef this_root = this->_equiv_relation.cfind_root_var(v);
+          VariableRef this_root = this->_equiv_relation.find_root_var(v);
 
           if (this_roots.find(this_root) != this_roots.end()) {
             continue; // equivalence class for v already merged
@@ -628,7 +1152,7 @@ public:
           this_roots.insert(this_root);
 
           const DomainPtr& domain =
-              this->_equiv_relation.cfind_domain(this_root);
+              this->_equiv_relation.find_domain(this_root);
 
           // Merge `domain` into `this_domain`
           if (this_domain == nullptr) {
@@ -636,25 +1160,22 @@ public:
           } else if (this_domain == domain) {
             // nothing to do
           } else {
-            auto merge_domain = std::make_shared< Domain >(Domain::top());
-            this_domain->normalize();
-            domain->normalize();
-            *merge_domain = (*this_domain).meet(*domain);
+            auto merge_domain = std::make_shared< Pack >(
+                normalized(*this_domain).meet(normalized(*domain)));
             this_domain.swap(merge_domain);
           }
         }
 
         // Compare `this_domain` and `other_domain`
         if (this_domain == nullptr) {
-          if (!other_domain->is_top()) {
+          if (!read(*other_domain,
+                    [](const Domain& d) { return d.is_top(); })) {
             return false;
           }
         } else if (this_domain == other_domain) {
           // this_domain.leq(other_domain) is true
         } else {
-          this_domain->normalize();
-          other_domain->normalize();
-          if (!((*this_domain).leq(*other_domain))) {
+          if (!normalized(*this_domain).leq(normalized(*other_domain))) {
             return false;
           }
         }
@@ -669,6 +1190,31 @@ public:
   }
 
 private:
+  /// \brief Return true if a binary operation with `other` can skip the
+  /// normalization of both operands, see LazyNormalization
+  ///
+  /// With the same packs on both sides, the operation is applied pack by pack,
+  /// and only normalizes the packs that differ. A pack reduced to bottom is
+  /// then not propagated to the whole value, which is sound but can lose
+  /// precision.
+  bool is_lazy_with(const VarPackingDomain& other) const {
+    return LazyNormalization::enabled() && !this->_is_bottom &&
+           !other._is_bottom &&
+           this->_equiv_relation.same_partition(other._equiv_relation);
+  }
+
+  /// \brief Apply `op` on the packs that differ
+  ///
+  /// Precondition: both operands have the same packs
+  template < typename BinaryOperator >
+  VarPackingDomain combine_binary_op(const VarPackingDomain& other,
+                                     const BinaryOperator& op) const {
+    VarPackingDomain result(*this);
+    result._equiv_relation.combine_domains(other._equiv_relation, op);
+    result._is_normalized = false;
+    return result;
+  }
+
   void merge_existing_equiv_classes(boost::optional< VariableRef >& root,
                                     VariableRef v) {
     if (!this->_equiv_relation.contains(v)) {
@@ -700,32 +1246,63 @@ private:
   template < typename BinaryOperator >
   VarPackingDomain union_binary_op(VarPackingDomain other,
                                    const BinaryOperator& op) const {
+    if (this->_equiv_relation.same_partition(other._equiv_relation)) {
+      // Same packs on both sides, only compute the packs that differ
+      return this->combine_binary_op(other, op);
+    }
+
     // `other` is a copy, thus we can update it
     /// TODO(marthaud): try to implement this without copying `other`
     VarPackingDomain result(*this);
 
-    // Forget variables in `result` that are not in `other`
-    // TODO(marthaud): variables() needs to creates a temporary vector because
-    // forget() might invalidate iterators
-    for (VariableRef v : result._equiv_relation.variables()) {
-      if (!other._equiv_relation.contains(v)) {
+    {
+      Difference diff = result._equiv_relation.difference(
+          other._equiv_relation);
+
+      // Forget variables in `result` that are not in `other`
+      for (VariableRef v : diff.left_only) {
         result._equiv_relation.forget(v);
       }
-    }
 
-    // Forget variables in `other` that are not in `result`
-    // TODO(marthaud): variables() needs to creates a temporary vector because
-    // forget() might invalidate iterators
-    for (VariableRef v : other._equiv_relation.variables()) {
-      if (!result._equiv_relation.contains(v)) {
+      // Forget variables in `other` that are not in `result`
+      for (VariableRef v : diff.right_only) {
         other._equiv_relation.forget(v);
       }
     }
 
+    // Other equivalence classes are the same in `result` and `other`
+    RootVariablesSet changed_roots =
+        result._equiv_relation.changed_roots(other._equiv_relation);
+
+    // Apply `op` on the pack of `root` in `result` and `other_domain`
+    auto apply_op = [&](VariableRef root, const DomainPtr& other_domain) {
+      const DomainPtr& domain = result._equiv_relation.find_domain(root);
+      if (domain == other_domain) {
+        // nothing to do, left and right packs are the same
+      } else {
+        auto merge_domain = std::make_shared< Pack >(op(*domain, *other_domain));
+        result._equiv_relation.set_domain(root,
+                                          std::move(merge_domain),
+                                          /* owned = */ true);
+      }
+    };
+
     {
-      // Iterate on equivalence classes in `results`, merge the variables in
-      // `other`
-      RootVariablesMap result_roots = result._equiv_relation.root_to_vars();
+      // Iterate on equivalence classes in `other` that are the same in
+      // `result`, and compute the binary operation
+      for (const auto& other_class : other._equiv_relation) {
+        const VariableRef& other_root = other_class.first;
+        if (changed_roots.find(other_root) == changed_roots.end()) {
+          apply_op(other_root, other_class.second.domain);
+        }
+      }
+    }
+
+    {
+      // Iterate on changed equivalence classes in `results`, merge the
+      // variables in `other`
+      RootVariablesMap result_roots =
+          result._equiv_relation.root_to_vars(changed_roots);
       for (const auto& result_class : result_roots) {
         boost::optional< VariableRef > root;
 
@@ -736,13 +1313,16 @@ private:
     }
 
     {
-      // Iterator on equivalence classes in `other`, merge the variables in
-      // `results` and compute the binary operation
-      RootVariablesMap other_roots = other._equiv_relation.root_to_vars();
+      // Iterate on changed equivalence classes in `other`, merge the variables
+      // in `results` and compute the binary operation
+      //
+      // The roots of the merged classes in `other` are roots of classes that
+      // changed in `other`, hence they are in `changed_roots`.
+      RootVariablesMap other_roots =
+          other._equiv_relation.root_to_vars(changed_roots);
       for (const auto& other_class : other_roots) {
-        const VariableRef& other_root = other_class.first;
         const DomainPtr& other_domain =
-            other._equiv_relation.find_domain(other_root);
+            other._equiv_relation.find_domain(other_class.first);
 
         boost::optional< VariableRef > root;
         for (VariableRef v : other_class.second) {
@@ -750,15 +1330,7 @@ private:
         }
 
         if (root) {
-          EquivalenceClass& equiv_class =
-              result._equiv_relation.find_equiv_class(*root);
-          if (equiv_class.domain == other_domain) {
-            // nothing to do, left and right packs are the same
-          } else {
-            auto merge_domain = std::make_shared< Domain >(Domain::top());
-            op(*merge_domain, *equiv_class.domain, *other_domain);
-            equiv_class.domain = merge_domain;
-          }
+          apply_op(*root, other_domain);
         }
       }
     }
@@ -771,13 +1343,18 @@ private:
   template < typename BinaryOperator >
   VarPackingDomain meet_binary_op(const VarPackingDomain& other,
                                   BinaryOperator op) const {
+    if (this->_equiv_relation.same_partition(other._equiv_relation)) {
+      // Same packs on both sides, only compute the packs that differ
+      return this->combine_binary_op(other, op);
+    }
+
     VarPackingDomain result(*this);
 
     RootVariablesMap other_roots = other._equiv_relation.root_to_vars();
     for (const auto& other_class : other_roots) {
       const VariableRef& other_root = other_class.first;
       const DomainPtr& other_domain =
-          other._equiv_relation.cfind_domain(other_root);
+          other._equiv_relation.find_domain(other_root);
 
       boost::optional< VariableRef > root;
       for (VariableRef v : other_class.second) {
@@ -789,18 +1366,21 @@ private:
         result.merge_unexisting_equiv_classes(root, v);
       }
 
-      EquivalenceClass& equiv_class =
-          result._equiv_relation.find_equiv_class(*root);
+      const DomainPtr& domain = result._equiv_relation.find_domain(*root);
       if (!new_domain) {
-        if (equiv_class.domain == other_domain) {
+        if (domain == other_domain) {
           // nothing to do, left and right packs are the same
         } else {
-          auto merge_domain = std::make_shared< Domain >(Domain::top());
-          op(*merge_domain, *equiv_class.domain, *other_domain);
-          equiv_class.domain = merge_domain;
+          auto merge_domain =
+              std::make_shared< Pack >(op(*domain, *other_domain));
+          result._equiv_relation.set_domain(*root,
+                                            std::move(merge_domain),
+                                            /* owned = */ true);
         }
       } else {
-        equiv_class.domain = other_domain;
+        result._equiv_relation.set_domain(*root,
+                                          other_domain,
+                                          /* owned = */ false);
       }
     }
 
@@ -809,57 +1389,60 @@ private:
   }
 
   struct JoinOperator {
-    void operator()(Domain& result, Domain& left, Domain& right) const {
-      left.normalize();
-      right.normalize();
-      result = left.join(right);
+    Domain operator()(const Pack& left, const Pack& right) const {
+      return normalized(left).join(normalized(right));
     }
   };
 
   struct MeetOperator {
-    void operator()(Domain& result, Domain& left, Domain& right) const {
-      left.normalize();
-      right.normalize();
-      result = left.meet(right);
+    Domain operator()(const Pack& left, const Pack& right) const {
+      return normalized(left).meet(normalized(right));
     }
   };
 
   struct WideningOperator {
-    void operator()(Domain& result, Domain& left, Domain& right) const {
-      right.normalize();
-      result = left.widening(right);
+    Domain operator()(const Pack& left, const Pack& right) const {
+      // The left operand should not be normalized
+      const Domain& normalized_right = normalized(right);
+      return read(left, [&](const Domain& d) {
+        return d.widening(normalized_right);
+      });
     }
   };
 
   struct WideningThresholdOperator {
     const Number& threshold;
 
-    void operator()(Domain& result, Domain& left, Domain& right) const {
-      right.normalize();
-      result = left.widening_threshold(right, threshold);
+    Domain operator()(const Pack& left, const Pack& right) const {
+      // The left operand should not be normalized
+      const Domain& normalized_right = normalized(right);
+      return read(left, [&](const Domain& d) {
+        return d.widening_threshold(normalized_right, this->threshold);
+      });
     }
   };
 
   struct NarrowingOperator {
-    void operator()(Domain& result, Domain& left, Domain& right) const {
-      left.normalize();
-      right.normalize();
-      result = left.narrowing(right);
+    Domain operator()(const Pack& left, const Pack& right) const {
+      return normalized(left).narrowing(normalized(right));
     }
   };
 
   struct NarrowingThresholdOperator {
     const Number& threshold;
 
-    void operator()(Domain& result, Domain& left, Domain& right) const {
-      left.normalize();
-      right.normalize();
-      result = left.narrowing_threshold(right, threshold);
+    Domain operator()(const Pack& left, const Pack& right) const {
+      return normalized(left).narrowing_threshold(normalized(right),
+                                                  this->threshold);
     }
   };
 
 public:
   VarPackingDomain join(const VarPackingDomain& other) const override {
+    if (this->is_lazy_with(other)) {
+      return this->combine_binary_op(other, JoinOperator{});
+    }
+
     // Requires normalization
     this->normalize();
     other.normalize();
@@ -878,6 +1461,10 @@ public:
   }
 
   VarPackingDomain widening(const VarPackingDomain& other) const override {
+    if (this->is_lazy_with(other)) {
+      return this->combine_binary_op(other, WideningOperator{});
+    }
+
     // Requires the normalization of the right operand.
     // The left operand (this) should not be normalized.
     other.normalize();
@@ -897,6 +1484,11 @@ public:
 
   VarPackingDomain widening_threshold(const VarPackingDomain& other,
                                       const Number& threshold) const override {
+    if (this->is_lazy_with(other)) {
+      return this->combine_binary_op(other,
+                                     WideningThresholdOperator{threshold});
+    }
+
     // Requires the normalization of the right operand.
     // The left operand (this) should not be normalized.
     other.normalize();
@@ -916,6 +1508,10 @@ public:
   }
 
   VarPackingDomain meet(const VarPackingDomain& other) const override {
+    if (this->is_lazy_with(other)) {
+      return this->combine_binary_op(other, MeetOperator{});
+    }
+
     // Requires normalization
     this->normalize();
     other.normalize();
@@ -932,6 +1528,10 @@ public:
   }
 
   VarPackingDomain narrowing(const VarPackingDomain& other) const override {
+    if (this->is_lazy_with(other)) {
+      return this->combine_binary_op(other, NarrowingOperator{});
+    }
+
     // Requires normalization
     this->normalize();
     other.normalize();
@@ -949,6 +1549,11 @@ public:
 
   VarPackingDomain narrowing_threshold(const VarPackingDomain& other,
                                        const Number& threshold) const override {
+    if (this->is_lazy_with(other)) {
+      return this->combine_binary_op(other,
+                                     NarrowingThresholdOperator{threshold});
+    }
+
     // Requires normalization
     this->normalize();
     other.normalize();
@@ -979,7 +1584,7 @@ public:
     }
 
     this->_equiv_relation.add_equiv_class(x);
-    this->_equiv_relation.find_domain(x)->assign(x, n);
+    this->_equiv_relation.find_mutable_domain(x).assign(x, n);
     this->_is_normalized = false;
   }
 
@@ -1003,9 +1608,7 @@ public:
     }
 
     this->_equiv_relation.add_var_to_equiv_class(x, y);
-    EquivalenceClass& equiv_class = this->_equiv_relation.find_equiv_class(y);
-    equiv_class.copy_domain();
-    equiv_class.domain->assign(x, y);
+    this->_equiv_relation.find_mutable_domain(y).assign(x, y);
     this->_is_normalized = false;
   }
 
@@ -1041,16 +1644,13 @@ public:
 
     // otherwise, x has already been merged
 
-    EquivalenceClass& equiv_class =
-        this->_equiv_relation.find_equiv_class(*root);
-    equiv_class.copy_domain();
-    equiv_class.domain->assign(x, e);
+    this->_equiv_relation.find_mutable_domain(*root).assign(x, e);
     this->_is_normalized = false;
   }
 
 private:
   /// \brief Add a relation x = f(y, z)
-  const DomainPtr& add_relation(VariableRef x, VariableRef y, VariableRef z) {
+  Domain& add_relation(VariableRef x, VariableRef y, VariableRef z) {
     boost::optional< VariableRef > root;
     this->merge_existing_equiv_classes(root, y);
     this->merge_existing_equiv_classes(root, z);
@@ -1061,21 +1661,18 @@ private:
       auto result = this->_equiv_relation.forget(x);
       if (result == ForgetResult::Bottom) {
         this->_is_bottom = true;
-        return this->_equiv_relation.find_domain(x);
+        return this->_equiv_relation.find_mutable_domain(x);
       }
 
       this->_equiv_relation.add_var_to_equiv_class(x, *root);
     }
     // otherwise, x has already been merged
 
-    EquivalenceClass& equiv_class =
-        this->_equiv_relation.find_equiv_class(*root);
-    equiv_class.copy_domain();
-    return equiv_class.domain;
+    return this->_equiv_relation.find_mutable_domain(*root);
   }
 
   /// \brief Add a relation x = f(y)
-  const DomainPtr& add_relation(VariableRef x, VariableRef y) {
+  Domain& add_relation(VariableRef x, VariableRef y) {
     if (!this->_equiv_relation.contains(y)) {
       this->_equiv_relation.add_equiv_class(y);
     }
@@ -1084,14 +1681,12 @@ private:
       auto result = this->_equiv_relation.forget(x);
       if (result == ForgetResult::Bottom) {
         this->_is_bottom = true;
-        return this->_equiv_relation.find_domain(x);
+        return this->_equiv_relation.find_mutable_domain(x);
       }
       this->_equiv_relation.add_var_to_equiv_class(x, y);
     }
 
-    EquivalenceClass& equiv_class = this->_equiv_relation.find_equiv_class(y);
-    equiv_class.copy_domain();
-    return equiv_class.domain;
+    return this->_equiv_relation.find_mutable_domain(y);
   }
 
 public:
@@ -1103,7 +1698,7 @@ public:
       return;
     }
 
-    this->add_relation(x, y, z)->apply(op, x, y, z);
+    this->add_relation(x, y, z).apply(op, x, y, z);
     this->_is_normalized = false;
   }
 
@@ -1115,7 +1710,7 @@ public:
       return;
     }
 
-    add_relation(x, y)->apply(op, x, y, z);
+    add_relation(x, y).apply(op, x, y, z);
     this->_is_normalized = false;
   }
 
@@ -1127,7 +1722,7 @@ public:
       return;
     }
 
-    add_relation(x, z)->apply(op, x, y, z);
+    add_relation(x, z).apply(op, x, y, z);
     this->_is_normalized = false;
   }
 
@@ -1152,10 +1747,7 @@ public:
       this->merge_unexisting_equiv_classes(root, term.first);
     }
 
-    EquivalenceClass& equiv_class =
-        this->_equiv_relation.find_equiv_class(*root);
-    equiv_class.copy_domain();
-    equiv_class.domain->add(cst);
+    this->_equiv_relation.find_mutable_domain(*root).add(cst);
     this->_is_normalized = false;
   }
 
@@ -1186,7 +1778,7 @@ public:
     }
 
     this->_equiv_relation.add_equiv_class(x);
-    this->_equiv_relation.find_domain(x)->set(x, value);
+    this->_equiv_relation.find_mutable_domain(x).set(x, value);
     this->_is_normalized = false;
   }
 
@@ -1211,7 +1803,7 @@ public:
     }
 
     this->_equiv_relation.add_equiv_class(x);
-    this->_equiv_relation.find_domain(x)->set(x, value);
+    this->_equiv_relation.find_mutable_domain(x).set(x, value);
     this->_is_normalized = false;
   }
 
@@ -1236,7 +1828,7 @@ public:
     }
 
     this->_equiv_relation.add_equiv_class(x);
-    this->_equiv_relation.find_domain(x)->set(x, value);
+    this->_equiv_relation.find_mutable_domain(x).set(x, value);
     this->_is_normalized = false;
   }
 
@@ -1255,13 +1847,11 @@ public:
     }
 
     if (this->_equiv_relation.contains(x)) {
-      EquivalenceClass& equiv_class = this->_equiv_relation.find_equiv_class(x);
-      equiv_class.copy_domain();
-      equiv_class.domain->refine(x, value);
+      this->_equiv_relation.find_mutable_domain(x).refine(x, value);
       this->_is_normalized = false;
     } else {
       this->_equiv_relation.add_equiv_class(x);
-      this->_equiv_relation.find_domain(x)->set(x, value);
+      this->_equiv_relation.find_mutable_domain(x).set(x, value);
     }
   }
 
@@ -1280,13 +1870,11 @@ public:
     }
 
     if (this->_equiv_relation.contains(x)) {
-      EquivalenceClass& equiv_class = this->_equiv_relation.find_equiv_class(x);
-      equiv_class.copy_domain();
-      equiv_class.domain->refine(x, value);
+      this->_equiv_relation.find_mutable_domain(x).refine(x, value);
       this->_is_normalized = false;
     } else {
       this->_equiv_relation.add_equiv_class(x);
-      this->_equiv_relation.find_domain(x)->set(x, value);
+      this->_equiv_relation.find_mutable_domain(x).set(x, value);
     }
   }
 
@@ -1305,13 +1893,11 @@ public:
     }
 
     if (this->_equiv_relation.contains(x)) {
-      EquivalenceClass& equiv_class = this->_equiv_relation.find_equiv_class(x);
-      equiv_class.copy_domain();
-      equiv_class.domain->refine(x, value);
+      this->_equiv_relation.find_mutable_domain(x).refine(x, value);
       this->_is_normalized = false;
     } else {
       this->_equiv_relation.add_equiv_class(x);
-      this->_equiv_relation.find_domain(x)->set(x, value);
+      this->_equiv_relation.find_mutable_domain(x).set(x, value);
     }
   }
 
@@ -1337,7 +1923,8 @@ public:
       return IntervalT::bottom();
     } else {
       if (this->_equiv_relation.contains(x)) {
-        return this->_equiv_relation.cfind_domain(x)->to_interval(x);
+        return query(*this->_equiv_relation.find_domain(x),
+                     [x](const Domain& d) { return d.to_interval(x); });
       } else {
         return IntervalT::top();
       }
@@ -1353,7 +1940,8 @@ public:
       return CongruenceT::bottom();
     } else {
       if (this->_equiv_relation.contains(x)) {
-        return this->_equiv_relation.cfind_domain(x)->to_congruence(x);
+        return query(*this->_equiv_relation.find_domain(x),
+                     [x](const Domain& d) { return d.to_congruence(x); });
       } else {
         return CongruenceT::top();
       }
@@ -1369,7 +1957,10 @@ public:
       return IntervalCongruenceT::bottom();
     } else {
       if (this->_equiv_relation.contains(x)) {
-        return this->_equiv_relation.cfind_domain(x)->to_interval_congruence(x);
+        return query(*this->_equiv_relation.find_domain(x),
+                     [x](const Domain& d) {
+                       return d.to_interval_congruence(x);
+                     });
       } else {
         return IntervalCongruenceT::top();
       }
@@ -1390,7 +1981,8 @@ public:
 
     LinearConstraintSystemT csts;
     for (const auto& equiv_class : this->_equiv_relation) {
-      csts.add(equiv_class.second.domain->to_linear_constraint_system());
+      csts.add(
+          normalized(*equiv_class.second.domain).to_linear_constraint_system());
     }
 
     return csts;
@@ -55,11 +55,18 @@
 
 #pragma once
 
+#include <algorithm>
+#include <deque>
 #include <iosfwd>
+#include <limits>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <boost/functional/hash.hpp>
+
 #include <ikos/core/semantic/dumpable.hpp>
 #include <ikos/core/semantic/indexable.hpp>
 #include <ikos/core/semantic/memory_location.hpp>
@@ -416,6 +423,21 @@ private:
       std::unordered_map< VariableRef, PointerAbsValueT, VariableHash >;
   using MemoryMap = std::
       unordered_map< MemoryLocationRef, PointerAbsValueT, MemoryLocationHash >;
+  using PointerUpdatesMap =
+      std::unordered_map< VariableRef, std::size_t, VariableHash >;
+  using MemoryUpdatesMap =
+      std::unordered_map< MemoryLocationRef, std::size_t, MemoryLocationHash >;
+  using PointerUsersMap = std::
+      unordered_map< VariableRef, std::vector< std::size_t >, VariableHash >;
+  using MemoryUsersMap = std::unordered_map< MemoryLocationRef,
+                                             std::vector< std::size_t >,
+                                             MemoryLocationHash >;
+  using RepresentativeMap =
+      std::unordered_map< VariableRef, VariableRef, VariableHash >;
+  using LoadTask = std::pair< std::size_t, MemoryLocationRef >;
+  using LoadTaskSet = std::unordered_set< std::pair< std::size_t, Index >,
+                                          boost::hash< std::pair< std::size_t,
+                                                                  Index > > >;
 
 public:
   using PointerIterator = typename PointerMap::const_iterator;
@@ -439,11 +461,37 @@ private:
   // Signedness of pointer offsets (usually Unsigned)
   Signedness _offsets_sign;
 
-  // Number of iterations
-  std::size_t _iteration = 0;
+  // Number of updates of each pointer variable, for the widening
+  PointerUpdatesMap _pointer_updates;
+
+  // Number of updates of each memory location, for the widening
+  MemoryUpdatesMap _memory_updates;
+
+  // Map from pointer variables to the indexes of the constraints reading them
+  PointerUsersMap _pointer_users;
+
+  // Map from memory locations to the indexes of the load constraints reading
+  // them, filled as the points-to sets of the load operands grow
+  MemoryUsersMap _memory_users;
+
+  // Set of pairs (load constraint, memory location) in `_memory_users`
+  LoadTaskSet _memory_users_set;
 
-  // Change seen during iteration
-  bool _change_seen = false;
+  // Map from pointer variables in a cycle of copy constraints `p = q + 0` to
+  // the representative of their cycle
+  RepresentativeMap _representatives;
+
+  // Worklist of constraint indexes whose inputs changed
+  std::deque< std::size_t > _worklist;
+
+  // Whether a constraint index is in `_worklist`
+  std::vector< bool > _in_worklist;
+
+  // Worklist of load constraints whose memory location changed
+  std::deque< LoadTask > _load_worklist;
+
+  // Set of pairs (load constraint, memory location) in `_load_worklist`
+  LoadTaskSet _in_load_worklist;
 
 public:
   /// \brief Default constructor
@@ -554,16 +602,17 @@ private:
   ///
   /// It processes all the constraints once.
   void step(const BinaryOp& op) {
-    for (auto it = this->_csts.begin(), et = this->_csts.end(); it != et;
-         ++it) {
-      this->process_constraint(it->get(), op);
+    for (std::size_t i = 0; i < this->_csts.size(); i++) {
+      this->process_constraint(i, op);
     }
   }
 
-  /// \brief Process the given constraint
+  /// \brief Process the constraint with the given index
   ///
-  /// It updates this->_pointers and this->_memory
-  void process_constraint(const ConstraintT* cst, const BinaryOp& op) {
+  /// It updates this->_pointers and this->_memory, and adds the constraints
+  /// depending on the updated values in the worklist.
+  void process_constraint(std::size_t index, const BinaryOp& op) {
+    const ConstraintT* cst = this->_csts[index].get();
     switch (cst->kind()) {
       case ConstraintT::AssignKind: {
         auto assign = static_cast< const AssignConstraintT* >(cst);
@@ -588,6 +637,7 @@ private:
           return;
         }
         for (MemoryLocationRef addr : op_value.points_to()) {
+          this->add_memory_user(addr, index);
           this->add_pointer(load->result(), this->get_memory(addr), op);
         }
       } break;
@@ -597,13 +647,27 @@ private:
     }
   }
 
+  /// \brief Process the load constraint with the given index, for the given
+  /// memory location only
+  ///
+  /// This is used when the value stored at `addr` changed: the other memory
+  /// locations pointed by the load operand do not need to be read again.
+  void process_load(std::size_t index,
+                    MemoryLocationRef addr,
+                    const BinaryOp& op) {
+    auto load = static_cast< const LoadConstraintT* >(this->_csts[index].get());
+    this->add_pointer(load->result(), this->get_memory(addr), op);
+  }
+
   /// \brief Return the abstract value for the given operand
   PointerAbsValueT process_operand(const OperandT* op) {
     switch (op->kind()) {
       case OperandT::VariableKind: {
         auto variable_op = static_cast< const VariableOperandT* >(op);
         PointerAbsValueT value = this->get_pointer(variable_op->var());
-        value.add_offset(variable_op->offset());
+        if (!variable_op->offset().is_zero()) {
+          value.add_offset(variable_op->offset());
+        }
         return value;
       }
       case OperandT::AddressKind: {
@@ -622,7 +686,7 @@ private:
 public:
   /// \brief Return the abstract value for the given pointer
   PointerAbsValueT get_pointer(VariableRef p) {
-    auto it = this->_pointers.find(p);
+    auto it = this->_pointers.find(this->representative(p));
     if (it == this->_pointers.end()) {
       return PointerAbsValueT::bottom(this->_offsets_bit_width,
                                       this->_offsets_sign);
@@ -656,10 +720,22 @@ public:
   MemoryIterator memory_end() const { return this->_memory.cend(); }
 
 private:
+  /// \brief Return the representative of the copy cycle of the given pointer
+  VariableRef representative(VariableRef p) const {
+    auto it = this->_representatives.find(p);
+    if (it == this->_representatives.end()) {
+      return p;
+    } else {
+      return it->second;
+    }
+  }
+
   /// \brief Add a pointer abstraction for the given pointer
   void add_pointer(VariableRef p,
                    const PointerAbsValueT& value,
                    const BinaryOp& op) {
+    p = this->representative(p);
+
     // Get a reference on the current value
     auto it = this->_pointers.find(p);
     if (it == this->_pointers.end()) {
@@ -670,7 +746,17 @@ private:
                                                        this->_offsets_sign));
       it = res.first;
     }
-    this->add_apply(it->second, value, op);
+    if (!this->add_apply(it->second, value, op, this->_pointer_updates[p])) {
+      return;
+    }
+
+    // Revisit the constraints reading `p`
+    auto users = this->_pointer_users.find(p);
+    if (users != this->_pointer_users.end()) {
+      for (std::size_t index : users->second) {
+        this->push(index);
+      }
+    }
   }
 
   /// \brief Add a pointer abstraction for the given memory location
@@ -687,30 +773,241 @@ private:
                                                        this->_offsets_sign));
       it = res.first;
     }
-    this->add_apply(it->second, value, op);
+    if (!this->add_apply(it->second, value, op, this->_memory_updates[m])) {
+      return;
+    }
+
+    // Revisit the load constraints reading `m`, for `m` only
+    auto users = this->_memory_users.find(m);
+    if (users != this->_memory_users.end()) {
+      for (std::size_t index : users->second) {
+        this->push_load(index, m);
+      }
+    }
   }
 
   /// \brief Add `after` in `before`, applying the given binary operator `op`
-  void add_apply(PointerAbsValueT& before,
+  ///
+  /// `updates` is the number of times `before` has been updated so far, it is
+  /// used in place of the iteration count by the operator.
+  ///
+  /// Returns true if `before` changed.
+  bool add_apply(PointerAbsValueT& before,
                  const PointerAbsValueT& after,
-                 const BinaryOp& op) {
-    if (!op.convergence_achieved(before, after)) {
-      this->_change_seen = true;
-      op.apply(before, after, this->_iteration);
+                 const BinaryOp& op,
+                 std::size_t& updates) {
+    if (op.convergence_achieved(before, after)) {
+      return false;
+    }
+    op.apply(before, after, updates++);
+    return true;
+  }
+
+  /// \brief Register the load constraint `index` as a reader of `m`
+  void add_memory_user(MemoryLocationRef m, std::size_t index) {
+    auto key =
+        std::make_pair(index, IndexableTraits< MemoryLocationRef >::index(m));
+    if (this->_memory_users_set.insert(key).second) {
+      this->_memory_users[m].push_back(index);
+    }
+  }
+
+  /// \brief Add the constraint `index` in the worklist
+  void push(std::size_t index) {
+    if (!this->_in_worklist[index]) {
+      this->_in_worklist[index] = true;
+      this->_worklist.push_back(index);
+    }
+  }
+
+  /// \brief Add the load constraint `index` for the memory location `m` in the
+  /// worklist
+  void push_load(std::size_t index, MemoryLocationRef m) {
+    auto key =
+        std::make_pair(index, IndexableTraits< MemoryLocationRef >::index(m));
+    if (this->_in_load_worklist.insert(key).second) {
+      this->_load_worklist.emplace_back(index, m);
+    }
+  }
+
+  /// \brief Collapse the cycles of copy constraints `p = q + 0`
+  ///
+  /// All the pointers in a strongly connected component of the copy graph have
+  /// the same value at the fixpoint, hence they share the value of a
+  /// representative during the resolution.
+  void collapse_copy_cycles() {
+    // Build the copy graph
+    std::unordered_map< VariableRef, std::size_t, VariableHash > node_ids;
+    std::vector< VariableRef > nodes;
+    std::vector< std::vector< std::size_t > > successors;
+    auto node = [&](VariableRef v) {
+      auto res = node_ids.emplace(v, nodes.size());
+      if (res.second) {
+        nodes.push_back(v);
+        successors.emplace_back();
+      }
+      return res.first->second;
+    };
+    for (const auto& cst : this->_csts) {
+      if (cst->kind() != ConstraintT::AssignKind) {
+        continue;
+      }
+      auto assign = static_cast< const AssignConstraintT* >(cst.get());
+      if (assign->operand()->kind() != OperandT::VariableKind) {
+        continue;
+      }
+      auto variable_op =
+          static_cast< const VariableOperandT* >(assign->operand());
+      if (!variable_op->offset().is_zero()) {
+        continue;
+      }
+      std::size_t src = node(variable_op->var());
+      std::size_t dest = node(assign->result());
+      successors[src].push_back(dest);
+    }
+
+    // Tarjan's algorithm, without recursion
+    const std::size_t undefined = std::numeric_limits< std::size_t >::max();
+    std::vector< std::size_t > dfs_num(nodes.size(), undefined);
+    std::vector< std::size_t > low_link(nodes.size(), 0);
+    std::vector< bool > on_stack(nodes.size(), false);
+    std::vector< std::size_t > stack;
+    std::vector< std::pair< std::size_t, std::size_t > > call_stack;
+    std::size_t next_dfs_num = 0;
+
+    auto visit = [&](std::size_t v) {
+      dfs_num[v] = low_link[v] = next_dfs_num++;
+      stack.push_back(v);
+      on_stack[v] = true;
+      call_stack.emplace_back(v, 0);
+    };
+
+    for (std::size_t root = 0; root < nodes.size(); root++) {
+      if (dfs_num[root] != undefined) {
+        continue;
+      }
+      visit(root);
+      while (!call_stack.empty()) {
+        std::size_t v = call_stack.back().first;
+        std::size_t pos = call_stack.back().second;
+        if (pos < successors[v].size()) {
+          call_stack.back().second++;
+          std::size_t w = successors[v][pos];
+          if (dfs_num[w] == undefined) {
+            visit(w);
+          } else if (on_stack[w]) {
+            low_link[v] = std::min(low_link[v], dfs_num[w]);
+          }
+          continue;
+        }
+
+        call_stack.pop_back();
+        if (!call_stack.empty()) {
+          std::size_t u = call_stack.back().first;
+          low_link[u] = std::min(low_link[u], low_link[v]);
+        }
+        if (low_link[v] == dfs_num[v]) {
+          // v is the root of a strongly connected component
+          std::size_t w;
+          do {
+            w = stack.back();
+            stack.pop_back();
+            on_stack[w] = false;
+            if (w != v) {
+              this->_representatives.emplace(nodes[w], nodes[v]);
+            }
+          } while (w != v);
+        }
+      }
+    }
+  }
+
+  /// \brief Index the constraints by the pointer variables they read
+  void index_pointer_users() {
+    for (std::size_t i = 0; i < this->_csts.size(); i++) {
+      const ConstraintT* cst = this->_csts[i].get();
+      const OperandT* operand = nullptr;
+      switch (cst->kind()) {
+        case ConstraintT::AssignKind: {
+          operand = static_cast< const AssignConstraintT* >(cst)->operand();
+        } break;
+        case ConstraintT::StoreKind: {
+          auto store = static_cast< const StoreConstraintT* >(cst);
+          operand = store->operand();
+          this->_pointer_users[this->representative(store->pointer())]
+              .push_back(i);
+        } break;
+        case ConstraintT::LoadKind: {
+          operand = static_cast< const LoadConstraintT* >(cst)->operand();
+        } break;
+        default: {
+          ikos_unreachable("unexpected kind");
+        }
+      }
+      if (operand->kind() == OperandT::VariableKind) {
+        VariableRef var =
+            static_cast< const VariableOperandT* >(operand)->var();
+        std::vector< std::size_t >& users =
+            this->_pointer_users[this->representative(var)];
+        if (users.empty() || users.back() != i) {
+          users.push_back(i);
+        }
+      }
     }
   }
 
 public:
   /// \brief Solve the constraint system
+  ///
+  /// This uses a worklist: each constraint is processed once, then only when
+  /// one of the values it reads changed. Pointers in a cycle of copy
+  /// constraints are collapsed beforehand.
+  ///
+  /// The widening is applied on a value after it has been updated
+  /// `widening_threshold` times.
   void solve(std::size_t widening_threshold = 50,
              std::size_t /*narrowing_threshold*/ = 1) {
-    this->_iteration = 0;
+    this->_pointer_updates.clear();
+    this->_memory_updates.clear();
+    this->_pointer_users.clear();
+    this->_memory_users.clear();
+    this->_memory_users_set.clear();
+    this->_representatives.clear();
+    this->_worklist.clear();
+    this->_in_worklist.assign(this->_csts.size(), false);
+    this->_load_worklist.clear();
+    this->_in_load_worklist.clear();
+
+    this->collapse_copy_cycles();
+    this->index_pointer_users();
+
     Extrapolate widening_op(widening_threshold);
-    do {
-      this->_iteration++;
-      this->_change_seen = false;
-      this->step(widening_op);
-    } while (this->_change_seen);
+    for (std::size_t i = 0; i < this->_csts.size(); i++) {
+      this->push(i);
+    }
+    while (!this->_worklist.empty() || !this->_load_worklist.empty()) {
+      if (!this->_worklist.empty()) {
+        std::size_t index = this->_worklist.front();
+        this->_worklist.pop_front();
+        this->_in_worklist[index] = false;
+        this->process_constraint(index, widening_op);
+      } else {
+        LoadTask task = this->_load_worklist.front();
+        this->_load_worklist.pop_front();
+        this->_in_load_worklist.erase(std::make_pair(
+            task.first,
+            IndexableTraits< MemoryLocationRef >::index(task.second)));
+        this->process_load(task.first, task.second, widening_op);
+      }
+    }
+
+    // Give the collapsed pointers the value of their representative
+    for (const auto& entry : this->_representatives) {
+      auto it = this->_pointers.find(entry.second);
+      if (it != this->_pointers.end()) {
+        this->_pointers.emplace(entry.first, it->second);
+      }
+    }
 
     // TODO(marthaud): commented out because this is unsound.
     //
@@ -725,8 +1022,7 @@ public:
     // See https://babelfish.arc.nasa.gov/jira/projects/IKOS/issues/IKOS-71
 
     // Refine narrowing_op;
-    // this->_iteration = 0;
-    // for (; this->_iteration < narrowing_threshold; ++this->_iteration) {
+    // for (std::size_t i = 0; i < narrowing_threshold; ++i) {
     //  this->step(narrowing_op);
     // }
   }
@@ -47,6 +47,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -729,6 +730,9 @@ private:
   // Invariant at checkpoints
   std::unordered_map< std::string, AbstractDomain > _checkpoints;
 
+  // Mutex on the checkpoints, when analyzing components concurrently
+  std::mutex _checkpoints_mutex;
+
 public:
   /// \brief Create a fixpoint iterator on the given ControlFlowGraph
   explicit FixpointIterator(ControlFlowGraphT& cfg)
@@ -763,6 +767,8 @@ private:
 
     std::unordered_map< std::string, AbstractDomain >& checkpoints;
 
+    std::mutex& checkpoints_mutex;
+
   public:
     using ResultType = void;
 
@@ -787,6 +793,7 @@ private:
     void operator()(QLinearAssertionT* s) { inv.second().add(s->constraint()); }
 
     void operator()(CheckPointT* s) {
+      std::lock_guard< std::mutex > lock(checkpoints_mutex);
       auto it = checkpoints.find(s->name());
       if (it != checkpoints.end()) {
         it->second = inv;
@@ -804,7 +811,9 @@ public:
   /// of the program upon entering the node. The method should return an
   /// abstract value representing the state of the program after the node.
   AbstractDomain analyze_node(BasicBlockT* bb, AbstractDomain inv) override {
-    ExecutionEngine engine{std::move(inv), this->_checkpoints};
+    ExecutionEngine engine{std::move(inv),
+                           this->_checkpoints,
+                           this->_checkpoints_mutex};
     for (StatementT* stmt : *bb) {
       apply_visitor(engine, stmt);
     }
@@ -0,0 +1,273 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Concurrent iteration over the components of a weak topological order
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <ikos/core/semantic/graph.hpp>
+#include <ikos/core/support/assert.hpp>
+
+namespace ikos {
+namespace core {
+
+namespace concurrent_wto_impl {
+
+/// \brief Collect the nodes of a weak topological order component
+template < typename ComponentVisitor, typename NodeRef >
+class NodeCollector final : public ComponentVisitor {
+public:
+  using WtoVertexT = typename ComponentVisitor::WtoVertexT;
+  using WtoCycleT = typename ComponentVisitor::WtoCycleT;
+
+private:
+  /// \brief Map from node to component index
+  std::unordered_map< NodeRef, std::size_t >& _component;
+
+  /// \brief Current component index
+  std::size_t _index;
+
+public:
+  NodeCollector(std::unordered_map< NodeRef, std::size_t >& component,
+                std::size_t index)
+      : _component(component), _index(index) {}
+
+  void visit(const WtoVertexT& vertex) override {
+    this->_component[vertex.node()] = this->_index;
+  }
+
+  void visit(const WtoCycleT& cycle) override {
+    this->_component[cycle.head()] = this->_index;
+    for (auto it = cycle.begin(), et = cycle.end(); it != et; ++it) {
+      it->accept(*this);
+    }
+  }
+
+}; // end class NodeCollector
+
+} // end namespace concurrent_wto_impl
+
+/// \brief Dependency graph between the top-level components of a weak
+/// topological order
+///
+/// Component `j` depends on component `i` if there is an edge from a node of
+/// `i` to a node of `j`. Since components are topologically sorted, `i < j`.
+template < typename GraphRef,
+           typename GraphTrait,
+           typename ComponentVisitor,
+           typename WtoT >
+class WtoComponentGraph {
+public:
+  using NodeRef = typename GraphTrait::NodeRef;
+  using WtoComponentT = typename WtoT::WtoComponentT;
+
+private:
+  /// \brief Top-level components, in the weak topological order
+  std::vector< const WtoComponentT* > _components;
+
+  /// \brief Map from node to the index of its top-level component
+  std::unordered_map< NodeRef, std::size_t > _component;
+
+  /// \brief Successors of each component
+  std::vector< std::vector< std::size_t > > _successors;
+
+public:
+  /// \brief Build the dependency graph of the given weak topological order
+  explicit WtoComponentGraph(const WtoT& wto) {
+    for (auto it = wto.begin(), et = wto.end(); it != et; ++it) {
+      concurrent_wto_impl::NodeCollector< ComponentVisitor, NodeRef > collector(
+          this->_component, this->_components.size());
+      it->accept(collector);
+      this->_components.push_back(&*it);
+    }
+    this->_successors.resize(this->_components.size());
+
+    for (const auto& entry : this->_component) {
+      NodeRef node = entry.first;
+      for (auto it = GraphTrait::successor_begin(node),
+                et = GraphTrait::successor_end(node);
+           it != et;
+           ++it) {
+        this->add_edge(node, *it);
+      }
+    }
+  }
+
+  /// \brief Return the number of top-level components
+  std::size_t size() const { return this->_components.size(); }
+
+  /// \brief Return the top-level component with the given index
+  const WtoComponentT& component(std::size_t i) const {
+    return *this->_components[i];
+  }
+
+  /// \brief Return the successors of each component
+  const std::vector< std::vector< std::size_t > >& successors() const {
+    return this->_successors;
+  }
+
+private:
+  /// \brief Add a dependency so that the component of `dest` runs after the
+  /// component of `src`
+  ///
+  /// This does nothing if both nodes are in the same component, or if `dest`
+  /// comes first in the weak topological order.
+  void add_edge(NodeRef src, NodeRef dest) {
+    auto src_it = this->_component.find(src);
+    auto dest_it = this->_component.find(dest);
+    if (src_it == this->_component.end() ||
+        dest_it == this->_component.end()) {
+      return;
+    }
+    if (src_it->second >= dest_it->second) {
+      return;
+    }
+    auto& successors = this->_successors[src_it->second];
+    if (std::find(successors.begin(), successors.end(), dest_it->second) ==
+        successors.end()) {
+      successors.push_back(dest_it->second);
+    }
+  }
+
+}; // end class WtoComponentGraph
+
+/// \brief Run a graph of tasks concurrently
+///
+/// `successors[i]` is the list of tasks that depend on task `i`, and must only
+/// contain tasks greater than `i`. `run(i)` is called on one of `jobs` threads
+/// once all the tasks that `i` depends on are finished.
+///
+/// Ready tasks are kept in one set shared by all threads, rather than in
+/// per-thread queues with work stealing: tasks are whole top-level components,
+/// hence there are few of them. Ready tasks are started in increasing order,
+/// hence tasks run in order when `jobs` is 1.
+///
+/// If a task throws an exception, no new task is started, and the first
+/// exception is rethrown once all threads are done.
+template < typename Function >
+void run_task_graph(const std::vector< std::vector< std::size_t > >& successors,
+                    unsigned jobs,
+                    Function run) {
+  std::size_t num_tasks = successors.size();
+  std::vector< std::size_t > num_predecessors(num_tasks, 0);
+  for (std::size_t i = 0; i < num_tasks; i++) {
+    for (std::size_t j : successors[i]) {
+      ikos_assert(i < j);
+      num_predecessors[j]++;
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::set< std::size_t > ready;
+  std::size_t finished = 0;
+  std::exception_ptr error = nullptr;
+
+  for (std::size_t i = 0; i < num_tasks; i++) {
+    if (num_predecessors[i] == 0) {
+      ready.insert(i);
+    }
+  }
+
+  auto worker = [&]() {
+    std::unique_lock< std::mutex > lock(mutex);
+
+    while (true) {
+      cond.wait(lock, [&] {
+        return error != nullptr || finished == num_tasks || !ready.empty();
+      });
+
+      if (error != nullptr || finished == num_tasks) {
+        return;
+      }
+
+      std::size_t task = *ready.begin();
+      ready.erase(ready.begin());
+      lock.unlock();
+      try {
+        run(task);
+      } catch (...) {
+        lock.lock();
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        cond.notify_all();
+        return;
+      }
+      lock.lock();
+      finished++;
+
+      for (std::size_t succ : successors[task]) {
+        if (--num_predecessors[succ] == 0) {
+          ready.insert(succ);
+        }
+      }
+
+      cond.notify_all();
+    }
+  };
+
+  if (jobs <= 1) {
+    worker();
+  } else {
+    std::vector< std::thread > threads;
+    threads.reserve(jobs);
+    for (unsigned i = 0; i < jobs; i++) {
+      threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // end namespace core
+} // end namespace ikos
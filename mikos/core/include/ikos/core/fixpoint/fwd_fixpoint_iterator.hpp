@@ -48,9 +48,11 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 
+#include <ikos/core/fixpoint/concurrent_wto.hpp>
 #include <ikos/core/fixpoint/fixpoint_iterator.hpp>
 #include <ikos/core/fixpoint/wto.hpp>
 
@@ -89,6 +91,11 @@ private:
       WtoIterator< GraphRef, AbstractValue, GraphTrait >;
   using WtoProcessor = interleaved_fwd_fixpoint_iterator_impl::
       WtoProcessor< GraphRef, AbstractValue, GraphTrait >;
+  using WtoComponentGraphT =
+      WtoComponentGraph< GraphRef,
+                         GraphTrait,
+                         WtoComponentVisitor< GraphRef, GraphTrait >,
+                         WtoT >;
 
 private:
   GraphRef _cfg;
@@ -97,6 +104,12 @@ private:
   InvariantTable _post;
   AbstractValue _bottom;
 
+  /// \brief Number of threads used to analyze top-level components
+  unsigned _jobs = 1;
+
+  /// \brief Mutex on the invariant tables, when using several threads
+  std::unique_ptr< std::mutex > _mutex;
+
 public:
   /// \brief Create an interleaved forward fixpoint iterator
   ///
@@ -129,9 +142,42 @@ public:
   /// \brief Get the bottom abstract value
   const AbstractValue& bottom() const { return this->_bottom; }
 
+  /// \brief Set the number of threads used to compute the fixpoint
+  ///
+  /// Top-level components of the weak topological order that do not depend on
+  /// each other are analyzed concurrently. Components nested in a cycle are
+  /// analyzed by the thread running the cycle. The result does not depend on
+  /// the number of threads.
+  ///
+  /// With more than one thread, the user-defined methods (`analyze_node`,
+  /// `analyze_edge`, `extrapolate`, etc.) are called concurrently, and must be
+  /// thread-safe. `process_pre` and `process_post` are still called
+  /// sequentially, in the weak topological order.
+  void set_jobs(unsigned jobs) {
+    this->_jobs = jobs;
+    if (jobs > 1) {
+      this->_mutex = std::make_unique< std::mutex >();
+    } else {
+      this->_mutex.reset();
+    }
+  }
+
+  /// \brief Return the number of threads used to compute the fixpoint
+  unsigned jobs() const { return this->_jobs; }
+
 private:
+  /// \brief Lock the invariant tables, when using several threads
+  std::unique_lock< std::mutex > lock_tables() const {
+    if (this->_mutex) {
+      return std::unique_lock< std::mutex >(*this->_mutex);
+    } else {
+      return std::unique_lock< std::mutex >();
+    }
+  }
+
   /// \brief Set the invariant for the given node
   void set(InvariantTable& table, NodeRef node, AbstractValue inv) const {
+    auto lock = this->lock_tables();
     auto it = table.find(node);
     if (it != table.end()) {
       it->second = std::move(inv);
@@ -152,6 +198,7 @@ private:
 
   /// \brief Get the invariant for the given node
   const AbstractValue& get(const InvariantTable& table, NodeRef node) const {
+    auto lock = this->lock_tables();
     auto it = table.find(node);
     if (it != table.end()) {
       return it->second;
@@ -279,8 +326,16 @@ public:
     this->set_pre(GraphTrait::entry(this->_cfg), std::move(init));
 
     // Compute the fixpoint
-    WtoIterator iterator(*this);
-    this->_wto.accept(iterator);
+    if (this->_jobs > 1) {
+      WtoComponentGraphT graph(this->_wto);
+      run_task_graph(graph.successors(), this->_jobs, [&](std::size_t i) {
+        WtoIterator iterator(*this);
+        graph.component(i).accept(iterator);
+      });
+    } else {
+      WtoIterator iterator(*this);
+      this->_wto.accept(iterator);
+    }
 
     // Call process_pre/process_post methods
     WtoProcessor processor(*this);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <iterator>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -24,6 +25,11 @@ class WtoProcessor;
 /// \brief Interleaved forward fixpoint iterator
 ///
 /// This class computes a fixpoint on a control flow graph.
+///
+/// Components are analyzed sequentially, in the weak topological order. Unlike
+/// FwdFixpointIterator, there is no concurrent mode: the deallocation of
+/// invariants (`last_user`, component predecessors) and the checks run during
+/// the fixpoint assume this order.
 template < typename GraphRef,
            typename AbstractValue,
            typename GraphTrait = GraphTraits< GraphRef > >
@@ -35,6 +41,7 @@ class InterleavedFwdFixpointIterator
 private:
   using NodeRef = typename GraphTrait::NodeRef;
   using InvariantTable = std::unordered_map< NodeRef, AbstractValue >;
+  using DeltaTable = std::unordered_map< NodeRef, NodeRef >;
   using WtoT = Wto< GraphRef, GraphTrait >;
   using WtoIterator = interleaved_fwd_fixpoint_iterator_impl::
       WtoIterator< GraphRef, AbstractValue, GraphTrait >;
@@ -46,7 +53,9 @@ private:
   WtoT _wto;
   InvariantTable _pre;
   InvariantTable _post;
+  DeltaTable _delta_pre;
   bool _defer_checks;
+  bool _use_delta_pre = false;
   NodeRef _exit;
   AbstractValue _bottom;
 
@@ -90,6 +99,17 @@ public:
   /// \brief Get the bottom abstract value
   const AbstractValue& bottom() const { return this->_bottom; }
 
+  /// \brief Enable the delta encoding of the cached pre invariants
+  ///
+  /// A cached pre invariant of a node with a single predecessor, whose pre
+  /// invariant is also cached, is not stored. It is recorded as derived from
+  /// the predecessor instead, and materialized by
+  /// `materialize_delta_pre()` when the predecessor runs its deferred checks.
+  void set_delta_pre(bool enabled) { this->_use_delta_pre = enabled; }
+
+  /// \brief Return true if the delta encoding of pre invariants is enabled
+  bool use_delta_pre() const { return this->_use_delta_pre; }
+
 private:
   /// \brief Set the invariant for the given node
   void set(InvariantTable& table, NodeRef node, AbstractValue inv) const {
@@ -114,6 +134,40 @@ private:
     this->set(this->_post, node, std::move(inv));
   }
 
+  /// \brief Return the node a cached pre invariant can be derived from
+  ///
+  /// Return null if the pre invariant of the node must be stored.
+  NodeRef delta_pre_base(NodeRef node) const {
+    if (!this->_use_delta_pre) {
+      return nullptr;
+    }
+    auto it = GraphTrait::predecessor_begin(node);
+    auto et = GraphTrait::predecessor_end(node);
+    if (it == et || std::next(it) != et) {
+      return nullptr;
+    }
+    NodeRef pred = *it;
+    if (pred == node || this->_wto.is_head(pred)) {
+      // The pre invariant of a head is cached after the stabilization of its
+      // component, which differs from the one used by its successors
+      return nullptr;
+    }
+    if (this->_pre.find(pred) == this->_pre.end() &&
+        this->_delta_pre.find(pred) == this->_delta_pre.end()) {
+      return nullptr;
+    }
+    return pred;
+  }
+
+  /// \brief Record that the pre invariant of a node is derived from `base`
+  void record_delta_pre(NodeRef node, NodeRef base) {
+    auto res = this->_delta_pre.emplace(node, base);
+    ikos_assert(res.second);
+    if (!res.second) {
+      exit(101);
+    }
+  }
+
   /// \brief Erase the invariant for the given node
   void erase(InvariantTable& table, NodeRef node) const {
     auto it = table.find(node);
@@ -138,6 +192,9 @@ private:
 protected:
   /// \brief Erase the pre invariant for the given node
   void erase_pre(NodeRef node) {
+    if (this->_delta_pre.erase(node) != 0) {
+      return;
+    }
     this->erase(this->_pre, node);
   }
 
@@ -151,6 +208,51 @@ protected:
     return this->_pre;
   }
 
+  /// \brief Accessor for the pre invariants derived from a predecessor
+  const DeltaTable& delta_pre() const { return this->_delta_pre; }
+
+  /// \brief Return true if the pre invariant of the node is cached
+  ///
+  /// This holds for both stored and derived pre invariants.
+  bool has_pre(NodeRef node) const {
+    return this->_pre.find(node) != this->_pre.end() ||
+           this->_delta_pre.find(node) != this->_delta_pre.end();
+  }
+
+  /// \brief Return the node the pre invariant of `node` is derived from
+  ///
+  /// Return null if the pre invariant is stored, or not cached.
+  NodeRef delta_pre_base_of(NodeRef node) const {
+    auto it = this->_delta_pre.find(node);
+    if (it != this->_delta_pre.end()) {
+      return it->second;
+    } else {
+      return nullptr;
+    }
+  }
+
+  /// \brief Materialize the pre invariants derived from the given node
+  ///
+  /// This must be called with the post invariant of `node` when running its
+  /// deferred checks, before its pre invariant is lost.
+  void materialize_delta_pre(NodeRef node, const AbstractValue& post) {
+    if (!this->_use_delta_pre) {
+      return;
+    }
+    for (auto it = GraphTrait::successor_begin(node),
+              et = GraphTrait::successor_end(node);
+         it != et;
+         ++it) {
+      NodeRef succ = *it;
+      auto d = this->_delta_pre.find(succ);
+      if (d == this->_delta_pre.end() || d->second != node) {
+        continue;
+      }
+      this->_delta_pre.erase(d);
+      this->set_pre(succ, this->analyze_edge(node, succ, post));
+    }
+  }
+
 public:
   /// \brief Get the pre invariant for the given node
   const AbstractValue& pre(NodeRef node) const {
@@ -282,8 +384,10 @@ public:
       this->erase_post(exit_block);
     }
 
-    ikos_assert(this->_defer_checks || this->_pre.empty());
-    if (!this->_defer_checks && !this->_pre.empty()) {
+    ikos_assert(this->_defer_checks ||
+                (this->_pre.empty() && this->_delta_pre.empty()));
+    if (!this->_defer_checks &&
+        (!this->_pre.empty() || !this->_delta_pre.empty())) {
       exit(104);
     }
     ikos_assert(this->_post.empty());
@@ -295,7 +399,10 @@ public:
   }
 
   /// \brief Clear the pre invariants
-  void clear_pre() { this->_pre.clear(); }
+  void clear_pre() {
+    this->_pre.clear();
+    this->_delta_pre.clear();
+  }
 
   /// \brief Clear the post invariants
   void clear_post() { this->_post.clear(); }
@@ -303,6 +410,7 @@ public:
   /// \brief Clear the current fixpoint
   void clear() {
     this->_pre.clear();
+    this->_delta_pre.clear();
     this->_post.clear();
   }
 
@@ -367,8 +475,14 @@ public:
 
     // Delete node's PRE value if the node is toplevel or does not has check.
     // That is, cache if node is in some loop and has check.
+    // With the delta encoding, only record the predecessor it derives from.
     if (cache_values) {
-      this->_iterator.set_pre(node, pre);
+      NodeRef base = this->_iterator.delta_pre_base(node);
+      if (base != nullptr) {
+        this->_iterator.record_delta_pre(node, base);
+      } else {
+        this->_iterator.set_pre(node, pre);
+      }
     }
 
     this->_iterator.set_post(node, std::move(this->_iterator.analyze_node(node,
@@ -259,6 +259,8 @@ private:
   NodeRefSet _is_in_loop_set;
   // Heads of outermost components.
   NodeRefSet _is_outermost_component_set;
+  // Heads of components.
+  NodeRefSet _is_head_set;
   const NodeRefSet _empty_set;
 
   /// \brief Return the post depth-first number of the given node
@@ -368,6 +370,11 @@ public:
       this->_is_outermost_component_set.end();
   }
 
+  /// \brief Return true if the node is the head of a component.
+  bool is_head(NodeRef node) const {
+    return this->_is_head_set.find(node) != this->_is_head_set.end();
+  }
+
   /// \brief Return true if the node is in a loop.
   bool is_in_loop(NodeRef node) const {
     return this->_is_in_loop_set.find(node) != this->_is_in_loop_set.end();
@@ -418,6 +425,7 @@ public:
     _has_check_set.clear();
     _is_in_loop_set.clear();
     _is_outermost_component_set.clear();
+    _is_head_set.clear();
   }
 
   template <typename T1, typename T2>
@@ -838,6 +846,7 @@ class WtoBuilder final {
 
   void set_head(NodeRef node) {
     this->_is_head.insert(node);
+    this->_wto._is_head_set.insert(node);
   }
 
   void set_in_loop(NodeRef node) {
@@ -49,6 +49,7 @@
 
 #include <type_traits>
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/exception.hpp>
@@ -477,6 +478,18 @@ inline std::ostream& operator<<(std::ostream& o, const Bound< Number >& bound) {
   return o;
 }
 
+/// \brief Return the hash of a bound
+template < typename Number >
+inline std::size_t hash_value(const Bound< Number >& bound) {
+  std::size_t hash = 0;
+  if (bound.is_finite()) {
+    boost::hash_combine(hash, *bound.number());
+  } else {
+    boost::hash_combine(hash, bound.is_plus_infinity() ? 1 : -1);
+  }
+  return hash;
+}
+
 /// \brief Bound on unlimited precision integers
 using ZBound = Bound< ZNumber >;
 
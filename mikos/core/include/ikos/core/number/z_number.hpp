@@ -46,8 +46,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -60,6 +63,7 @@
 #include <ikos/core/number/exception.hpp>
 #include <ikos/core/number/supported_integral.hpp>
 #include <ikos/core/support/assert.hpp>
+#include <ikos/core/support/compiler.hpp>
 
 namespace ikos {
 namespace core {
@@ -283,12 +287,154 @@ template <>
 struct MpzTo< long long >
     : public MpzToLongLong< sizeof(long long) == sizeof(long) > {};
 
+/// \brief Return true if `a + b` overflows, otherwise store the sum in `r`
+inline bool add_overflow(int64_t a, int64_t b, int64_t& r) {
+#if __has_builtin(__builtin_add_overflow) || IKOS_GNUC_PREREQ(5, 0, 0)
+  return __builtin_add_overflow(a, b, &r);
+#else
+  if ((b > 0 && a > std::numeric_limits< int64_t >::max() - b) ||
+      (b < 0 && a < std::numeric_limits< int64_t >::min() - b)) {
+    return true;
+  }
+  r = a + b;
+  return false;
+#endif
+}
+
+/// \brief Return true if `a - b` overflows, otherwise store the difference in
+/// `r`
+inline bool sub_overflow(int64_t a, int64_t b, int64_t& r) {
+#if __has_builtin(__builtin_sub_overflow) || IKOS_GNUC_PREREQ(5, 0, 0)
+  return __builtin_sub_overflow(a, b, &r);
+#else
+  if ((b < 0 && a > std::numeric_limits< int64_t >::max() + b) ||
+      (b > 0 && a < std::numeric_limits< int64_t >::min() + b)) {
+    return true;
+  }
+  r = a - b;
+  return false;
+#endif
+}
+
+/// \brief Return true if `a * b` overflows, otherwise store the product in `r`
+inline bool mul_overflow(int64_t a, int64_t b, int64_t& r) {
+#if __has_builtin(__builtin_mul_overflow) || IKOS_GNUC_PREREQ(5, 0, 0)
+  return __builtin_mul_overflow(a, b, &r);
+#else
+  if (a == 0 || b == 0) {
+    r = 0;
+    return false;
+  }
+  if ((a == -1 && b == std::numeric_limits< int64_t >::min()) ||
+      (b == -1 && a == std::numeric_limits< int64_t >::min())) {
+    return true;
+  }
+  auto p = static_cast< int64_t >(static_cast< uint64_t >(a) *
+                                  static_cast< uint64_t >(b));
+  if (p / b != a) {
+    return true;
+  }
+  r = p;
+  return false;
+#endif
+}
+
+/// \brief Helper to check if an integral type fits in a int64_t
+template < typename T >
+struct Int64Fits {
+  bool operator()(T n) {
+    return std::is_signed< T >::value ||
+           static_cast< uint64_t >(n) <=
+               static_cast< uint64_t >(std::numeric_limits< int64_t >::max());
+  }
+};
+
+/// \brief Helper to check if a int64_t fits in the given integer type
+template < typename T >
+struct Int64FitsIn {
+  bool operator()(int64_t n) {
+    if (n < 0) {
+      return std::is_signed< T >::value &&
+             n >= static_cast< int64_t >(std::numeric_limits< T >::min());
+    } else {
+      return static_cast< uint64_t >(n) <=
+             static_cast< uint64_t >(std::numeric_limits< T >::max());
+    }
+  }
+};
+
 } // end namespace detail
 
 /// \brief Class for unlimited precision integers
+///
+/// Numbers that fit in a int64_t are stored inline and the arithmetic is
+/// performed with overflow-checked machine instructions. On overflow, the
+/// number is promoted to a GMP integer.
 class ZNumber {
 private:
-  mpz_class _n;
+  /// If the number fits in a int64_t, store directly the integer,
+  /// Otherwise use a pointer on a mpz_class.
+  union {
+    int64_t i;    /// Used to store the small integer value.
+    mpz_class* p; /// Used to store the large integer value.
+  } _n;
+  bool _is_large;
+
+  // Invariant: _is_large => the number does not fit in a int64_t
+
+private:
+  /// \brief Return true if the number is stored in a int64_t
+  bool is_small() const { return ikos_likely(!this->_is_large); }
+
+  /// \brief Return true if the number is stored in a mpz_class
+  bool is_large() const { return !this->is_small(); }
+
+  /// \brief Return -1, 0 or 1 whether the number is negative, zero or positive
+  int sign() const {
+    if (this->is_small()) {
+      return static_cast< int >(this->_n.i > 0) -
+             static_cast< int >(this->_n.i < 0);
+    } else {
+      return mpz_sgn(this->_n.p->get_mpz_t());
+    }
+  }
+
+  /// \brief Set the number to the given int64_t
+  void set_small(int64_t n) {
+    if (this->is_large()) {
+      delete this->_n.p;
+      this->_is_large = false;
+    }
+    this->_n.i = n;
+  }
+
+  /// \brief Set the number to the given mpz_class
+  ///
+  /// The number is demoted to a int64_t if it fits.
+  void set_large(const mpz_class& n) {
+    if (detail::MpzFits< int64_t >()(n)) {
+      this->set_small(detail::MpzTo< int64_t >()(n));
+    } else if (this->is_large()) {
+      *this->_n.p = n;
+    } else {
+      this->_n.p = new mpz_class(n);
+      this->_is_large = true;
+    }
+  }
+
+  /// \brief Set the number to the given mpz_class
+  ///
+  /// The number is demoted to a int64_t if it fits.
+  void set_large(mpz_class&& n) {
+    if (detail::MpzFits< int64_t >()(n)) {
+      this->set_small(detail::MpzTo< int64_t >()(n));
+    } else if (this->is_large()) {
+      *this->_n.p = std::move(n);
+    } else {
+      this->_n.p = new mpz_class(std::move(n));
+      this->_is_large = true;
+    }
+  }
 
 public:
   /// \brief Create a ZNumber from a string representation
@@ -331,50 +477,110 @@ public:
   /// @{
 
   /// \brief Default constructor that creates a ZNumber equals to 0
-  ZNumber() = default;
+  ZNumber() noexcept : _is_large(false) { this->_n.i = 0; }
 
   /// \brief Copy constructor
-  ZNumber(const ZNumber&) = default;
+  ZNumber(const ZNumber& o) : _is_large(o._is_large) {
+    if (o.is_small()) {
+      this->_n.i = o._n.i;
+    } else {
+      this->_n.p = new mpz_class(*o._n.p);
+    }
+  }
 
   /// \brief Move constructor
-  // TODO(marthaud): Add noexcept when mpz_class(mpz_class&&) becomes noexcept
-  ZNumber(ZNumber&&) = default;
+  ZNumber(ZNumber&& o) noexcept : _n(o._n), _is_large(o._is_large) {
+    o._is_large = false; // do not delete o._n.p
+  }
 
   /// \brief Create a ZNumber from a mpz_class
-  explicit ZNumber(const mpz_class& n) : _n(n) {}
+  explicit ZNumber(const mpz_class& n) : _is_large(false) {
+    this->_n.i = 0;
+    this->set_large(n);
+  }
 
   /// \brief Create a ZNumber from a mpz_class
-  explicit ZNumber(mpz_class&& n) : _n(std::move(n)) {}
+  explicit ZNumber(mpz_class&& n) : _is_large(false) {
+    this->_n.i = 0;
+    this->set_large(std::move(n));
+  }
 
   /// \brief Create a ZNumber from an integral type
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
-  explicit ZNumber(T n) : _n(detail::MpzAdapter< T >()(n)) {}
+  explicit ZNumber(T n) : _is_large(!detail::Int64Fits< T >()(n)) {
+    if (this->is_small()) {
+      this->_n.i = static_cast< int64_t >(n);
+    } else {
+      this->_n.p = new mpz_class(detail::MpzAdapter< T >()(n));
+    }
+  }
 
   /// \brief Destructor
-  ~ZNumber() = default;
+  ~ZNumber() {
+    if (this->is_large()) {
+      delete this->_n.p;
+    }
+  }
 
   /// @}
   /// \name Assignment Operators
   /// @{
 
   /// \brief Copy assignment
-  ZNumber& operator=(const ZNumber&) = default;
+  ZNumber& operator=(const ZNumber& o) {
+    if (this == &o) {
+      return *this;
+    }
+
+    if (o.is_small()) {
+      this->set_small(o._n.i);
+    } else if (this->is_large()) {
+      *this->_n.p = *o._n.p;
+    } else {
+      this->_n.p = new mpz_class(*o._n.p);
+      this->_is_large = true;
+    }
+    return *this;
+  }
 
   /// \brief Move assignment
-  ZNumber& operator=(ZNumber&&) noexcept = default;
+  ZNumber& operator=(ZNumber&& o) noexcept {
+    if (this == &o) {
+      return *this;
+    }
+
+    if (this->is_large()) {
+      delete this->_n.p;
+    }
+
+    this->_n = o._n;
+    this->_is_large = o._is_large;
+    o._is_large = false; // do not delete o._n.p
+    return *this;
+  }
 
   /// \brief Assignment for integral types
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator=(T n) {
-    this->_n = detail::MpzAdapter< T >()(n);
+    if (detail::Int64Fits< T >()(n)) {
+      this->set_small(static_cast< int64_t >(n));
+    } else {
+      this->set_large(mpz_class(detail::MpzAdapter< T >()(n)));
+    }
     return *this;
   }
 
   /// \brief Addition assignment
   ZNumber& operator+=(const ZNumber& x) {
-    this->_n += x._n;
+    int64_t r;
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(!detail::add_overflow(this->_n.i, x._n.i, r))) {
+      this->_n.i = r;
+    } else {
+      this->set_large(this->mpz() + x.mpz());
+    }
     return *this;
   }
 
@@ -382,13 +588,18 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator+=(T x) {
-    this->_n += detail::MpzAdapter< T >()(x);
-    return *this;
+    return this->operator+=(ZNumber(x));
   }
 
   /// \brief Subtraction assignment
   ZNumber& operator-=(const ZNumber& x) {
-    this->_n -= x._n;
+    int64_t r;
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(!detail::sub_overflow(this->_n.i, x._n.i, r))) {
+      this->_n.i = r;
+    } else {
+      this->set_large(this->mpz() - x.mpz());
+    }
     return *this;
   }
 
@@ -396,13 +607,18 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator-=(T x) {
-    this->_n -= detail::MpzAdapter< T >()(x);
-    return *this;
+    return this->operator-=(ZNumber(x));
   }
 
   /// \brief Multiplication assignment
   ZNumber& operator*=(const ZNumber& x) {
-    this->_n *= x._n;
+    int64_t r;
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(!detail::mul_overflow(this->_n.i, x._n.i, r))) {
+      this->_n.i = r;
+    } else {
+      this->set_large(this->mpz() * x.mpz());
+    }
     return *this;
   }
 
@@ -410,16 +626,21 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator*=(T x) {
-    this->_n *= detail::MpzAdapter< T >()(x);
-    return *this;
+    return this->operator*=(ZNumber(x));
   }
 
   /// \brief Integer division assignment
   ///
   /// Integer division with rounding towards zero.
   ZNumber& operator/=(const ZNumber& x) {
-    ikos_assert_msg(x._n != 0, "division by zero");
-    this->_n /= x._n;
+    ikos_assert_msg(x.sign() != 0, "division by zero");
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(this->_n.i != std::numeric_limits< int64_t >::min() ||
+                    x._n.i != -1)) {
+      this->_n.i /= x._n.i;
+    } else {
+      this->set_large(this->mpz() / x.mpz());
+    }
     return *this;
   }
 
@@ -430,8 +651,7 @@ public:
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator/=(T x) {
     ikos_assert_msg(x != 0, "division by zero");
-    this->_n /= detail::MpzAdapter< T >()(x);
-    return *this;
+    return this->operator/=(ZNumber(x));
   }
 
   /// \brief Remainder assignment
@@ -442,8 +662,14 @@ public:
   /// The sign of `x` is ignored, and the result will have the same sign as
   /// `this`.
   ZNumber& operator%=(const ZNumber& x) {
-    ikos_assert_msg(x._n != 0, "division by zero");
-    this->_n %= x._n;
+    ikos_assert_msg(x.sign() != 0, "division by zero");
+    if (this->is_small() && x.is_small() &&
+        ikos_likely(this->_n.i != std::numeric_limits< int64_t >::min() ||
+                    x._n.i != -1)) {
+      this->_n.i %= x._n.i;
+    } else {
+      this->set_large(this->mpz() % x.mpz());
+    }
     return *this;
   }
 
@@ -458,13 +684,16 @@ public:
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator%=(T x) {
     ikos_assert_msg(x != 0, "division by zero");
-    this->_n %= detail::MpzAdapter< T >()(x);
-    return *this;
+    return this->operator%=(ZNumber(x));
   }
 
   /// \brief Bitwise AND assignment
   ZNumber& operator&=(const ZNumber& x) {
-    this->_n &= x._n;
+    if (this->is_small() && x.is_small()) {
+      this->_n.i &= x._n.i;
+    } else {
+      this->set_large(this->mpz() & x.mpz());
+    }
     return *this;
   }
 
@@ -472,13 +701,16 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator&=(T x) {
-    this->_n &= detail::MpzAdapter< T >()(x);
-    return *this;
+    return this->operator&=(ZNumber(x));
   }
 
   /// \brief Bitwise OR assignment
   ZNumber& operator|=(const ZNumber& x) {
-    this->_n |= x._n;
+    if (this->is_small() && x.is_small()) {
+      this->_n.i |= x._n.i;
+    } else {
+      this->set_large(this->mpz() | x.mpz());
+    }
     return *this;
   }
 
@@ -486,13 +718,16 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator|=(T x) {
-    this->_n |= detail::MpzAdapter< T >()(x);
-    return *this;
+    return this->operator|=(ZNumber(x));
   }
 
   /// \brief Bitwise XOR assignment
   ZNumber& operator^=(const ZNumber& x) {
-    this->_n ^= x._n;
+    if (this->is_small() && x.is_small()) {
+      this->_n.i ^= x._n.i;
+    } else {
+      this->set_large(this->mpz() ^ x.mpz());
+    }
     return *this;
   }
 
@@ -500,18 +735,16 @@ public:
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator^=(T x) {
-    this->_n ^= detail::MpzAdapter< T >()(x);
-    return *this;
+    return this->operator^=(ZNumber(x));
   }
 
   /// \brief Left binary shift assignment
   ///
   /// This is undefined if `x` isn't between 0 and 2**32 - 1
   ZNumber& operator<<=(const ZNumber& x) {
-    ikos_assert_msg(x._n >= 0, "shift count is negative");
-    ikos_assert_msg(x._n.fits_ulong_p(), "shift count is too big");
-    this->_n <<= x._n.get_ui();
-    return *this;
+    ikos_assert_msg(x.sign() >= 0, "shift count is negative");
+    ikos_assert_msg(x.fits< unsigned long >(), "shift count is too big");
+    return this->operator<<=(x.to< unsigned long >());
   }
 
   /// \brief Left binary shift assignment with integral types
@@ -521,7 +754,15 @@ public:
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator<<=(T x) {
     ikos_assert_msg(x >= 0, "shift count is negative");
-    this->_n <<= static_cast< unsigned long int >(x);
+    auto shift = static_cast< unsigned long int >(x);
+    int64_t r;
+    if (this->is_small() && shift < 63 &&
+        ikos_likely(
+            !detail::mul_overflow(this->_n.i, int64_t(1) << shift, r))) {
+      this->_n.i = r;
+    } else {
+      this->set_large(this->mpz() << shift);
+    }
     return *this;
   }
 
@@ -529,10 +770,9 @@ public:
   ///
   /// This is undefined if `x` isn't between 0 and 2**32 - 1
   ZNumber& operator>>=(const ZNumber& x) {
-    ikos_assert_msg(x._n >= 0, "shift count is negative");
-    ikos_assert_msg(x._n.fits_ulong_p(), "shift count is too big");
-    this->_n >>= x._n.get_ui();
-    return *this;
+    ikos_assert_msg(x.sign() >= 0, "shift count is negative");
+    ikos_assert_msg(x.fits< unsigned long >(), "shift count is too big");
+    return this->operator>>=(x.to< unsigned long >());
   }
 
   /// \brief Right binary shift with integral types
@@ -542,7 +782,14 @@ public:
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   ZNumber& operator>>=(T x) {
     ikos_assert_msg(x >= 0, "shift count is negative");
-    this->_n >>= static_cast< unsigned long int >(x);
+    auto shift = static_cast< unsigned long int >(x);
+    if (this->is_small()) {
+      // Arithmetic shift, rounding towards -oo
+      // NOLINTNEXTLINE(hicpp-signed-bitwise)
+      this->_n.i >>= std::min(shift, 63UL);
+    } else {
+      this->set_large(this->mpz() >> shift);
+    }
     return *this;
   }
 
@@ -555,30 +802,47 @@ public:
 
   /// \brief Prefix increment
   ZNumber& operator++() {
-    ++this->_n;
+    if (this->is_small() &&
+        ikos_likely(this->_n.i != std::numeric_limits< int64_t >::max())) {
+      ++this->_n.i;
+    } else {
+      this->set_large(this->mpz() + 1);
+    }
     return *this;
   }
 
   /// \brief Postfix increment
   const ZNumber operator++(int) {
     ZNumber r(*this);
-    ++this->_n;
+    ++(*this);
     return r;
   }
 
   /// \brief Unary minus
-  const ZNumber operator-() const { return ZNumber(-this->_n); }
+  const ZNumber operator-() const {
+    if (this->is_small() &&
+        ikos_likely(this->_n.i != std::numeric_limits< int64_t >::min())) {
+      return ZNumber(-this->_n.i);
+    } else {
+      return ZNumber(-this->mpz());
+    }
+  }
 
   /// \brief Prefix decrement
   ZNumber& operator--() {
-    --this->_n;
+    if (this->is_small() &&
+        ikos_likely(this->_n.i != std::numeric_limits< int64_t >::min())) {
+      --this->_n.i;
+    } else {
+      this->set_large(this->mpz() - 1);
+    }
     return *this;
   }
 
   /// \brief Postfix decrement
   const ZNumber operator--(int) {
     ZNumber r(*this);
-    --this->_n;
+    --(*this);
     return r;
   }
 
@@ -586,14 +850,17 @@ public:
   ///
   /// This is undefined for negative numbers.
   ZNumber next_power_of_2() const {
-    ikos_assert(this->_n >= 0);
+    ikos_assert(this->sign() >= 0);
 
-    if (this->_n <= 1) {
+    if (this->is_small() && this->_n.i <= 1) {
       return ZNumber(1);
     }
 
-    ZNumber n(this->_n - 1);
-    return ZNumber(mpz_class(1) << n.size_in_bits());
+    ZNumber n(*this);
+    --n;
+    ZNumber r(1);
+    r <<= n.size_in_bits();
+    return r;
   }
 
   /// @}
@@ -604,66 +871,79 @@ public:
   ///
   /// This is undefined if the number is 0.
   uint64_t trailing_zeros() const {
-    ikos_assert(this->_n != 0);
-    return mpz_scan1(this->_n.get_mpz_t(), 0);
+    ikos_assert(this->sign() != 0);
+    return mpz_scan1(this->mpz().get_mpz_t(), 0);
   }
 
   /// \brief Return the number of trailing '1' bits
   ///
   /// This is undefined if the number is -1.
   uint64_t trailing_ones() const {
-    ikos_assert(this->_n != -1);
-    return mpz_scan0(this->_n.get_mpz_t(), 0);
+    ikos_assert(this->is_large() || this->_n.i != -1);
+    return mpz_scan0(this->mpz().get_mpz_t(), 0);
   }
 
   /// \brief Return the number of bits
   ///
   /// The sign is ignored.
   uint64_t size_in_bits() const {
-    return mpz_sizeinbase(this->_n.get_mpz_t(), 2);
+    return mpz_sizeinbase(this->mpz().get_mpz_t(), 2);
   }
 
   /// @}
   /// \name Conversion Functions
   /// @{
 
-  /// \brief Get the internal representation
-  const mpz_class& mpz() const { return this->_n; }
+  /// \brief Return the number as a mpz_class
+  mpz_class mpz() const {
+    if (this->is_small()) {
+      return mpz_class(detail::MpzAdapter< int64_t >()(this->_n.i));
+    } else {
+      return *this->_n.p;
+    }
+  }
 
   /// \brief Return true if the number fits in the given integer type
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   bool fits() const {
-    return detail::MpzFits< T >()(this->_n);
+    if (this->is_small()) {
+      return detail::Int64FitsIn< T >()(this->_n.i);
+    } else {
+      return detail::MpzFits< T >()(*this->_n.p);
+    }
   }
 
   /// \brief Return the number as the given integer type
   template < typename T,
              class = std::enable_if_t< IsSupportedIntegral< T >::value > >
   T to() const {
-    ikos_assert_msg(detail::MpzFits< T >()(this->_n), "does not fit");
-    return detail::MpzTo< T >()(this->_n);
+    ikos_assert_msg(this->fits< T >(), "does not fit");
+    if (this->is_small()) {
+      return static_cast< T >(this->_n.i);
+    } else {
+      return detail::MpzTo< T >()(*this->_n.p);
+    }
   }
 
   /// \brief Return a string representation of the ZNumber in the given base
   ///
   /// The base can vary from 2 to 36, or from -2 to -36
-  std::string str(int base = 10) const { return this->_n.get_str(base); }
+  std::string str(int base = 10) const { return this->mpz().get_str(base); }
 
   /// @}
 
-  friend ZNumber mod(const ZNumber&, const ZNumber&);
+  friend bool operator==(const ZNumber&, const ZNumber&);
 
-  friend ZNumber gcd(const ZNumber&, const ZNumber&);
+  friend bool operator<(const ZNumber&, const ZNumber&);
 
-  friend ZNumber lcm(const ZNumber&, const ZNumber&);
+  friend ZNumber mod(const ZNumber&, const ZNumber&);
 
-  friend void gcd_extended(
-      const ZNumber&, const ZNumber&, ZNumber&, ZNumber&, ZNumber&);
+  friend ZNumber abs(const ZNumber&);
 
-  friend std::istream& operator>>(std::istream& i, ZNumber& n);
+  friend ZNumber gcd(const ZNumber&, const ZNumber&);
 
-  friend class QNumber;
+  friend std::size_t hash_value(const ZNumber&);
 
 }; // end class ZNumber
 
@@ -672,67 +952,86 @@ public:
 
 /// \brief Addition
 inline ZNumber operator+(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() + rhs.mpz());
+  ZNumber r(lhs);
+  r += rhs;
+  return r;
 }
 
 /// \brief Addition with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator+(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() + detail::MpzAdapter< T >()(rhs));
+  ZNumber r(lhs);
+  r += rhs;
+  return r;
 }
 
 /// \brief Addition with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator+(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) + rhs.mpz());
+  ZNumber r(lhs);
+  r += rhs;
+  return r;
 }
 
 /// \brief Subtraction
 inline ZNumber operator-(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() - rhs.mpz());
+  ZNumber r(lhs);
+  r -= rhs;
+  return r;
 }
 
 /// \brief Subtraction with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator-(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() - detail::MpzAdapter< T >()(rhs));
+  ZNumber r(lhs);
+  r -= rhs;
+  return r;
 }
 
 /// \brief Subtraction with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator-(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) - rhs.mpz());
+  ZNumber r(lhs);
+  r -= rhs;
+  return r;
 }
 
 /// \brief Multiplication
 inline ZNumber operator*(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() * rhs.mpz());
+  ZNumber r(lhs);
+  r *= rhs;
+  return r;
 }
 
 /// \brief Multiplication with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator*(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() * detail::MpzAdapter< T >()(rhs));
+  ZNumber r(lhs);
+  r *= rhs;
+  return r;
 }
 
 /// \brief Multiplication with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator*(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) * rhs.mpz());
+  ZNumber r(lhs);
+  r *= rhs;
+  return r;
 }
 
 /// \brief Integer division
 ///
 /// Integer division with rounding towards zero.
 inline ZNumber operator/(const ZNumber& lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() != 0, "division by zero");
-  return ZNumber(lhs.mpz() / rhs.mpz());
+  ZNumber r(lhs);
+  r /= rhs;
+  return r;
 }
 
 /// \brief Integer division with integral types
@@ -741,8 +1040,9 @@ inline ZNumber operator/(const ZNumber& lhs, const ZNumber& rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator/(const ZNumber& lhs, T rhs) {
-  ikos_assert_msg(rhs != 0, "division by zero");
-  return ZNumber(lhs.mpz() / detail::MpzAdapter< T >()(rhs));
+  ZNumber r(lhs);
+  r /= rhs;
+  return r;
 }
 
 /// \brief Integer division with integral types
@@ -751,8 +1051,9 @@ inline ZNumber operator/(const ZNumber& lhs, T rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator/(T lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() != 0, "division by zero");
-  return ZNumber(detail::MpzAdapter< T >()(lhs) / rhs.mpz());
+  ZNumber r(lhs);
+  r /= rhs;
+  return r;
 }
 
 /// \brief Remainder
@@ -763,8 +1064,9 @@ inline ZNumber operator/(T lhs, const ZNumber& rhs) {
 /// The sign of `rhs` is ignored, and the result will have the same sign as
 /// `lhs`.
 inline ZNumber operator%(const ZNumber& lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() != 0, "division by zero");
-  return ZNumber(lhs.mpz() % rhs.mpz());
+  ZNumber r(lhs);
+  r %= rhs;
+  return r;
 }
 
 /// \brief Remainder with integral types
@@ -777,8 +1079,9 @@ inline ZNumber operator%(const ZNumber& lhs, const ZNumber& rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator%(const ZNumber& lhs, T rhs) {
-  ikos_assert_msg(rhs != 0, "division by zero");
-  return ZNumber(lhs.mpz() % detail::MpzAdapter< T >()(rhs));
+  ZNumber r(lhs);
+  r %= rhs;
+  return r;
 }
 
 /// \brief Remainder with integral types
@@ -791,74 +1094,93 @@ inline ZNumber operator%(const ZNumber& lhs, T rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator%(T lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() != 0, "division by zero");
-  return ZNumber(detail::MpzAdapter< T >()(lhs) % rhs.mpz());
+  ZNumber r(lhs);
+  r %= rhs;
+  return r;
 }
 
 /// \brief Bitwise AND
 inline ZNumber operator&(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() & rhs.mpz());
+  ZNumber r(lhs);
+  r &= rhs;
+  return r;
 }
 
 /// \brief Bitwise AND with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator&(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() & detail::MpzAdapter< T >()(rhs));
+  ZNumber r(lhs);
+  r &= rhs;
+  return r;
 }
 
 /// \brief Bitwise AND with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator&(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) & rhs.mpz());
+  ZNumber r(lhs);
+  r &= rhs;
+  return r;
 }
 
 /// \brief Bitwise OR
 inline ZNumber operator|(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() | rhs.mpz());
+  ZNumber r(lhs);
+  r |= rhs;
+  return r;
 }
 
 /// \brief Bitwise OR with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator|(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() | detail::MpzAdapter< T >()(rhs));
+  ZNumber r(lhs);
+  r |= rhs;
+  return r;
 }
 
 /// \brief Bitwise OR with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator|(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) | rhs.mpz());
+  ZNumber r(lhs);
+  r |= rhs;
+  return r;
 }
 
 /// \brief Bitwise XOR
 inline ZNumber operator^(const ZNumber& lhs, const ZNumber& rhs) {
-  return ZNumber(lhs.mpz() ^ rhs.mpz());
+  ZNumber r(lhs);
+  r ^= rhs;
+  return r;
 }
 
 /// \brief Bitwise XOR with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator^(const ZNumber& lhs, T rhs) {
-  return ZNumber(lhs.mpz() ^ detail::MpzAdapter< T >()(rhs));
+  ZNumber r(lhs);
+  r ^= rhs;
+  return r;
 }
 
 /// \brief Bitwise XOR with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator^(T lhs, const ZNumber& rhs) {
-  return ZNumber(detail::MpzAdapter< T >()(lhs) ^ rhs.mpz());
+  ZNumber r(lhs);
+  r ^= rhs;
+  return r;
 }
 
 /// \brief Left binary shift
 ///
 /// This is undefined if `rhs` isn't between 0 and 2**32 - 1
 inline ZNumber operator<<(const ZNumber& lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() >= 0, "shift count is negative");
-  ikos_assert_msg(rhs.mpz().fits_ulong_p(), "shift count is too big");
-  return ZNumber(lhs.mpz() << rhs.mpz().get_ui());
+  ZNumber r(lhs);
+  r <<= rhs;
+  return r;
 }
 
 /// \brief Left binary shift with integral types
@@ -867,8 +1189,9 @@ inline ZNumber operator<<(const ZNumber& lhs, const ZNumber& rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator<<(const ZNumber& lhs, T rhs) {
-  ikos_assert_msg(rhs >= 0, "shift count is negative");
-  return ZNumber(lhs.mpz() << static_cast< unsigned long int >(rhs));
+  ZNumber r(lhs);
+  r <<= rhs;
+  return r;
 }
 
 /// \brief Left binary shift with integral types
@@ -886,9 +1209,9 @@ inline ZNumber operator<<(T lhs, const ZNumber& rhs) {
 ///
 /// This is undefined if `rhs` isn't between 0 and 2**32 - 1
 inline ZNumber operator>>(const ZNumber& lhs, const ZNumber& rhs) {
-  ikos_assert_msg(rhs.mpz() >= 0, "shift count is negative");
-  ikos_assert_msg(rhs.mpz().fits_ulong_p(), "shift count is too big");
-  return ZNumber(lhs.mpz() >> rhs.mpz().get_ui());
+  ZNumber r(lhs);
+  r >>= rhs;
+  return r;
 }
 
 /// \brief Right binary shift with integral types
@@ -897,8 +1220,9 @@ inline ZNumber operator>>(const ZNumber& lhs, const ZNumber& rhs) {
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline ZNumber operator>>(const ZNumber& lhs, T rhs) {
-  ikos_assert_msg(rhs >= 0, "shift count is negative");
-  return ZNumber(lhs.mpz() >> static_cast< unsigned long int >(rhs));
+  ZNumber r(lhs);
+  r >>= rhs;
+  return r;
 }
 
 /// \brief Right binary shift with integral types
@@ -918,116 +1242,133 @@ inline ZNumber operator>>(T lhs, const ZNumber& rhs) {
 
 /// \brief Equality operator
 inline bool operator==(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() == rhs.mpz();
+  if (lhs.is_small() && rhs.is_small()) {
+    return lhs._n.i == rhs._n.i;
+  } else if (lhs.is_large() && rhs.is_large()) {
+    return *lhs._n.p == *rhs._n.p;
+  } else {
+    // A large number never fits in a int64_t
+    return false;
+  }
 }
 
 /// \brief Equality operator with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator==(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() == detail::MpzAdapter< T >()(rhs);
+  return lhs == ZNumber(rhs);
 }
 
 /// \brief Equality operator with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator==(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) == rhs.mpz();
+  return ZNumber(lhs) == rhs;
 }
 
 /// \brief Inequality operator
 inline bool operator!=(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() != rhs.mpz();
+  return !(lhs == rhs);
 }
 
 /// \brief Inequality operator with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator!=(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() != detail::MpzAdapter< T >()(rhs);
+  return !(lhs == ZNumber(rhs));
 }
 
 /// \brief Inequality operator with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator!=(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) != rhs.mpz();
+  return !(ZNumber(lhs) == rhs);
 }
 
 /// \brief Less than comparison
 inline bool operator<(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() < rhs.mpz();
+  if (lhs.is_small() && rhs.is_small()) {
+    return lhs._n.i < rhs._n.i;
+  } else if (lhs.is_large() && rhs.is_large()) {
+    return *lhs._n.p < *rhs._n.p;
+  } else if (lhs.is_large()) {
+    // lhs is out of the int64_t range
+    return mpz_sgn(lhs._n.p->get_mpz_t()) < 0;
+  } else {
+    // rhs is out of the int64_t range
+    return mpz_sgn(rhs._n.p->get_mpz_t()) > 0;
+  }
 }
 
 /// \brief Less than comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator<(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() < detail::MpzAdapter< T >()(rhs);
+  return lhs < ZNumber(rhs);
 }
 
 /// \brief Less than comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator<(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) < rhs.mpz();
+  return ZNumber(lhs) < rhs;
 }
 
 /// \brief Less or equal comparison
 inline bool operator<=(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() <= rhs.mpz();
+  return !(rhs < lhs);
 }
 
 /// \brief Less or equal comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator<=(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() <= detail::MpzAdapter< T >()(rhs);
+  return !(ZNumber(rhs) < lhs);
 }
 
 /// \brief Less or equal comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator<=(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) <= rhs.mpz();
+  return !(rhs < ZNumber(lhs));
 }
 
 /// \brief Greater than comparison
 inline bool operator>(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() > rhs.mpz();
+  return rhs < lhs;
 }
 
 /// \brief Greater than comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator>(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() > detail::MpzAdapter< T >()(rhs);
+  return ZNumber(rhs) < lhs;
 }
 
 /// \brief Greater than comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator>(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) > rhs.mpz();
+  return rhs < ZNumber(lhs);
 }
 
 /// \brief Greater or equal comparison
 inline bool operator>=(const ZNumber& lhs, const ZNumber& rhs) {
-  return lhs.mpz() >= rhs.mpz();
+  return !(lhs < rhs);
 }
 
 /// \brief Greater or equal comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator>=(const ZNumber& lhs, T rhs) {
-  return lhs.mpz() >= detail::MpzAdapter< T >()(rhs);
+  return !(lhs < ZNumber(rhs));
 }
 
 /// \brief Greater or equal comparison with integral types
 template < typename T,
            class = std::enable_if_t< IsSupportedIntegral< T >::value > >
 inline bool operator>=(T lhs, const ZNumber& rhs) {
-  return detail::MpzAdapter< T >()(lhs) >= rhs.mpz();
+  return !(ZNumber(lhs) < rhs);
 }
 
 /// @}
@@ -1081,15 +1422,32 @@ inline const ZNumber& max(const ZNumber& a,
 ///
 /// The sign of `d` is ignored, and the result is always non-negative.
 inline ZNumber mod(const ZNumber& n, const ZNumber& d) {
-  ikos_assert_msg(d.mpz() != 0, "division by zero");
-  ZNumber r;
-  mpz_mod(r._n.get_mpz_t(), n._n.get_mpz_t(), d._n.get_mpz_t());
-  return r;
+  ikos_assert_msg(d != 0, "division by zero");
+  if (n.is_small() && d.is_small() &&
+      ikos_likely(d._n.i != std::numeric_limits< int64_t >::min() &&
+                  d._n.i != -1)) {
+    int64_t r = n._n.i % d._n.i;
+    if (r < 0) {
+      r += (d._n.i < 0) ? -d._n.i : d._n.i;
+    }
+    return ZNumber(r);
+  } else {
+    mpz_class r;
+    mpz_class n_mpz = n.mpz();
+    mpz_class d_mpz = d.mpz();
+    mpz_mod(r.get_mpz_t(), n_mpz.get_mpz_t(), d_mpz.get_mpz_t());
+    return ZNumber(std::move(r));
+  }
 }
 
 /// \brief Return the absolute value of the given number
 inline ZNumber abs(const ZNumber& n) {
-  return ZNumber(abs(n.mpz()));
+  if (n.is_small() &&
+      ikos_likely(n._n.i != std::numeric_limits< int64_t >::min())) {
+    return ZNumber(n._n.i < 0 ? -n._n.i : n._n.i);
+  } else {
+    return ZNumber(abs(n.mpz()));
+  }
 }
 
 /// \brief Return the greatest common divisor of the given numbers
@@ -1098,9 +1456,25 @@ inline ZNumber abs(const ZNumber& n) {
 /// negative. Except if both inputs are zero; then this function defines
 /// `gcd(0, 0) = 0`.
 inline ZNumber gcd(const ZNumber& a, const ZNumber& b) {
-  ZNumber r;
-  mpz_gcd(r._n.get_mpz_t(), a._n.get_mpz_t(), b._n.get_mpz_t());
-  return r;
+  if (a.is_small() && b.is_small()) {
+    // Euclid's algorithm on the absolute values, which fit in a uint64_t
+    auto x = static_cast< uint64_t >(a._n.i);
+    auto y = static_cast< uint64_t >(b._n.i);
+    x = (a._n.i < 0) ? -x : x;
+    y = (b._n.i < 0) ? -y : y;
+    while (y != 0) {
+      uint64_t t = x % y;
+      x = y;
+      y = t;
+    }
+    return ZNumber(static_cast< unsigned long long >(x));
+  } else {
+    mpz_class r;
+    mpz_class a_mpz = a.mpz();
+    mpz_class b_mpz = b.mpz();
+    mpz_gcd(r.get_mpz_t(), a_mpz.get_mpz_t(), b_mpz.get_mpz_t());
+    return ZNumber(std::move(r));
+  }
 }
 
 /// \brief Return the greatest common divisor of the given numbers
@@ -1109,10 +1483,13 @@ inline ZNumber gcd(const ZNumber& a, const ZNumber& b, const ZNumber& c) {
 }
 
 /// \brief Return the least common multiple of the given numbers
+///
+/// The result is always non-negative.
 inline ZNumber lcm(const ZNumber& a, const ZNumber& b) {
-  ZNumber r;
-  mpz_lcm(r._n.get_mpz_t(), a._n.get_mpz_t(), b._n.get_mpz_t());
-  return r;
+  if (a == 0 || b == 0) {
+    return ZNumber(0);
+  }
+  return abs(a / gcd(a, b) * b);
 }
 
 /// \brief Run Euclid's algorithm
@@ -1123,11 +1500,17 @@ inline ZNumber lcm(const ZNumber& a, const ZNumber& b) {
 /// negative (or zero if both inputs are zero).
 inline void gcd_extended(
     const ZNumber& a, const ZNumber& b, ZNumber& g, ZNumber& u, ZNumber& v) {
-  mpz_gcdext(g._n.get_mpz_t(),
-             u._n.get_mpz_t(),
-             v._n.get_mpz_t(),
-             a._n.get_mpz_t(),
-             b._n.get_mpz_t());
+  mpz_class a_mpz = a.mpz();
+  mpz_class b_mpz = b.mpz();
+  mpz_class g_mpz, u_mpz, v_mpz;
+  mpz_gcdext(g_mpz.get_mpz_t(),
+             u_mpz.get_mpz_t(),
+             v_mpz.get_mpz_t(),
+             a_mpz.get_mpz_t(),
+             b_mpz.get_mpz_t());
+  g = ZNumber(std::move(g_mpz));
+  u = ZNumber(std::move(u_mpz));
+  v = ZNumber(std::move(v_mpz));
 }
 
 /// @}
@@ -1142,7 +1525,9 @@ inline std::ostream& operator<<(std::ostream& o, const ZNumber& n) {
 
 /// \brief Read a ZNumber from a stream, in base 10
 inline std::istream& operator>>(std::istream& i, ZNumber& n) {
-  i >> n._n;
+  mpz_class m;
+  i >> m;
+  n = ZNumber(std::move(m));
   return i;
 }
 
@@ -1150,7 +1535,11 @@ inline std::istream& operator>>(std::istream& i, ZNumber& n) {
 
 /// \brief Return the hash of a ZNumber
 inline std::size_t hash_value(const ZNumber& n) {
-  const mpz_class& m = n.mpz();
+  if (n.is_small()) {
+    return boost::hash_value(n._n.i);
+  }
+
+  const mpz_class& m = *n._n.p;
   std::size_t result = 0;
   boost::hash_combine(result, m.get_mpz_t()[0]._mp_size);
   for (int i = 0, e = std::abs(m.get_mpz_t()[0]._mp_size); i < e; ++i) {
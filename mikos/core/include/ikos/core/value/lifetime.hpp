@@ -177,7 +177,16 @@ public:
 
   static std::string name() { return "lifetime"; }
 
+  // Friends
+
+  friend std::size_t hash_value(const Lifetime&);
+
 }; // end class Lifetime
 
+/// \brief Return the hash of a Lifetime
+inline std::size_t hash_value(const Lifetime& value) {
+  return static_cast< std::size_t >(value._kind);
+}
+
 } // end namespace core
 } // end namespace ikos
@@ -51,6 +51,7 @@
 
 #pragma once
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/domain/abstract_domain.hpp>
@@ -837,6 +838,15 @@ inline Congruence xor_(const Congruence& lhs, const Congruence& rhs) {
 /// \name Input / Output
 /// @{
 
+/// \brief Return the hash of a congruence
+inline std::size_t hash_value(const Congruence& congruence) {
+  std::size_t hash = 0;
+  boost::hash_combine(hash, congruence.bit_width());
+  boost::hash_combine(hash, congruence.sign());
+  boost::hash_combine(hash, congruence.to_z_congruence());
+  return hash;
+}
+
 /// \brief Write a congruence on a stream
 inline std::ostream& operator<<(std::ostream& o, const Congruence& congruence) {
   congruence.dump(o);
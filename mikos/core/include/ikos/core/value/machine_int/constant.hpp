@@ -43,6 +43,7 @@
 
 #pragma once
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/domain/abstract_domain.hpp>
@@ -710,6 +711,20 @@ inline Constant xor_(const Constant& lhs, const Constant& rhs) {
 /// \name Input / Output
 /// @{
 
+/// \brief Return the hash of a constant
+inline std::size_t hash_value(const Constant& constant) {
+  std::size_t hash = 0;
+  boost::hash_combine(hash, constant.bit_width());
+  boost::hash_combine(hash, constant.sign());
+  boost::hash_combine(hash, constant.is_top());
+  if (constant.is_integer()) {
+    boost::hash_combine(hash, *constant.integer());
+  } else {
+    boost::hash_combine(hash, constant.is_bottom());
+  }
+  return hash;
+}
+
 /// \brief Write a constant on a stream
 inline std::ostream& operator<<(std::ostream& o, const Constant& constant) {
   constant.dump(o);
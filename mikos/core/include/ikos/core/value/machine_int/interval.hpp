@@ -43,6 +43,7 @@
 
 #pragma once
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/domain/abstract_domain.hpp>
@@ -962,6 +963,18 @@ inline Interval xor_(const Interval& lhs, const Interval& rhs) {
 /// \name Input / Output
 /// @{
 
+/// \brief Return the hash of an interval
+inline std::size_t hash_value(const Interval& interval) {
+  std::size_t hash = 0;
+  boost::hash_combine(hash, interval.bit_width());
+  boost::hash_combine(hash, interval.sign());
+  if (!interval.is_bottom()) {
+    boost::hash_combine(hash, interval.lb());
+    boost::hash_combine(hash, interval.ub());
+  }
+  return hash;
+}
+
 /// \brief Write an interval on a stream
 inline std::ostream& operator<<(std::ostream& o, const Interval& interval) {
   interval.dump(o);
@@ -43,6 +43,8 @@
 
 #pragma once
 
+#include <boost/functional/hash.hpp>
+
 #include <ikos/core/domain/abstract_domain.hpp>
 #include <ikos/core/value/machine_int/congruence.hpp>
 #include <ikos/core/value/machine_int/interval.hpp>
@@ -799,6 +801,14 @@ inline IntervalCongruence xor_(const IntervalCongruence& lhs,
 /// \name Input / Output
 /// @{
 
+/// \brief Return the hash of an interval-congruence
+inline std::size_t hash_value(const IntervalCongruence& iv) {
+  std::size_t hash = 0;
+  boost::hash_combine(hash, iv.interval());
+  boost::hash_combine(hash, iv.to_z_congruence());
+  return hash;
+}
+
 /// \brief Write an interval-congruence on a stream
 inline std::ostream& operator<<(std::ostream& o, const IntervalCongruence& iv) {
   iv.dump(o);
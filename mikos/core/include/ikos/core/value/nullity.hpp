@@ -177,7 +177,16 @@ public:
 
   static std::string name() { return "nullity"; }
 
+  // Friends
+
+  friend std::size_t hash_value(const Nullity&);
+
 }; // end class Nullity
 
+/// \brief Return the hash of a Nullity
+inline std::size_t hash_value(const Nullity& value) {
+  return static_cast< std::size_t >(value._kind);
+}
+
 } // end namespace core
 } // end namespace ikos
@@ -46,6 +46,7 @@
 
 #pragma once
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/domain/abstract_domain.hpp>
@@ -837,6 +838,22 @@ inline std::ostream& operator<<(std::ostream& o,
   return o;
 }
 
+/// \brief Return the hash of a congruence on integers
+inline std::size_t hash_value(const Congruence< ZNumber >& c) {
+  if (c.is_bottom()) {
+    return 0;
+  }
+  std::size_t hash = 1;
+  boost::hash_combine(hash, c.modulus());
+  boost::hash_combine(hash, c.residue());
+  return hash;
+}
+
+/// \brief Return the hash of a congruence on rationals
+inline std::size_t hash_value(const Congruence< QNumber >& c) {
+  return hash_value(c.to_constant());
+}
+
 /// \brief Congruence on unlimited precision integers
 using ZCongruence = Congruence< ZNumber >;
 
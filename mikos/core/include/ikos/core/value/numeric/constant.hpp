@@ -47,6 +47,7 @@
 
 #include <type_traits>
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/domain/abstract_domain.hpp>
@@ -536,6 +537,19 @@ inline std::ostream& operator<<(std::ostream& o,
   return o;
 }
 
+/// \brief Return the hash of a constant
+template < typename Number >
+inline std::size_t hash_value(const Constant< Number >& c) {
+  if (c.is_bottom()) {
+    return 0;
+  } else if (c.is_top()) {
+    return 1;
+  }
+  std::size_t hash = 2;
+  boost::hash_combine(hash, *c.number());
+  return hash;
+}
+
 /// \brief Constant on unlimited precision integers
 using ZConstant = Constant< ZNumber >;
 
@@ -48,6 +48,7 @@
 
 #include <type_traits>
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/adt/patricia_tree/map.hpp>
@@ -703,6 +704,24 @@ public:
     return !this->operator==(other);
   }
 
+  /// \brief Return the hash of a gauge bound
+  ///
+  /// Null coefficients are skipped, since they compare equal to missing ones.
+  friend std::size_t hash_value(const GaugeBound& b) {
+    std::size_t hash = 0;
+    boost::hash_combine(hash, b._is_infinite);
+    boost::hash_combine(hash, b._cst);
+    for (const auto& binding : b._coeffs) {
+      if (binding.second != 0) {
+        boost::hash_combine(hash,
+                            IndexableTraits< VariableRef >::index(
+                                binding.first));
+        boost::hash_combine(hash, binding.second);
+      }
+    }
+    return hash;
+  }
+
 private:
   /// \brief Min with 0
   struct MinZero {
@@ -1576,6 +1595,18 @@ public:
 
 }; // end class Gauge
 
+/// \brief Return the hash of a gauge
+template < typename Number, typename VariableRef >
+inline std::size_t hash_value(const Gauge< Number, VariableRef >& gauge) {
+  if (gauge.is_bottom()) {
+    return 0;
+  }
+  std::size_t hash = 1;
+  boost::hash_combine(hash, gauge.lb());
+  boost::hash_combine(hash, gauge.ub());
+  return hash;
+}
+
 /// \brief Write a gauge on a stream
 template < typename Number, typename VariableRef >
 inline std::ostream& operator<<(std::ostream& o,
@@ -49,6 +49,7 @@
 
 #include <type_traits>
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/domain/abstract_domain.hpp>
@@ -802,6 +803,18 @@ inline LinearConstraintSystem< Number, VariableRef > within_interval(
   return within_interval(LinearExpression< Number, VariableRef >(v), i);
 }
 
+/// \brief Return the hash of an interval
+template < typename Number >
+inline std::size_t hash_value(const Interval< Number >& i) {
+  if (i.is_bottom()) {
+    return 0;
+  }
+  std::size_t hash = 1;
+  boost::hash_combine(hash, i.lb());
+  boost::hash_combine(hash, i.ub());
+  return hash;
+}
+
 /// \brief Interval on unlimited precision integers
 using ZInterval = Interval< ZNumber >;
 
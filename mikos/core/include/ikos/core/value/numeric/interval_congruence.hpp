@@ -45,6 +45,8 @@
 
 #pragma once
 
+#include <boost/functional/hash.hpp>
+
 #include <ikos/core/domain/abstract_domain.hpp>
 #include <ikos/core/number/bound.hpp>
 #include <ikos/core/value/numeric/congruence.hpp>
@@ -560,6 +562,19 @@ inline IntervalCongruence< QNumber > operator/(
   return IntervalCongruence< QNumber >(lhs.interval() / rhs.interval());
 }
 
+/// \brief Return the hash of an interval-congruence on integers
+inline std::size_t hash_value(const IntervalCongruence< ZNumber >& ic) {
+  std::size_t hash = 0;
+  boost::hash_combine(hash, ic.interval());
+  boost::hash_combine(hash, ic.congruence());
+  return hash;
+}
+
+/// \brief Return the hash of an interval-congruence on rationals
+inline std::size_t hash_value(const IntervalCongruence< QNumber >& ic) {
+  return hash_value(ic.interval());
+}
+
 /// \brief Write an interval-congruence on a stream
 template < typename Number >
 inline std::ostream& operator<<(std::ostream& o,
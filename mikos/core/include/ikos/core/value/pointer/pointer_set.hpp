@@ -43,6 +43,8 @@
 
 #pragma once
 
+#include <boost/functional/hash.hpp>
+
 #include <ikos/core/value/machine_int/interval.hpp>
 #include <ikos/core/value/nullity.hpp>
 #include <ikos/core/value/pointer/pointer.hpp>
@@ -228,6 +230,16 @@ public:
 
 }; // end class PointerSet
 
+/// \brief Return the hash of a pointer set
+template < typename MemoryLocationRef >
+inline std::size_t hash_value(
+    const PointerSet< MemoryLocationRef >& pointer_set) {
+  std::size_t hash = 0;
+  boost::hash_combine(hash, pointer_set.points_to());
+  boost::hash_combine(hash, pointer_set.offsets());
+  return hash;
+}
+
 /// \brief Write a pointer set on a stream
 template < typename MemoryLocationRef >
 inline std::ostream& operator<<(
@@ -43,6 +43,7 @@
 
 #pragma once
 
+#include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 
 #include <ikos/core/adt/patricia_tree/set.hpp>
@@ -292,6 +293,22 @@ public:
 
 }; // end class PointsToSet
 
+/// \brief Return the hash of a points-to set
+template < typename MemoryLocationRef >
+inline std::size_t hash_value(
+    const PointsToSet< MemoryLocationRef >& points_to) {
+  if (points_to.is_bottom()) {
+    return 0;
+  } else if (points_to.is_top()) {
+    return 1;
+  }
+  std::size_t hash = 2;
+  for (auto it = points_to.begin(), et = points_to.end(); it != et; ++it) {
+    boost::hash_combine(hash, IndexableTraits< MemoryLocationRef >::index(*it));
+  }
+  return hash;
+}
+
 /// \brief Write a points-to set on a stream
 template < typename MemoryLocationRef >
 inline std::ostream& operator<<(
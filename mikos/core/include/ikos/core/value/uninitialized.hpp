@@ -183,7 +183,16 @@ public:
 
   static std::string name() { return "uninitialized"; }
 
+  // Friends
+
+  friend std::size_t hash_value(const Uninitialized&);
+
 }; // end class Uninitialized
 
+/// \brief Return the hash of a Uninitialized
+inline std::size_t hash_value(const Uninitialized& value) {
+  return static_cast< std::size_t >(value._kind);
+}
+
 } // end namespace core
 } // end namespace ikos
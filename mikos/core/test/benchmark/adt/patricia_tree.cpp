@@ -0,0 +1,212 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Benchmark of the patricia tree node allocation
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ikos/core/adt/patricia_tree/map.hpp>
+#include <ikos/core/adt/patricia_tree/set.hpp>
+
+/// \file
+///
+/// Measure the throughput of insert, join and leq on patricia tree maps and
+/// sets, shaped like the separate domains of the analyzer: many small
+/// environments sharing most of their nodes.
+///
+/// Usage: benchmark-core-adt-patricia_tree-<variant> [num_keys] [num_rounds]
+///
+/// The variant is selected at compile time, see node_ptr.hpp.
+
+namespace {
+
+using Index = ikos::core::Index;
+using Map = ikos::core::PatriciaTreeMap< Index, Index >;
+using Set = ikos::core::PatriciaTreeSet< Index >;
+using Clock = std::chrono::steady_clock;
+
+const char* variant_name() {
+#if defined(IKOS_PATRICIA_TREE_HASH_CONSING)
+  return "hash-consing";
+#elif defined(IKOS_PATRICIA_TREE_SINGLE_THREAD)
+  return "pool allocator (single thread)";
+#elif defined(IKOS_PATRICIA_TREE_POOL_ALLOCATOR)
+  return "pool allocator";
+#else
+  return "std::shared_ptr";
+#endif
+}
+
+/// \brief Run `f` and print the number of operations per second
+template < typename Function >
+void measure(const std::string& name, std::size_t num_ops, Function f) {
+  auto start = Clock::now();
+  std::size_t checksum = f();
+  std::chrono::duration< double > elapsed = Clock::now() - start;
+  std::cout << std::left << std::setw(12) << name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(0)
+            << (static_cast< double >(num_ops) / elapsed.count()) << " ops/s"
+            << std::setw(10) << std::setprecision(3) << elapsed.count()
+            << " s  (checksum " << checksum << ")\n";
+}
+
+/// \brief Build `num_envs` maps that share a common base and differ on a few
+/// keys, as abstract environments along different paths would
+std::vector< Map > make_maps(const std::vector< Index >& keys,
+                             std::size_t num_envs,
+                             std::mt19937_64& rng) {
+  Map base;
+  for (Index k : keys) {
+    base.insert_or_assign(k, k);
+  }
+  std::vector< Map > maps(num_envs, base);
+  std::uniform_int_distribution< std::size_t > pick(0, keys.size() - 1);
+  for (Map& m : maps) {
+    for (int i = 0; i < 8; i++) {
+      Index k = keys[pick(rng)];
+      m.insert_or_assign(k, k + rng() % 16);
+    }
+  }
+  return maps;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  std::size_t num_keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+  std::size_t num_rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+  const std::size_t num_envs = 64;
+
+  std::mt19937_64 rng(42);
+  std::vector< Index > keys(num_keys);
+  for (Index& k : keys) {
+    k = rng() & 0xffffff;
+  }
+
+  std::cout << "variant: " << variant_name() << ", keys: " << num_keys
+            << ", rounds: " << num_rounds << "\n";
+
+  measure("map insert", num_rounds * num_keys, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      Map m;
+      for (Index k : keys) {
+        m.insert_or_assign(k, k + r);
+      }
+      checksum += m.size();
+    }
+    return checksum;
+  });
+
+  std::vector< Map > maps = make_maps(keys, num_envs, rng);
+  auto max = [](Index a, Index b) { return std::max(a, b); };
+  auto le = [](Index a, Index b) { return a <= b; };
+
+  measure("map join", num_rounds * num_envs, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      for (std::size_t i = 0; i < num_envs; i++) {
+        Map m = maps[i].join(maps[(i + r + 1) % num_envs], max);
+        checksum += m.size();
+      }
+    }
+    return checksum;
+  });
+
+  measure("map leq", num_rounds * num_envs, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      for (std::size_t i = 0; i < num_envs; i++) {
+        Map m = maps[i].join(maps[(i + 1) % num_envs], max);
+        checksum += static_cast< std::size_t >(maps[i].leq(m, le));
+      }
+    }
+    return checksum;
+  });
+
+  measure("set insert", num_rounds * num_keys, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      Set s;
+      for (Index k : keys) {
+        s.insert(k + r);
+      }
+      checksum += s.size();
+    }
+    return checksum;
+  });
+
+  std::vector< Set > sets(num_envs);
+  for (std::size_t i = 0; i < num_envs; i++) {
+    for (std::size_t j = 0; j < num_keys; j++) {
+      if ((j + i) % 3 != 0) {
+        sets[i].insert(keys[j]);
+      }
+    }
+  }
+
+  measure("set join", num_rounds * num_envs, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      for (std::size_t i = 0; i < num_envs; i++) {
+        Set s = sets[i].join(sets[(i + r + 1) % num_envs]);
+        checksum += s.size();
+      }
+    }
+    return checksum;
+  });
+
+  measure("set leq", num_rounds * num_envs, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      for (std::size_t i = 0; i < num_envs; i++) {
+        Set s = sets[i].join(sets[(i + 1) % num_envs]);
+        checksum += static_cast< std::size_t >(sets[i].is_subset_of(s));
+      }
+    }
+    return checksum;
+  });
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Benchmark of the machine integer interval domain
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ikos/core/domain/machine_int/interval.hpp>
+#include <ikos/core/example/machine_int/variable_factory.hpp>
+
+/// \file
+///
+/// Join, widen, meet and compare invariants of `machine_int::IntervalDomain`
+/// on thousands of variables of various bit-widths.
+///
+/// The two operands are built separately, so that they do not share any
+/// subtree: every variable goes through the interval operations, as for the
+/// invariants of two different branches.
+///
+/// Usage: benchmark-core-domain-machine_int_interval [num_vars] [num_rounds]
+
+namespace {
+
+using Int = ikos::core::MachineInt;
+using Interval = ikos::core::machine_int::Interval;
+using ikos::core::Signed;
+using ikos::core::Signedness;
+using ikos::core::Unsigned;
+using VariableFactory = ikos::core::example::machine_int::VariableFactory;
+using Variable = VariableFactory::VariableRef;
+using IntervalDomain = ikos::core::machine_int::IntervalDomain< Variable >;
+using Clock = std::chrono::steady_clock;
+
+/// \brief Bit-widths of the variables, including a large one
+constexpr unsigned BitWidths[] = {1, 8, 16, 32, 64, 32, 64, 128};
+
+/// \brief Build an invariant with interval [offset, offset + width] for each
+/// variable
+IntervalDomain make_invariant(const std::vector< Variable >& vars,
+                              int offset,
+                              int width) {
+  auto inv = IntervalDomain::top();
+  for (std::size_t i = 0; i < vars.size(); i++) {
+    unsigned bit_width = vars[i]->bit_width();
+    Signedness sign = vars[i]->sign();
+    int lb = bit_width == 1 ? 0 : static_cast< int >(i % 50) + offset;
+    int ub = bit_width == 1 ? 0 : lb + width;
+    inv.set(vars[i],
+            Interval(Int(lb, bit_width, sign), Int(ub, bit_width, sign)));
+  }
+  return inv;
+}
+
+/// \brief Run `f` and print the number of operations per second
+template < typename Function >
+void measure(const std::string& name, std::size_t num_ops, Function f) {
+  auto start = Clock::now();
+  std::size_t checksum = f();
+  std::chrono::duration< double > elapsed = Clock::now() - start;
+  std::cout << std::left << std::setw(16) << name << std::right
+            << std::setw(12)
+            << static_cast< std::size_t >(
+                   static_cast< double >(num_ops) / elapsed.count())
+            << " ops/s  " << std::setw(8) << std::fixed
+            << std::setprecision(3) << elapsed.count() << " s  (checksum "
+            << checksum << ")\n";
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  std::size_t num_vars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000;
+  std::size_t num_rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+
+  std::cout << "vars: " << num_vars << ", rounds: " << num_rounds << "\n";
+
+  VariableFactory vfac;
+  std::vector< Variable > vars;
+  for (std::size_t i = 0; i < num_vars; i++) {
+    unsigned bit_width = BitWidths[i % (sizeof(BitWidths) / sizeof(unsigned))];
+    Signedness sign = (i / 3) % 2 == 0 ? Signed : Unsigned;
+    vars.push_back(vfac.get("v" + std::to_string(i), bit_width, sign));
+  }
+
+  IntervalDomain small = make_invariant(vars, 0, 10);
+  IntervalDomain large = make_invariant(vars, 0, 20);
+  IntervalDomain shifted = make_invariant(vars, 5, 10);
+  IntervalDomain same = make_invariant(vars, 0, 10);
+
+  measure("join", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      IntervalDomain inv = small;
+      inv.join_with(shifted);
+      checksum += static_cast< std::size_t >(inv.is_top());
+    }
+    return checksum;
+  });
+  measure("join (leq)", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      IntervalDomain inv = small;
+      inv.join_with(large);
+      checksum += static_cast< std::size_t >(inv.is_top());
+    }
+    return checksum;
+  });
+  measure("widening", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      IntervalDomain inv = small;
+      inv.widen_with(shifted);
+      checksum += static_cast< std::size_t >(inv.is_top());
+    }
+    return checksum;
+  });
+  measure("meet", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      IntervalDomain inv = small;
+      inv.meet_with(shifted);
+      checksum += static_cast< std::size_t >(inv.is_bottom());
+    }
+    return checksum;
+  });
+  measure("narrowing", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      IntervalDomain inv = large;
+      inv.narrow_with(small);
+      checksum += static_cast< std::size_t >(inv.is_bottom());
+    }
+    return checksum;
+  });
+  measure("leq", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      checksum += static_cast< std::size_t >(small.leq(large));
+    }
+    return checksum;
+  });
+  measure("equals", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      checksum += static_cast< std::size_t >(small.equals(same));
+    }
+    return checksum;
+  });
+  return 0;
+}
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Benchmark of the virtual dispatch of the polymorphic domains
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ikos/core/domain/machine_int/interval.hpp>
+#include <ikos/core/domain/machine_int/numeric_domain_adapter.hpp>
+#include <ikos/core/domain/machine_int/polymorphic_domain.hpp>
+#include <ikos/core/domain/numeric/var_packing_dbm_congruence.hpp>
+#include <ikos/core/example/machine_int/variable_factory.hpp>
+
+/// \file
+///
+/// Compare a machine integer domain used directly with the same domain behind
+/// `machine_int::PolymorphicDomain`, as in the default build of the analyzer,
+/// where every operation is a virtual call and every copy a heap allocation.
+/// The analyzer built with `-DSTATIC_DOMAIN=<domain>` uses the former.
+///
+/// The workload mimics the fixpoint on a chain of basic blocks: copy the
+/// invariant, apply a few transfer functions, join and compare.
+///
+/// The interval domain runs 50 times more rounds than the relational one.
+///
+/// Usage: benchmark-core-domain-polymorphic_domain [num_vars] [num_rounds]
+
+namespace {
+
+using ZNumber = ikos::core::ZNumber;
+using Int = ikos::core::MachineInt;
+using ikos::core::Signed;
+using ikos::core::machine_int::BinaryOperator;
+using ikos::core::machine_int::Predicate;
+using VariableFactory = ikos::core::example::machine_int::VariableFactory;
+using Variable = VariableFactory::VariableRef;
+using PolymorphicDomain =
+    ikos::core::machine_int::PolymorphicDomain< Variable >;
+using IntervalDomain = ikos::core::machine_int::IntervalDomain< Variable >;
+using VarPackDBMCongruence =
+    ikos::core::numeric::VarPackingDBMCongruence< ZNumber, Variable >;
+using VarPackDBMCongruenceDomain =
+    ikos::core::machine_int::NumericDomainAdapter< Variable,
+                                                   VarPackDBMCongruence >;
+using Clock = std::chrono::steady_clock;
+
+/// \brief Analyze `num_rounds` times a chain of blocks on `vars`
+template < typename Domain >
+std::size_t run(const Domain& top,
+                const std::vector< Variable >& vars,
+                std::size_t num_rounds) {
+  std::size_t checksum = 0;
+  std::size_t n = vars.size();
+  for (std::size_t r = 0; r < num_rounds; r++) {
+    Domain inv = top;
+    inv.assign(vars[0], Int(0, 32, Signed));
+    Domain acc = inv;
+    for (std::size_t i = 1; i < n; i++) {
+      // Copy of the pre invariant, as done on every edge
+      Domain post = inv;
+      post.apply(BinaryOperator::Add,
+                 vars[i],
+                 vars[i - 1],
+                 Int(static_cast< int >(i % 7), 32, Signed));
+      post.add(Predicate::LE, vars[i], Int(1000, 32, Signed));
+      post.add(Predicate::LE, vars[i - 1], vars[i]);
+      acc.join_with(post);
+      checksum += static_cast< std::size_t >(post.leq(acc));
+      inv = std::move(post);
+    }
+    checksum += static_cast< std::size_t >(acc.is_bottom());
+  }
+  return checksum;
+}
+
+/// \brief Run `f` and print the elapsed time
+template < typename Function >
+void measure(const std::string& name, Function f) {
+  auto start = Clock::now();
+  std::size_t checksum = f();
+  std::chrono::duration< double > elapsed = Clock::now() - start;
+  std::cout << std::left << std::setw(34) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(3)
+            << elapsed.count() << " s  (checksum " << checksum << ")\n";
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  std::size_t num_vars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+  std::size_t num_rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+
+  std::cout << "vars: " << num_vars << ", rounds: " << num_rounds << "\n";
+
+  VariableFactory vfac;
+  std::vector< Variable > vars;
+  for (std::size_t i = 0; i < num_vars; i++) {
+    vars.push_back(vfac.get("v" + std::to_string(i), 32, Signed));
+  }
+
+  measure("interval (static)", [&] {
+    return run(IntervalDomain::top(), vars, num_rounds * 50);
+  });
+  measure("interval (polymorphic)", [&] {
+    return run(PolymorphicDomain(IntervalDomain::top()),
+               vars,
+               num_rounds * 50);
+  });
+  measure("var-pack-dbm-congruence (static)", [&] {
+    return run(VarPackDBMCongruenceDomain(VarPackDBMCongruence::top()),
+               vars,
+               num_rounds);
+  });
+  measure("var-pack-dbm-congruence (poly)", [&] {
+    return run(PolymorphicDomain(
+                   VarPackDBMCongruenceDomain(VarPackDBMCongruence::top())),
+               vars,
+               num_rounds);
+  });
+
+  return 0;
+}
@@ -0,0 +1,227 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Benchmark of the variable packing DBM with congruences
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ikos/core/domain/numeric/var_packing_dbm_congruence.hpp>
+#include <ikos/core/example/variable_factory.hpp>
+
+/// \file
+///
+/// Scale the scenarios of the unit tests of `VarPackingDBMCongruence` to
+/// thousands of variables, grouped in packs of 4 related variables.
+///
+/// Each operation copies a large invariant, as done on every edge of the
+/// fixpoint, then updates, joins or compares a single pack.
+///
+/// Usage: benchmark-core-domain-var_packing_dbm_congruence [num_vars]
+/// [num_rounds] [eager|lazy]
+
+namespace {
+
+using ZNumber = ikos::core::ZNumber;
+using VariableFactory = ikos::core::example::VariableFactory;
+using Variable = VariableFactory::VariableRef;
+using VariableExpr = ikos::core::VariableExpression< ZNumber, Variable >;
+using BinaryOperator = ikos::core::numeric::BinaryOperator;
+using Bound = ikos::core::ZBound;
+using Interval = ikos::core::numeric::ZInterval;
+using VarPackingDBMCongruence =
+    ikos::core::numeric::VarPackingDBMCongruence< ZNumber, Variable >;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t PackSize = 4;
+
+/// \brief Relate the variables of the pack starting at `vars[i]`
+void add_pack(VarPackingDBMCongruence& inv,
+              const std::vector< Variable >& vars,
+              std::size_t i,
+              int offset) {
+  inv.set(vars[i], Interval(Bound(offset), Bound(offset + 10)));
+  for (std::size_t j = i + 1; j < i + PackSize; j++) {
+    inv.add(VariableExpr(vars[j]) - VariableExpr(vars[j - 1]) <= 1);
+    inv.add(VariableExpr(vars[j - 1]) - VariableExpr(vars[j]) <= 0);
+  }
+}
+
+/// \brief Run `f` and print the number of operations per second
+template < typename Function >
+void measure(const std::string& name, std::size_t num_ops, Function f) {
+  auto start = Clock::now();
+  std::size_t checksum = f();
+  std::chrono::duration< double > elapsed = Clock::now() - start;
+  std::cout << std::left << std::setw(16) << name << std::right
+            << std::setw(12)
+            << static_cast< std::size_t >(
+                   static_cast< double >(num_ops) / elapsed.count())
+            << " ops/s  " << std::setw(8) << std::fixed
+            << std::setprecision(3) << elapsed.count() << " s  (checksum "
+            << checksum << ")\n";
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  std::size_t num_vars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000;
+  std::size_t num_rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+  bool lazy = argc > 3 && std::string(argv[3]) == "lazy";
+  num_vars = std::max(num_vars / PackSize, std::size_t(1)) * PackSize;
+  std::size_t num_packs = num_vars / PackSize;
+
+  std::cout << "vars: " << num_vars << ", rounds: " << num_rounds
+            << ", normalization: " << (lazy ? "lazy" : "eager") << "\n";
+
+  ikos::core::LazyNormalization::enable(lazy);
+
+  VariableFactory vfac;
+  std::vector< Variable > vars;
+  for (std::size_t i = 0; i < num_vars; i++) {
+    vars.push_back(vfac.get("v" + std::to_string(i)));
+  }
+
+  auto base = VarPackingDBMCongruence::top();
+  for (std::size_t p = 0; p < num_packs; p++) {
+    add_pack(base, vars, p * PackSize, static_cast< int >(p % 100));
+  }
+  base.normalize();
+
+  // Pack updated by the i-th round
+  auto pack = [&](std::size_t r) { return (r * 7919 % num_packs) * PackSize; };
+
+  measure("copy", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      VarPackingDBMCongruence inv = base;
+      checksum += static_cast< std::size_t >(inv.is_bottom());
+    }
+    return checksum;
+  });
+  measure("assign", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      VarPackingDBMCongruence inv = base;
+      std::size_t i = pack(r);
+      inv.assign(vars[i + 1], VariableExpr(vars[i]) + 2);
+      checksum += static_cast< std::size_t >(inv.is_bottom());
+    }
+    return checksum;
+  });
+  measure("apply", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      VarPackingDBMCongruence inv = base;
+      std::size_t i = pack(r);
+      inv.apply(BinaryOperator::Mul, vars[i + 2], vars[i], ZNumber(4));
+      checksum += static_cast< std::size_t >(inv.is_bottom());
+    }
+    return checksum;
+  });
+  measure("add", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      VarPackingDBMCongruence inv = base;
+      std::size_t i = pack(r);
+      inv.add(VariableExpr(vars[i + 3]) <= 150);
+      checksum += static_cast< std::size_t >(inv.is_bottom());
+    }
+    return checksum;
+  });
+  measure("forget", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      VarPackingDBMCongruence inv = base;
+      inv.forget(vars[pack(r) + 1]);
+      checksum += static_cast< std::size_t >(inv.is_bottom());
+    }
+    return checksum;
+  });
+  measure("join", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      VarPackingDBMCongruence inv = base;
+      std::size_t i = pack(r);
+      inv.add(VariableExpr(vars[i + 3]) - VariableExpr(vars[i]) <= 1);
+      inv.join_with(base);
+      checksum += static_cast< std::size_t >(base.leq(inv));
+    }
+    return checksum;
+  });
+  measure("join (repack)", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      VarPackingDBMCongruence inv = base;
+      std::size_t i = pack(r);
+      inv.set(vars[i], Interval(Bound(-5), Bound(5)));
+      inv.join_with(base);
+      checksum += static_cast< std::size_t >(base.leq(inv));
+    }
+    return checksum;
+  });
+  measure("leq", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      VarPackingDBMCongruence inv = base;
+      inv.add(VariableExpr(vars[pack(r)]) <= 5);
+      checksum += static_cast< std::size_t >(inv.leq(base));
+    }
+    return checksum;
+  });
+  measure("widening", num_rounds, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds; r++) {
+      VarPackingDBMCongruence inv = base;
+      std::size_t i = pack(r);
+      inv.assign(vars[i], VariableExpr(vars[i]) + 1);
+      inv.widen_with(base);
+      checksum += static_cast< std::size_t >(inv.is_top());
+    }
+    return checksum;
+  });
+
+  std::cout << "closures: " << ikos::core::LazyNormalization::closures()
+            << ", avoided closures: "
+            << ikos::core::LazyNormalization::avoided_closures() << "\n";
+  return 0;
+}
@@ -0,0 +1,173 @@
+/*******************************************************************************
+ *
+ * \file
+ * \brief Benchmark of the unlimited precision integer arithmetic
+ *
+ * Notices:
+ *
+ * Copyright (c) 2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ikos/core/domain/numeric/dbm.hpp>
+#include <ikos/core/example/variable_factory.hpp>
+#include <ikos/core/number/z_number.hpp>
+#include <ikos/core/value/numeric/congruence.hpp>
+#include <ikos/core/value/numeric/interval.hpp>
+
+/// \file
+///
+/// Measure the throughput of the numerical operations that dominate the
+/// analysis time with small constants: the closure of a DBM, joins of
+/// intervals and the arithmetic on congruences.
+///
+/// Usage: benchmark-core-number-z_number [num_vars] [num_rounds]
+
+namespace {
+
+using ZNumber = ikos::core::ZNumber;
+using VariableFactory = ikos::core::example::VariableFactory;
+using Variable = ikos::core::example::VariableFactory::VariableRef;
+using VariableExpr = ikos::core::VariableExpression< ZNumber, Variable >;
+using Bound = ikos::core::ZBound;
+using Interval = ikos::core::numeric::ZInterval;
+using Congruence = ikos::core::numeric::ZCongruence;
+using DBM = ikos::core::numeric::DBM< ZNumber, Variable >;
+using Clock = std::chrono::steady_clock;
+
+/// \brief Run `f` and print the number of operations per second
+template < typename Function >
+void measure(const std::string& name, std::size_t num_ops, Function f) {
+  auto start = Clock::now();
+  std::size_t checksum = f();
+  std::chrono::duration< double > elapsed = Clock::now() - start;
+  std::cout << std::left << std::setw(16) << name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(0)
+            << (static_cast< double >(num_ops) / elapsed.count()) << " ops/s"
+            << std::setw(10) << std::setprecision(3) << elapsed.count()
+            << " s  (checksum " << checksum << ")\n";
+}
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  std::size_t num_vars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32;
+  std::size_t num_rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution< int > pick_cst(-100, 100);
+
+  std::cout << "vars: " << num_vars << ", rounds: " << num_rounds << "\n";
+
+  VariableFactory vfac;
+  std::vector< Variable > vars;
+  for (std::size_t i = 0; i < num_vars; i++) {
+    vars.push_back(vfac.get("v" + std::to_string(i)));
+  }
+
+  // A chain of difference constraints, plus random shortcuts
+  DBM base = DBM::top();
+  for (std::size_t i = 0; i + 1 < num_vars; i++) {
+    base.add(VariableExpr(vars[i + 1]) - VariableExpr(vars[i]) <=
+             ZNumber(pick_cst(rng) + 100));
+  }
+  base.add(VariableExpr(vars[0]) >= ZNumber(0));
+  base.add(VariableExpr(vars[0]) <= ZNumber(1000));
+  std::uniform_int_distribution< std::size_t > pick_var(0, num_vars - 1);
+  for (std::size_t i = 0; i < num_vars; i++) {
+    base.add(VariableExpr(vars[pick_var(rng)]) -
+                 VariableExpr(vars[pick_var(rng)]) <=
+             ZNumber(pick_cst(rng) + 200));
+  }
+
+  measure("dbm closure", num_rounds * 10, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds * 10; r++) {
+      // The meet forces a full closure
+      DBM inv = base.meet(DBM::top());
+      checksum += static_cast< std::size_t >(
+          inv.to_interval(vars[num_vars - 1]).ub().number()->to< int >());
+    }
+    return checksum;
+  });
+
+  std::vector< Interval > intervals;
+  for (std::size_t i = 0; i < 1024; i++) {
+    int lb = pick_cst(rng);
+    int ub = lb + std::abs(pick_cst(rng));
+    intervals.emplace_back(Bound(lb), Bound(ub));
+  }
+
+  measure("interval join", num_rounds * 1024 * 16, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds * 16; r++) {
+      Interval acc = Interval::bottom();
+      for (const Interval& itv : intervals) {
+        acc.join_with(itv);
+        acc = acc.join(itv + Interval(static_cast< int >(r % 7)));
+      }
+      checksum += static_cast< std::size_t >(acc.ub().number()->to< int >());
+    }
+    return checksum;
+  });
+
+  std::vector< Congruence > congruences;
+  for (std::size_t i = 0; i < 1024; i++) {
+    congruences.emplace_back(ZNumber(std::abs(pick_cst(rng)) % 16),
+                             ZNumber(pick_cst(rng)));
+  }
+
+  measure("congruence ops", num_rounds * 1024 * 4, [&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < num_rounds * 4; r++) {
+      for (std::size_t i = 0; i < congruences.size(); i++) {
+        const Congruence& a = congruences[i];
+        const Congruence& b = congruences[(i + r + 1) % congruences.size()];
+        Congruence c = (a + b) * a;
+        c.join_with(b);
+        c.meet_with(a - b);
+        checksum += static_cast< std::size_t >(c.is_bottom());
+      }
+    }
+    return checksum;
+  });
+
+  return 0;
+}
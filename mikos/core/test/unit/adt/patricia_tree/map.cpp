@@ -42,6 +42,11 @@
 
 #define BOOST_TEST_MODULE test_patricia_tree_map
 #define BOOST_TEST_DYN_LINK
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <vector>
+
 #include <boost/mpl/list.hpp>
 #include <boost/test/output_test_stream.hpp>
 #include <boost/test/unit_test.hpp>
@@ -272,3 +277,93 @@ BOOST_AUTO_TEST_CASE(test_patricia_tree_map) {
       {{1, "hellozzzzz"}}};
   BOOST_CHECK(std::equal(m.begin(), m.end(), std::begin(tab4), std::end(tab4)));
 }
+
+BOOST_AUTO_TEST_CASE(test_patricia_tree_map_threads) {
+  using Index = ikos::core::Index;
+  using Map = ikos::core::PatriciaTreeMap< Index, Index >;
+
+  // Maps built on worker threads, shared and destroyed on the main thread
+  std::vector< Map > maps(4);
+  std::vector< std::thread > threads;
+  for (std::size_t i = 0; i < maps.size(); i++) {
+    threads.emplace_back([&maps, i] {
+      Map m;
+      for (Index k = 0; k < 1000; k++) {
+        m.insert_or_assign(k, k * i);
+      }
+      for (Index k = 0; k < 1000; k += 2) {
+        m.erase(k);
+      }
+      maps[i] = m;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  Map m;
+  for (const auto& other : maps) {
+    BOOST_CHECK(other.size() == 500);
+    m.join_with(other, [](Index a, Index b) { return std::max(a, b); });
+  }
+  BOOST_CHECK(m.size() == 500);
+  BOOST_CHECK(*m.at(1) == 3);
+  BOOST_CHECK(*m.at(999) == 999 * 3);
+  maps.clear();
+  BOOST_CHECK(*m.at(999) == 999 * 3);
+}
+
+#ifdef IKOS_PATRICIA_TREE_HASH_CONSING
+BOOST_AUTO_TEST_CASE(test_patricia_tree_map_hash_consing) {
+  using Index = ikos::core::Index;
+  using Map = ikos::core::PatriciaTreeMap< Index, std::string >;
+
+  // Only physically equal trees compare equal with this comparison
+  auto never = [](const std::string&, const std::string&) { return false; };
+
+  Map m1;
+  m1.insert_or_assign(1, "hello");
+  m1.insert_or_assign(2, "world");
+  m1.insert_or_assign(7, "!");
+  Map m2;
+  m2.insert_or_assign(7, "!");
+  m2.insert_or_assign(2, "world");
+  m2.insert_or_assign(1, "hello");
+  BOOST_CHECK(m1.equals(m2, never));
+  BOOST_CHECK(m1.leq(m2, never));
+
+  m2.insert_or_assign(2, "x");
+  BOOST_CHECK(!m1.equals(m2, never));
+  m2.insert_or_assign(2, "world");
+  BOOST_CHECK(m1.equals(m2, never));
+
+  m2.erase(7);
+  BOOST_CHECK(!m1.equals(m2, never));
+  m2.insert_or_assign(7, "!");
+  BOOST_CHECK(m1.equals(m2, never));
+
+  // Cached join
+  Map m3;
+  m3.insert_or_assign(2, "zzzzz");
+  m3.insert_or_assign(3, "a");
+  Map j1 = m1.join(m3, std::plus<>());
+  Map j2 = m2.join(m3, std::plus<>());
+  BOOST_CHECK(j1.equals(j2, never));
+  BOOST_CHECK(*j1.at(2) == "worldzzzzz");
+  BOOST_CHECK(j1.size() == 4);
+
+  // Cached joins are not reused once their operands are destroyed, even if
+  // new trees get the same addresses
+  for (int i = 0; i < 8; i++) {
+    Map a;
+    a.insert_or_assign(1, std::to_string(i));
+    a.insert_or_assign(4, "a");
+    Map b;
+    b.insert_or_assign(1, "b");
+    b.insert_or_assign(5, "c");
+    Map j = a.join(b, std::plus<>());
+    BOOST_CHECK(*j.at(1) == std::to_string(i) + "b");
+    BOOST_CHECK(j.size() == 3);
+  }
+}
+#endif
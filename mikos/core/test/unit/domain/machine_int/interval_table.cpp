@@ -0,0 +1,405 @@
+/*******************************************************************************
+ *
+ * Tests for machine_int::IntervalTable
+ *
+ * Contact: ikos@lists.nasa.gov
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#define BOOST_TEST_MODULE test_machine_int_interval_table
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <ikos/core/domain/machine_int/interval_table.hpp>
+#include <ikos/core/domain/machine_int/separate_domain.hpp>
+#include <ikos/core/example/machine_int/variable_factory.hpp>
+
+using Int = ikos::core::MachineInt;
+using Interval = ikos::core::machine_int::Interval;
+using ikos::core::Signed;
+using ikos::core::Signedness;
+using ikos::core::Unsigned;
+using VariableFactory = ikos::core::example::machine_int::VariableFactory;
+using Variable = VariableFactory::VariableRef;
+using IntervalTable = ikos::core::machine_int::IntervalTable< Variable >;
+using SeparateDomain =
+    ikos::core::machine_int::SeparateDomain< Variable, Interval >;
+
+namespace impl = ikos::core::machine_int::interval_table_impl;
+
+// The AVX2 variant of this test must compile the AVX2 kernels
+#if defined(IKOS_TEST_AVX2) && !defined(__AVX2__)
+#error "IKOS_TEST_AVX2 is defined, but the compiler does not target AVX2"
+#endif
+
+namespace {
+
+/// \brief Random invariants, on both representations
+class Generator {
+private:
+  std::mt19937_64 _rng;
+  std::vector< Variable > _vars;
+
+public:
+  explicit Generator(VariableFactory& vfac) : _rng(42) {
+    const unsigned bit_widths[] = {1, 8, 16, 32, 64};
+    for (unsigned bit_width : bit_widths) {
+      for (Signedness sign : {Signed, Unsigned}) {
+        for (int i = 0; i < 4; i++) {
+          this->_vars.push_back(vfac.get("v" +
+                                             std::to_string(
+                                                 this->_vars.size()),
+                                         bit_width,
+                                         sign));
+        }
+      }
+    }
+  }
+
+  const std::vector< Variable >& vars() const { return this->_vars; }
+
+  /// \brief Return a random integer, close to the limits or to zero
+  Int integer(unsigned bit_width, Signedness sign) {
+    Int min = Int::min(bit_width, sign);
+    Int max = Int::max(bit_width, sign);
+    Int one(1, bit_width, sign);
+    switch (this->_rng() % 8) {
+      case 0:
+        return min;
+      case 1:
+        return max;
+      case 2:
+        return bit_width > 1 ? min + one : min;
+      case 3:
+        return bit_width > 1 ? max - one : max;
+      case 4:
+        return Int(this->_rng() % 4, bit_width, sign);
+      default:
+        return Int(this->_rng(), bit_width, sign);
+    }
+  }
+
+  /// \brief Return a random interval, neither bottom nor top
+  Interval interval(unsigned bit_width, Signedness sign) {
+    for (;;) {
+      Int a = this->integer(bit_width, sign);
+      Int b = this->integer(bit_width, sign);
+      Interval i = (a <= b) ? Interval(a, b) : Interval(b, a);
+      if (!i.is_top()) {
+        return i;
+      }
+    }
+  }
+
+  /// \brief Fill both representations with random intervals
+  ///
+  /// If `all` is true, all the variables are bound.
+  void fill(SeparateDomain& inv, IntervalTable& table, bool all) {
+    for (Variable x : this->_vars) {
+      if (all || this->_rng() % 3 != 0) {
+        Interval i = this->interval(x->bit_width(), x->sign());
+        inv.set(x, i);
+        table.set(x, i);
+      }
+    }
+  }
+
+  /// \brief Return a random threshold
+  Int threshold() { return this->integer(64, Signed); }
+
+  /// \brief Return a random encoded bound, often 0 or `Ones`
+  uint64_t bound() {
+    switch (this->_rng() % 4) {
+      case 0:
+        return 0;
+      case 1:
+        return impl::Ones;
+      default:
+        return this->_rng() >> (this->_rng() % 64);
+    }
+  }
+
+  /// \brief Fill the arrays with random encoded bounds
+  ///
+  /// Intervals are often non-empty, and often equal in both arrays.
+  void fill(std::vector< uint64_t >& lbs,
+            std::vector< uint64_t >& ubs,
+            std::vector< uint64_t >& o_lbs,
+            std::vector< uint64_t >& o_ubs) {
+    for (std::size_t i = 0; i < lbs.size(); i++) {
+      lbs[i] = this->bound();
+      ubs[i] = this->bound();
+      if (this->_rng() % 4 != 0 && lbs[i] > ubs[i]) {
+        std::swap(lbs[i], ubs[i]);
+      }
+      if (this->_rng() % 2 == 0) {
+        o_lbs[i] = lbs[i];
+        o_ubs[i] = ubs[i];
+      } else {
+        o_lbs[i] = this->bound();
+        o_ubs[i] = this->bound();
+      }
+    }
+  }
+};
+
+/// \brief Check that both representations are equal
+void check_equal(const std::vector< Variable >& vars,
+                 const SeparateDomain& inv,
+                 const IntervalTable& table) {
+  BOOST_REQUIRE(!inv.is_bottom());
+  std::size_t size = 0;
+  for (Variable x : vars) {
+    Interval expected = inv.get(x);
+    boost::optional< Interval > i = table.get(x);
+    if (expected.is_top()) {
+      BOOST_CHECK(!i);
+    } else {
+      BOOST_REQUIRE(i);
+      BOOST_CHECK(*i == expected);
+      size++;
+    }
+  }
+  BOOST_CHECK(table.size() == size);
+}
+
+} // end anonymous namespace
+
+BOOST_AUTO_TEST_CASE(get_set_erase) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x", 8, Signed));
+  Variable y(vfac.get("y", 64, Unsigned));
+  Variable z(vfac.get("z", 1, Signed));
+
+  IntervalTable table;
+  BOOST_CHECK(table.empty());
+  BOOST_CHECK(!table.get(x));
+
+  table.set(x, Interval(Int(-128, 8, Signed), Int(3, 8, Signed)));
+  table.set(y, Interval(Int(7, 64, Unsigned), Int::max(64, Unsigned)));
+  table.set(z, Interval(Int(-1, 1, Signed)));
+  BOOST_CHECK(table.size() == 3);
+  BOOST_CHECK(*table.get(x) ==
+              Interval(Int(-128, 8, Signed), Int(3, 8, Signed)));
+  BOOST_CHECK(*table.get(y) ==
+              Interval(Int(7, 64, Unsigned), Int::max(64, Unsigned)));
+  BOOST_CHECK(*table.get(z) == Interval(Int(-1, 1, Signed)));
+
+  IntervalTable copy = table;
+  table.set(x, Interval(Int(1, 8, Signed)));
+  table.erase(y);
+  BOOST_CHECK(table.size() == 2);
+  BOOST_CHECK(*table.get(x) == Interval(Int(1, 8, Signed)));
+  BOOST_CHECK(!table.get(y));
+  BOOST_CHECK(copy.size() == 3);
+  BOOST_CHECK(*copy.get(x) ==
+              Interval(Int(-128, 8, Signed), Int(3, 8, Signed)));
+  BOOST_CHECK(copy.get(y));
+
+  table.erase(x);
+  table.erase(z);
+  BOOST_CHECK(table.empty());
+}
+
+BOOST_AUTO_TEST_CASE(same_as_separate_domain) {
+  VariableFactory vfac;
+  Generator gen(vfac);
+  const std::vector< Variable >& vars = gen.vars();
+
+  for (int round = 0; round < 2000; round++) {
+    auto x = SeparateDomain::top();
+    auto y = SeparateDomain::top();
+    IntervalTable tx;
+    IntervalTable ty;
+    bool aligned = round % 2 == 0;
+    gen.fill(x, tx, aligned);
+    gen.fill(y, ty, aligned);
+    check_equal(vars, x, tx);
+    check_equal(vars, y, ty);
+
+    BOOST_CHECK(tx.leq(ty) == x.leq(y));
+    BOOST_CHECK(ty.leq(tx) == y.leq(x));
+    BOOST_CHECK(tx.leq(tx));
+    BOOST_CHECK(tx.equals(ty) == x.equals(y));
+    BOOST_CHECK(tx.equals(tx));
+
+    {
+      auto r = x;
+      IntervalTable t = tx;
+      r.join_with(y);
+      t.join_with(ty);
+      check_equal(vars, r, t);
+      BOOST_CHECK(tx.leq(t));
+      BOOST_CHECK(ty.leq(t));
+    }
+    {
+      auto r = x;
+      IntervalTable t = tx;
+      r.widen_with(y);
+      t.widen_with(ty);
+      check_equal(vars, r, t);
+    }
+    {
+      Int threshold = gen.threshold();
+      auto r = x;
+      IntervalTable t = tx;
+      r.widen_threshold_with(y, threshold);
+      t.widen_threshold_with(ty, threshold);
+      check_equal(vars, r, t);
+    }
+    {
+      auto r = x;
+      IntervalTable t = tx;
+      r.meet_with(y);
+      bool not_bottom = t.meet_with(ty);
+      BOOST_CHECK(not_bottom == !r.is_bottom());
+      if (not_bottom) {
+        check_equal(vars, r, t);
+      }
+    }
+    {
+      auto r = x;
+      IntervalTable t = tx;
+      r.narrow_with(y);
+      bool not_bottom = t.narrow_with(ty);
+      BOOST_CHECK(not_bottom == !r.is_bottom());
+      if (not_bottom) {
+        check_equal(vars, r, t);
+      }
+    }
+    {
+      Int threshold = gen.threshold();
+      auto r = x;
+      IntervalTable t = tx;
+      r.narrow_threshold_with(y, threshold);
+      bool not_bottom = t.narrow_threshold_with(ty, threshold);
+      BOOST_CHECK(not_bottom == !r.is_bottom());
+      if (not_bottom) {
+        check_equal(vars, r, t);
+      }
+    }
+
+    // The operands are unchanged
+    check_equal(vars, x, tx);
+    check_equal(vars, y, ty);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(kernels) {
+  VariableFactory vfac;
+  Generator gen(vfac);
+
+  // Sizes around multiples of 4, to cover the vectorized loops and the tails
+  for (std::size_t n = 0; n <= 13; n++) {
+    for (int round = 0; round < 200; round++) {
+      std::vector< uint64_t > lbs(n), ubs(n), o_lbs(n), o_ubs(n);
+      gen.fill(lbs, ubs, o_lbs, o_ubs);
+
+      // Scalar reference, element by element
+      std::vector< uint64_t > join_lbs(n), join_ubs(n);
+      std::vector< uint64_t > widen_lbs(n), widen_ubs(n);
+      std::vector< uint64_t > meet_lbs(n), meet_ubs(n);
+      std::vector< uint64_t > narrow_lbs(n), narrow_ubs(n);
+      bool meet_not_bottom = true;
+      bool narrow_not_bottom = true;
+      bool leq = true;
+      std::size_t count_top = 0;
+      for (std::size_t i = 0; i < n; i++) {
+        join_lbs[i] = std::min(lbs[i], o_lbs[i]);
+        join_ubs[i] = std::max(ubs[i], o_ubs[i]);
+        widen_lbs[i] = (o_lbs[i] < lbs[i]) ? 0 : lbs[i];
+        widen_ubs[i] = (ubs[i] < o_ubs[i]) ? impl::Ones : ubs[i];
+        meet_lbs[i] = std::max(lbs[i], o_lbs[i]);
+        meet_ubs[i] = std::min(ubs[i], o_ubs[i]);
+        meet_not_bottom = meet_not_bottom && meet_lbs[i] <= meet_ubs[i];
+        narrow_lbs[i] = (lbs[i] == 0) ? o_lbs[i] : lbs[i];
+        narrow_ubs[i] = (ubs[i] == impl::Ones) ? o_ubs[i] : ubs[i];
+        narrow_not_bottom = narrow_not_bottom && narrow_lbs[i] <= narrow_ubs[i];
+        leq = leq && o_lbs[i] <= lbs[i] && ubs[i] <= o_ubs[i];
+        count_top += (lbs[i] == 0 && ubs[i] == impl::Ones) ? 1 : 0;
+      }
+
+      BOOST_CHECK(impl::leq(n,
+                            lbs.data(),
+                            ubs.data(),
+                            o_lbs.data(),
+                            o_ubs.data()) == leq);
+      BOOST_CHECK(impl::count_top(n, lbs.data(), ubs.data()) == count_top);
+      {
+        std::vector< uint64_t > r_lbs = lbs, r_ubs = ubs;
+        impl::join(n, r_lbs.data(), r_ubs.data(), o_lbs.data(), o_ubs.data());
+        BOOST_CHECK(r_lbs == join_lbs);
+        BOOST_CHECK(r_ubs == join_ubs);
+      }
+      {
+        std::vector< uint64_t > r_lbs = lbs, r_ubs = ubs;
+        impl::widening(n,
+                       r_lbs.data(),
+                       r_ubs.data(),
+                       o_lbs.data(),
+                       o_ubs.data());
+        BOOST_CHECK(r_lbs == widen_lbs);
+        BOOST_CHECK(r_ubs == widen_ubs);
+      }
+      {
+        std::vector< uint64_t > r_lbs = lbs, r_ubs = ubs;
+        bool not_bottom = impl::meet(n,
+                                     r_lbs.data(),
+                                     r_ubs.data(),
+                                     o_lbs.data(),
+                                     o_ubs.data());
+        BOOST_CHECK(not_bottom == meet_not_bottom);
+        BOOST_CHECK(r_lbs == meet_lbs);
+        BOOST_CHECK(r_ubs == meet_ubs);
+      }
+      {
+        std::vector< uint64_t > r_lbs = lbs, r_ubs = ubs;
+        bool not_bottom = impl::narrowing(n,
+                                          r_lbs.data(),
+                                          r_ubs.data(),
+                                          o_lbs.data(),
+                                          o_ubs.data());
+        BOOST_CHECK(not_bottom == narrow_not_bottom);
+        BOOST_CHECK(r_lbs == narrow_lbs);
+        BOOST_CHECK(r_ubs == narrow_ubs);
+      }
+    }
+  }
+}
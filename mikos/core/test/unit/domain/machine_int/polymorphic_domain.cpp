@@ -367,6 +367,38 @@ BOOST_AUTO_TEST_CASE(join) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(copy_on_write) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x", 32, Signed));
+
+  auto inv1 = PolymorphicDomain(IntervalDomain::top());
+  inv1.set(x, Interval(Int(0, 32, Signed), Int(1, 32, Signed)));
+
+  std::size_t shares = ikos::core::CopyOnWriteStats::shares();
+  std::size_t clones = ikos::core::CopyOnWriteStats::clones();
+  auto inv2 = inv1;
+  BOOST_CHECK(ikos::core::CopyOnWriteStats::shares() == shares + 1);
+  BOOST_CHECK((inv2 == inv1));
+  BOOST_CHECK(ikos::core::CopyOnWriteStats::clones() == clones);
+
+  // Joining a value with a copy does not clone it
+  inv2.join_with(inv1);
+  BOOST_CHECK(ikos::core::CopyOnWriteStats::clones() == clones);
+
+  // Modifying a copy does not change the original
+  inv2.set(x, Interval(Int(2, 32, Signed)));
+  BOOST_CHECK(ikos::core::CopyOnWriteStats::clones() == clones + 1);
+  BOOST_CHECK(inv1.to_interval(x) ==
+              Interval(Int(0, 32, Signed), Int(1, 32, Signed)));
+  BOOST_CHECK(inv2.to_interval(x) == Interval(Int(2, 32, Signed)));
+
+  // The original is not shared anymore
+  inv1.set_to_bottom();
+  BOOST_CHECK(ikos::core::CopyOnWriteStats::clones() == clones + 1);
+  BOOST_CHECK(inv1.is_bottom());
+  BOOST_CHECK(!inv2.is_bottom());
+}
+
 BOOST_AUTO_TEST_CASE(widening) {
   VariableFactory vfac;
   Variable x(vfac.get("x", 32, Signed));
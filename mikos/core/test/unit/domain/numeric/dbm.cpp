@@ -42,6 +42,13 @@
 
 #define BOOST_TEST_MODULE test_dbm
 #define BOOST_TEST_DYN_LINK
+#include <array>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <boost/mpl/list.hpp>
 #include <boost/test/output_test_stream.hpp>
 #include <boost/test/unit_test.hpp>
@@ -829,6 +836,165 @@ BOOST_AUTO_TEST_CASE(forget) {
   BOOST_CHECK(inv.is_top());
 }
 
+BOOST_AUTO_TEST_CASE(incremental_closure) {
+  VariableFactory vfac;
+  std::vector< Variable > vars;
+  for (int i = 0; i < 6; i++) {
+    vars.push_back(vfac.get("v" + std::to_string(i)));
+  }
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution< std::size_t > pick_var(0, vars.size() - 1);
+  std::uniform_int_distribution< int > pick_op(0, 5);
+  std::uniform_int_distribution< int > pick_cst(-10, 10);
+
+  for (int run = 0; run < 50; run++) {
+    // `inc` uses the incremental closure, `full` is re-created by a meet after
+    // each operation and thus always uses the full closure
+    auto inc = DBM::top();
+    auto full = DBM::top();
+
+    for (int step = 0; step < 30; step++) {
+      Variable x = vars[pick_var(gen)];
+      Variable y = vars[pick_var(gen)];
+      ZNumber c(pick_cst(gen));
+
+      switch (pick_op(gen)) {
+        case 0: {
+          inc.add(VariableExpr(x) - VariableExpr(y) <= c);
+          full.add(VariableExpr(x) - VariableExpr(y) <= c);
+        } break;
+        case 1: {
+          inc.add(VariableExpr(x) <= c + 20);
+          full.add(VariableExpr(x) <= c + 20);
+        } break;
+        case 2: {
+          inc.add(VariableExpr(x) >= c - 20);
+          full.add(VariableExpr(x) >= c - 20);
+        } break;
+        case 3: {
+          inc.assign(x, VariableExpr(y) + c);
+          full.assign(x, VariableExpr(y) + c);
+        } break;
+        case 4: {
+          inc.apply(BinaryOperator::Add, x, x, c);
+          full.apply(BinaryOperator::Add, x, x, c);
+        } break;
+        default: {
+          inc.forget(x);
+          full.forget(x);
+        } break;
+      }
+
+      full = full.meet(DBM::top());
+
+      BOOST_CHECK(inc.is_bottom() == full.is_bottom());
+      BOOST_CHECK(inc.equals(full));
+      for (const auto& v : vars) {
+        BOOST_CHECK(inc.to_interval(v) == full.to_interval(v));
+      }
+
+      if (inc.is_bottom()) {
+        break;
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(copy_on_write) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+
+  auto inv1 = DBM::top();
+  inv1.set(y, Interval(Bound(0), Bound(10)));
+  inv1.add(VariableExpr(x) - VariableExpr(y) <= 1);
+  inv1.normalize();
+  Interval x_interval = inv1.to_interval(x);
+  BOOST_CHECK(x_interval == Interval(Bound::minus_infinity(), Bound(11)));
+
+  std::size_t clones = ikos::core::CopyOnWriteStats::clones();
+  auto inv2 = inv1;
+  BOOST_CHECK(inv2.equals(inv1));
+  BOOST_CHECK(ikos::core::CopyOnWriteStats::clones() == clones);
+
+  // Modifying a copy does not change the original
+  inv2.set(x, Interval(Bound(20)));
+  BOOST_CHECK(ikos::core::CopyOnWriteStats::clones() == clones + 1);
+  BOOST_CHECK(inv1.to_interval(x) == x_interval);
+  BOOST_CHECK(inv2.to_interval(x) == Interval(Bound(20)));
+
+  // Adding a variable to a copy does not change the original
+  auto inv3 = inv1;
+  inv3.add(VariableExpr(z) - VariableExpr(x) <= 0);
+  inv3.normalize();
+  BOOST_CHECK(inv1.to_interval(z) == Interval::top());
+  BOOST_CHECK(inv3.to_interval(z) == x_interval);
+  BOOST_CHECK(inv1.to_interval(x) == x_interval);
+  BOOST_CHECK(inv1.to_interval(y) == Interval(Bound(0), Bound(10)));
+}
+
+BOOST_AUTO_TEST_CASE(threads) {
+  constexpr std::size_t NumThreads = 2;
+  constexpr std::size_t NumVars = 24;
+
+  VariableFactory vfac;
+  std::vector< Variable > xs;
+  for (std::size_t i = 0; i < NumVars; i++) {
+    xs.push_back(vfac.get("x" + std::to_string(i)));
+  }
+
+  Interval expected(Bound(0), Bound(100));
+  for (std::size_t round = 0; round < 50; round++) {
+    // Chain 0 <= x_0 <= x_1 <= ... <= x_n <= 100, not normalized yet
+    auto base = DBM::top();
+    base.add(VariableExpr(xs[0]) >= 0);
+    for (std::size_t i = 0; i + 1 < NumVars; i++) {
+      base.add(VariableExpr(xs[i]) <= VariableExpr(xs[i + 1]));
+    }
+    base.add(VariableExpr(xs[NumVars - 1]) <= 100);
+    if (round % 2 == 1) {
+      // Needs a full closure instead of an incremental one
+      base = base.meet(DBM::top());
+    }
+
+    // The copies share the matrix of `base`, and are normalized concurrently
+    std::array< DBM, NumThreads > copies{base, base};
+    std::array< bool, NumThreads > ok{};
+    std::atomic< std::size_t > ready(0);
+    std::vector< std::thread > threads;
+    for (std::size_t t = 0; t < NumThreads; t++) {
+      threads.emplace_back([&, t] {
+        ready++;
+        while (ready < NumThreads) {
+          std::this_thread::yield();
+        }
+
+        const DBM& inv = copies[t];
+        inv.normalize();
+        ok[t] = !inv.is_bottom();
+        for (std::size_t i = 0; i < NumVars; i++) {
+          ok[t] = ok[t] && inv.to_interval(xs[i]) == expected;
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (std::size_t t = 0; t < NumThreads; t++) {
+      BOOST_CHECK(ok[t]);
+    }
+
+    // The threads did not modify the matrix of `base`
+    base.normalize();
+    for (std::size_t i = 0; i < NumVars; i++) {
+      BOOST_CHECK(base.to_interval(xs[i]) == expected);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(to_interval) {
   VariableFactory vfac;
   Variable x(vfac.get("x"));
@@ -42,6 +42,12 @@
 
 #define BOOST_TEST_MODULE test_var_packing_dbm
 #define BOOST_TEST_DYN_LINK
+#include <array>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <boost/mpl/list.hpp>
 #include <boost/test/output_test_stream.hpp>
 #include <boost/test/unit_test.hpp>
@@ -921,3 +927,145 @@ BOOST_AUTO_TEST_CASE(to_interval_congruence) {
                                          3 * VariableExpr(y) + 1) ==
               IntervalCongruence(Interval(Bound(-9), Bound(-4))));
 }
+
+BOOST_AUTO_TEST_CASE(lazy_normalization) {
+  using LazyNormalization = ikos::core::LazyNormalization;
+
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+  Variable z(vfac.get("z"));
+  Variable w(vfac.get("w"));
+  Variable a(vfac.get("a"));
+
+  LazyNormalization::enable(true);
+
+  // Packs {x, y} and {z, w}, not normalized
+  auto inv1 = VarPackingDBM::top();
+  inv1.add(VariableExpr(x) - VariableExpr(y) <= 0);
+  inv1.add(VariableExpr(x) >= 0);
+  inv1.add(VariableExpr(y) <= 10);
+  inv1.add(VariableExpr(z) - VariableExpr(w) <= 0);
+  inv1.add(VariableExpr(w) <= 5);
+
+  // Only the pack {x, y} differs, the pack {z, w} is shared
+  auto inv2 = inv1;
+  inv2.add(VariableExpr(x) >= 2);
+
+  // The join only normalizes both packs {x, y}
+  std::size_t closures = LazyNormalization::closures();
+  auto inv3 = inv1.join(inv2);
+  BOOST_CHECK(LazyNormalization::closures() == closures + 2);
+  BOOST_CHECK(inv2.leq(inv3));
+  BOOST_CHECK(!inv3.leq(inv2));
+  BOOST_CHECK(LazyNormalization::closures() == closures + 3);
+
+  // Queries normalize the pack they need, once
+  BOOST_CHECK(inv3.to_interval(x) == Interval(Bound(0), Bound(10)));
+  BOOST_CHECK(inv3.to_interval(z) == Interval(Bound::minus_infinity(),
+                                              Bound(5)));
+  closures = LazyNormalization::closures();
+  BOOST_CHECK(inv1.to_interval(z) == Interval(Bound::minus_infinity(),
+                                              Bound(5)));
+  BOOST_CHECK(LazyNormalization::closures() == closures);
+
+  // Transfer functions only normalize the packs of their operands
+  inv2.add(VariableExpr(y) <= 8);
+  inv2.add(VariableExpr(w) <= 4);
+  closures = LazyNormalization::closures();
+  inv2.apply(BinaryOperator::Mul, a, x, y);
+  BOOST_CHECK(LazyNormalization::closures() == closures + 1);
+  BOOST_CHECK(inv2.to_interval(a) == Interval(Bound(4), Bound(64)));
+
+  // A dirty pack that is never queried is never normalized
+  std::size_t avoided = LazyNormalization::avoided_closures();
+  {
+    auto inv4 = inv1;
+    inv4.add(VariableExpr(w) <= 4);
+  }
+  BOOST_CHECK(LazyNormalization::avoided_closures() == avoided + 1);
+
+  // A pack reduced to bottom is found by is_bottom()
+  auto inv5 = inv1;
+  inv5.add(VariableExpr(w) <= VariableExpr(z) - 1);
+  BOOST_CHECK(inv5.is_bottom());
+
+  LazyNormalization::enable(false);
+}
+
+BOOST_AUTO_TEST_CASE(threads) {
+  constexpr std::size_t NumThreads = 4;
+  constexpr std::size_t NumPacks = 256;
+
+  VariableFactory vfac;
+  std::vector< Variable > xs;
+  std::vector< Variable > ys;
+  for (std::size_t i = 0; i < NumPacks; i++) {
+    xs.push_back(vfac.get("x" + std::to_string(i)));
+    ys.push_back(vfac.get("y" + std::to_string(i)));
+  }
+
+  // Packs {x_i, y_i} with 0 <= x_i <= y_i <= 10, not normalized yet
+  auto base = VarPackingDBM::top();
+  for (std::size_t i = 0; i < NumPacks; i++) {
+    base.add(VariableExpr(xs[i]) >= 0);
+    base.add(VariableExpr(xs[i]) <= VariableExpr(ys[i]));
+    base.add(VariableExpr(ys[i]) <= 10);
+  }
+
+  // Copies of `base` share its packs, and are used by different threads.
+  // `base` itself is only read.
+  std::array< bool, NumThreads > ok{};
+  std::atomic< std::size_t > ready(0);
+  std::vector< std::thread > threads;
+  for (std::size_t t = 0; t < NumThreads; t++) {
+    threads.emplace_back([&, t] {
+      VarPackingDBM ref = base;
+      ok[t] = true;
+
+      // Start together, so that the shared packs are normalized concurrently
+      ready++;
+      while (ready < NumThreads) {
+        std::this_thread::yield();
+      }
+
+      for (std::size_t round = 0; round < 50; round++) {
+        VarPackingDBM inv = base;
+        inv.add(VariableExpr(xs[t]) >= 1);
+        inv.normalize();
+
+        for (std::size_t i = 0; i < NumPacks; i++) {
+          Interval expected(Bound(i == t ? 1 : 0), Bound(10));
+          ok[t] = ok[t] && inv.to_interval(xs[i]) == expected &&
+                  inv.to_interval(ys[i]) == expected;
+        }
+        ok[t] = ok[t] && inv.leq(ref) && !ref.leq(inv);
+
+        VarPackingDBM widened = inv;
+        widened.widen_with(ref);
+        ok[t] = ok[t] && ref.leq(widened) && !widened.leq(ref);
+
+        inv.join_with(ref);
+        ok[t] = ok[t] && inv.equals(ref);
+
+        inv.meet_with(ref);
+        inv.assign(ys[t], 5);
+        ok[t] = ok[t] &&
+                inv.to_interval(xs[t]) == Interval(Bound(0), Bound(10)) &&
+                inv.to_interval(ys[t]) == Interval(Bound(5));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (std::size_t t = 0; t < NumThreads; t++) {
+    BOOST_CHECK(ok[t]);
+  }
+  base.normalize();
+  for (std::size_t i = 0; i < NumPacks; i++) {
+    BOOST_CHECK(base.to_interval(xs[i]) == Interval(Bound(0), Bound(10)));
+    BOOST_CHECK(base.to_interval(ys[i]) == Interval(Bound(0), Bound(10)));
+  }
+}
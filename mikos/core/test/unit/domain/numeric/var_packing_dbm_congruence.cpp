@@ -1059,3 +1059,51 @@ BOOST_AUTO_TEST_CASE(to_interval_congruence) {
               IntervalCongruence(Interval(Bound(-20), Bound(-5)),
                                  Congruence(ZNumber(3), ZNumber(1))));
 }
+
+BOOST_AUTO_TEST_CASE(shared_structure) {
+  VariableFactory vfac;
+  std::vector< Variable > xs;
+  std::vector< Variable > ys;
+  for (int i = 0; i < 32; i++) {
+    xs.push_back(vfac.get("x" + std::to_string(i)));
+    ys.push_back(vfac.get("y" + std::to_string(i)));
+  }
+
+  // One pack {x_i, y_i} per i, with x_i in [0, i] and y_i in [x_i, x_i + 1]
+  auto base = VarPackingDBMCongruence::top();
+  for (int i = 0; i < 32; i++) {
+    base.set(xs[i], Interval(Bound(0), Bound(i)));
+    base.add(VariableExpr(ys[i]) - VariableExpr(xs[i]) <= 1);
+    base.add(VariableExpr(xs[i]) - VariableExpr(ys[i]) <= 0);
+  }
+
+  // Same packs as `base`
+  auto inv1 = base;
+  inv1.add(VariableExpr(ys[5]) <= 3);
+  BOOST_CHECK(inv1.to_interval(xs[5]) == Interval(Bound(0), Bound(3)));
+  BOOST_CHECK(base.to_interval(xs[5]) == Interval(Bound(0), Bound(5)));
+  BOOST_CHECK(inv1.leq(base));
+  BOOST_CHECK(!base.leq(inv1));
+  BOOST_CHECK(inv1.join(base).equals(base));
+  BOOST_CHECK(inv1.meet(base).equals(inv1));
+
+  // Different packs
+  auto inv2 = base;
+  inv2.set(xs[0], Interval(Bound(5)));
+  BOOST_CHECK(inv2.to_interval(xs[0]) == Interval(Bound(5)));
+  BOOST_CHECK(base.to_interval(xs[0]) == Interval(Bound(0)));
+  BOOST_CHECK(!inv2.leq(base));
+  BOOST_CHECK(!base.leq(inv2));
+
+  auto inv3 = inv2.join(base);
+  BOOST_CHECK(inv3.to_interval(xs[0]) == Interval(Bound(0), Bound(5)));
+  BOOST_CHECK(inv3.to_interval(ys[0]) == Interval(Bound(0), Bound(1)));
+  BOOST_CHECK(inv3.to_interval(ys[7]) == Interval(Bound(0), Bound(8)));
+  BOOST_CHECK(base.leq(inv3));
+  BOOST_CHECK(inv2.leq(inv3));
+
+  inv3.add(VariableExpr(xs[7]) <= 2);
+  BOOST_CHECK(inv3.to_interval(ys[7]) == Interval(Bound(0), Bound(3)));
+  BOOST_CHECK(base.to_interval(ys[7]) == Interval(Bound(0), Bound(8)));
+  BOOST_CHECK(!base.leq(inv3));
+}
@@ -0,0 +1,183 @@
+/*******************************************************************************
+ *
+ * Tests for VarPackingSparseDBM
+ *
+ * Notices:
+ *
+ * Copyright (c) 2018-2019 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Disclaimers:
+ *
+ * No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY OF
+ * ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY, INCLUDING, BUT NOT LIMITED
+ * TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL CONFORM TO SPECIFICATIONS,
+ * ANY IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * OR FREEDOM FROM INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE
+ * ERROR FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+ * THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER, CONSTITUTE AN
+ * ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT OF ANY RESULTS,
+ * RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY OTHER APPLICATIONS
+ * RESULTING FROM USE OF THE SUBJECT SOFTWARE.  FURTHER, GOVERNMENT AGENCY
+ * DISCLAIMS ALL WARRANTIES AND LIABILITIES REGARDING THIRD-PARTY SOFTWARE,
+ * IF PRESENT IN THE ORIGINAL SOFTWARE, AND DISTRIBUTES IT "AS IS."
+ *
+ * Waiver and Indemnity:  RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS AGAINST
+ * THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL
+ * AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF THE SUBJECT SOFTWARE RESULTS
+ * IN ANY LIABILITIES, DEMANDS, DAMAGES, EXPENSES OR LOSSES ARISING FROM SUCH
+ * USE, INCLUDING ANY DAMAGES FROM PRODUCTS BASED ON, OR RESULTING FROM,
+ * RECIPIENT'S USE OF THE SUBJECT SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD
+ * HARMLESS THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS,
+ * AS WELL AS ANY PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.
+ * RECIPIENT'S SOLE REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE,
+ * UNILATERAL TERMINATION OF THIS AGREEMENT.
+ *
+ ******************************************************************************/
+
+#define BOOST_TEST_MODULE test_var_packing_sparse_dbm
+#define BOOST_TEST_DYN_LINK
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <ikos/core/domain/numeric/var_packing_dbm.hpp>
+#include <ikos/core/domain/numeric/var_packing_sparse_dbm.hpp>
+#include <ikos/core/example/variable_factory.hpp>
+
+using ZNumber = ikos::core::ZNumber;
+using VariableFactory = ikos::core::example::VariableFactory;
+using Variable = ikos::core::example::VariableFactory::VariableRef;
+using VariableExpr = ikos::core::VariableExpression< ZNumber, Variable >;
+using BinaryOperator = ikos::core::numeric::BinaryOperator;
+using Bound = ikos::core::ZBound;
+using Interval = ikos::core::numeric::ZInterval;
+using VarPackingDBM = ikos::core::numeric::VarPackingDBM< ZNumber, Variable >;
+using VarPackingSparseDBM =
+    ikos::core::numeric::VarPackingSparseDBM< ZNumber, Variable >;
+
+BOOST_AUTO_TEST_CASE(is_top_and_bottom) {
+  VariableFactory vfac;
+  Variable x(vfac.get("x"));
+  Variable y(vfac.get("y"));
+
+  BOOST_CHECK(VarPackingSparseDBM::top().is_top());
+  BOOST_CHECK(!VarPackingSparseDBM::top().is_bottom());
+
+  BOOST_CHECK(!VarPackingSparseDBM::bottom().is_top());
+  BOOST_CHECK(VarPackingSparseDBM::bottom().is_bottom());
+
+  auto inv = VarPackingSparseDBM::top();
+  inv.set(x, Interval(1));
+  BOOST_CHECK(!inv.is_top());
+  BOOST_CHECK(!inv.is_bottom());
+
+  inv.set(x, Interval::bottom());
+  BOOST_CHECK(!inv.is_top());
+  BOOST_CHECK(inv.is_bottom());
+
+  inv.set_to_top();
+  inv.add(VariableExpr(x) - VariableExpr(y) <= 1);
+  inv.forget(x);
+  BOOST_CHECK(inv.is_top());
+}
+
+BOOST_AUTO_TEST_CASE(join) {
+  VariableFactory vfac;
+  Variable i(vfac.get("i"));
+  Variable j(vfac.get("j"));
+  Variable k(vfac.get("k"));
+
+  auto inv1 = VarPackingSparseDBM::top();
+  inv1.assign(i, 0);
+  inv1.assign(j, i);
+  inv1.assign(k, 5);
+
+  auto inv2 = inv1;
+  inv2.apply(BinaryOperator::Add, i, i, ZNumber(1));
+  inv2.apply(BinaryOperator::Add, j, j, ZNumber(1));
+
+  auto inv3 = inv1.join(inv2);
+  BOOST_CHECK(inv3.to_interval(i) == Interval(Bound(0), Bound(1)));
+  BOOST_CHECK(inv3.to_interval(k) == Interval(5));
+  BOOST_CHECK(inv3.to_interval(VariableExpr(i) - VariableExpr(j)) ==
+              Interval(Bound(-1), Bound(1)));
+
+  // i - j = 0 is kept by the join
+  inv3.add(VariableExpr(i) >= 1);
+  inv3.normalize();
+  BOOST_CHECK(inv3.to_interval(j) == Interval(1));
+}
+
+BOOST_AUTO_TEST_CASE(same_as_var_packing_dbm) {
+  VariableFactory vfac;
+  std::vector< Variable > vars;
+  for (int i = 0; i < 6; i++) {
+    vars.push_back(vfac.get("v" + std::to_string(i)));
+  }
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution< std::size_t > pick_var(0, vars.size() - 1);
+  std::uniform_int_distribution< int > pick_op(0, 6);
+  std::uniform_int_distribution< int > pick_cst(-10, 10);
+
+  for (int run = 0; run < 50; run++) {
+    auto sparse = VarPackingSparseDBM::top();
+    auto dense = VarPackingDBM::top();
+
+    for (int step = 0; step < 30; step++) {
+      Variable x = vars[pick_var(gen)];
+      Variable y = vars[pick_var(gen)];
+      ZNumber c(pick_cst(gen));
+
+      switch (pick_op(gen)) {
+        case 0: {
+          sparse.add(VariableExpr(x) - VariableExpr(y) <= c);
+          dense.add(VariableExpr(x) - VariableExpr(y) <= c);
+        } break;
+        case 1: {
+          sparse.add(VariableExpr(x) <= c + 20);
+          dense.add(VariableExpr(x) <= c + 20);
+        } break;
+        case 2: {
+          sparse.add(VariableExpr(x) >= c - 20);
+          dense.add(VariableExpr(x) >= c - 20);
+        } break;
+        case 3: {
+          sparse.assign(x, VariableExpr(y) + c);
+          dense.assign(x, VariableExpr(y) + c);
+        } break;
+        case 4: {
+          sparse.assign(x, c);
+          dense.assign(x, c);
+        } break;
+        case 5: {
+          sparse.forget(x);
+          dense.forget(x);
+        } break;
+        default: {
+          auto sparse_other = sparse;
+          auto dense_other = dense;
+          sparse_other.apply(BinaryOperator::Add, x, x, c);
+          dense_other.apply(BinaryOperator::Add, x, x, c);
+          sparse.join_with(sparse_other);
+          dense.join_with(dense_other);
+        } break;
+      }
+
+      BOOST_CHECK(sparse.is_bottom() == dense.is_bottom());
+      for (const auto& v : vars) {
+        BOOST_CHECK(sparse.to_interval(v) == dense.to_interval(v));
+      }
+      auto inv = VarPackingDBM::top();
+      inv.add(sparse.to_linear_constraint_system());
+      BOOST_CHECK(inv.equals(dense));
+
+      if (dense.is_bottom()) {
+        break;
+      }
+    }
+  }
+}
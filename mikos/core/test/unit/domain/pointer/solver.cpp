@@ -353,3 +353,133 @@ BOOST_AUTO_TEST_CASE(test_4) {
                                                      zero));
   BOOST_CHECK(s.get_memory(nrows) == PointerAbsValue::bottom(64, Unsigned));
 }
+
+BOOST_AUTO_TEST_CASE(test_copy_cycle) {
+  // p = &x;
+  // q = &y + 4;
+  // p = r;
+  // q = p;
+  // r = q;
+  // s = *p;
+  // *r = &x;
+
+  VariableFactory vfac;
+  MemoryFactory memfac;
+
+  Variable p(vfac.get("p"));
+  Variable q(vfac.get("q"));
+  Variable r(vfac.get("r"));
+  Variable s(vfac.get("s"));
+
+  MemLocation x(memfac.get("x"));
+  MemLocation y(memfac.get("y"));
+
+  ConstraintSystem sys(64, Unsigned);
+  Interval zero(Int(0, 64, Unsigned));
+  Interval four(Int(4, 64, Unsigned));
+
+  sys.add(Assign::create(p, AddrOperand::create(x, zero)));
+  sys.add(Assign::create(q, AddrOperand::create(y, four)));
+  sys.add(Assign::create(p, VarOperand::create(r, zero)));
+  sys.add(Assign::create(q, VarOperand::create(p, zero)));
+  sys.add(Assign::create(r, VarOperand::create(q, zero)));
+  sys.add(Load::create(s, VarOperand::create(p, zero)));
+  sys.add(Store::create(r, AddrOperand::create(x, zero)));
+
+  sys.solve();
+
+  PointerAbsValue expected(Uninitialized::top(),
+                           Nullity::top(),
+                           PointsToSet{x, y},
+                           Interval(Int(0, 64, Unsigned),
+                                    Int(4, 64, Unsigned)));
+  BOOST_CHECK(sys.get_pointer(p) == expected);
+  BOOST_CHECK(sys.get_pointer(q) == expected);
+  BOOST_CHECK(sys.get_pointer(r) == expected);
+  BOOST_CHECK(sys.get_pointer(s) == PointerAbsValue(Uninitialized::top(),
+                                                    Nullity::top(),
+                                                    PointsToSet{x},
+                                                    zero));
+
+  // All the pointers of the cycle are reported
+  std::size_t num_pointers = 0;
+  for (auto it = sys.pointer_begin(); it != sys.pointer_end(); ++it) {
+    num_pointers++;
+  }
+  BOOST_CHECK(num_pointers == 4);
+}
+
+BOOST_AUTO_TEST_CASE(test_widening) {
+  // p = &x;
+  // p = p + 4;
+
+  VariableFactory vfac;
+  MemoryFactory memfac;
+
+  Variable p(vfac.get("p"));
+
+  MemLocation x(memfac.get("x"));
+
+  ConstraintSystem s(64, Unsigned);
+  Interval zero(Int(0, 64, Unsigned));
+
+  s.add(Assign::create(p, AddrOperand::create(x, zero)));
+  s.add(Assign::create(p,
+                       VarOperand::create(p, Interval(Int(4, 64, Unsigned)))));
+
+  s.solve();
+
+  BOOST_CHECK(s.get_pointer(p) == PointerAbsValue(Uninitialized::top(),
+                                                  Nullity::top(),
+                                                  PointsToSet{x},
+                                                  Interval::top(64, Unsigned)));
+}
+
+BOOST_AUTO_TEST_CASE(test_late_store) {
+  // p = &a;
+  // q = *p;
+  // r = *q;
+  // *p = &b;
+  // *q = &c;
+  //
+  // The loads are processed before the stores, and need to be revisited.
+
+  VariableFactory vfac;
+  MemoryFactory memfac;
+
+  Variable p(vfac.get("p"));
+  Variable q(vfac.get("q"));
+  Variable r(vfac.get("r"));
+
+  MemLocation a(memfac.get("a"));
+  MemLocation b(memfac.get("b"));
+  MemLocation c(memfac.get("c"));
+
+  ConstraintSystem s(64, Unsigned);
+  Interval zero(Int(0, 64, Unsigned));
+
+  s.add(Assign::create(p, AddrOperand::create(a, zero)));
+  s.add(Load::create(q, VarOperand::create(p, zero)));
+  s.add(Load::create(r, VarOperand::create(q, zero)));
+  s.add(Store::create(p, AddrOperand::create(b, zero)));
+  s.add(Store::create(q, AddrOperand::create(c, zero)));
+
+  s.solve();
+
+  BOOST_CHECK(s.get_pointer(q) == PointerAbsValue(Uninitialized::top(),
+                                                  Nullity::top(),
+                                                  PointsToSet{b},
+                                                  zero));
+  BOOST_CHECK(s.get_pointer(r) == PointerAbsValue(Uninitialized::top(),
+                                                  Nullity::top(),
+                                                  PointsToSet{c},
+                                                  zero));
+  BOOST_CHECK(s.get_memory(a) == PointerAbsValue(Uninitialized::top(),
+                                                 Nullity::top(),
+                                                 PointsToSet{b},
+                                                 zero));
+  BOOST_CHECK(s.get_memory(b) == PointerAbsValue(Uninitialized::top(),
+                                                 Nullity::top(),
+                                                 PointsToSet{c},
+                                                 zero));
+}
@@ -567,3 +567,74 @@ BOOST_AUTO_TEST_CASE(test6) {
   BOOST_CHECK(end.to_interval(temp1) ==
               ZInterval(ZBound(5), ZBound::plus_infinity()));
 }
+
+BOOST_AUTO_TEST_CASE(test_concurrent) {
+  // Two independent loops, joined at the end
+  ControlFlowGraph cfg("entry");
+
+  BasicBlock* entry = cfg.get("entry");
+  BasicBlock* loop1_bb1 = cfg.get("loop1_bb1");
+  BasicBlock* loop1_bb1_t = cfg.get("loop1_bb1_t");
+  BasicBlock* loop1_bb1_f = cfg.get("loop1_bb1_f");
+  BasicBlock* loop1_bb2 = cfg.get("loop1_bb2");
+  BasicBlock* loop2_bb1 = cfg.get("loop2_bb1");
+  BasicBlock* loop2_bb1_t = cfg.get("loop2_bb1_t");
+  BasicBlock* loop2_bb1_f = cfg.get("loop2_bb1_f");
+  BasicBlock* loop2_bb2 = cfg.get("loop2_bb2");
+  BasicBlock* ret = cfg.get("ret");
+
+  VariableFactory vfac;
+  Variable n1(vfac.get("n1"));
+  Variable i(vfac.get("i"));
+  Variable j(vfac.get("j"));
+
+  entry->add_successor(loop1_bb1);
+  entry->add_successor(loop2_bb1);
+  loop1_bb1->add_successor(loop1_bb1_t);
+  loop1_bb1->add_successor(loop1_bb1_f);
+  loop1_bb1_t->add_successor(loop1_bb2);
+  loop1_bb2->add_successor(loop1_bb1);
+  loop1_bb1_f->add_successor(ret);
+  loop2_bb1->add_successor(loop2_bb1_t);
+  loop2_bb1->add_successor(loop2_bb1_f);
+  loop2_bb1_t->add_successor(loop2_bb2);
+  loop2_bb2->add_successor(loop2_bb1);
+  loop2_bb1_f->add_successor(ret);
+
+  entry->add(std::make_unique< ZLinearAssignment >(n1, ZLinearExpression(1)));
+  entry->add(std::make_unique< ZLinearAssignment >(i, ZLinearExpression(0)));
+  entry->add(std::make_unique< ZLinearAssignment >(j, ZLinearExpression(0)));
+
+  loop1_bb1_t->add(std::make_unique< ZLinearAssertion >(ZVarExpr(i) <= 9));
+  loop1_bb1_f->add(std::make_unique< ZLinearAssertion >(ZVarExpr(i) >= 10));
+  loop1_bb2->add(std::make_unique< CheckPoint >("loop1.in"));
+  loop1_bb2->add(
+      std::make_unique< ZBinaryOperation >(i, BinaryOperator::Add, i, n1));
+
+  loop2_bb1_t->add(std::make_unique< ZLinearAssertion >(ZVarExpr(j) <= 19));
+  loop2_bb1_f->add(std::make_unique< ZLinearAssertion >(ZVarExpr(j) >= 20));
+  loop2_bb2->add(std::make_unique< CheckPoint >("loop2.in"));
+  loop2_bb2->add(
+      std::make_unique< ZBinaryOperation >(j, BinaryOperator::Add, j, n1));
+
+  ret->add(std::make_unique< CheckPoint >("end"));
+
+  for (unsigned jobs = 1; jobs <= 4; jobs++) {
+    muzq::FixpointIterator< Variable, ZIntervalDomain, QIntervalDomain >
+        fixpoint(cfg);
+    fixpoint.set_jobs(jobs);
+    fixpoint.run();
+
+    ZIntervalDomain loop1_in = fixpoint.checkpoint("loop1.in").first();
+    BOOST_CHECK(loop1_in.to_interval(i) == ZInterval(ZBound(0), ZBound(9)));
+    BOOST_CHECK(loop1_in.to_interval(j) == ZInterval(0));
+
+    ZIntervalDomain loop2_in = fixpoint.checkpoint("loop2.in").first();
+    BOOST_CHECK(loop2_in.to_interval(i) == ZInterval(0));
+    BOOST_CHECK(loop2_in.to_interval(j) == ZInterval(ZBound(0), ZBound(19)));
+
+    ZIntervalDomain end = fixpoint.checkpoint("end").first();
+    BOOST_CHECK(end.to_interval(i) == ZInterval(ZBound(0), ZBound(10)));
+    BOOST_CHECK(end.to_interval(j) == ZInterval(ZBound(0), ZBound(20)));
+  }
+}
@@ -41,6 +41,7 @@
  ******************************************************************************/
 
 #include <limits>
+#include <vector>
 
 #define BOOST_TEST_MODULE test_z_number
 #define BOOST_TEST_DYN_LINK
@@ -601,3 +602,86 @@ BOOST_AUTO_TEST_CASE(test_z_number) {
   output << Z(42);
   BOOST_CHECK(output.is_equal("42"));
 }
+
+BOOST_AUTO_TEST_CASE(test_z_number_int64_overflow) {
+  using Z = ikos::core::ZNumber;
+
+  // Compare the results with GMP around the boundaries of int64_t
+  std::vector< mpz_class > values = {
+      mpz_class(0),
+      mpz_class(1),
+      mpz_class(-1),
+      mpz_class(2),
+      mpz_class(-3),
+      mpz_class("4294967296"),
+      mpz_class("-4294967297"),
+      mpz_class("3037000499"),
+      mpz_class("9223372036854775806"),
+      mpz_class("9223372036854775807"),
+      mpz_class("9223372036854775808"),
+      mpz_class("-9223372036854775807"),
+      mpz_class("-9223372036854775808"),
+      mpz_class("-9223372036854775809"),
+      mpz_class("18446744073709551616"),
+      mpz_class("-12157665459056928801"),
+  };
+
+  for (const mpz_class& a : values) {
+    Z x(a);
+    BOOST_CHECK(x.mpz() == a);
+    BOOST_CHECK(x.str() == a.get_str());
+    BOOST_CHECK((-x).mpz() == -a);
+    BOOST_CHECK(abs(x).mpz() == abs(a));
+    BOOST_CHECK((x + 1).mpz() == a + 1);
+    BOOST_CHECK((x - 1).mpz() == a - 1);
+    BOOST_CHECK((x << 1).mpz() == a << 1);
+    BOOST_CHECK((x << 70).mpz() == a << 70);
+    BOOST_CHECK((x >> 1).mpz() == a >> 1);
+    BOOST_CHECK((x >> 70).mpz() == a >> 70);
+    BOOST_CHECK(x.fits< long long >() ==
+                (a >= mpz_class("-9223372036854775808") &&
+                 a <= mpz_class("9223372036854775807")));
+    BOOST_CHECK(x.fits< unsigned long long >() ==
+                (a >= 0 && a <= mpz_class("18446744073709551615")));
+    BOOST_CHECK(x.fits< int >() == a.fits_sint_p());
+    BOOST_CHECK(x.fits< unsigned int >() == a.fits_uint_p());
+
+    Z y(x);
+    ++y;
+    BOOST_CHECK(y.mpz() == a + 1);
+    --y;
+    --y;
+    BOOST_CHECK(y.mpz() == a - 1);
+
+    for (const mpz_class& b : values) {
+      Z z(b);
+      BOOST_CHECK((x + z).mpz() == a + b);
+      BOOST_CHECK((x - z).mpz() == a - b);
+      BOOST_CHECK((x * z).mpz() == a * b);
+      BOOST_CHECK((x & z).mpz() == (a & b));
+      BOOST_CHECK((x | z).mpz() == (a | b));
+      BOOST_CHECK((x ^ z).mpz() == (a ^ b));
+      BOOST_CHECK((x == z) == (a == b));
+      BOOST_CHECK((x < z) == (a < b));
+      BOOST_CHECK((x <= z) == (a <= b));
+      BOOST_CHECK(gcd(x, z).mpz() == gcd(a, b));
+      BOOST_CHECK(lcm(x, z).mpz() == lcm(a, b));
+      if (b != 0) {
+        BOOST_CHECK((x / z).mpz() == a / b);
+        BOOST_CHECK((x % z).mpz() == a % b);
+        mpz_class r;
+        mpz_mod(r.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
+        BOOST_CHECK(mod(x, z).mpz() == r);
+      }
+    }
+  }
+
+  // Results that fit in a int64_t are demoted, so equal numbers hash equally
+  Z big = Z(std::numeric_limits< long long >::max()) + 1;
+  BOOST_CHECK(big.mpz() == mpz_class("9223372036854775808"));
+  big -= 1;
+  BOOST_CHECK(big == Z(std::numeric_limits< long long >::max()));
+  BOOST_CHECK(hash_value(big) ==
+              hash_value(Z(std::numeric_limits< long long >::max())));
+  BOOST_CHECK(hash_value(Z(mpz_class(42))) == hash_value(Z(42)));
+}